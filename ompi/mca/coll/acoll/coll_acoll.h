@@ -24,6 +24,9 @@
 #include "opal/mca/accelerator/accelerator.h"
 #include "opal/mca/shmem/base/base.h"
 #include "opal/mca/shmem/shmem.h"
+#include "opal/mca/threads/thread_usage.h"
+#include "opal/mca/timer/base/base.h"
+#include "opal/sys/atomic.h"
 
 // For smsc
 #include "opal/mca/smsc/smsc.h"
@@ -49,6 +52,10 @@ extern int mca_coll_acoll_bcast_nonsg;
 extern int mca_coll_acoll_bcast_socket;
 extern int mca_coll_acoll_allgather_lin;
 extern int mca_coll_acoll_allgather_ring_1;
+extern int mca_coll_acoll_use_hugepages;
+extern uint64_t mca_coll_acoll_hugepage_size;
+extern int mca_coll_acoll_pvar_timing;
+extern opal_thread_local opal_timer_t mca_coll_acoll_sync_usec;
 
 /* API functions */
 int mca_coll_acoll_init_query(bool enable_progress_threads, bool enable_mpi_threads);
@@ -85,12 +92,25 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
 
 int mca_coll_acoll_barrier_intra(struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
 
+int mca_coll_acoll_allreduce_multi(int n, const void *const *sbufs, void *const *rbufs,
+                                   const size_t *counts, struct ompi_datatype_t *const *dtypes,
+                                   struct ompi_op_t *const *ops, struct ompi_communicator_t *comm,
+                                   mca_coll_base_module_t *module);
+
+/* Scratch memory backed by huge pages when coll_acoll_use_hugepages is set */
+void *mca_coll_acoll_hugepage_alloc(size_t size);
+void mca_coll_acoll_hugepage_free(void *ptr);
+
+/* Lookup of the acoll module serving a communicator, used by the MPI_T pvars */
+struct mca_coll_acoll_module_t *mca_coll_acoll_comm_module(struct ompi_communicator_t *comm);
+
 END_C_DECLS
 
 #define MCA_COLL_ACOLL_ROOT_CHANGE_THRESH 10
 #define MCA_COLL_ACOLL_SPLIT_FACTOR_LIST_LEN 6
 #define MCA_COLL_ACOLL_SPLIT_FACTOR_LIST {2, 4, 8, 16, 32, 64}
 #define MCA_COLL_ACOLL_PROGRESS_COUNT 10000
+#define MCA_COLL_ACOLL_MULTI_MAX_OPS 64
 
 /* Hybrid backoff spin-wait thresholds for intra-node synchronization */
 #define MCA_COLL_ACOLL_SPIN_FAST_PATH_ITERS 200    /* Pure spinning iterations */
@@ -133,6 +153,49 @@ typedef enum MCA_COLL_ACOLL_BASE_LYRS {
     MCA_COLL_ACOLL_NUM_BASE_LYRS
 } MCA_COLL_ACOLL_BASE_LYRS;
 
+/* Collectives, algorithm classes and fallback reasons tracked by the
+ * MPI_T performance variables. Values are used as array indices. */
+typedef enum MCA_COLL_ACOLL_PVAR_COLLS {
+    MCA_COLL_ACOLL_PVAR_ALLGATHER = 0,
+    MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+    MCA_COLL_ACOLL_PVAR_ALLTOALL,
+    MCA_COLL_ACOLL_PVAR_BARRIER,
+    MCA_COLL_ACOLL_PVAR_BCAST,
+    MCA_COLL_ACOLL_PVAR_GATHER,
+    MCA_COLL_ACOLL_PVAR_REDUCE,
+    MCA_COLL_ACOLL_PVAR_NUM_COLLS
+} MCA_COLL_ACOLL_PVAR_COLLS;
+
+typedef enum MCA_COLL_ACOLL_PVAR_ALGS {
+    MCA_COLL_ACOLL_PVAR_ALG_SHM = 0,  /* Shared memory segment based */
+    MCA_COLL_ACOLL_PVAR_ALG_SMSC,     /* Single copy (xpmem) based */
+    MCA_COLL_ACOLL_PVAR_ALG_HIER,     /* Subgroup/topology aware point-to-point */
+    MCA_COLL_ACOLL_PVAR_ALG_BASE,     /* Algorithm from coll/base */
+    MCA_COLL_ACOLL_PVAR_NUM_ALGS
+} MCA_COLL_ACOLL_PVAR_ALGS;
+
+typedef enum MCA_COLL_ACOLL_PVAR_FALLBACKS {
+    MCA_COLL_ACOLL_PVAR_FB_COMM_SIZE = 0, /* Communicator too small */
+    MCA_COLL_ACOLL_PVAR_FB_MAX_COMMS,     /* More than max_comms communicators */
+    MCA_COLL_ACOLL_PVAR_FB_ROOT_CHANGE,   /* Too many root changes */
+    MCA_COLL_ACOLL_PVAR_FB_DTYPE,         /* Non-predefined datatype */
+    MCA_COLL_ACOLL_PVAR_FB_ACCEL_BUF,     /* Accelerator buffer */
+    MCA_COLL_ACOLL_PVAR_FB_NON_COMMUTE,   /* Non-commutative operation */
+    MCA_COLL_ACOLL_PVAR_NUM_FBS
+} MCA_COLL_ACOLL_PVAR_FALLBACKS;
+
+typedef struct coll_acoll_pvars {
+    unsigned long long alg_count[MCA_COLL_ACOLL_PVAR_NUM_COLLS][MCA_COLL_ACOLL_PVAR_NUM_ALGS];
+    unsigned long long fallback_count[MCA_COLL_ACOLL_PVAR_NUM_COLLS][MCA_COLL_ACOLL_PVAR_NUM_FBS];
+    unsigned long long bytes[MCA_COLL_ACOLL_PVAR_NUM_COLLS];
+    /* Seconds, only updated when coll_acoll_pvar_timing is set */
+    double sync_time[MCA_COLL_ACOLL_PVAR_NUM_COLLS];
+    double data_time[MCA_COLL_ACOLL_PVAR_NUM_COLLS];
+    /* Number of bcasts using linear sends in stage 0, 1 and 2 */
+    unsigned long long bcast_lin_count[3];
+    unsigned int alltoall_split_factor;
+} coll_acoll_pvars_t;
+
 typedef struct coll_acoll_smsc_info {
     mca_smsc_endpoint_t **ep;
     void **rreg;
@@ -222,7 +285,7 @@ typedef struct coll_acoll_reserve_mem {
     void *reserve_mem;
     uint64_t reserve_mem_size;
     bool reserve_mem_allocate;
-    bool reserve_mem_in_use;
+    opal_atomic_int32_t reserve_mem_in_use;
 } coll_acoll_reserve_mem_t;
 
 typedef struct {
@@ -257,10 +320,11 @@ struct mca_coll_acoll_module_t {
     int max_comms;
     coll_acoll_subcomms_t **subc;
     coll_acoll_reserve_mem_t reserve_mem_s;
-    int num_subc;
+    opal_atomic_int32_t num_subc;
     coll_acoll_alltoall_attr_t alltoall_attr;
     // 1 if SMSC, in particular xpmem is available, 0 otherwise
     int has_smsc;
+    coll_acoll_pvars_t pvars;
 };
 
 typedef struct mca_coll_acoll_module_t mca_coll_acoll_module_t;
@@ -286,4 +350,31 @@ static inline void coll_acoll_subcomm_free(ompi_communicator_t **comm)
     }
 }
 
+/* Account one call of collective coll served by algorithm class alg */
+static inline void coll_acoll_pvar_alg(mca_coll_acoll_module_t *acoll_module, int coll, int alg,
+                                       size_t bytes)
+{
+    acoll_module->pvars.alg_count[coll][alg]++;
+    acoll_module->pvars.bytes[coll] += bytes;
+}
+
+static inline void coll_acoll_pvar_fallback(mca_coll_acoll_module_t *acoll_module, int coll,
+                                            int reason)
+{
+    acoll_module->pvars.fallback_count[coll][reason]++;
+}
+
+/* Sync wait time accounting, a no-op unless coll_acoll_pvar_timing is set */
+static inline opal_timer_t coll_acoll_sync_begin(void)
+{
+    return mca_coll_acoll_pvar_timing ? opal_timer_base_get_usec() : 0;
+}
+
+static inline void coll_acoll_sync_end(opal_timer_t start)
+{
+    if (mca_coll_acoll_pvar_timing) {
+        mca_coll_acoll_sync_usec += opal_timer_base_get_usec() - start;
+    }
+}
+
 #endif /* MCA_COLL_ACOLL_EXPORT_H */
@@ -484,11 +484,18 @@ int mca_coll_acoll_allgather(const void *sbuf, size_t scount, struct ompi_dataty
     coll_acoll_subcomms_t *subc = NULL;
     char *local_rbuf;
     ompi_communicator_t *intra_comm;
+    size_t rdsize;
+
+    ompi_datatype_type_size(rdtype, &rdsize);
 
     /* Obtain the subcomms structure */
     err = check_and_create_subc(comm, acoll_module, &subc);
     /* Fallback to ring if subc is not obtained */
     if (NULL == subc) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_ALLGATHER,
+                                 MCA_COLL_ACOLL_PVAR_FB_MAX_COMMS);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLGATHER,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, rcount * rdsize);
         return ompi_coll_base_allgather_intra_ring(sbuf, scount, sdtype, rbuf, rcount, rdtype, comm,
                                                    module);
     }
@@ -505,6 +512,8 @@ int mca_coll_acoll_allgather(const void *sbuf, size_t scount, struct ompi_dataty
     if (MPI_SUCCESS != err) {
         return err;
     }
+    coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLGATHER, MCA_COLL_ACOLL_PVAR_ALG_HIER,
+                        rcount * rdsize);
 
     rank = ompi_comm_rank(comm);
     node_size = size > 2 ? subc->derived_node_size : size;
@@ -19,6 +19,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/pml/pml.h"
 #include "ompi/op/op.h"
+#include "opal/mca/memcpy/base/base.h"
 #include "opal/util/bit_ops.h"
 #include "coll_acoll.h"
 #include "coll_acoll_utils.h"
@@ -81,10 +82,12 @@ static inline int mca_coll_acoll_reduce_smsc_h(const void *sbuf, void *rbuf, siz
     if (!subc->smsc_use_sr_buf) {
         tmp_rbuf = (char *) data->scratch;
         tmp_sbuf = (char *) data->scratch + (subc->smsc_buf_size) / 2;
+        /* The other processes read the staged copy through smsc, this
+         * process only its own chunk: bypass the caches */
         if ((MPI_IN_PLACE == sbuf)) {
-            memcpy(tmp_sbuf, rbuf, total_dsize);
+            opal_memcpy_nt(tmp_sbuf, rbuf, total_dsize);
         } else {
-            memcpy(tmp_sbuf, sbuf, total_dsize);
+            opal_memcpy_nt(tmp_sbuf, sbuf, total_dsize);
         }
     } else {
         tmp_sbuf = (char *) sbuf;
@@ -211,10 +214,12 @@ static inline int mca_coll_acoll_allreduce_smsc_f(const void *sbuf, void *rbuf,
     if (!subc->smsc_use_sr_buf) {
         tmp_rbuf = (char *) data->scratch;
         tmp_sbuf = (char *) data->scratch + (subc->smsc_buf_size) / 2;
+        /* The other processes read the staged copy through smsc, this
+         * process only its own chunk: bypass the caches */
         if ((MPI_IN_PLACE == sbuf)) {
-            memcpy(tmp_sbuf, rbuf, total_dsize);
+            opal_memcpy_nt(tmp_sbuf, rbuf, total_dsize);
         } else {
-            memcpy(tmp_sbuf, sbuf, total_dsize);
+            opal_memcpy_nt(tmp_sbuf, sbuf, total_dsize);
         }
     } else {
         tmp_sbuf = (char *) sbuf;
@@ -299,6 +304,7 @@ void mca_coll_acoll_sync(coll_acoll_data_t *data, int offset, int *group, int gp
                          int up)
 {
     volatile int *tmp, tmp0;
+    opal_timer_t start = coll_acoll_sync_begin();
     tmp = (int *) ((char *) data->allshmmmap_sbuf[group[0]] + offset
                    + CACHE_LINE_SIZE * rank);
     tmp0 = __atomic_load_n((int *) ((char *) data->allshmmmap_sbuf[group[0]] + offset
@@ -360,6 +366,7 @@ void mca_coll_acoll_sync(coll_acoll_data_t *data, int offset, int *group, int gp
     } else {
         data->sync[1] = val;
     }
+    coll_acoll_sync_end(start);
 }
 
 int mca_coll_acoll_allreduce_small_msgs_h(const void *sbuf, void *rbuf, size_t count,
@@ -466,14 +473,21 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
     int dev_id;
     bool is_opt = true;
     if (!OMPI_COMM_CHECK_ASSERT_NO_ACCEL_BUF(comm)) {
-        if (!ompi_datatype_is_predefined(dtype)
-            || (0 < opal_accelerator.check_addr(sbuf, &dev_id, &flags))
-            || (0 < opal_accelerator.check_addr(rbuf, &dev_id, &flags))) {
+        if (!ompi_datatype_is_predefined(dtype)) {
+            coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                     MCA_COLL_ACOLL_PVAR_FB_DTYPE);
+            is_opt = false;
+        } else if ((0 < opal_accelerator.check_addr(sbuf, &dev_id, &flags))
+                   || (0 < opal_accelerator.check_addr(rbuf, &dev_id, &flags))) {
+            coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                     MCA_COLL_ACOLL_PVAR_FB_ACCEL_BUF);
             is_opt = false;
         }
     }
 
     if ((1 == size) && is_opt) {
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                            MCA_COLL_ACOLL_PVAR_ALG_SHM, total_dsize);
         if (MPI_IN_PLACE != sbuf) {
             memcpy((char *) rbuf, sbuf, total_dsize);
         }
@@ -482,6 +496,10 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
 
     /* Falling back to recursivedoubling for non-commutative operators to be safe */
     if (!ompi_op_is_commute(op)) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                 MCA_COLL_ACOLL_PVAR_FB_NON_COMMUTE);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype, op, comm,
                                                                 module);
     }
@@ -496,6 +514,10 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
 
     /* Fallback to knomial if subc is not obtained */
     if (NULL == subc) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                 MCA_COLL_ACOLL_PVAR_FB_MAX_COMMS);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype, op, comm,
                                                                 module);
     }
@@ -512,6 +534,8 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
     /* Try with socket/node based split */
     if (num_nodes > 1) {
         if (total_dsize > 16384) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
             return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype, op,
                                                                     comm, module);
         }
@@ -524,12 +548,16 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
 
         /* Validate communicator hierarchy before proceeding */
         if (NULL == soc_comm || NULL == ldr_comm) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
             return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype, op,
                                                                     comm, module);
         }
 
         err = check_and_create_subc(soc_comm, acoll_module, &soc_subc);
         if (NULL != soc_subc) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_HIER, total_dsize);
             if (!soc_subc->initialized || (soc_root != soc_subc->prev_init_root)) {
                 err = mca_coll_acoll_comm_split_init(soc_comm, acoll_module, soc_subc, soc_root);
                 if (MPI_SUCCESS != err)
@@ -606,15 +634,23 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
 
     if (1 == num_nodes) {
         if (total_dsize < 32) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
             return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype, op,
                                                                     comm, module);
         } else if ((total_dsize < 512) && is_opt) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_SHM, total_dsize);
             return mca_coll_acoll_allreduce_small_msgs_h(sbuf, rbuf, count, dtype, op, comm, module,
                                                          subc, 1);
         } else if (total_dsize <= 2048) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
             return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype, op,
                                                                     comm, module);
         } else if (total_dsize < 65536) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
             if (1 == alg) {
                 return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype,
                                                                         op, comm, module);
@@ -628,33 +664,203 @@ int mca_coll_acoll_allreduce_intra(const void *sbuf, void *rbuf, size_t count,
         } else if (total_dsize < 4194304) {
             if (((0 != subc->smsc_use_sr_buf) || (subc->smsc_buf_size > 2 * total_dsize))
                 && (1 != subc->without_smsc) && is_opt) {
+                coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                    MCA_COLL_ACOLL_PVAR_ALG_SMSC, total_dsize);
                 return mca_coll_acoll_allreduce_smsc_f(sbuf, rbuf, count, dtype, op, comm, module, subc);
             } else {
+                coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                    MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
                 return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype,
                                                                         op, comm, module);
             }
         } else if (total_dsize <= 16777216) {
             if (((0 != subc->smsc_use_sr_buf) || (subc->smsc_buf_size > 2 * total_dsize))
                 && (1 != subc->without_smsc) && is_opt) {
+                coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                    MCA_COLL_ACOLL_PVAR_ALG_SMSC, total_dsize);
                 mca_coll_acoll_reduce_smsc_h(sbuf, rbuf, count, dtype, op, comm, module, subc);
                 return mca_coll_acoll_bcast(rbuf, count, dtype, 0, comm, module);
             } else {
+                coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                    MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
                 return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype,
                                                                         op, comm, module);
             }
         } else {
             if (((0 != subc->smsc_use_sr_buf) || (subc->smsc_buf_size > 2 * total_dsize))
                 && (1 != subc->without_smsc) && is_opt) {
+                coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                    MCA_COLL_ACOLL_PVAR_ALG_SMSC, total_dsize);
                 return mca_coll_acoll_allreduce_smsc_f(sbuf, rbuf, count, dtype, op, comm, module, subc);
             } else {
+                coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                                    MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
                 return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype,
                                                                         op, comm, module);
             }
         }
 
     } else {
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_allreduce_intra_redscat_allgather(sbuf, rbuf, count, dtype, op, comm,
                                                                 module);
     }
     return MPI_SUCCESS;
 }
+
+/*
+ * mca_coll_acoll_allreduce_multi
+ *
+ * Function:    Fused allreduce of several small operands
+ * Accepts:     n operands, each with its own buffers, count, datatype and op
+ * Returns:     MPI_SUCCESS or error code
+ *
+ * Description: Same scheme as mca_coll_acoll_allreduce_small_msgs_h, but all
+ *              operands are packed into the per-rank shm slot so that the
+ *              whole batch costs a single set of syncs. Operands are aligned
+ *              to 16 bytes within the slot and reduced one by one with their
+ *              own op/datatype.
+ *
+ * Limitations: Single node, at most MCA_COLL_ACOLL_MULTI_MAX_OPS operands,
+ *              predefined datatypes, commutative ops, host buffers, and a
+ *              packed size within PER_RANK_SHM_SIZE. Anything
+ *              else falls back to one allreduce per operand.
+ */
+int mca_coll_acoll_allreduce_multi(int n, const void *const *sbufs, void *const *rbufs,
+                                   const size_t *counts, struct ompi_datatype_t *const *dtypes,
+                                   struct ompi_op_t *const *ops, struct ompi_communicator_t *comm,
+                                   mca_coll_base_module_t *module)
+{
+    mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *) module;
+    coll_acoll_subcomms_t *subc = NULL;
+    coll_acoll_data_t *data;
+    size_t offsets[MCA_COLL_ACOLL_MULTI_MAX_OPS + 1], total_dsize = 0, dsize;
+    char packed[PER_RANK_SHM_SIZE] __opal_attribute_aligned__(16);
+    uint64_t flags = 0;
+    int dev_id, err = MPI_SUCCESS;
+    bool is_opt = (1 < ompi_comm_size(comm)) && (n <= MCA_COLL_ACOLL_MULTI_MAX_OPS);
+
+    /* Compute the packed layout and check that every operand qualifies */
+    offsets[0] = 0;
+    for (int i = 0; is_opt && (i < n); i++) {
+        ompi_datatype_type_size(dtypes[i], &dsize);
+        total_dsize += counts[i] * dsize;
+        offsets[i + 1] = OPAL_ALIGN(offsets[i] + counts[i] * dsize, 16, size_t);
+        if (!ompi_datatype_is_predefined(dtypes[i]) || !ompi_op_is_commute(ops[i])) {
+            is_opt = false;
+        } else if (!OMPI_COMM_CHECK_ASSERT_NO_ACCEL_BUF(comm)
+                   && (((MPI_IN_PLACE != sbufs[i])
+                        && (0 < opal_accelerator.check_addr(sbufs[i], &dev_id, &flags)))
+                       || (0 < opal_accelerator.check_addr(rbufs[i], &dev_id, &flags)))) {
+            is_opt = false;
+        }
+    }
+    if (is_opt && (offsets[n] > PER_RANK_SHM_SIZE)) {
+        is_opt = false;
+    }
+
+    if (is_opt) {
+        err = check_and_create_subc(comm, acoll_module, &subc);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+        if ((NULL != subc) && !subc->initialized) {
+            err = mca_coll_acoll_comm_split_init(comm, acoll_module, subc, 0);
+            if (MPI_SUCCESS != err) {
+                return err;
+            }
+        }
+        if ((NULL == subc) || (1 != subc->num_nodes)) {
+            is_opt = false;
+        }
+    }
+
+    if (!is_opt) {
+        for (int i = 0; i < n; i++) {
+            err = comm->c_coll->coll_allreduce(sbufs[i], rbufs[i], counts[i], dtypes[i], ops[i],
+                                               comm, comm->c_coll->coll_allreduce_module);
+            if (MPI_SUCCESS != err) {
+                return err;
+            }
+        }
+        return MPI_SUCCESS;
+    }
+
+    coll_acoll_init(module, comm, subc->data, subc, 0);
+    data = subc->data;
+    if (NULL == data) {
+        return OMPI_ERROR;
+    }
+    coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLREDUCE, MCA_COLL_ACOLL_PVAR_ALG_SHM,
+                        total_dsize);
+
+    int rank = ompi_comm_rank(comm);
+    int l1_gp_size = data->l1_gp_size;
+    int *l1_gp = data->l1_gp;
+    int *l2_gp = data->l2_gp;
+    int l2_gp_size = data->l2_gp_size;
+    int l2_local_rank = data->l2_local_rank;
+    int offset1 = data->offset[0];
+    int offset2 = data->offset[1];
+    int tshm_offset = data->offset[2];
+    char *slot = (char *) data->allshmmmap_sbuf[l1_gp[0]] + data->offset[3];
+    char *leader = (char *) data->allshmmmap_sbuf[l1_gp[0]];
+
+    if ((rank == l1_gp[0]) && (l2_gp_size > 1)) {
+        mca_coll_acoll_sync(data, offset2, l2_gp, l2_gp_size, rank, 3);
+    }
+
+    /* Pack all operands into the per-rank shm slot */
+    for (int i = 0; i < n; i++) {
+        ompi_datatype_type_size(dtypes[i], &dsize);
+        memcpy(slot + offsets[i], (MPI_IN_PLACE == sbufs[i]) ? rbufs[i] : sbufs[i],
+               counts[i] * dsize);
+    }
+
+    mca_coll_acoll_sync(data, offset1, l1_gp, l1_gp_size, rank, 1);
+
+    if (rank == l1_gp[0]) {
+        memcpy(leader, slot, offsets[n]);
+        for (int j = 1; j < l1_gp_size; j++) {
+            char *peer = (char *) data->allshmmmap_sbuf[l1_gp[0]] + tshm_offset
+                         + l1_gp[j] * PER_RANK_SHM_SIZE;
+            for (int i = 0; i < n; i++) {
+                ompi_op_reduce(ops[i], peer + offsets[i], leader + offsets[i], counts[i],
+                               dtypes[i]);
+            }
+        }
+        memcpy(packed, leader, offsets[n]);
+
+        if (l2_gp_size > 1) {
+            mca_coll_acoll_sync(data, offset2, l2_gp, l2_gp_size, rank, 3);
+        }
+
+        /* Allreduce across leaders */
+        for (int j = 0; j < l2_gp_size; j++) {
+            if (j == l2_local_rank) {
+                continue;
+            }
+            for (int i = 0; i < n; i++) {
+                ompi_op_reduce(ops[i], (char *) data->allshmmmap_sbuf[l2_gp[j]] + offsets[i],
+                               packed + offsets[i], counts[i], dtypes[i]);
+            }
+        }
+    }
+
+    if (ompi_comm_size(subc->numa_comm) > 1) {
+        err = ompi_coll_base_bcast_intra_basic_linear(packed, offsets[n], &ompi_mpi_byte.dt, 0,
+                                                      subc->numa_comm, module);
+        if (MPI_SUCCESS != err) {
+            return err;
+        }
+    }
+
+    /* Unpack the results */
+    for (int i = 0; i < n; i++) {
+        ompi_datatype_type_size(dtypes[i], &dsize);
+        memcpy(rbufs[i], packed + offsets[i], counts[i] * dsize);
+    }
+
+    return MPI_SUCCESS;
+}
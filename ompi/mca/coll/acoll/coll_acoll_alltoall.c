@@ -461,10 +461,18 @@ int mca_coll_acoll_alltoall
     mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *)module;
     coll_acoll_subcomms_t *subc = NULL;
 
+    size_t dsize = 0;
+    ompi_datatype_type_size(rdtype, &dsize);
+
     /* Obtain the subcomms structure */
     error = check_and_create_subc(comm, acoll_module, &subc);
     /* Fallback to knomial if subcomms is not obtained */
     if ((NULL == subc) || (size < 4)) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_ALLTOALL,
+                                 (NULL == subc) ? MCA_COLL_ACOLL_PVAR_FB_MAX_COMMS
+                                                : MCA_COLL_ACOLL_PVAR_FB_COMM_SIZE);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLTOALL,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, size * rcount * dsize);
         return mca_coll_acoll_base_alltoall_dispatcher
                         (sbuf, scount, sdtype,
                          rbuf, rcount, rdtype,
@@ -478,13 +486,12 @@ int mca_coll_acoll_alltoall
         if (MPI_SUCCESS != error) { return error; }
     }
 
-    size_t dsize = 0;
-    ompi_datatype_type_size(rdtype, &dsize);
-
     /* Derive upper bound on message size where this algorithm is applicable. */
     size_t dsize_thresh = mca_coll_acoll_get_msg_thresh(subc, acoll_module);
 
     if (dsize_thresh < (rcount * rext)) {
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLTOALL,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, size * rcount * dsize);
         return mca_coll_acoll_base_alltoall_dispatcher
                         (sbuf, scount, sdtype,
                          rbuf, rcount, rdtype,
@@ -509,6 +516,9 @@ int mca_coll_acoll_alltoall
                      (MPI_IN_PLACE == sbuf), comm,
                      &sync_enable, &grp_split_f);
     }
+    coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_ALLTOALL,
+                        MCA_COLL_ACOLL_PVAR_ALG_HIER, size * rcount * dsize);
+    acoll_module->pvars.alltoall_split_factor = (unsigned int) grp_split_f;
 
     char* work_buf_free = NULL;
     char* work_buf = NULL;
@@ -257,6 +257,10 @@ int mca_coll_acoll_barrier_intra(struct ompi_communicator_t *comm, mca_coll_base
 
     /* Fallback to linear if subcomms structure is not obtained */
     if (NULL == subc) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_BARRIER,
+                                 MCA_COLL_ACOLL_PVAR_FB_MAX_COMMS);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_BARRIER,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, 0);
         return ompi_coll_base_barrier_intra_basic_linear(comm, module);
     }
 
@@ -275,6 +279,10 @@ int mca_coll_acoll_barrier_intra(struct ompi_communicator_t *comm, mca_coll_base
     /* Default barrier for intra-node case - shared memory hierarchical */
     /* ToDo: Need to check how this works with inter-case */
     if (1 == num_nodes) {
+        if ((0 == subc->barrier_algo) || (1 == subc->barrier_algo)) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_BARRIER,
+                                MCA_COLL_ACOLL_PVAR_ALG_SHM, 0);
+        }
         if (0 == subc->barrier_algo) {
             return mca_coll_acoll_barrier_shm_h(comm, module, subc);
         } else if (1 == subc->barrier_algo) {
@@ -282,6 +290,7 @@ int mca_coll_acoll_barrier_intra(struct ompi_communicator_t *comm, mca_coll_base
         }
     }
 
+    coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_BARRIER, MCA_COLL_ACOLL_PVAR_ALG_HIER, 0);
     reqs = ompi_coll_base_comm_get_reqs(module->base_data, size);
     if (NULL == reqs) {
         return OMPI_ERR_OUT_OF_RESOURCE;
@@ -673,7 +673,13 @@ int mca_coll_acoll_bcast(void *buff, size_t count, struct ompi_datatype_t *datat
 
     /* For small communicators, use linear bcast */
     size = ompi_comm_size(comm);
+    ompi_datatype_type_size(datatype, &dsize);
+    total_dsize = dsize * count;
     if (size < 8) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                                 MCA_COLL_ACOLL_PVAR_FB_COMM_SIZE);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_bcast_intra_basic_linear(buff, count, datatype, root, comm, module);
     }
 
@@ -681,12 +687,20 @@ int mca_coll_acoll_bcast(void *buff, size_t count, struct ompi_datatype_t *datat
     err = check_and_create_subc(comm, acoll_module, &subc);
     /* Fallback to knomial if subcomms is not obtained */
     if (NULL == subc) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                                 MCA_COLL_ACOLL_PVAR_FB_MAX_COMMS);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_bcast_intra_knomial(buff, count, datatype, root, comm, module, 0, 4);
     }
 
     /* Fallback to knomial if no. of root changes is beyond a threshold */
     if ((subc->num_root_change > MCA_COLL_ACOLL_ROOT_CHANGE_THRESH)
         && (root != subc->prev_init_root)) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                                 MCA_COLL_ACOLL_PVAR_FB_ROOT_CHANGE);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         if (acoll_module->disable_fallback) {
             return ompi_coll_base_bcast_intra_basic_linear(buff, count, datatype, root, comm, module);
         } else {
@@ -700,8 +714,6 @@ int mca_coll_acoll_bcast(void *buff, size_t count, struct ompi_datatype_t *datat
         }
     }
 
-    ompi_datatype_type_size(datatype, &dsize);
-    total_dsize = dsize * count;
     rank = ompi_comm_rank(comm);
     sg_cnt = acoll_module->sg_cnt;
     num_nodes = subc->num_nodes;
@@ -711,6 +723,8 @@ int mca_coll_acoll_bcast(void *buff, size_t count, struct ompi_datatype_t *datat
     if (((num_nodes >= 8 && total_dsize <= 65536)
         || (1 == num_nodes && size >= 256 && total_dsize < 16384)) &&
         !acoll_module->disable_fallback) {
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_bcast_intra_knomial(buff, count, datatype, root, comm, module, 0, 4);
     }
 
@@ -728,12 +742,23 @@ int mca_coll_acoll_bcast(void *buff, size_t count, struct ompi_datatype_t *datat
     /* - it's a gpu buffer */
     uint64_t flags = 0;
     int dev_id;
-    if (!OMPI_COMM_CHECK_ASSERT_NO_ACCEL_BUF(comm)) {
-        if (!ompi_datatype_is_predefined(datatype)
-            || (0 < opal_accelerator.check_addr(buff, &dev_id, &flags))) {
+    if (!OMPI_COMM_CHECK_ASSERT_NO_ACCEL_BUF(comm) && use_shm) {
+        if (!ompi_datatype_is_predefined(datatype)) {
+            coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                                     MCA_COLL_ACOLL_PVAR_FB_DTYPE);
+            use_shm = 0;
+        } else if (0 < opal_accelerator.check_addr(buff, &dev_id, &flags)) {
+            coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                                     MCA_COLL_ACOLL_PVAR_FB_ACCEL_BUF);
             use_shm = 0;
         }
     }
+    coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_BCAST,
+                        use_shm ? MCA_COLL_ACOLL_PVAR_ALG_SHM : MCA_COLL_ACOLL_PVAR_ALG_HIER,
+                        total_dsize);
+    acoll_module->pvars.bcast_lin_count[0] += lin_0;
+    acoll_module->pvars.bcast_lin_count[1] += lin_1;
+    acoll_module->pvars.bcast_lin_count[2] += lin_2;
 
     coll_acoll_bcast_subcomms(comm, subc, subcomms, subc_roots, root, num_nodes, use_0, no_sg,
                               use_numa, use_socket);
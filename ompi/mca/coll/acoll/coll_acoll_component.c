@@ -12,8 +12,14 @@
 
 #include "ompi_config.h"
 
+#include <stddef.h>
+
 #include "mpi.h"
 #include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/base.h"
+#include "opal/mca/base/mca_base_pvar.h"
+#include "opal/util/sys_limits.h"
+#include "opal/util/output.h"
 #include "coll_acoll.h"
 
 /*
@@ -54,11 +60,46 @@ int mca_coll_acoll_smsc_use_sr_buf = 1;
 /* Default barrier algorithm - hierarchical algorithm using shared memory */
 /* ToDo: check how this works with inter-node*/
 int mca_coll_acoll_barrier_algo = 0;
+/* Huge pages for shared memory segments and scratch buffers, off by default */
+int mca_coll_acoll_use_hugepages = 0;
+uint64_t mca_coll_acoll_hugepage_size = 2 * 1024 * 1024; // 2 MB
+/* Timing of sync waits vs. data movement for the MPI_T pvars, off by default */
+int mca_coll_acoll_pvar_timing = 0;
+opal_thread_local opal_timer_t mca_coll_acoll_sync_usec = 0;
+
+/*
+ * MPI_T performance variables. Each pvar is bound to a communicator and
+ * exposes a slice of the coll_acoll_pvars_t of the acoll module serving it.
+ */
+typedef struct coll_acoll_pvar_desc {
+    size_t offset;
+    int count;
+    size_t elem_size;
+} coll_acoll_pvar_desc_t;
+
+enum {
+    ACOLL_PVAR_ALG_COUNT = 0,
+    ACOLL_PVAR_FALLBACK_COUNT,
+    ACOLL_PVAR_BYTES,
+    ACOLL_PVAR_SYNC_TIME,
+    ACOLL_PVAR_DATA_TIME,
+    ACOLL_PVAR_NUM_PER_COLL
+};
+
+#define ACOLL_PVAR_OFFSET(field, idx) \
+    (offsetof(coll_acoll_pvars_t, field) + (idx) * sizeof(((coll_acoll_pvars_t *) 0)->field[0]))
+
+static coll_acoll_pvar_desc_t acoll_pvar_desc[MCA_COLL_ACOLL_PVAR_NUM_COLLS * ACOLL_PVAR_NUM_PER_COLL
+                                              + 2];
+
+static const char *acoll_pvar_coll_names[MCA_COLL_ACOLL_PVAR_NUM_COLLS]
+    = {"allgather", "allreduce", "alltoall", "barrier", "bcast", "gather", "reduce"};
 
 /*
  * Local function
  */
 static int acoll_register(void);
+static void acoll_register_pvars(void);
 
 /*
  * Instantiate the public struct with all of our public information
@@ -230,16 +271,159 @@ static int acoll_register(void)
         "should not be used.",
         MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
         &mca_coll_acoll_alltoall_psplit_msg_thres);
+    (void) mca_base_component_var_register(
+        &mca_coll_acoll_component.collm_version, "use_hugepages",
+        "Back shared memory segments and scratch buffers with huge pages "
+        "when set to 1. Uses hugetlbfs through the hugepage mpool if a "
+        "matching mount exists, transparent huge pages otherwise, and "
+        "silently falls back to regular pages if neither is available.",
+        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+        &mca_coll_acoll_use_hugepages);
+    (void) mca_base_component_var_register(
+        &mca_coll_acoll_component.collm_version, "hugepage_size",
+        "Huge page size in bytes used when use_hugepages is set "
+        "(e.g. 2097152 for 2MB or 1073741824 for 1GB pages). Must be a "
+        "power of two of at least the page size, huge pages are disabled "
+        "otherwise.",
+        MCA_BASE_VAR_TYPE_UINT64_T, NULL, 0, 0, OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+        &mca_coll_acoll_hugepage_size);
+    /* The sizes are rounded up with OPAL_ALIGN, which needs a power of two */
+    if ((0 != mca_coll_acoll_use_hugepages)
+        && ((mca_coll_acoll_hugepage_size < (uint64_t) opal_getpagesize())
+            || (0 != (mca_coll_acoll_hugepage_size & (mca_coll_acoll_hugepage_size - 1))))) {
+        opal_output_verbose(MCA_BASE_VERBOSE_WARN, ompi_coll_base_framework.framework_output,
+                            "coll:acoll: hugepage_size %" PRIu64 " is not a power of two of at "
+                            "least the page size, huge pages are disabled.",
+                            mca_coll_acoll_hugepage_size);
+        mca_coll_acoll_use_hugepages = 0;
+    }
+    (void) mca_base_component_var_register(
+        &mca_coll_acoll_component.collm_version, "pvar_timing",
+        "Accumulate the time spent in shared memory sync waits and in data "
+        "movement per collective, exposed through the sync_time/data_time "
+        "MPI_T performance variables. Adds two timer reads per call.",
+        MCA_BASE_VAR_TYPE_INT, NULL, 0, 0, OPAL_INFO_LVL_9, MCA_BASE_VAR_SCOPE_READONLY,
+        &mca_coll_acoll_pvar_timing);
+
+    acoll_register_pvars();
+
+    return OMPI_SUCCESS;
+}
+
+static int acoll_pvar_notify(mca_base_pvar_t *pvar, mca_base_pvar_event_t event, void *obj_handle,
+                             int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = ((coll_acoll_pvar_desc_t *) pvar->ctx)->count;
+    }
 
     return OMPI_SUCCESS;
 }
 
+static int acoll_pvar_read(const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    const coll_acoll_pvar_desc_t *desc = (const coll_acoll_pvar_desc_t *) pvar->ctx;
+    mca_coll_acoll_module_t *acoll_module = mca_coll_acoll_comm_module(
+        (ompi_communicator_t *) obj_handle);
+    size_t len = desc->count * desc->elem_size;
+
+    if (NULL == acoll_module) {
+        memset(value, 0, len);
+    } else {
+        memcpy(value, (char *) &acoll_module->pvars + desc->offset, len);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static void acoll_register_one_pvar(coll_acoll_pvar_desc_t *desc, const char *name,
+                                    const char *description, int var_class,
+                                    mca_base_var_type_t type)
+{
+    (void) mca_base_component_pvar_register(&mca_coll_acoll_component.collm_version, name,
+                                            description, OPAL_INFO_LVL_4, var_class, type, NULL,
+                                            MCA_BASE_VAR_BIND_MPI_COMM,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            acoll_pvar_read, NULL, acoll_pvar_notify, desc);
+}
+
+static void acoll_register_pvars(void)
+{
+    coll_acoll_pvar_desc_t *desc = acoll_pvar_desc;
+    char name[64];
+
+    for (int i = 0; i < MCA_COLL_ACOLL_PVAR_NUM_COLLS; i++) {
+        const char *coll = acoll_pvar_coll_names[i];
+
+        *desc = (coll_acoll_pvar_desc_t) {
+            ACOLL_PVAR_OFFSET(alg_count, i), MCA_COLL_ACOLL_PVAR_NUM_ALGS,
+            sizeof(unsigned long long)};
+        snprintf(name, sizeof(name), "%s_algorithm_count", coll);
+        acoll_register_one_pvar(desc++, name,
+                                "Number of calls served by each algorithm class: "
+                                "[0] shared memory, [1] smsc (single copy), "
+                                "[2] subgroup/topology aware point-to-point, [3] coll/base",
+                                MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG);
+
+        *desc = (coll_acoll_pvar_desc_t) {
+            ACOLL_PVAR_OFFSET(fallback_count, i), MCA_COLL_ACOLL_PVAR_NUM_FBS,
+            sizeof(unsigned long long)};
+        snprintf(name, sizeof(name), "%s_fallback_count", coll);
+        acoll_register_one_pvar(desc++, name,
+                                "Number of calls that dropped the optimized path, by reason: "
+                                "[0] communicator too small, [1] max_comms exceeded, "
+                                "[2] too many root changes, [3] non-predefined datatype, "
+                                "[4] accelerator buffer, [5] non-commutative operation",
+                                MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG);
+
+        *desc = (coll_acoll_pvar_desc_t) {
+            ACOLL_PVAR_OFFSET(bytes, i), 1, sizeof(unsigned long long)};
+        snprintf(name, sizeof(name), "%s_bytes", coll);
+        acoll_register_one_pvar(desc++, name,
+                                "Bytes contributed by the local process over all calls",
+                                MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG);
+
+        *desc = (coll_acoll_pvar_desc_t) {
+            ACOLL_PVAR_OFFSET(sync_time, i), 1, sizeof(double)};
+        snprintf(name, sizeof(name), "%s_sync_time", coll);
+        acoll_register_one_pvar(desc++, name,
+                                "Seconds spent waiting on shared memory flags "
+                                "(requires coll_acoll_pvar_timing)",
+                                MCA_BASE_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE);
+
+        *desc = (coll_acoll_pvar_desc_t) {
+            ACOLL_PVAR_OFFSET(data_time, i), 1, sizeof(double)};
+        snprintf(name, sizeof(name), "%s_data_time", coll);
+        acoll_register_one_pvar(desc++, name,
+                                "Seconds spent outside of sync waits, i.e. moving and "
+                                "reducing data (requires coll_acoll_pvar_timing)",
+                                MCA_BASE_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE);
+    }
+
+    *desc = (coll_acoll_pvar_desc_t) {offsetof(coll_acoll_pvars_t, bcast_lin_count), 3,
+                                      sizeof(unsigned long long)};
+    acoll_register_one_pvar(desc++, "bcast_linear_count",
+                            "Number of hierarchical bcasts using linear instead of binomial "
+                            "sends in stage [0] across nodes, [1] across subgroups and "
+                            "[2] within subgroups",
+                            MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG);
+
+    *desc = (coll_acoll_pvar_desc_t) {offsetof(coll_acoll_pvars_t, alltoall_split_factor), 1,
+                                      sizeof(unsigned int)};
+    acoll_register_one_pvar(desc, "alltoall_split_factor",
+                            "Split factor used by the last parallel split alltoall",
+                            MCA_BASE_PVAR_CLASS_LEVEL, MCA_BASE_VAR_TYPE_UNSIGNED_INT);
+}
+
 /*
  * Module constructor
  */
 static void mca_coll_acoll_module_construct(mca_coll_acoll_module_t *module)
 {
 
+    memset(&module->pvars, 0, sizeof(module->pvars));
+
     /* Set number of subcomms to 0 */
     module->num_subc = 0;
     module->subc = NULL;
@@ -248,10 +432,9 @@ static void mca_coll_acoll_module_construct(mca_coll_acoll_module_t *module)
     (module->reserve_mem_s).reserve_mem = NULL;
     (module->reserve_mem_s).reserve_mem_size = 0;
     (module->reserve_mem_s).reserve_mem_allocate = false;
-    (module->reserve_mem_s).reserve_mem_in_use = false;
+    (module->reserve_mem_s).reserve_mem_in_use = 0;
     if ((0 != mca_coll_acoll_reserve_memory_for_algo)
-        && (0 < mca_coll_acoll_reserve_memory_size_for_algo)
-        && (false == ompi_mpi_thread_multiple)) {
+        && (0 < mca_coll_acoll_reserve_memory_size_for_algo)) {
         (module->reserve_mem_s).reserve_mem_allocate = true;
         (module->reserve_mem_s).reserve_mem_size = mca_coll_acoll_reserve_memory_size_for_algo;
     }
@@ -308,7 +491,7 @@ static void mca_coll_acoll_module_destruct(mca_coll_acoll_module_t *module)
                 data->allshm_sbuf = NULL;
                 free(data->allshm_rbuf);
                 data->allshm_rbuf = NULL;
-                free(data->scratch);
+                mca_coll_acoll_hugepage_free(data->scratch);
                 data->scratch = NULL;
                 free(data->allshmseg_id);
                 data->allshmseg_id = NULL;
@@ -351,7 +534,7 @@ static void mca_coll_acoll_module_destruct(mca_coll_acoll_module_t *module)
 
     if ((true == (module->reserve_mem_s).reserve_mem_allocate)
         && (NULL != (module->reserve_mem_s).reserve_mem)) {
-        free((module->reserve_mem_s).reserve_mem);
+        mca_coll_acoll_hugepage_free((module->reserve_mem_s).reserve_mem);
     }
 
     (module->alltoall_attr).split_factor = 0;
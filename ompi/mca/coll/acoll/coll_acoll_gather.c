@@ -45,7 +45,7 @@ int mca_coll_acoll_gather_intra(const void *sbuf, size_t scount, struct ompi_dat
     MPI_Status status;
     MPI_Aint sextent, sgap = 0, ssize;
     MPI_Aint rextent = 0;
-    size_t total_recv = 0;
+    size_t total_recv = 0, dsize;
     int sg_cnt, node_cnt;
     int cur_sg, root_sg;
     int cur_node, root_node;
@@ -59,6 +59,16 @@ int mca_coll_acoll_gather_intra(const void *sbuf, size_t scount, struct ompi_dat
     size = ompi_comm_size(comm);
     rank = ompi_comm_rank(comm);
 
+    if (MPI_IN_PLACE == sbuf) {
+        ompi_datatype_type_size(rdtype, &dsize);
+        dsize *= rcount;
+    } else {
+        ompi_datatype_type_size(sdtype, &dsize);
+        dsize *= scount;
+    }
+    coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_GATHER, MCA_COLL_ACOLL_PVAR_ALG_HIER,
+                        dsize);
+
     sg_cnt = acoll_module->sg_cnt;
     node_cnt = acoll_module->node_cnt;
     num_nodes = (size + node_cnt - 1) / node_cnt;
@@ -10,16 +10,41 @@
 #include "ompi_config.h"
 
 #include <stdio.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 #include "mpi.h"
 #include "ompi/mca/coll/base/base.h"
 #include "ompi/mca/coll/coll.h"
+#include "opal/mca/mpool/base/base.h"
+#include "opal/mca/mpool/mpool.h"
+#include "opal/align.h"
 #include "coll_acoll.h"
 
 
 static int acoll_module_enable(mca_coll_base_module_t *module,  struct ompi_communicator_t *comm);
 static int acoll_module_disable(mca_coll_base_module_t *module, struct ompi_communicator_t *comm);
 
+static int acoll_allgather_timed(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                                 void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                                 struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
+static int acoll_allreduce_timed(const void *sbuf, void *rbuf, size_t count,
+                                 struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                 struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
+static int acoll_alltoall_timed(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                                void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                                struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
+static int acoll_barrier_timed(struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
+static int acoll_bcast_timed(void *buff, size_t count, struct ompi_datatype_t *datatype, int root,
+                             struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
+static int acoll_gather_timed(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                              void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype, int root,
+                              struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
+static int acoll_reduce_timed(const void *sbuf, void *rbuf, size_t count,
+                              struct ompi_datatype_t *dtype, struct ompi_op_t *op, int root,
+                              struct ompi_communicator_t *comm, mca_coll_base_module_t *module);
+
 /*
  * Initial query function that is invoked during MPI_INIT, allowing
  * this component to disqualify itself if it doesn't support the
@@ -32,6 +57,55 @@ int mca_coll_acoll_init_query(bool enable_progress_threads, bool enable_mpi_thre
 }
 
 
+/*
+ * Allocate scratch memory, backed by huge pages if requested.
+ * The hugepage mpool is preferred when a hugetlbfs mount of the requested
+ * page size exists. Otherwise the buffer is aligned to the huge page size and
+ * advised for transparent huge pages, which the kernel may or may not honor.
+ */
+void *mca_coll_acoll_hugepage_alloc(size_t size)
+{
+    mca_mpool_base_module_t *mpool;
+    char hints[64];
+    void *ptr;
+
+    if ((0 == mca_coll_acoll_use_hugepages) || (0 == size)) {
+        return malloc(size);
+    }
+
+    snprintf(hints, sizeof(hints), "page_size=%" PRIu64, mca_coll_acoll_hugepage_size);
+    mpool = mca_mpool_base_module_lookup(hints);
+    if ((NULL != mpool) && (mca_mpool_base_default_module != mpool)) {
+        ptr = mca_mpool_base_alloc(size, NULL, hints);
+        if (NULL != ptr) {
+            return ptr;
+        }
+    }
+
+    size = OPAL_ALIGN(size, mca_coll_acoll_hugepage_size, size_t);
+    ptr = mca_mpool_base_default_module->mpool_alloc(mca_mpool_base_default_module, size,
+                                                     mca_coll_acoll_hugepage_size, 0);
+#if defined(HAVE_SYS_MMAN_H) && defined(MADV_HUGEPAGE)
+    if (NULL != ptr) {
+        (void) madvise(ptr, size, MADV_HUGEPAGE);
+    }
+#endif
+    return ptr;
+}
+
+/* Free memory obtained from mca_coll_acoll_hugepage_alloc */
+void mca_coll_acoll_hugepage_free(void *ptr)
+{
+    if (NULL == ptr) {
+        return;
+    }
+    if (0 == mca_coll_acoll_use_hugepages) {
+        free(ptr);
+    } else {
+        /* Handles both mpool and default module allocations */
+        (void) mca_mpool_base_free(ptr);
+    }
+}
 
 #define ACOLL_INSTALL_COLL_API(__comm, __module, __api)                                                     \
     do                                                                                                      \
@@ -78,6 +152,14 @@ mca_coll_base_module_t *mca_coll_acoll_comm_query(struct ompi_communicator_t *co
 
     /* Set topology params */
     acoll_module->max_comms = mca_coll_acoll_max_comms;
+    /* The subcomms registry is sized up front so that it never moves */
+    if (acoll_module->max_comms > 0) {
+        acoll_module->subc = calloc(acoll_module->max_comms, sizeof(coll_acoll_subcomms_t *));
+        if (NULL == acoll_module->subc) {
+            OBJ_RELEASE(acoll_module);
+            return NULL;
+        }
+    }
     acoll_module->sg_scale = mca_coll_acoll_sg_scale;
     acoll_module->sg_size = mca_coll_acoll_sg_size;
     acoll_module->sg_cnt = mca_coll_acoll_sg_size / mca_coll_acoll_sg_scale;
@@ -178,6 +260,18 @@ mca_coll_base_module_t *mca_coll_acoll_comm_query(struct ompi_communicator_t *co
     acoll_module->super.coll_bcast = mca_coll_acoll_bcast;
     acoll_module->super.coll_gather = mca_coll_acoll_gather_intra;
     acoll_module->super.coll_reduce = mca_coll_acoll_reduce_intra;
+    acoll_module->super.coll_allreduce_multi = mca_coll_acoll_allreduce_multi;
+
+    /* Time the calls for the sync_time/data_time pvars only on request */
+    if (mca_coll_acoll_pvar_timing) {
+        acoll_module->super.coll_allgather = acoll_allgather_timed;
+        acoll_module->super.coll_allreduce = acoll_allreduce_timed;
+        acoll_module->super.coll_alltoall = acoll_alltoall_timed;
+        acoll_module->super.coll_barrier = acoll_barrier_timed;
+        acoll_module->super.coll_bcast = acoll_bcast_timed;
+        acoll_module->super.coll_gather = acoll_gather_timed;
+        acoll_module->super.coll_reduce = acoll_reduce_timed;
+    }
 
     return &(acoll_module->super);
 }
@@ -202,6 +296,7 @@ static int acoll_module_enable(mca_coll_base_module_t *module, struct ompi_commu
    ACOLL_INSTALL_COLL_API(comm, acoll_module, bcast);
    ACOLL_INSTALL_COLL_API(comm, acoll_module, gather);
    ACOLL_INSTALL_COLL_API(comm, acoll_module, reduce);
+   ACOLL_INSTALL_COLL_API(comm, acoll_module, allreduce_multi);
 
    /* Initialize k-nomial tree */
     module->base_data->cached_kmtree = NULL;
@@ -223,6 +318,154 @@ static int acoll_module_disable(mca_coll_base_module_t *module, struct ompi_comm
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, bcast);
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, gather);
     ACOLL_UNINSTALL_COLL_API(comm, acoll_module, reduce);
+    ACOLL_UNINSTALL_COLL_API(comm, acoll_module, allreduce_multi);
 
     return OMPI_SUCCESS;
 }
+
+/*
+ * Find the acoll module serving any collective of the communicator, or NULL
+ * if acoll is not in use on it.
+ */
+mca_coll_acoll_module_t *mca_coll_acoll_comm_module(struct ompi_communicator_t *comm)
+{
+    mca_coll_base_module_t *modules[MCA_COLL_ACOLL_PVAR_NUM_COLLS];
+
+    if ((NULL == comm) || (NULL == comm->c_coll)) {
+        return NULL;
+    }
+
+    modules[MCA_COLL_ACOLL_PVAR_ALLGATHER] = comm->c_coll->coll_allgather_module;
+    modules[MCA_COLL_ACOLL_PVAR_ALLREDUCE] = comm->c_coll->coll_allreduce_module;
+    modules[MCA_COLL_ACOLL_PVAR_ALLTOALL] = comm->c_coll->coll_alltoall_module;
+    modules[MCA_COLL_ACOLL_PVAR_BARRIER] = comm->c_coll->coll_barrier_module;
+    modules[MCA_COLL_ACOLL_PVAR_BCAST] = comm->c_coll->coll_bcast_module;
+    modules[MCA_COLL_ACOLL_PVAR_GATHER] = comm->c_coll->coll_gather_module;
+    modules[MCA_COLL_ACOLL_PVAR_REDUCE] = comm->c_coll->coll_reduce_module;
+    for (int i = 0; i < MCA_COLL_ACOLL_PVAR_NUM_COLLS; i++) {
+        if ((NULL != modules[i]) && (acoll_module_enable == modules[i]->coll_module_enable)) {
+            return (mca_coll_acoll_module_t *) modules[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Timed entry points. The sync wait time accumulated by the shared memory
+ * spin loops during the call is split off from the total call time, the
+ * remainder is accounted as data movement.
+ */
+typedef struct {
+    opal_timer_t start;
+    opal_timer_t sync_start;
+} acoll_pvar_timer_t;
+
+static inline void acoll_pvar_timer_start(acoll_pvar_timer_t *timer)
+{
+    timer->sync_start = mca_coll_acoll_sync_usec;
+    timer->start = opal_timer_base_get_usec();
+}
+
+static inline void acoll_pvar_timer_stop(acoll_pvar_timer_t *timer, mca_coll_base_module_t *module,
+                                         int coll)
+{
+    mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *) module;
+    opal_timer_t total = opal_timer_base_get_usec() - timer->start;
+    opal_timer_t sync = mca_coll_acoll_sync_usec - timer->sync_start;
+
+    if (sync > total) {
+        sync = total;
+    }
+    acoll_module->pvars.sync_time[coll] += (double) sync * 1e-6;
+    acoll_module->pvars.data_time[coll] += (double) (total - sync) * 1e-6;
+}
+
+static int acoll_allgather_timed(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                                 void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                                 struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    acoll_pvar_timer_t timer;
+    int err;
+
+    acoll_pvar_timer_start(&timer);
+    err = mca_coll_acoll_allgather(sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module);
+    acoll_pvar_timer_stop(&timer, module, MCA_COLL_ACOLL_PVAR_ALLGATHER);
+    return err;
+}
+
+static int acoll_allreduce_timed(const void *sbuf, void *rbuf, size_t count,
+                                 struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                                 struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    acoll_pvar_timer_t timer;
+    int err;
+
+    acoll_pvar_timer_start(&timer);
+    err = mca_coll_acoll_allreduce_intra(sbuf, rbuf, count, dtype, op, comm, module);
+    acoll_pvar_timer_stop(&timer, module, MCA_COLL_ACOLL_PVAR_ALLREDUCE);
+    return err;
+}
+
+static int acoll_alltoall_timed(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                                void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                                struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    acoll_pvar_timer_t timer;
+    int err;
+
+    acoll_pvar_timer_start(&timer);
+    err = mca_coll_acoll_alltoall(sbuf, scount, sdtype, rbuf, rcount, rdtype, comm, module);
+    acoll_pvar_timer_stop(&timer, module, MCA_COLL_ACOLL_PVAR_ALLTOALL);
+    return err;
+}
+
+static int acoll_barrier_timed(struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    acoll_pvar_timer_t timer;
+    int err;
+
+    acoll_pvar_timer_start(&timer);
+    err = mca_coll_acoll_barrier_intra(comm, module);
+    acoll_pvar_timer_stop(&timer, module, MCA_COLL_ACOLL_PVAR_BARRIER);
+    return err;
+}
+
+static int acoll_bcast_timed(void *buff, size_t count, struct ompi_datatype_t *datatype, int root,
+                             struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    acoll_pvar_timer_t timer;
+    int err;
+
+    acoll_pvar_timer_start(&timer);
+    err = mca_coll_acoll_bcast(buff, count, datatype, root, comm, module);
+    acoll_pvar_timer_stop(&timer, module, MCA_COLL_ACOLL_PVAR_BCAST);
+    return err;
+}
+
+static int acoll_gather_timed(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                              void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype, int root,
+                              struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    acoll_pvar_timer_t timer;
+    int err;
+
+    acoll_pvar_timer_start(&timer);
+    err = mca_coll_acoll_gather_intra(sbuf, scount, sdtype, rbuf, rcount, rdtype, root, comm,
+                                      module);
+    acoll_pvar_timer_stop(&timer, module, MCA_COLL_ACOLL_PVAR_GATHER);
+    return err;
+}
+
+static int acoll_reduce_timed(const void *sbuf, void *rbuf, size_t count,
+                              struct ompi_datatype_t *dtype, struct ompi_op_t *op, int root,
+                              struct ompi_communicator_t *comm, mca_coll_base_module_t *module)
+{
+    acoll_pvar_timer_t timer;
+    int err;
+
+    acoll_pvar_timer_start(&timer);
+    err = mca_coll_acoll_reduce_intra(sbuf, rbuf, count, dtype, op, root, comm, module);
+    acoll_pvar_timer_stop(&timer, module, MCA_COLL_ACOLL_PVAR_REDUCE);
+    return err;
+}
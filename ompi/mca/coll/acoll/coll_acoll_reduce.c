@@ -17,6 +17,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/pml/pml.h"
 #include "ompi/op/op.h"
+#include "opal/mca/memcpy/base/base.h"
 #include "opal/util/bit_ops.h"
 #include "coll_acoll.h"
 #include "coll_acoll_utils.h"
@@ -231,10 +232,12 @@ static inline int mca_coll_acoll_reduce_smsc(const void *sbuf, void *rbuf, size_
     if (0 == subc->smsc_use_sr_buf) {
         tmp_rbuf = (char *) data->scratch;
         tmp_sbuf = (char *) data->scratch + (subc->smsc_buf_size) / 2;
+        /* The other processes read the staged copy through smsc, this
+         * process only its own chunk: bypass the caches */
         if ((MPI_IN_PLACE == sbuf) && (rank == root)) {
-            memcpy(tmp_sbuf, rbuf, total_dsize);
+            opal_memcpy_nt(tmp_sbuf, rbuf, total_dsize);
         } else {
-            memcpy(tmp_sbuf, sbuf, total_dsize);
+            opal_memcpy_nt(tmp_sbuf, sbuf, total_dsize);
         }
     } else {
         tmp_sbuf = (char *) sbuf;
@@ -353,16 +356,29 @@ int mca_coll_acoll_reduce_intra(const void *sbuf, void *rbuf, size_t count,
     mca_coll_acoll_module_t *acoll_module = (mca_coll_acoll_module_t *) module;
 
     size = ompi_comm_size(comm);
-    if (size < 4)
+    ompi_datatype_type_size(dtype, &dsize);
+    total_dsize = dsize * count;
+    if (size < 4) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                 MCA_COLL_ACOLL_PVAR_FB_COMM_SIZE);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_reduce_intra_basic_linear(sbuf, rbuf, count, dtype, op, root, comm,
                                                         module);
+    }
 
     /* Falling back to inorder binary for non-commutative operators to be safe */
     if (!ompi_op_is_commute(op)) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                 MCA_COLL_ACOLL_PVAR_FB_NON_COMMUTE);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_reduce_intra_in_order_binary(sbuf, rbuf, count, dtype, op, root, comm,
                                                            module, 0, 0);
     }
     if (0 != root) { // ToDo: support non-zero root
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_reduce_intra_binomial(sbuf, rbuf, count, dtype, op, root, comm,
                                                     module, 0, 0);
     }
@@ -374,15 +390,18 @@ int mca_coll_acoll_reduce_intra(const void *sbuf, void *rbuf, size_t count,
     int dev_id;
     bool is_opt = true;
     if (!OMPI_COMM_CHECK_ASSERT_NO_ACCEL_BUF(comm)) {
-        if (!ompi_datatype_is_predefined(dtype)
-            || (0 < opal_accelerator.check_addr(sbuf, &dev_id, &flags))
-            || (0 < opal_accelerator.check_addr(rbuf, &dev_id, &flags))) {
+        if (!ompi_datatype_is_predefined(dtype)) {
+            coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                     MCA_COLL_ACOLL_PVAR_FB_DTYPE);
+            is_opt = false;
+        } else if ((0 < opal_accelerator.check_addr(sbuf, &dev_id, &flags))
+                   || (0 < opal_accelerator.check_addr(rbuf, &dev_id, &flags))) {
+            coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                     MCA_COLL_ACOLL_PVAR_FB_ACCEL_BUF);
             is_opt = false;
         }
     }
 
-    ompi_datatype_type_size(dtype, &dsize);
-    total_dsize = dsize * count;
     if (-1 == acoll_module->red_algo) {
         alg = coll_reduce_decision_fixed(size, total_dsize);
     } else {
@@ -395,6 +414,10 @@ int mca_coll_acoll_reduce_intra(const void *sbuf, void *rbuf, size_t count,
 
     /* Fallback to knomial if subc is not obtained */
     if (NULL == subc) {
+        coll_acoll_pvar_fallback(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                 MCA_COLL_ACOLL_PVAR_FB_MAX_COMMS);
+        coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                            MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
         return ompi_coll_base_reduce_intra_binomial(sbuf, rbuf, count, dtype, op, root, comm,
                                                     module, 0, 0);
     }
@@ -414,6 +437,9 @@ int mca_coll_acoll_reduce_intra(const void *sbuf, void *rbuf, size_t count,
             alg = acoll_module->red_algo;
         }
         if (is_dsize_lt_thresh) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                (0 == alg) ? MCA_COLL_ACOLL_PVAR_ALG_HIER
+                                           : MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
             if (0 == alg) {
                 return coll_acoll_reduce_topo(sbuf, rbuf, count, dtype, op, root, comm, module,
                                               subc);
@@ -433,18 +459,26 @@ int mca_coll_acoll_reduce_intra(const void *sbuf, void *rbuf, size_t count,
                   && ((acoll_module->reserve_mem_s).reserve_mem_size >= total_dsize))
                  || ((0 == subc->smsc_use_sr_buf) && (subc->smsc_buf_size > 2 * total_dsize)))
                 && (subc->without_smsc != 1) && is_opt) {
+                coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                    MCA_COLL_ACOLL_PVAR_ALG_SMSC, total_dsize);
                 return mca_coll_acoll_reduce_smsc(sbuf, rbuf, count, dtype, op, root, comm,
                                                    module, subc);
             } else {
+                coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                    MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
                 return ompi_coll_base_reduce_intra_binomial(sbuf, rbuf, count, dtype, op,
                                                                    root, comm, module, 0, 0);
             }
         }
     } else {
         if (total_dsize <= 4096) {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_HIER, total_dsize);
             return coll_acoll_reduce_topo(sbuf, rbuf, count, dtype, op, root, comm, module,
                                           subc);
         } else {
+            coll_acoll_pvar_alg(acoll_module, MCA_COLL_ACOLL_PVAR_REDUCE,
+                                MCA_COLL_ACOLL_PVAR_ALG_BASE, total_dsize);
             return ompi_coll_base_reduce_intra_binomial(sbuf, rbuf, count, dtype, op, root, comm,
                                                         module, 0, 0);
         }
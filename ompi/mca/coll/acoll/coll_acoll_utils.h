@@ -16,6 +16,9 @@
 #include "ompi/mca/coll/base/coll_base_functions.h"
 #include "opal/include/opal/align.h"
 #include "opal/mca/rcache/base/base.h"
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 
 
@@ -47,6 +50,7 @@ static inline void spin_wait_with_progress(volatile int *flag, int expected_valu
     int pcount = 0;
     int progress_freq = 1;
     int observed;
+    opal_timer_t start = coll_acoll_sync_begin();
 
     while ((observed = __atomic_load_n(flag, __ATOMIC_ACQUIRE)) != expected_value) {
         pcount++;
@@ -66,26 +70,34 @@ static inline void spin_wait_with_progress(volatile int *flag, int expected_valu
             if (progress_freq < MCA_COLL_ACOLL_SPIN_SLOW_PATH_MAX_FREQ) progress_freq++;
         }
     }
+    coll_acoll_sync_end(start);
 }
 
 
-/* Function to allocate scratch buffer */
+/* Function to allocate scratch buffer. The pre-allocated buffer is claimed
+ * atomically, concurrent callers that lose the claim get a new buffer. */
 static inline void *coll_acoll_buf_alloc(coll_acoll_reserve_mem_t *reserve_mem_ptr, uint64_t size)
 {
     void *temp_ptr = NULL;
+    int32_t not_in_use = 0;
+
     /* If requested size is within the pre-allocated range, use the
        pre-allocated buffer if not in use. */
     if ((true == reserve_mem_ptr->reserve_mem_allocate)
         && (size <= reserve_mem_ptr->reserve_mem_size)
-        && (false == reserve_mem_ptr->reserve_mem_in_use)) {
+        && opal_atomic_compare_exchange_strong_32(&reserve_mem_ptr->reserve_mem_in_use,
+                                                  &not_in_use, 1)) {
+        /* Only the owner of the claim allocates the buffer */
         if (NULL == reserve_mem_ptr->reserve_mem) {
-            reserve_mem_ptr->reserve_mem = malloc(reserve_mem_ptr->reserve_mem_size);
+            reserve_mem_ptr->reserve_mem =
+                mca_coll_acoll_hugepage_alloc(reserve_mem_ptr->reserve_mem_size);
         }
         temp_ptr = reserve_mem_ptr->reserve_mem;
 
-        /* Mark the buffer as "in use" */
-        if (NULL != temp_ptr) {
-            reserve_mem_ptr->reserve_mem_in_use = true;
+        if (NULL == temp_ptr) {
+            opal_atomic_wmb();
+            reserve_mem_ptr->reserve_mem_in_use = 0;
+            temp_ptr = malloc(size);
         }
     } else {
         /* If requested size if greater than that of the pre-allocated
@@ -99,55 +111,73 @@ static inline void *coll_acoll_buf_alloc(coll_acoll_reserve_mem_t *reserve_mem_p
 /* Function to free scratch buffer */
 static inline void coll_acoll_buf_free(coll_acoll_reserve_mem_t *reserve_mem_ptr, void *ptr)
 {
+    if (NULL == ptr) {
+        return;
+    }
     /* Free the buffer only if it is not the reserved (pre-allocated) one */
-    if ((false == reserve_mem_ptr->reserve_mem_allocate)
-        || (false == reserve_mem_ptr->reserve_mem_in_use)) {
-        if (NULL != ptr) {
-            free(ptr);
-        }
-    } else if (reserve_mem_ptr->reserve_mem == ptr) {
+    if (reserve_mem_ptr->reserve_mem == ptr) {
         /* Mark the reserved buffer as free to be used */
-        reserve_mem_ptr->reserve_mem_in_use = false;
+        opal_atomic_wmb();
+        reserve_mem_ptr->reserve_mem_in_use = 0;
+    } else {
+        free(ptr);
+    }
+}
+
+/* Advise the kernel to back an attached shared memory segment with
+ * transparent huge pages. Failures are ignored, regular pages are used. */
+static inline void coll_acoll_shm_advise_hugepage(void *addr, size_t size)
+{
+#if defined(HAVE_SYS_MMAN_H) && defined(MADV_HUGEPAGE)
+    if ((0 != mca_coll_acoll_use_hugepages) && (NULL != addr)) {
+        (void) madvise(addr, size, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+/* Look up the subcomms structure of a communicator in the module registry */
+static inline coll_acoll_subcomms_t *coll_acoll_find_subc(mca_coll_acoll_module_t *acoll_module,
+                                                          int cid)
+{
+    int num_subc = acoll_module->num_subc;
+
+    opal_atomic_rmb();
+    for (int i = 0; i < num_subc; i++) {
+        coll_acoll_subcomms_t *subc = acoll_module->subc[i];
+        if ((NULL != subc) && (subc->cid == cid)) {
+            return subc;
+        }
     }
+    return NULL;
 }
 
-/* Function to check if subcomms structure is allocated and initialized */
+/* Function to check if subcomms structure is allocated and initialized.
+ * The registry is lock-free: a new entry is fully initialized before it is
+ * published into the first free slot with a compare-and-swap, and num_subc
+ * only advances past published entries. */
 static inline int check_and_create_subc(ompi_communicator_t *comm,
                                         mca_coll_acoll_module_t *acoll_module,
                                         coll_acoll_subcomms_t **subc_ptr)
 {
     int cid = ompi_comm_get_local_cid(comm);
-    int num_subc = acoll_module->num_subc;
     coll_acoll_subcomms_t *subc;
 
     /* Return if max comms is not positive */
-    if (acoll_module->max_comms <= 0) {
+    if ((acoll_module->max_comms <= 0) || (NULL == acoll_module->subc)) {
         OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
                      "coll:acoll WARNING Set mca_coll_acoll_max_comms to positive value to use acoll!"));
         *subc_ptr = NULL;
         return MPI_SUCCESS;
     }
 
-    /* Allocate memory for subcomms array */
-    if (NULL == acoll_module->subc) {
-        acoll_module->subc = malloc(sizeof(coll_acoll_subcomms_t**) * acoll_module->max_comms);
-        if (NULL == acoll_module->subc) {
-            return OMPI_ERR_OUT_OF_RESOURCE;
-        }
-    } else {
-        /* Check if subcomms structure is already created for the communicator */
-        for (int i = 0; i < num_subc; i++) {
-            if (NULL != acoll_module->subc[i]) {
-                if (acoll_module->subc[i]->cid == cid) {
-                    *subc_ptr = acoll_module->subc[i];
-                    return MPI_SUCCESS;
-                }
-            }
-        }
+    /* Check if subcomms structure is already created for the communicator */
+    *subc_ptr = coll_acoll_find_subc(acoll_module, cid);
+    if (NULL != *subc_ptr) {
+        return MPI_SUCCESS;
     }
 
     /* Subcomms structure is not present, create one if within limit*/
-    if (num_subc == acoll_module->max_comms) {
+    if (acoll_module->num_subc >= acoll_module->max_comms) {
         OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
                      "coll:acoll WARNING Falling back to base since max communicators limit %d exceeded, set mca_coll_acoll_max_comms to higher value to use acoll!", acoll_module->max_comms));
         *subc_ptr = NULL;
@@ -157,9 +187,6 @@ static inline int check_and_create_subc(ompi_communicator_t *comm,
     if (NULL == *subc_ptr) {
         return MPI_SUCCESS;
     }
-    /* Update the module with the new subc */
-    acoll_module->subc[num_subc] = *subc_ptr;
-    acoll_module->num_subc++;
 
     /* Initialize elements of subc */
     subc = *subc_ptr;
@@ -212,8 +239,34 @@ static inline int check_and_create_subc(ompi_communicator_t *comm,
         subc->smsc_use_sr_buf = 0;
         subc->without_smsc = 1;
     }
-    return MPI_SUCCESS;
 
+    /* Publish the new subc in the first free slot */
+    while (true) {
+        int idx = acoll_module->num_subc;
+        intptr_t empty = 0;
+
+        if (idx >= acoll_module->max_comms) {
+            free(subc);
+            *subc_ptr = NULL;
+            return MPI_SUCCESS;
+        }
+        opal_atomic_wmb();
+        if (opal_atomic_compare_exchange_strong_ptr((opal_atomic_intptr_t *) &acoll_module->subc[idx],
+                                                    &empty, (intptr_t) subc)) {
+            (void) opal_atomic_fetch_add_32(&acoll_module->num_subc, 1);
+            return MPI_SUCCESS;
+        }
+        /* Lost the slot, another thread may have registered the same communicator */
+        if (((coll_acoll_subcomms_t *) empty)->cid == cid) {
+            free(subc);
+            *subc_ptr = (coll_acoll_subcomms_t *) empty;
+            return MPI_SUCCESS;
+        }
+        /* Wait for the winner to advance num_subc */
+        while (idx == acoll_module->num_subc) {
+            opal_atomic_rmb();
+        }
+    }
 }
 
 /* Function to compare integer elements */
@@ -855,7 +908,7 @@ static inline int coll_acoll_init(mca_coll_base_module_t *module, ompi_communica
     }
 
     if (0 == subc->smsc_use_sr_buf) {
-        data->scratch = (char *) malloc(subc->smsc_buf_size);
+        data->scratch = (char *) mca_coll_acoll_hugepage_alloc(subc->smsc_buf_size);
         if (NULL == data->scratch) {
             line = __LINE__;
             ret = OMPI_ERR_OUT_OF_RESOURCE;
@@ -948,6 +1001,10 @@ static inline int coll_acoll_init(mca_coll_base_module_t *module, ompi_communica
         long memsize
             = (LEADER_SHM_SIZE /* scratch leader */ + CACHE_LINE_SIZE * size /* sync variables l1 group*/
                + CACHE_LINE_SIZE * size /* sync variables l2 group*/ + PER_RANK_SHM_SIZE * size /*data from ranks*/ + 2 * CACHE_LINE_SIZE * size /* sync variables for bcast and barrier*/);
+        if (0 != mca_coll_acoll_use_hugepages) {
+            /* Round up so that the segment can be fully backed by huge pages */
+            memsize = OPAL_ALIGN(memsize, mca_coll_acoll_hugepage_size, long);
+        }
         ret = opal_shmem_segment_create(&seg_ds, shfn, memsize);
         free(shfn);
     }
@@ -966,14 +1023,19 @@ static inline int coll_acoll_init(mca_coll_base_module_t *module, ompi_communica
     if (data->l1_gp[0] != rank) {
         data->allshmmmap_sbuf[data->l1_gp[0]] = opal_shmem_segment_attach(
             &data->allshmseg_id[data->l1_gp[0]]);
+        coll_acoll_shm_advise_hugepage(data->allshmmmap_sbuf[data->l1_gp[0]],
+                                       data->allshmseg_id[data->l1_gp[0]].seg_size);
     } else {
         for (int i = 0; i < data->l2_gp_size; i++) {
             data->allshmmmap_sbuf[data->l2_gp[i]] = opal_shmem_segment_attach(
                 &data->allshmseg_id[data->l2_gp[i]]);
+            coll_acoll_shm_advise_hugepage(data->allshmmmap_sbuf[data->l2_gp[i]],
+                                           data->allshmseg_id[data->l2_gp[i]].seg_size);
         }
     }
 
     data->allshmmmap_sbuf[root] = opal_shmem_segment_attach(&data->allshmseg_id[0]);
+    coll_acoll_shm_advise_hugepage(data->allshmmmap_sbuf[root], data->allshmseg_id[0].seg_size);
 
     int offset = LEADER_SHM_SIZE;
     memset(((char *) data->allshmmmap_sbuf[data->l1_gp[0]]) + offset + CACHE_LINE_SIZE * rank, 0,
@@ -1010,7 +1072,7 @@ error_hndl:
         data->smsc_saddr = NULL;
         free(data->smsc_raddr);
         data->smsc_raddr = NULL;
-        free(data->scratch);
+        mca_coll_acoll_hugepage_free(data->scratch);
         data->scratch = NULL;
         free(data->smsc_info.ep);
         data->smsc_info.ep = NULL;
@@ -33,6 +33,7 @@ typedef enum {
     OMPI_COLL_ADAPT_ALGORITHM_PIPELINE,
     OMPI_COLL_ADAPT_ALGORITHM_CHAIN,
     OMPI_COLL_ADAPT_ALGORITHM_LINEAR,
+    OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE, /* tree and segment size chosen at runtime */
     OMPI_COLL_ADAPT_ALGORITHM_COUNT /* number of algorithms, keep last! */
 } ompi_coll_adapt_algorithm_t;
 
@@ -84,6 +85,22 @@ typedef struct mca_coll_adapt_component_t {
     /* Reduce free list */
     opal_free_list_t *adapt_ireduce_context_free_list;
 
+    /* Allreduce MCA parameter */
+    int adapt_iallreduce_algorithm;
+    size_t adapt_iallreduce_segment_size;
+
+    /* Allgather MCA parameter */
+    size_t adapt_iallgather_segment_size;
+    /* Allgather free list */
+    opal_free_list_t *adapt_iallgather_context_free_list;
+
+    /* MCA parameter: number of trials of each candidate of the adaptive algorithm */
+    int adapt_tuning_trials;
+
+    /* MCA parameter: progress the requests from the coll/base progress thread */
+    bool adapt_progress_thread;
+    bool adapt_progress_thread_retained;
+
 } mca_coll_adapt_component_t;
 
 /*
@@ -94,6 +111,7 @@ typedef struct mca_coll_adapt_collective_fallback_s {
     union {
         mca_coll_base_module_reduce_fn_t   reduce;
         mca_coll_base_module_ireduce_fn_t ireduce;
+        mca_coll_base_module_iallreduce_fn_t iallreduce;
     } previous_routine;
     mca_coll_base_module_t *previous_module;
 } mca_coll_adapt_collective_fallback_t;
@@ -102,6 +120,7 @@ typedef struct mca_coll_adapt_collective_fallback_s {
 typedef enum mca_coll_adapt_colltype {
     ADAPT_REDUCE  = 0,
     ADAPT_IREDUCE = 1,
+    ADAPT_IALLREDUCE = 2,
     ADAPT_COLLCOUNT
 } mca_coll_adapt_colltype_t;
 
@@ -111,9 +130,11 @@ typedef enum mca_coll_adapt_colltype {
  */
 #define previous_reduce     previous_routines[ADAPT_REDUCE].previous_routine.reduce
 #define previous_ireduce    previous_routines[ADAPT_IREDUCE].previous_routine.ireduce
+#define previous_iallreduce previous_routines[ADAPT_IALLREDUCE].previous_routine.iallreduce
 
 #define previous_reduce_module     previous_routines[ADAPT_REDUCE].previous_module
 #define previous_ireduce_module    previous_routines[ADAPT_IREDUCE].previous_module
+#define previous_iallreduce_module previous_routines[ADAPT_IALLREDUCE].previous_module
 
 
 /* Coll adapt module per communicator*/
@@ -127,6 +148,11 @@ struct mca_coll_adapt_module_t {
     /* cached topologies */
     opal_list_t *topo_cache;
 
+    /* choices of the adaptive algorithm */
+    struct ompi_coll_adapt_tuning_t *ibcast_tuning;
+    struct ompi_coll_adapt_tuning_t *ireduce_tuning;
+    struct ompi_coll_adapt_tuning_t *iallreduce_tuning;
+
     /* Whether this module has been lazily initialized or not yet */
     bool adapt_enabled;
 };
@@ -12,6 +12,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/coll_base_topo.h"
 #include "ompi/mca/coll/base/coll_base_functions.h"
+#include "coll_adapt_context.h"
 #include <math.h>
 
 /* Bcast */
@@ -19,10 +20,27 @@ int ompi_coll_adapt_ibcast_register(void);
 int ompi_coll_adapt_ibcast_fini(void);
 int ompi_coll_adapt_bcast(BCAST_ARGS);
 int ompi_coll_adapt_ibcast(IBCAST_ARGS);
+int ompi_coll_adapt_ibcast_generic(IBCAST_ARGS, ompi_coll_tree_t *tree, size_t seg_size,
+                                   ompi_coll_adapt_tuning_probe_t *probe,
+                                   ompi_coll_adapt_constant_bcast_context_t **deferred);
+int ompi_coll_adapt_ibcast_segment_ready(ompi_coll_adapt_constant_bcast_context_t *con, int frag_id);
 
 /* Reduce */
 int ompi_coll_adapt_ireduce_register(void);
 int ompi_coll_adapt_ireduce_fini(void);
 int ompi_coll_adapt_reduce(REDUCE_ARGS);
 int ompi_coll_adapt_ireduce(IREDUCE_ARGS);
+int ompi_coll_adapt_ireduce_generic(IREDUCE_ARGS, ompi_coll_tree_t *tree, size_t seg_size,
+                                    ompi_coll_adapt_tuning_probe_t *probe,
+                                    ompi_coll_adapt_reduce_segment_fn_t segment_done,
+                                    void *segment_done_data);
+
+/* Allreduce */
+int ompi_coll_adapt_iallreduce_register(void);
+int ompi_coll_adapt_iallreduce(IALLREDUCE_ARGS);
+
+/* Allgather */
+int ompi_coll_adapt_iallgather_register(void);
+int ompi_coll_adapt_iallgather_fini(void);
+int ompi_coll_adapt_iallgather(IALLGATHER_ARGS);
 
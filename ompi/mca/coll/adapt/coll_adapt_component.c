@@ -15,6 +15,7 @@
 #include "opal/util/show_help.h"
 #include "ompi/constants.h"
 #include "ompi/mca/coll/coll.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
 #include "coll_adapt.h"
 #include "coll_adapt_algorithms.h"
 
@@ -93,8 +94,16 @@ static int adapt_open(void)
 /* Shut down the component */
 static int adapt_close(void)
 {
+    mca_coll_adapt_component_t *cs = &mca_coll_adapt_component;
+
     ompi_coll_adapt_ibcast_fini();
     ompi_coll_adapt_ireduce_fini();
+    ompi_coll_adapt_iallgather_fini();
+
+    if (cs->adapt_progress_thread_retained) {
+        ompi_coll_base_progress_thread_release();
+        cs->adapt_progress_thread_retained = false;
+    }
 
     return OMPI_SUCCESS;
 }
@@ -150,8 +159,29 @@ static int adapt_register(void)
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_ALL,
                                            &cs->adapt_context_free_list_inc);
+
+    cs->adapt_tuning_trials = 2;
+    (void) mca_base_component_var_register(c, "tuning_trials",
+                                           "Number of calls trying each tree and segment size for each power of two of the message size with the adaptive algorithm (7) of bcast and reduce. The processes then agree on the fastest with a nonblocking allreduce, and use it a few calls later; the calls in between use the binomial tree with the configured segment size",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &cs->adapt_tuning_trials);
+    if (cs->adapt_tuning_trials < 1) {
+        cs->adapt_tuning_trials = 1;
+    }
+
+    cs->adapt_progress_thread = false;
+    (void) mca_base_component_var_register(c, "progress_thread",
+                                           "Progress the started nonblocking collectives from a dedicated thread, so that they advance while the application computes without calling MPI (see coll_base_progress_thread_bind)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &cs->adapt_progress_thread);
     ompi_coll_adapt_ibcast_register();
     ompi_coll_adapt_ireduce_register();
+    ompi_coll_adapt_iallreduce_register();
+    ompi_coll_adapt_iallgather_register();
 
     return adapt_verify_mca_variables();
 }
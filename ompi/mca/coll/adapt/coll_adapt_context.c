@@ -28,6 +28,26 @@ static void adapt_constant_reduce_context_destruct(ompi_coll_adapt_constant_redu
 }
 
 
+static void adapt_constant_allreduce_context_construct(ompi_coll_adapt_constant_allreduce_context_t *context)
+{
+    OBJ_CONSTRUCT(&context->mutex, opal_mutex_t);
+}
+
+static void adapt_constant_allreduce_context_destruct(ompi_coll_adapt_constant_allreduce_context_t *context)
+{
+    OBJ_DESTRUCT(&context->mutex);
+}
+
+static void adapt_constant_allgather_context_construct(ompi_coll_adapt_constant_allgather_context_t *context)
+{
+    OBJ_CONSTRUCT(&context->mutex, opal_mutex_t);
+}
+
+static void adapt_constant_allgather_context_destruct(ompi_coll_adapt_constant_allgather_context_t *context)
+{
+    OBJ_DESTRUCT(&context->mutex);
+}
+
 OBJ_CLASS_INSTANCE(ompi_coll_adapt_bcast_context_t, opal_free_list_item_t,
                    NULL, NULL);
 
@@ -40,3 +60,14 @@ OBJ_CLASS_INSTANCE(ompi_coll_adapt_reduce_context_t, opal_free_list_item_t,
 OBJ_CLASS_INSTANCE(ompi_coll_adapt_constant_reduce_context_t, opal_object_t,
                    &adapt_constant_reduce_context_construct,
                    &adapt_constant_reduce_context_destruct);
+
+OBJ_CLASS_INSTANCE(ompi_coll_adapt_constant_allreduce_context_t, opal_object_t,
+                   &adapt_constant_allreduce_context_construct,
+                   &adapt_constant_allreduce_context_destruct);
+
+OBJ_CLASS_INSTANCE(ompi_coll_adapt_allgather_context_t, opal_free_list_item_t,
+                   NULL, NULL);
+
+OBJ_CLASS_INSTANCE(ompi_coll_adapt_constant_allgather_context_t, opal_object_t,
+                   &adapt_constant_allgather_context_construct,
+                   &adapt_constant_allgather_context_destruct);
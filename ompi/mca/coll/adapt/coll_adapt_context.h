@@ -9,6 +9,9 @@
  * $HEADER$
  */
 
+#ifndef MCA_COLL_ADAPT_CONTEXT_H
+#define MCA_COLL_ADAPT_CONTEXT_H
+
 #include "ompi/mca/coll/coll.h"
 #include "opal/class/opal_free_list.h"
 #include "opal/class/opal_list.h"
@@ -17,11 +20,13 @@
 #include "ompi/op/op.h"
 #include "ompi/mca/coll/base/coll_base_topo.h"
 #include "coll_adapt_inbuf.h"
+#include "coll_adapt_tuning.h"
 
 /* Bcast constant context in bcast context */
 struct ompi_coll_adapt_constant_bcast_context_s {
     opal_object_t super;
     int root;
+    char *buff;
     size_t count;
     size_t seg_count;
     ompi_datatype_t *datatype;
@@ -40,6 +45,8 @@ struct ompi_coll_adapt_constant_bcast_context_s {
     int num_sent_segs;
     ompi_coll_tree_t *tree;
     int ibcast_tag;
+    /* Measurement for the adaptive algorithm */
+    ompi_coll_adapt_tuning_probe_t probe;
 };
 
 typedef struct ompi_coll_adapt_constant_bcast_context_s ompi_coll_adapt_constant_bcast_context_t;
@@ -63,6 +70,9 @@ struct ompi_coll_adapt_bcast_context_s {
 
 OBJ_CLASS_DECLARATION(ompi_coll_adapt_bcast_context_t);
 
+/* Called at the root of a reduce when a segment is completely reduced */
+typedef void (*ompi_coll_adapt_reduce_segment_fn_t) (void *data, int seg_index);
+
 /* Reduce constant context in reduce context */
 struct ompi_coll_adapt_constant_reduce_context_s {
     opal_object_t super;
@@ -103,6 +113,11 @@ struct ompi_coll_adapt_constant_reduce_context_s {
     /* A list to store the segments which are received and not yet be sent */
     opal_list_t recv_list;
     ompi_request_t *request;
+    /* Measurement for the adaptive algorithm */
+    ompi_coll_adapt_tuning_probe_t probe;
+    /* Optional notification of the reduced segments at the root */
+    ompi_coll_adapt_reduce_segment_fn_t segment_done;
+    void *segment_done_data;
 };
 
 typedef struct ompi_coll_adapt_constant_reduce_context_s ompi_coll_adapt_constant_reduce_context_t;
@@ -126,3 +141,91 @@ struct ompi_coll_adapt_reduce_context_s {
 };
 
 OBJ_CLASS_DECLARATION(ompi_coll_adapt_reduce_context_t);
+
+/* Allreduce constant context: a reduce to the root which provides each
+ * reduced segment to a broadcast from the root over the same tree */
+struct ompi_coll_adapt_constant_allreduce_context_s {
+    opal_object_t super;
+    ompi_request_t *request;
+    /* The broadcast fed by the reduce, at the root */
+    ompi_coll_adapt_constant_bcast_context_t *bcast;
+    /* Mutex to provide the segments to the broadcast in order */
+    opal_mutex_t mutex;
+    /* Reduced segments, and next segment to provide to the broadcast, out of
+     * num_segs (the broadcast is released once it has all of them) */
+    char *ready;
+    int next_seg;
+    int num_segs;
+    /* Number of requests, among the reduce and the broadcast, not completed yet */
+    opal_atomic_int32_t num_pending;
+    /* Copy of the contribution for MPI_IN_PLACE on the other processes */
+    char *tmpbuf;
+    /* Measurement for the adaptive algorithm */
+    ompi_coll_adapt_tuning_probe_t probe;
+};
+
+typedef struct ompi_coll_adapt_constant_allreduce_context_s ompi_coll_adapt_constant_allreduce_context_t;
+
+OBJ_CLASS_DECLARATION(ompi_coll_adapt_constant_allreduce_context_t);
+
+/* Allgather constant context: the blocks are gathered to the root of a
+ * binomial tree, each process forwarding the blocks of its subtree to its
+ * parent as they arrive, and the root provides the gathered segments to a
+ * broadcast over the same tree */
+struct ompi_coll_adapt_constant_allgather_context_s {
+    opal_object_t super;
+    ompi_communicator_t *comm;
+    ompi_datatype_t *rdtype;
+    size_t rcount;
+    /* Distance between two blocks in rbuf */
+    ptrdiff_t block_extent;
+    char *rbuf;
+    int rank;
+    int size;
+    ompi_coll_tree_t *tree;
+    int gather_tag;
+    /* Mutex to protect the state of the gather */
+    opal_mutex_t mutex;
+    /* Blocks present in rbuf */
+    char *ready;
+    /* Next block to receive from each child, and the distance between the blocks of its subtree */
+    int *next_recv;
+    int *stride;
+    /* Next block to send to the parent, and the distance between the blocks of the subtree */
+    int next_send;
+    int send_stride;
+    int ongoing_send;
+    /* Blocks sent to the parent, and blocks to send */
+    int num_sent;
+    int num_to_send;
+    /* Blocks received from the children, and blocks to receive */
+    int num_recv;
+    int num_to_recv;
+    /* The broadcast fed by the gather at the root, its segments and the next one */
+    ompi_coll_adapt_constant_bcast_context_t *bcast;
+    int num_ready_blocks;
+    int next_seg;
+    int num_segs;
+    size_t seg_count;
+    /* Number of parts, among the gather and the broadcast, not completed yet */
+    opal_atomic_int32_t num_pending;
+    ompi_request_t *request;
+};
+
+typedef struct ompi_coll_adapt_constant_allgather_context_s ompi_coll_adapt_constant_allgather_context_t;
+
+OBJ_CLASS_DECLARATION(ompi_coll_adapt_constant_allgather_context_t);
+
+/* Allgather context of each block */
+struct ompi_coll_adapt_allgather_context_s {
+    opal_free_list_item_t super;
+    int block;
+    int child_id;
+    ompi_coll_adapt_constant_allgather_context_t *con;
+};
+
+typedef struct ompi_coll_adapt_allgather_context_s ompi_coll_adapt_allgather_context_t;
+
+OBJ_CLASS_DECLARATION(ompi_coll_adapt_allgather_context_t);
+
+#endif /* MCA_COLL_ADAPT_CONTEXT_H */
@@ -0,0 +1,466 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "ompi/communicator/communicator.h"
+#include "coll_adapt.h"
+#include "coll_adapt_algorithms.h"
+#include "coll_adapt_context.h"
+#include "coll_adapt_topocache.h"
+#include "ompi/constants.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
+#include "ompi/mca/pml/pml.h"
+#include "opal/util/bit_ops.h"
+
+/*
+ * MPI_Iallgather gathers the blocks to rank 0 over a binomial tree and
+ * broadcasts them from rank 0 over the same tree. In the binomial tree
+ * rooted at 0, the subtree of a rank r > 0 holds the ranks r + k * N, with N
+ * the smallest power of two above r: each process receives the blocks of
+ * the subtree of each child in this order, directly in place in rbuf, and
+ * forwards the blocks of its own subtree to its parent in the same order as
+ * soon as they arrive. The broadcast is started without its segments at the
+ * root, and the gather provides them once all their blocks arrived.
+ */
+
+/*
+ * Set up MCA parameters of MPI_Iallgather
+ */
+int ompi_coll_adapt_iallgather_register(void)
+{
+    mca_base_component_t *c = &mca_coll_adapt_component.super.collm_version;
+
+    mca_coll_adapt_component.adapt_iallgather_segment_size = 131072;
+    mca_base_component_var_register(c, "allgather_segment_size",
+                                    "Segment size in bytes used by the broadcast of the gathered blocks in allgather. 0 bytes means no segmentation.",
+                                    MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                    OPAL_INFO_LVL_5,
+                                    MCA_BASE_VAR_SCOPE_ALL,
+                                    &mca_coll_adapt_component.adapt_iallgather_segment_size);
+
+    mca_coll_adapt_component.adapt_iallgather_context_free_list = NULL;
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Release the free list created in ompi_coll_adapt_iallgather
+ */
+int ompi_coll_adapt_iallgather_fini(void)
+{
+    if (NULL != mca_coll_adapt_component.adapt_iallgather_context_free_list) {
+        OBJ_RELEASE(mca_coll_adapt_component.adapt_iallgather_context_free_list);
+        mca_coll_adapt_component.adapt_iallgather_context_free_list = NULL;
+        OPAL_OUTPUT_VERBOSE((10, mca_coll_adapt_component.adapt_output, "iallgather fini\n"));
+    }
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Complete the iallgather request once both the gather and the broadcast completed
+ */
+static void iallgather_part_fini(ompi_coll_adapt_constant_allgather_context_t *con)
+{
+    ompi_request_t *temp_req;
+
+    if (0 != opal_atomic_sub_fetch_32(&con->num_pending, 1)) {
+        return;
+    }
+    /* NULL if the request was already completed by iallgather_fail */
+    temp_req = con->request;
+    free(con->ready);
+    free(con->next_recv);
+    OBJ_RELEASE(con);
+    if (NULL != temp_req) {
+        ompi_request_complete(temp_req, 1);
+    }
+}
+
+/*
+ * Release the context and the request of an iallgather which could not be
+ * started
+ */
+static void iallgather_release(ompi_coll_adapt_constant_allgather_context_t *con,
+                               ompi_coll_base_nbc_request_t *temp_request,
+                               ompi_request_t **request)
+{
+    free(con->ready);
+    free(con->next_recv);
+    OBJ_RELEASE(con);
+    OBJ_RELEASE(temp_request);
+    *request = &ompi_request_null.request;
+}
+
+/*
+ * The gather could not be started after the broadcast: complete the request
+ * with the error now, as the broadcast does not complete without the
+ * gather. The context is released with the broadcast, if it completes.
+ */
+static void iallgather_fail(ompi_coll_adapt_constant_allgather_context_t *con, int err)
+{
+    ompi_request_t *temp_req = con->request;
+
+    con->request = NULL;
+    opal_atomic_wmb();
+    temp_req->req_status.MPI_ERROR = err;
+    ompi_request_complete(temp_req, 1);
+    /* The part of the gather, which never completes */
+    if (mca_coll_adapt_component.adapt_progress_thread) {
+        ompi_coll_base_progress_thread_done();
+    }
+    iallgather_part_fini(con);
+}
+
+static void iallgather_gather_fini(ompi_coll_adapt_constant_allgather_context_t *con)
+{
+    OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
+                         "[%d]: Iallgather, gather complete\n", con->rank));
+    if (mca_coll_adapt_component.adapt_progress_thread) {
+        ompi_coll_base_progress_thread_done();
+    }
+    iallgather_part_fini(con);
+}
+
+/*
+ * Completion callback of the request of the broadcast
+ */
+static int iallgather_bcast_cb(ompi_request_t * req)
+{
+    ompi_coll_adapt_constant_allgather_context_t *con =
+        (ompi_coll_adapt_constant_allgather_context_t *) req->req_complete_cb_data;
+
+    req->req_free(&req);
+    iallgather_part_fini(con);
+    /* Call back function return 1 to signal that request has been free'd */
+    return 1;
+}
+
+/*
+ * Provide to the broadcast, in order, the segments whose blocks all arrived
+ * at the root. Called with con->mutex held.
+ */
+static void iallgather_feed_bcast(ompi_coll_adapt_constant_allgather_context_t *con)
+{
+    while (con->num_ready_blocks < con->size && con->ready[con->num_ready_blocks]) {
+        con->num_ready_blocks++;
+    }
+    while (con->next_seg < con->num_segs) {
+        size_t end = (size_t) (con->next_seg + 1) * con->seg_count;
+        if (con->num_ready_blocks < con->size && end > (size_t) con->num_ready_blocks * con->rcount) {
+            break;
+        }
+        /* The last segment releases con->bcast */
+        int seg = con->next_seg++;
+        ompi_coll_adapt_ibcast_segment_ready(con->bcast, seg);
+    }
+}
+
+static int iallgather_recv_cb(ompi_request_t * req);
+static int iallgather_send_cb(ompi_request_t * req);
+
+/*
+ * Receive block from the child_id-th child
+ */
+static int iallgather_post_recv(ompi_coll_adapt_constant_allgather_context_t *con, int child_id, int block)
+{
+    ompi_coll_adapt_allgather_context_t *context;
+    ompi_request_t *recv_req;
+    int err;
+
+    context = (ompi_coll_adapt_allgather_context_t *) opal_free_list_wait(mca_coll_adapt_component.adapt_iallgather_context_free_list);
+    context->block = block;
+    context->child_id = child_id;
+    context->con = con;
+    OBJ_RETAIN(con);
+    OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
+                         "[%d]: Iallgather, recv block %d from %d tag %d\n", con->rank, block,
+                         con->tree->tree_next[child_id], con->gather_tag - block));
+    err = MCA_PML_CALL(irecv(con->rbuf + (ptrdiff_t) block * con->block_extent, con->rcount, con->rdtype,
+                             con->tree->tree_next[child_id], con->gather_tag - block, con->comm,
+                             &recv_req));
+    if (MPI_SUCCESS != err) {
+        opal_free_list_return(mca_coll_adapt_component.adapt_iallgather_context_free_list,
+                              (opal_free_list_item_t *) context);
+        OBJ_RELEASE(con);
+        return err;
+    }
+    ompi_request_set_callback(recv_req, iallgather_recv_cb, context);
+    return MPI_SUCCESS;
+}
+
+/*
+ * Send to the parent the next blocks of the subtree, in order, as long as
+ * they arrived and the number of ongoing sends allows it
+ */
+static int iallgather_send_blocks(ompi_coll_adapt_constant_allgather_context_t *con)
+{
+    ompi_coll_adapt_allgather_context_t *context;
+    ompi_request_t *send_req;
+    int block, err;
+
+    for (;;) {
+        OPAL_THREAD_LOCK(&con->mutex);
+        if (con->next_send >= con->size || !con->ready[con->next_send]
+            || con->ongoing_send >= mca_coll_adapt_component.adapt_ireduce_max_send_requests) {
+            OPAL_THREAD_UNLOCK(&con->mutex);
+            return MPI_SUCCESS;
+        }
+        block = con->next_send;
+        con->next_send += con->send_stride;
+        con->ongoing_send++;
+        OPAL_THREAD_UNLOCK(&con->mutex);
+
+        context = (ompi_coll_adapt_allgather_context_t *) opal_free_list_wait(mca_coll_adapt_component.adapt_iallgather_context_free_list);
+        context->block = block;
+        context->child_id = -1;
+        context->con = con;
+        OBJ_RETAIN(con);
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
+                             "[%d]: Iallgather, send block %d to %d tag %d\n", con->rank, block,
+                             con->tree->tree_prev, con->gather_tag - block));
+        err = MCA_PML_CALL(isend(con->rbuf + (ptrdiff_t) block * con->block_extent, con->rcount,
+                                 con->rdtype, con->tree->tree_prev, con->gather_tag - block,
+                                 MCA_PML_BASE_SEND_STANDARD, con->comm, &send_req));
+        if (MPI_SUCCESS != err) {
+            opal_free_list_return(mca_coll_adapt_component.adapt_iallgather_context_free_list,
+                                  (opal_free_list_item_t *) context);
+            OBJ_RELEASE(con);
+            return err;
+        }
+        ompi_request_set_callback(send_req, iallgather_send_cb, context);
+    }
+}
+
+/*
+ * Callback function of isend
+ */
+static int iallgather_send_cb(ompi_request_t * req)
+{
+    ompi_coll_adapt_allgather_context_t *context =
+        (ompi_coll_adapt_allgather_context_t *) req->req_complete_cb_data;
+    ompi_coll_adapt_constant_allgather_context_t *con = context->con;
+    bool done;
+
+    OPAL_THREAD_LOCK(&con->mutex);
+    con->ongoing_send--;
+    done = (++con->num_sent == con->num_to_send);
+    OPAL_THREAD_UNLOCK(&con->mutex);
+
+    opal_free_list_return(mca_coll_adapt_component.adapt_iallgather_context_free_list,
+                          (opal_free_list_item_t *) context);
+    if (done) {
+        iallgather_gather_fini(con);
+    } else {
+        iallgather_send_blocks(con);
+    }
+    OBJ_RELEASE(con);
+    req->req_free(&req);
+    /* Call back function return 1 to signal that request has been free'd */
+    return 1;
+}
+
+/*
+ * Callback function of irecv
+ */
+static int iallgather_recv_cb(ompi_request_t * req)
+{
+    ompi_coll_adapt_allgather_context_t *context =
+        (ompi_coll_adapt_allgather_context_t *) req->req_complete_cb_data;
+    ompi_coll_adapt_constant_allgather_context_t *con = context->con;
+    int child_id = context->child_id, next;
+    bool done = false;
+
+    OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
+                         "[%d]: Iallgather, received block %d\n", con->rank, context->block));
+    OPAL_THREAD_LOCK(&con->mutex);
+    con->ready[context->block] = 1;
+    con->num_recv++;
+    next = con->next_recv[child_id];
+    if (next < con->size) {
+        con->next_recv[child_id] += con->stride[child_id];
+    }
+    if (0 == con->rank) {
+        iallgather_feed_bcast(con);
+        done = (con->num_recv == con->num_to_recv);
+    }
+    OPAL_THREAD_UNLOCK(&con->mutex);
+
+    opal_free_list_return(mca_coll_adapt_component.adapt_iallgather_context_free_list,
+                          (opal_free_list_item_t *) context);
+    /* Keep the receives from this child going */
+    if (next < con->size) {
+        iallgather_post_recv(con, child_id, next);
+    }
+    if (0 != con->rank) {
+        iallgather_send_blocks(con);
+    } else if (done) {
+        iallgather_gather_fini(con);
+    }
+    OBJ_RELEASE(con);
+    req->req_free(&req);
+    /* Call back function return 1 to signal that request has been free'd */
+    return 1;
+}
+
+int ompi_coll_adapt_iallgather(const void *sbuf, size_t scount, struct ompi_datatype_t *sdtype,
+                               void *rbuf, size_t rcount, struct ompi_datatype_t *rdtype,
+                               struct ompi_communicator_t *comm, ompi_request_t ** request,
+                               mca_coll_base_module_t * module)
+{
+    ompi_coll_adapt_tuning_probe_t no_probe = { .tuning = NULL };
+    ompi_coll_base_nbc_request_t *temp_request;
+    ompi_coll_adapt_constant_allgather_context_t *con;
+    ompi_request_t *bcast_req;
+    ompi_coll_tree_t *tree;
+    ptrdiff_t lb, extent;
+    size_t type_size;
+    int rank = ompi_comm_rank(comm), size = ompi_comm_size(comm), err;
+
+    /* Atomically set up free list */
+    if (NULL == mca_coll_adapt_component.adapt_iallgather_context_free_list) {
+        opal_free_list_t* fl = OBJ_NEW(opal_free_list_t);
+        opal_free_list_init(fl,
+                            sizeof(ompi_coll_adapt_allgather_context_t),
+                            opal_cache_line_size,
+                            OBJ_CLASS(ompi_coll_adapt_allgather_context_t),
+                            0, opal_cache_line_size,
+                            mca_coll_adapt_component.adapt_context_free_list_min,
+                            mca_coll_adapt_component.adapt_context_free_list_max,
+                            mca_coll_adapt_component.adapt_context_free_list_inc,
+                            NULL, 0, NULL, NULL, NULL);
+        if( !OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_PTR((opal_atomic_intptr_t *)&mca_coll_adapt_component.adapt_iallgather_context_free_list,
+                                                     &(intptr_t){0}, fl) ) {
+            OBJ_RELEASE(fl);
+        }
+    }
+
+    /* Set up request */
+    temp_request = OBJ_NEW(ompi_coll_base_nbc_request_t);
+    OMPI_REQUEST_INIT(&temp_request->super, false);
+    temp_request->super.req_state = OMPI_REQUEST_ACTIVE;
+    temp_request->super.req_type = OMPI_REQUEST_COLL;
+    temp_request->super.req_free = ompi_coll_adapt_request_free;
+    temp_request->super.req_status.MPI_SOURCE = 0;
+    temp_request->super.req_status.MPI_TAG = 0;
+    temp_request->super.req_status.MPI_ERROR = 0;
+    temp_request->super.req_status._cancelled = 0;
+    temp_request->super.req_status._ucount = 0;
+    *request = (ompi_request_t*)temp_request;
+
+    ompi_datatype_type_size(rdtype, &type_size);
+    if (0 == rcount * type_size) {
+        ompi_request_complete(&temp_request->super, 1);
+        return MPI_SUCCESS;
+    }
+
+    /* The gather needs the subtrees of the binomial tree rooted at 0 */
+    tree = ompi_coll_adapt_module_cached_topology(module, comm, 0, OMPI_COLL_ADAPT_ALGORITHM_BINOMIAL);
+    ompi_datatype_get_extent(rdtype, &lb, &extent);
+
+    /* Set constant context for the gather and the broadcast */
+    con = OBJ_NEW(ompi_coll_adapt_constant_allgather_context_t);
+    con->comm = comm;
+    con->rdtype = rdtype;
+    con->rcount = rcount;
+    con->block_extent = (ptrdiff_t) rcount * extent;
+    con->rbuf = (char *) rbuf;
+    con->rank = rank;
+    con->size = size;
+    con->tree = tree;
+    con->ready = (char *) calloc(size, sizeof(char));
+    con->next_recv = (int *) malloc(2 * sizeof(int) * (tree->tree_nextsize + 1));
+    if (NULL == con->ready || NULL == con->next_recv) {
+        iallgather_release(con, temp_request, request);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    con->stride = con->next_recv + tree->tree_nextsize + 1;
+    for (int i = 0; i < tree->tree_nextsize; i++) {
+        con->next_recv[i] = tree->tree_next[i];
+        con->stride[i] = opal_next_poweroftwo(tree->tree_next[i]);
+    }
+    /* The blocks of the subtree: rank + k * send_stride, rank's own first */
+    con->send_stride = (0 == rank) ? 1 : opal_next_poweroftwo(rank);
+    con->next_send = rank;
+    con->ongoing_send = 0;
+    con->num_sent = 0;
+    con->num_to_send = (0 == rank) ? 0 : (size - 1 - rank) / con->send_stride + 1;
+    con->num_recv = 0;
+    con->num_to_recv = (size - 1 - rank) / con->send_stride;
+    con->bcast = NULL;
+    con->num_ready_blocks = 0;
+    con->next_seg = 0;
+    con->num_segs = 0;
+    con->seg_count = 0;
+    con->num_pending = 2;
+    con->request = (ompi_request_t*)temp_request;
+
+    if (MPI_IN_PLACE != sbuf) {
+        err = ompi_datatype_sndrcv((void *) sbuf, scount, sdtype,
+                                   con->rbuf + (ptrdiff_t) rank * con->block_extent, rcount, rdtype);
+        if (MPI_SUCCESS != err) {
+            iallgather_release(con, temp_request, request);
+            return err;
+        }
+    }
+    con->ready[rank] = 1;
+
+    /* Start the broadcast first, so that it can receive the segments of the gather */
+    err = ompi_coll_adapt_ibcast_generic(rbuf, (size_t) size * rcount, rdtype, 0, comm, &bcast_req, module,
+                                         tree, mca_coll_adapt_component.adapt_iallgather_segment_size,
+                                         &no_probe, 0 == rank ? &con->bcast : NULL);
+    if (MPI_SUCCESS != err) {
+        iallgather_release(con, temp_request, request);
+        return err;
+    }
+    if (0 == rank) {
+        con->num_segs = con->bcast->num_segs;
+        con->seg_count = con->bcast->seg_count;
+    }
+    ompi_request_set_callback(bcast_req, iallgather_bcast_cb, con);
+
+    con->gather_tag = ompi_coll_base_nbc_reserve_tags(comm, size);
+    if (mca_coll_adapt_component.adapt_progress_thread) {
+        ompi_coll_base_progress_thread_post();
+    }
+    OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
+                         "[%d]: Iallgather, %d blocks to receive, %d to send, tag %d\n",
+                         rank, con->num_to_recv, con->num_to_send, con->gather_tag));
+
+    /* Receive the first blocks of each child */
+    for (int i = 0; i < tree->tree_nextsize; i++) {
+        for (int j = 0; j < mca_coll_adapt_component.adapt_ireduce_max_recv_requests; j++) {
+            int block;
+            OPAL_THREAD_LOCK(&con->mutex);
+            block = con->next_recv[i];
+            if (block < size) {
+                con->next_recv[i] += con->stride[i];
+            }
+            OPAL_THREAD_UNLOCK(&con->mutex);
+            if (block >= size) {
+                break;
+            }
+            err = iallgather_post_recv(con, i, block);
+            if (MPI_SUCCESS != err) {
+                iallgather_fail(con, err);
+                return err;
+            }
+        }
+    }
+
+    if (0 == rank) {
+        OPAL_THREAD_LOCK(&con->mutex);
+        iallgather_feed_bcast(con);
+        OPAL_THREAD_UNLOCK(&con->mutex);
+        return MPI_SUCCESS;
+    }
+    err = iallgather_send_blocks(con);
+    if (MPI_SUCCESS != err) {
+        iallgather_fail(con, err);
+    }
+    return err;
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "ompi/communicator/communicator.h"
+#include "coll_adapt.h"
+#include "coll_adapt_algorithms.h"
+#include "coll_adapt_context.h"
+#include "coll_adapt_topocache.h"
+#include "coll_adapt_tuning.h"
+#include "ompi/constants.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
+#include "opal/datatype/opal_datatype.h"
+
+/*
+ * MPI_Iallreduce is a reduce to rank 0 fused with a broadcast from rank 0
+ * over the same tree: the broadcast is started without its segments at the
+ * root, and the reduce provides them as they are completely reduced, so the
+ * broadcast of the first segments overlaps the reduction of the next ones.
+ * Like the reduce, it only works for commutative operations.
+ */
+
+/*
+ * Set up MCA parameters of MPI_Iallreduce
+ */
+int ompi_coll_adapt_iallreduce_register(void)
+{
+    mca_base_component_t *c = &mca_coll_adapt_component.super.collm_version;
+
+    mca_coll_adapt_component.adapt_iallreduce_algorithm = OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE;
+    mca_base_component_var_register(c, "allreduce_algorithm",
+                                    "Tree of the reduce and broadcast of allreduce, 1: binomial, 2: in_order_binomial, 3: binary, 4: pipeline, 5: chain, 6: linear, 7: adaptive (tree and segment size chosen at runtime, see coll_adapt_tuning_trials)",
+                                    MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                    OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL,
+                                    &mca_coll_adapt_component.adapt_iallreduce_algorithm);
+    if( (mca_coll_adapt_component.adapt_iallreduce_algorithm <= OMPI_COLL_ADAPT_ALGORITHM_TUNED) ||
+        (mca_coll_adapt_component.adapt_iallreduce_algorithm >= OMPI_COLL_ADAPT_ALGORITHM_COUNT) ) {
+        mca_coll_adapt_component.adapt_iallreduce_algorithm = OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE;
+    }
+
+    mca_coll_adapt_component.adapt_iallreduce_segment_size = 524288;
+    mca_base_component_var_register(c, "allreduce_segment_size",
+                                    "Segment size in bytes used by allreduce. Only has meaning if algorithm is forced. 0 bytes means no segmentation.",
+                                    MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                    OPAL_INFO_LVL_5,
+                                    MCA_BASE_VAR_SCOPE_ALL,
+                                    &mca_coll_adapt_component.adapt_iallreduce_segment_size);
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Complete the iallreduce request once both the reduce and the broadcast completed
+ */
+static void iallreduce_part_fini(ompi_coll_adapt_constant_allreduce_context_t *con)
+{
+    ompi_request_t *temp_req;
+
+    if (0 != opal_atomic_sub_fetch_32(&con->num_pending, 1)) {
+        return;
+    }
+    /* NULL if the request was already completed by iallreduce_fail */
+    temp_req = con->request;
+    ompi_coll_adapt_tuning_record(&con->probe);
+    free(con->tmpbuf);
+    free(con->ready);
+    OBJ_RELEASE(con);
+    if (NULL != temp_req) {
+        ompi_request_complete(temp_req, 1);
+    }
+}
+
+/*
+ * Release the context and the request of an iallreduce which could not be
+ * started
+ */
+static void iallreduce_release(ompi_coll_adapt_constant_allreduce_context_t *con,
+                               ompi_coll_base_nbc_request_t *temp_request,
+                               ompi_request_t **request)
+{
+    if (NULL != con->probe.tuning) {
+        OBJ_RELEASE(con->probe.tuning);
+    }
+    free(con->tmpbuf);
+    free(con->ready);
+    OBJ_RELEASE(con);
+    OBJ_RELEASE(temp_request);
+    *request = &ompi_request_null.request;
+}
+
+/*
+ * The reduce could not be started after the broadcast: complete the request
+ * with the error now, as the broadcast does not complete without the
+ * reduce. The context is released with the broadcast, if it completes.
+ */
+static void iallreduce_fail(ompi_coll_adapt_constant_allreduce_context_t *con, int err)
+{
+    ompi_request_t *temp_req = con->request;
+
+    if (NULL != con->probe.tuning) {
+        OBJ_RELEASE(con->probe.tuning);
+        con->probe.tuning = NULL;
+    }
+    con->request = NULL;
+    opal_atomic_wmb();
+    temp_req->req_status.MPI_ERROR = err;
+    ompi_request_complete(temp_req, 1);
+    /* The part of the reduce */
+    iallreduce_part_fini(con);
+}
+
+/*
+ * Completion callback of the requests of the reduce and of the broadcast
+ */
+static int iallreduce_part_cb(ompi_request_t * req)
+{
+    ompi_coll_adapt_constant_allreduce_context_t *con =
+        (ompi_coll_adapt_constant_allreduce_context_t *) req->req_complete_cb_data;
+
+    req->req_free(&req);
+    iallreduce_part_fini(con);
+    /* Call back function return 1 to signal that request has been free'd */
+    return 1;
+}
+
+/*
+ * Called by the reduce at the root when a segment is reduced: provide the
+ * segments to the broadcast in order, as the processes receive them in
+ * order of segment
+ */
+static void iallreduce_segment_done(void *data, int seg_index)
+{
+    ompi_coll_adapt_constant_allreduce_context_t *con =
+        (ompi_coll_adapt_constant_allreduce_context_t *) data;
+
+    OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
+                         "[%d]: Iallreduce, segment %d reduced\n",
+                         ompi_comm_rank(con->bcast->comm), seg_index));
+    OPAL_THREAD_LOCK(&con->mutex);
+    con->ready[seg_index] = 1;
+    while (con->next_seg < con->num_segs && con->ready[con->next_seg]) {
+        /* The last segment releases con->bcast */
+        int seg = con->next_seg++;
+        ompi_coll_adapt_ibcast_segment_ready(con->bcast, seg);
+    }
+    OPAL_THREAD_UNLOCK(&con->mutex);
+}
+
+int ompi_coll_adapt_iallreduce(const void *sbuf, void *rbuf, size_t count, struct ompi_datatype_t *dtype,
+                               struct ompi_op_t *op, struct ompi_communicator_t *comm,
+                               ompi_request_t ** request, mca_coll_base_module_t * module)
+{
+    mca_coll_adapt_module_t *adapt_module = (mca_coll_adapt_module_t *) module;
+    ompi_coll_adapt_algorithm_t algorithm = mca_coll_adapt_component.adapt_iallreduce_algorithm;
+    size_t seg_size = mca_coll_adapt_component.adapt_iallreduce_segment_size, type_size;
+    ompi_coll_adapt_tuning_probe_t probe = { .tuning = NULL }, no_probe = { .tuning = NULL };
+    ompi_coll_base_nbc_request_t *temp_request;
+    ompi_coll_adapt_constant_allreduce_context_t *con;
+    ompi_request_t *bcast_req, *reduce_req;
+    ompi_coll_tree_t *tree;
+    size_t seg_count;
+    int rank = ompi_comm_rank(comm), err;
+
+    /* Fall-back if operation is not commutative */
+    if (!ompi_op_is_commute(op)) {
+        OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
+                    "ADAPT cannot handle allreduce with this (non-commutative) operation. It needs to fall back on another component\n"));
+        return adapt_module->previous_iallreduce(sbuf, rbuf, count, dtype, op, comm, request,
+                                                 adapt_module->previous_iallreduce_module);
+    }
+
+    ompi_datatype_type_size(dtype, &type_size);
+    if (OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE == algorithm) {
+        if (0 == count * type_size) {
+            algorithm = OMPI_COLL_ADAPT_ALGORITHM_BINOMIAL;
+        } else {
+            err = ompi_coll_adapt_tuning_select(&adapt_module->iallreduce_tuning, comm, count * type_size,
+                                                &algorithm, &seg_size, &probe);
+            if (OMPI_SUCCESS != err) {
+                return err;
+            }
+        }
+    }
+    tree = ompi_coll_adapt_module_cached_topology(module, comm, 0, algorithm);
+
+    OPAL_OUTPUT_VERBOSE((10, mca_coll_adapt_component.adapt_output,
+                         "iallreduce algorithm %d, segment size %zu\n", algorithm, seg_size));
+
+    /* Set up request */
+    temp_request = OBJ_NEW(ompi_coll_base_nbc_request_t);
+    OMPI_REQUEST_INIT(&temp_request->super, false);
+    temp_request->super.req_state = OMPI_REQUEST_ACTIVE;
+    temp_request->super.req_type = OMPI_REQUEST_COLL;
+    temp_request->super.req_free = ompi_coll_adapt_request_free;
+    temp_request->super.req_status.MPI_SOURCE = 0;
+    temp_request->super.req_status.MPI_TAG = 0;
+    temp_request->super.req_status.MPI_ERROR = 0;
+    temp_request->super.req_status._cancelled = 0;
+    temp_request->super.req_status._ucount = 0;
+    *request = (ompi_request_t*)temp_request;
+
+    if (0 == count * type_size) {
+        ompi_request_complete(&temp_request->super, 1);
+        return MPI_SUCCESS;
+    }
+
+    /* Set constant context for the completion of the parts */
+    con = OBJ_NEW(ompi_coll_adapt_constant_allreduce_context_t);
+    con->request = (ompi_request_t*)temp_request;
+    con->bcast = NULL;
+    con->ready = NULL;
+    con->next_seg = 0;
+    con->num_segs = 0;
+    con->num_pending = 2;
+    con->tmpbuf = NULL;
+    con->probe.tuning = NULL;
+
+    if (0 == rank) {
+        /* The same segments as the reduce and the broadcast */
+        seg_count = count;
+        COLL_BASE_COMPUTED_SEGCOUNT(seg_size, type_size, seg_count);
+        con->num_segs = (count + seg_count - 1) / seg_count;
+        con->ready = (char *) calloc(con->num_segs, sizeof(char));
+        if (NULL == con->ready) {
+            con->probe = probe;
+            iallreduce_release(con, temp_request, request);
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+    } else if (MPI_IN_PLACE == sbuf) {
+        /* The broadcast overwrites rbuf while the reduce sends the
+         * contribution of the process, which thus needs a copy */
+        ptrdiff_t gap, span = opal_datatype_span(&dtype->super, count, &gap);
+        con->tmpbuf = (char *) malloc(span);
+        if (NULL == con->tmpbuf) {
+            con->probe = probe;
+            iallreduce_release(con, temp_request, request);
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        sbuf = con->tmpbuf - gap;
+        ompi_datatype_copy_content_same_ddt(dtype, count, (char *) sbuf, (char *) rbuf);
+    }
+
+    /* The request now owns the measurement */
+    con->probe = probe;
+
+    /* Start the broadcast first, so that it can receive the segments of the reduce */
+    err = ompi_coll_adapt_ibcast_generic(rbuf, count, dtype, 0, comm, &bcast_req, module, tree,
+                                         seg_size, &no_probe, 0 == rank ? &con->bcast : NULL);
+    if (MPI_SUCCESS != err) {
+        iallreduce_release(con, temp_request, request);
+        return err;
+    }
+    ompi_request_set_callback(bcast_req, iallreduce_part_cb, con);
+
+    err = ompi_coll_adapt_ireduce_generic(sbuf, rbuf, count, dtype, op, 0, comm, &reduce_req, module, tree,
+                                          seg_size, &no_probe, iallreduce_segment_done, con);
+    if (MPI_SUCCESS != err) {
+        iallreduce_fail(con, err);
+        return err;
+    }
+    ompi_request_set_callback(reduce_req, iallreduce_part_cb, con);
+
+    return MPI_SUCCESS;
+}
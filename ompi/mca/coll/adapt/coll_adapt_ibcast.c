@@ -23,9 +23,6 @@
 #include "opal/sys/atomic.h"
 #include "ompi/mca/pml/ob1/pml_ob1.h"
 
-static int ompi_coll_adapt_ibcast_generic(IBCAST_ARGS,
-                                   ompi_coll_tree_t * tree, size_t seg_size);
-
 /*
  * Set up MCA parameters of MPI_Bcast and MPI_IBcast
  */
@@ -33,15 +30,15 @@ int ompi_coll_adapt_ibcast_register(void)
 {
     mca_base_component_t *c = &mca_coll_adapt_component.super.collm_version;
 
-    mca_coll_adapt_component.adapt_ibcast_algorithm = 1;
+    mca_coll_adapt_component.adapt_ibcast_algorithm = OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE;
     mca_base_component_var_register(c, "bcast_algorithm",
-                                    "Algorithm of broadcast, 0: tuned, 1: binomial, 2: in_order_binomial, 3: binary, 4: pipeline, 5: chain, 6: linear",
+                                    "Algorithm of broadcast, 0: tuned, 1: binomial, 2: in_order_binomial, 3: binary, 4: pipeline, 5: chain, 6: linear, 7: adaptive (tree and segment size chosen at runtime, see coll_adapt_tuning_trials)",
                                     MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                     OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL,
                                     &mca_coll_adapt_component.adapt_ibcast_algorithm);
     if( (mca_coll_adapt_component.adapt_ibcast_algorithm < 0) ||
         (mca_coll_adapt_component.adapt_ibcast_algorithm >= OMPI_COLL_ADAPT_ALGORITHM_COUNT) ) {
-        mca_coll_adapt_component.adapt_ibcast_algorithm = 1;
+        mca_coll_adapt_component.adapt_ibcast_algorithm = OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE;
     }
 
     mca_coll_adapt_component.adapt_ibcast_segment_size = 0;
@@ -106,7 +103,11 @@ static int ibcast_request_fini(ompi_coll_adapt_bcast_context_t * context)
         free(context->con->recv_array);
     }
     OBJ_RELEASE(context->con->mutex);
+    ompi_coll_adapt_tuning_record(&context->con->probe);
     OBJ_RELEASE(context->con);
+    if (mca_coll_adapt_component.adapt_progress_thread) {
+        ompi_coll_base_progress_thread_done();
+    }
     ompi_request_complete(temp_req, 1);
 
     return OMPI_SUCCESS;
@@ -321,10 +322,76 @@ static int recv_cb(ompi_request_t * req)
     return 1;
 }
 
+/*
+ * Provide segment frag_id at the root of an ibcast started with deferred
+ * segments, and send it to the children which are waiting for it, as the
+ * receive callback does with the segments received from the parent
+ */
+int ompi_coll_adapt_ibcast_segment_ready(ompi_coll_adapt_constant_bcast_context_t *con, int frag_id)
+{
+    int i, err = MPI_SUCCESS;
+
+    OPAL_THREAD_LOCK(con->mutex);
+    int num_recv_segs = ++(con->num_recv_segs);
+    con->recv_array[num_recv_segs - 1] = frag_id;
+
+    for (i = 0; i < con->tree->tree_nextsize; i++) {
+        if (num_recv_segs - 1 == con->send_array[i]) {
+            ompi_coll_adapt_bcast_context_t *send_context;
+            ompi_request_t *send_req;
+
+            ++(con->send_array[i]);
+            OPAL_THREAD_UNLOCK(con->mutex);
+
+            int send_count = con->seg_count;
+            if (frag_id == (con->num_segs - 1)) {
+                send_count = con->count - frag_id * con->seg_count;
+            }
+            send_context = (ompi_coll_adapt_bcast_context_t *) opal_free_list_wait(mca_coll_adapt_component.adapt_ibcast_context_free_list);
+            send_context->buff = con->buff + (ptrdiff_t) frag_id * con->real_seg_size;
+            send_context->frag_id = frag_id;
+            send_context->child_id = i;
+            send_context->peer = con->tree->tree_next[i];
+            send_context->con = con;
+            OBJ_RETAIN(con);
+            OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
+                                 "[%d]: Send(start in segment ready): segment %d to %d at buff %p send_count %d tag %d\n",
+                                 ompi_comm_rank(con->comm), frag_id, send_context->peer,
+                                 (void *) send_context->buff, send_count, con->ibcast_tag - frag_id));
+            err = MCA_PML_CALL(isend
+                               (send_context->buff, send_count, con->datatype, send_context->peer,
+                                con->ibcast_tag - frag_id,
+                                MCA_PML_BASE_SEND_STANDARD, con->comm, &send_req));
+            if (MPI_SUCCESS != err) {
+                opal_free_list_return(mca_coll_adapt_component.adapt_ibcast_context_free_list,
+                                      (opal_free_list_item_t *)send_context);
+                OBJ_RELEASE(con);
+                return err;
+            }
+            ompi_request_set_callback(send_req, send_cb, send_context);
+
+            OPAL_THREAD_LOCK(con->mutex);
+        }
+    }
+    OPAL_THREAD_UNLOCK(con->mutex);
+
+    /* Release the reference returned with the deferred segments */
+    if (num_recv_segs == con->num_segs) {
+        OBJ_RELEASE(con);
+    }
+    return err;
+}
+
 int ompi_coll_adapt_ibcast(void *buff, size_t count, struct ompi_datatype_t *datatype, int root,
                           struct ompi_communicator_t *comm, ompi_request_t ** request,
                           mca_coll_base_module_t * module)
 {
+    mca_coll_adapt_module_t *adapt_module = (mca_coll_adapt_module_t *) module;
+    ompi_coll_adapt_algorithm_t algorithm = mca_coll_adapt_component.adapt_ibcast_algorithm;
+    size_t seg_size = mca_coll_adapt_component.adapt_ibcast_segment_size, type_size;
+    ompi_coll_adapt_tuning_probe_t probe = { .tuning = NULL };
+    int err;
+
     OPAL_OUTPUT_VERBOSE((10, mca_coll_adapt_component.adapt_output,
                          "ibcast root %d, algorithm %d, coll_adapt_ibcast_segment_size %zu, coll_adapt_ibcast_max_send_requests %d, coll_adapt_ibcast_max_recv_requests %d\n",
                          root, mca_coll_adapt_component.adapt_ibcast_algorithm,
@@ -332,21 +399,39 @@ int ompi_coll_adapt_ibcast(void *buff, size_t count, struct ompi_datatype_t *dat
                          mca_coll_adapt_component.adapt_ibcast_max_send_requests,
                          mca_coll_adapt_component.adapt_ibcast_max_recv_requests));
 
-    if (OMPI_COLL_ADAPT_ALGORITHM_TUNED == mca_coll_adapt_component.adapt_ibcast_algorithm) {
+    if (OMPI_COLL_ADAPT_ALGORITHM_TUNED == algorithm) {
         OPAL_OUTPUT_VERBOSE((10, mca_coll_adapt_component.adapt_output, "tuned not implemented\n"));
         return OMPI_ERR_NOT_IMPLEMENTED;
     }
 
-    return ompi_coll_adapt_ibcast_generic(buff, count, datatype, root, comm, request, module,
-                                          ompi_coll_adapt_module_cached_topology(module, comm, root, mca_coll_adapt_component.adapt_ibcast_algorithm),
-                                          mca_coll_adapt_component.adapt_ibcast_segment_size);
+    if (OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE == algorithm) {
+        ompi_datatype_type_size(datatype, &type_size);
+        if (0 == count * type_size) {
+            algorithm = OMPI_COLL_ADAPT_ALGORITHM_BINOMIAL;
+        } else {
+            err = ompi_coll_adapt_tuning_select(&adapt_module->ibcast_tuning, comm, count * type_size,
+                                                &algorithm, &seg_size, &probe);
+            if (OMPI_SUCCESS != err) {
+                return err;
+            }
+        }
+    }
+
+    err = ompi_coll_adapt_ibcast_generic(buff, count, datatype, root, comm, request, module,
+                                         ompi_coll_adapt_module_cached_topology(module, comm, root, algorithm),
+                                         seg_size, &probe, NULL);
+    if (MPI_SUCCESS != err && NULL != probe.tuning) {
+        OBJ_RELEASE(probe.tuning);
+    }
+    return err;
 }
 
 
 int ompi_coll_adapt_ibcast_generic(void *buff, size_t count, struct ompi_datatype_t *datatype, int root,
                                    struct ompi_communicator_t *comm, ompi_request_t ** request,
                                    mca_coll_base_module_t * module, ompi_coll_tree_t * tree,
-                                   size_t seg_size)
+                                   size_t seg_size, ompi_coll_adapt_tuning_probe_t *probe,
+                                   ompi_coll_adapt_constant_bcast_context_t **deferred)
 {
     int i, j, rank, err;
     /* The min of num_segs and SEND_NUM or RECV_NUM, in case the num_segs is less than SEND_NUM or RECV_NUM */
@@ -403,6 +488,9 @@ int ompi_coll_adapt_ibcast_generic(void *buff, size_t count, struct ompi_datatyp
     temp_request->super.req_status._cancelled = 0;
     temp_request->super.req_status._ucount = 0;
     *request = (ompi_request_t*)temp_request;
+    if (mca_coll_adapt_component.adapt_progress_thread) {
+        ompi_coll_base_progress_thread_post();
+    }
 
     /* Set up mutex */
     mutex = OBJ_NEW(opal_mutex_t);
@@ -428,6 +516,7 @@ int ompi_coll_adapt_ibcast_generic(void *buff, size_t count, struct ompi_datatyp
     /* Set constant context for send and recv call back */
     ompi_coll_adapt_constant_bcast_context_t *con = OBJ_NEW(ompi_coll_adapt_constant_bcast_context_t);
     con->root = root;
+    con->buff = (char *) buff;
     con->count = count;
     con->seg_count = seg_count;
     con->datatype = datatype;
@@ -443,6 +532,9 @@ int ompi_coll_adapt_ibcast_generic(void *buff, size_t count, struct ompi_datatyp
     con->request = (ompi_request_t*)temp_request;
     con->tree = tree;
     con->ibcast_tag = ompi_coll_base_nbc_reserve_tags(comm, num_segs);
+    /* The request now owns the measurement */
+    con->probe = *probe;
+    probe->tuning = NULL;
 
     OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
                          "[%d]: Ibcast, root %d, tag %d\n", rank, root,
@@ -454,8 +546,18 @@ int ompi_coll_adapt_ibcast_generic(void *buff, size_t count, struct ompi_datatyp
 
     OPAL_THREAD_LOCK(mutex);
 
+    /* If the segments are not available yet at the root, they are provided
+     * later, each as if it was received from a parent */
+    if (rank == root && NULL != deferred) {
+        for (i = 0; i < tree->tree_nextsize; i++) {
+            send_array[i] = 0;
+        }
+        OBJ_RETAIN(con);
+        *deferred = con;
+    }
+
     /* If the current process is root, it sends segment to every children */
-    if (rank == root) {
+    else if (rank == root) {
         /* Handle the situation when num_segs < SEND_NUM */
         if (num_segs <= mca_coll_adapt_component.adapt_ibcast_max_send_requests) {
             min = num_segs;
@@ -504,6 +606,9 @@ int ompi_coll_adapt_ibcast_generic(void *buff, size_t count, struct ompi_datatyp
                                   con->ibcast_tag - i, sendmode, comm,
                                   &send_req));
                 if (MPI_SUCCESS != err) {
+                    if (mca_coll_adapt_component.adapt_progress_thread) {
+                        ompi_coll_base_progress_thread_done();
+                    }
                     return err;
                 }
                 /* Set send callback */
@@ -563,6 +668,9 @@ int ompi_coll_adapt_ibcast_generic(void *buff, size_t count, struct ompi_datatyp
             /* Set receive callback */
             OPAL_THREAD_UNLOCK(mutex);
             if (MPI_SUCCESS != err) {
+                if (mca_coll_adapt_component.adapt_progress_thread) {
+                    ompi_coll_base_progress_thread_done();
+                }
                 return err;
             }
             ompi_request_set_callback(recv_req, recv_cb, context);
@@ -25,9 +25,6 @@
 #include "ompi/mca/pml/pml.h"
 #include "ompi/mca/coll/base/coll_base_topo.h"
 
-static int ompi_coll_adapt_ireduce_generic(IREDUCE_ARGS,
-                                           ompi_coll_tree_t * tree, size_t seg_size);
-
 /* MPI_Reduce and MPI_Ireduce in the ADAPT module only work for commutative operations */
 
 /*
@@ -37,15 +34,15 @@ int ompi_coll_adapt_ireduce_register(void)
 {
     mca_base_component_t *c = &mca_coll_adapt_component.super.collm_version;
 
-    mca_coll_adapt_component.adapt_ireduce_algorithm = 1;
+    mca_coll_adapt_component.adapt_ireduce_algorithm = OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE;
     mca_base_component_var_register(c, "reduce_algorithm",
-                                    "Algorithm of reduce, 1: binomial, 2: in_order_binomial, 3: binary, 4: pipeline, 5: chain, 6: linear",
+                                    "Algorithm of reduce, 1: binomial, 2: in_order_binomial, 3: binary, 4: pipeline, 5: chain, 6: linear, 7: adaptive (tree and segment size chosen at runtime, see coll_adapt_tuning_trials)",
                                     MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                     OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL,
                                     &mca_coll_adapt_component.adapt_ireduce_algorithm);
     if( (mca_coll_adapt_component.adapt_ireduce_algorithm < 0) ||
         (mca_coll_adapt_component.adapt_ireduce_algorithm > OMPI_COLL_ADAPT_ALGORITHM_COUNT) ) {
-        mca_coll_adapt_component.adapt_ireduce_algorithm = 1;
+        mca_coll_adapt_component.adapt_ireduce_algorithm = OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE;
     }
 
     mca_coll_adapt_component.adapt_ireduce_segment_size = 524288;
@@ -204,10 +201,14 @@ static int ireduce_request_fini(ompi_coll_adapt_reduce_context_t * context)
     if (context->con->tree->tree_nextsize > 0) {
         free(context->con->next_recv_segs);
     }
+    ompi_coll_adapt_tuning_record(&context->con->probe);
     OBJ_RELEASE(context->con);
     OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output, "return context_list\n"));
     opal_free_list_return(mca_coll_adapt_component.adapt_ireduce_context_free_list,
                           (opal_free_list_item_t *) context);
+    if (mca_coll_adapt_component.adapt_progress_thread) {
+        ompi_coll_base_progress_thread_done();
+    }
     /* Complete the request */
     ompi_request_complete(temp_req, 1);
     return OMPI_SUCCESS;
@@ -408,6 +409,14 @@ static int recv_cb(ompi_request_t * req)
     /* Set recv list */
     if (context->con->rank != context->con->tree->tree_root) {
         add_to_recv_list(context->con, context->seg_index);
+    } else if (NULL != context->con->segment_done) {
+        /* Signal the segments reduced with the contributions of all the children */
+        add_to_recv_list(context->con, context->seg_index);
+        ompi_coll_adapt_item_t *item = get_next_ready_item(context->con, context->con->tree->tree_nextsize);
+        if (NULL != item) {
+            context->con->segment_done(context->con->segment_done_data, item->id);
+            OBJ_RELEASE(item);
+        }
     }
 
     /* Send to parent */
@@ -482,10 +491,14 @@ int ompi_coll_adapt_ireduce(const void *sbuf, void *rbuf, size_t count, struct o
                            struct ompi_op_t *op, int root, struct ompi_communicator_t *comm,
                            ompi_request_t ** request, mca_coll_base_module_t * module)
 {
+    mca_coll_adapt_module_t *adapt_module = (mca_coll_adapt_module_t *) module;
+    ompi_coll_adapt_algorithm_t algorithm = mca_coll_adapt_component.adapt_ireduce_algorithm;
+    size_t seg_size = mca_coll_adapt_component.adapt_ireduce_segment_size, type_size;
+    ompi_coll_adapt_tuning_probe_t probe = { .tuning = NULL };
+    int err;
 
     /* Fall-back if operation is commutative */
     if (!ompi_op_is_commute(op)){
-        mca_coll_adapt_module_t *adapt_module = (mca_coll_adapt_module_t *) module;
         OPAL_OUTPUT_VERBOSE((30, mca_coll_adapt_component.adapt_output,
                     "ADAPT cannot handle reduce with this (non-commutative) operation. It needs to fall back on another component\n"));
         return adapt_module->previous_ireduce(sbuf, rbuf, count, dtype, op, root,
@@ -501,17 +514,31 @@ int ompi_coll_adapt_ireduce(const void *sbuf, void *rbuf, size_t count, struct o
                          mca_coll_adapt_component.adapt_ireduce_max_send_requests,
                          mca_coll_adapt_component.adapt_ireduce_max_recv_requests));
 
-    if (OMPI_COLL_ADAPT_ALGORITHM_TUNED == mca_coll_adapt_component.adapt_ireduce_algorithm) {
+    if (OMPI_COLL_ADAPT_ALGORITHM_TUNED == algorithm) {
         OPAL_OUTPUT_VERBOSE((10, mca_coll_adapt_component.adapt_output, "tuned not implemented\n"));
         return OMPI_ERR_NOT_IMPLEMENTED;
     }
 
+    if (OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE == algorithm) {
+        ompi_datatype_type_size(dtype, &type_size);
+        if (0 == count * type_size) {
+            algorithm = OMPI_COLL_ADAPT_ALGORITHM_BINOMIAL;
+        } else {
+            err = ompi_coll_adapt_tuning_select(&adapt_module->ireduce_tuning, comm, count * type_size,
+                                                &algorithm, &seg_size, &probe);
+            if (OMPI_SUCCESS != err) {
+                return err;
+            }
+        }
+    }
 
-    return ompi_coll_adapt_ireduce_generic(sbuf, rbuf, count, dtype, op, root, comm, request, module,
-                                           ompi_coll_adapt_module_cached_topology(module, comm, root,
-                                        		                                            mca_coll_adapt_component.adapt_ireduce_algorithm),
-                                           mca_coll_adapt_component.adapt_ireduce_segment_size);
-
+    err = ompi_coll_adapt_ireduce_generic(sbuf, rbuf, count, dtype, op, root, comm, request, module,
+                                          ompi_coll_adapt_module_cached_topology(module, comm, root, algorithm),
+                                          seg_size, &probe, NULL, NULL);
+    if (MPI_SUCCESS != err && NULL != probe.tuning) {
+        OBJ_RELEASE(probe.tuning);
+    }
+    return err;
 }
 
 
@@ -519,7 +546,9 @@ int ompi_coll_adapt_ireduce_generic(const void *sbuf, void *rbuf, size_t count,
                                     struct ompi_datatype_t *dtype, struct ompi_op_t *op, int root,
                                     struct ompi_communicator_t *comm, ompi_request_t ** request,
                                     mca_coll_base_module_t * module, ompi_coll_tree_t * tree,
-                                    size_t seg_size)
+                                    size_t seg_size, ompi_coll_adapt_tuning_probe_t *probe,
+                                    ompi_coll_adapt_reduce_segment_fn_t segment_done,
+                                    void *segment_done_data)
 {
 
     ptrdiff_t extent, lower_bound, segment_increment;
@@ -575,6 +604,9 @@ int ompi_coll_adapt_ireduce_generic(const void *sbuf, void *rbuf, size_t count,
     temp_request->super.req_status._cancelled = 0;
     temp_request->super.req_status._ucount = 0;
     *request = (ompi_request_t*)temp_request;
+    if (mca_coll_adapt_component.adapt_progress_thread) {
+        ompi_coll_base_progress_thread_post();
+    }
 
     /* Set up mutex */
     mutex_op_list = (opal_mutex_t *) malloc(sizeof(opal_mutex_t) * num_segs);
@@ -606,6 +638,11 @@ int ompi_coll_adapt_ireduce_generic(const void *sbuf, void *rbuf, size_t count,
     con->distance = 0;
     con->ireduce_tag = ompi_coll_base_nbc_reserve_tags(comm, num_segs);
     con->real_seg_size = real_seg_size;
+    /* The request now owns the measurement */
+    con->probe = *probe;
+    probe->tuning = NULL;
+    con->segment_done = segment_done;
+    con->segment_done_data = segment_done_data;
 
     /* If the current process is not leaf */
     if (tree->tree_nextsize > 0) {
@@ -710,6 +747,9 @@ int ompi_coll_adapt_ireduce_generic(const void *sbuf, void *rbuf, size_t count,
                                     (temp_recv_buf, recv_count, dtype, tree->tree_next[i],
                                     con->ireduce_tag - seg_index, comm, &recv_req));
                 if (MPI_SUCCESS != err) {
+                    if (mca_coll_adapt_component.adapt_progress_thread) {
+                        ompi_coll_base_progress_thread_done();
+                    }
                     return err;
                 }
                 /* Set the recv callback */
@@ -761,6 +801,9 @@ int ompi_coll_adapt_ireduce_generic(const void *sbuf, void *rbuf, size_t count,
                                 con->ireduce_tag - context->seg_index,
                                 sendmode, comm, &send_req));
             if (MPI_SUCCESS != err) {
+                if (mca_coll_adapt_component.adapt_progress_thread) {
+                    ompi_coll_base_progress_thread_done();
+                }
                 return err;
             }
 
@@ -40,6 +40,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/base.h"
 #include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
 #include "ompi/proc/proc.h"
 #include "coll_adapt.h"
 
@@ -47,6 +48,7 @@
 #include "ompi/mca/pml/pml.h"
 #include "coll_adapt_algorithms.h"
 #include "coll_adapt_topocache.h"
+#include "coll_adapt_tuning.h"
 
 
 /*
@@ -59,6 +61,9 @@
 static void adapt_module_construct(mca_coll_adapt_module_t * module)
 {
     module->topo_cache    = NULL;
+    module->ibcast_tuning = NULL;
+    module->ireduce_tuning = NULL;
+    module->iallreduce_tuning = NULL;
     module->adapt_enabled = false;
 }
 
@@ -75,6 +80,18 @@ static void adapt_module_destruct(mca_coll_adapt_module_t * module)
         OBJ_RELEASE(module->topo_cache);
         module->topo_cache = NULL;
     }
+    if (NULL != module->ibcast_tuning) {
+        ompi_coll_adapt_tuning_fini(module->ibcast_tuning);
+        OBJ_RELEASE(module->ibcast_tuning);
+    }
+    if (NULL != module->ireduce_tuning) {
+        ompi_coll_adapt_tuning_fini(module->ireduce_tuning);
+        OBJ_RELEASE(module->ireduce_tuning);
+    }
+    if (NULL != module->iallreduce_tuning) {
+        ompi_coll_adapt_tuning_fini(module->iallreduce_tuning);
+        OBJ_RELEASE(module->iallreduce_tuning);
+    }
     module->adapt_enabled = false;
 }
 
@@ -132,6 +149,8 @@ static int adapt_module_enable(mca_coll_base_module_t * module,
     ADAPT_INSTALL_COLL_API(comm, adapt_module, bcast);
     ADAPT_INSTALL_AND_SAVE_COLL_API(comm, adapt_module, ireduce);
     ADAPT_INSTALL_COLL_API(comm, adapt_module, ibcast);
+    ADAPT_INSTALL_AND_SAVE_COLL_API(comm, adapt_module, iallreduce);
+    ADAPT_INSTALL_COLL_API(comm, adapt_module, iallgather);
 
     return OMPI_SUCCESS;
 }
@@ -144,6 +163,8 @@ static int adapt_module_disable(mca_coll_base_module_t *module,
     ADAPT_UNINSTALL_COLL_API(comm, adapt_module, bcast);
     ADAPT_UNINSTALL_AND_RESTORE_COLL_API(comm, adapt_module, ireduce);
     ADAPT_UNINSTALL_COLL_API(comm, adapt_module, ibcast);
+    ADAPT_UNINSTALL_AND_RESTORE_COLL_API(comm, adapt_module, iallreduce);
+    ADAPT_UNINSTALL_COLL_API(comm, adapt_module, iallgather);
 
     return OMPI_SUCCESS;
 }
@@ -155,6 +176,18 @@ static int adapt_module_disable(mca_coll_base_module_t *module,
  */
 int ompi_coll_adapt_init_query(bool enable_progress_threads, bool enable_mpi_threads)
 {
+    mca_coll_adapt_component_t *cs = &mca_coll_adapt_component;
+
+    if (cs->adapt_progress_thread && !cs->adapt_progress_thread_retained) {
+        /* The progress thread triggers the callbacks of the requests
+         * concurrently with the application threads */
+        opal_set_using_threads(true);
+        if (OMPI_SUCCESS == ompi_coll_base_progress_thread_retain()) {
+            cs->adapt_progress_thread_retained = true;
+        } else {
+            cs->adapt_progress_thread = false;
+        }
+    }
     return OMPI_SUCCESS;
 }
 
@@ -200,6 +233,8 @@ mca_coll_base_module_t *ompi_coll_adapt_comm_query(struct ompi_communicator_t *
     adapt_module->super.coll_reduce = ompi_coll_adapt_reduce;
     adapt_module->super.coll_ibcast = ompi_coll_adapt_ibcast;
     adapt_module->super.coll_ireduce = ompi_coll_adapt_ireduce;
+    adapt_module->super.coll_iallreduce = ompi_coll_adapt_iallreduce;
+    adapt_module->super.coll_iallgather = ompi_coll_adapt_iallgather;
 
     opal_output_verbose(10, ompi_coll_base_framework.framework_output,
                         "coll:adapt:comm_query (%s/%s): pick me! pick me!",
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include <string.h>
+
+#include "coll_adapt.h"
+#include "coll_adapt_tuning.h"
+
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+#include "ompi/request/request.h"
+#include "opal/util/output.h"
+
+static void adapt_tuning_construct(ompi_coll_adapt_tuning_t *tuning)
+{
+    OBJ_CONSTRUCT(&tuning->lock, opal_mutex_t);
+    for (int i = 0; i < OMPI_COLL_ADAPT_TUNING_BUCKETS; i++) {
+        tuning->buckets[i] = NULL;
+    }
+}
+
+static void adapt_tuning_destruct(ompi_coll_adapt_tuning_t *tuning)
+{
+    for (int i = 0; i < OMPI_COLL_ADAPT_TUNING_BUCKETS; i++) {
+        if (NULL != tuning->buckets[i]) {
+            /* ompi_coll_adapt_tuning_fini() completed the agreements */
+            assert(NULL == tuning->buckets[i]->agree_req);
+            free(tuning->buckets[i]->agree_buf);
+            free(tuning->buckets[i]);
+        }
+    }
+    OBJ_DESTRUCT(&tuning->lock);
+}
+
+OBJ_CLASS_INSTANCE(ompi_coll_adapt_tuning_t, opal_object_t,
+                   adapt_tuning_construct, adapt_tuning_destruct);
+
+/* The trees tried, and the segment sizes tried with them */
+static const ompi_coll_adapt_algorithm_t tuning_trees[] = {
+    OMPI_COLL_ADAPT_ALGORITHM_BINOMIAL,
+    OMPI_COLL_ADAPT_ALGORITHM_BINARY,
+    OMPI_COLL_ADAPT_ALGORITHM_CHAIN,
+    OMPI_COLL_ADAPT_ALGORITHM_PIPELINE
+};
+static const size_t tuning_seg_sizes[] = { 0, 8192, 32768, 131072, 524288, 2097152 };
+
+/* Messages up to this size are also tried without segmentation */
+#define TUNING_MAX_UNSEGMENTED (64 * 1024)
+/* A segment size is tried if it splits the message in at least
+ * TUNING_MIN_SEGS and at most TUNING_MAX_SEGS segments */
+#define TUNING_MIN_SEGS 4
+#define TUNING_MAX_SEGS 4096
+/* Number of calls between the start of the agreement and the use of its
+ * result, for the allreduce to complete in the background */
+#define TUNING_AGREE_CALLS 8
+
+/*
+ * The candidates of a bucket only depend on the bucket, so that all the
+ * processes try them in the same order. The chains only pay off with
+ * enough segments to fill the pipeline.
+ */
+static void tuning_bucket_init(ompi_coll_adapt_tuning_bucket_t *bucket, int index)
+{
+    size_t bytes = (size_t) 1 << index;
+    int n = 0;
+
+    for (size_t s = 0; s < sizeof(tuning_seg_sizes) / sizeof(tuning_seg_sizes[0]); s++) {
+        size_t seg_size = tuning_seg_sizes[s];
+
+        if (0 == seg_size ? bytes > TUNING_MAX_UNSEGMENTED
+            : (bytes < TUNING_MIN_SEGS * seg_size || bytes / seg_size > TUNING_MAX_SEGS)) {
+            continue;
+        }
+        for (size_t t = 0; t < sizeof(tuning_trees) / sizeof(tuning_trees[0]); t++) {
+            if (0 == seg_size && (OMPI_COLL_ADAPT_ALGORITHM_CHAIN == tuning_trees[t]
+                                  || OMPI_COLL_ADAPT_ALGORITHM_PIPELINE == tuning_trees[t])) {
+                continue;
+            }
+            bucket->candidates[n].algorithm = tuning_trees[t];
+            bucket->candidates[n].seg_size = seg_size;
+            bucket->best[n] = 0.0;
+            n++;
+        }
+    }
+    bucket->num_candidates = n;
+    bucket->num_calls = 0;
+    bucket->selected = (1 == n) ? 0 : -1;
+    bucket->agree_req = NULL;
+    bucket->agree_buf = NULL;
+}
+
+/*
+ * Choose the candidate with the lowest maximum time over the processes.
+ * The measurements of the trials still running are missing (0), and the
+ * maximum ignores them as long as one process measured the candidate.
+ */
+static void tuning_bucket_decide(ompi_coll_adapt_tuning_bucket_t *bucket, const double *best,
+                                 struct ompi_communicator_t *comm, int index)
+{
+    bucket->selected = 0;
+    for (int i = 1; i < bucket->num_candidates; i++) {
+        if (best[i] > 0.0 && (best[bucket->selected] <= 0.0 || best[i] < best[bucket->selected])) {
+            bucket->selected = i;
+        }
+    }
+    opal_output_verbose(10, mca_coll_adapt_component.adapt_output,
+                        "coll:adapt:tuning (%s): messages of %zu bytes and more use algorithm %d "
+                        "with segments of %zu bytes (%g us/KB)",
+                        ompi_comm_print_cid(comm), (size_t) 1 << index,
+                        bucket->candidates[bucket->selected].algorithm,
+                        bucket->candidates[bucket->selected].seg_size,
+                        best[bucket->selected] * 1024.0);
+}
+
+/* Start the allreduce of the measurements of the trials. Those of the
+ * trials still running are missing, see tuning_bucket_decide(). */
+static int tuning_bucket_agree_start(ompi_coll_adapt_tuning_t *tuning,
+                                     ompi_coll_adapt_tuning_bucket_t *bucket,
+                                     struct ompi_communicator_t *comm)
+{
+    ompi_request_t *request;
+    int err;
+
+    bucket->agree_buf = (double *) malloc(bucket->num_candidates * sizeof(double));
+    if (NULL == bucket->agree_buf) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    OPAL_THREAD_LOCK(&tuning->lock);
+    memcpy(bucket->agree_buf, bucket->best, bucket->num_candidates * sizeof(double));
+    OPAL_THREAD_UNLOCK(&tuning->lock);
+
+    err = comm->c_coll->coll_iallreduce(MPI_IN_PLACE, bucket->agree_buf, bucket->num_candidates,
+                                        MPI_DOUBLE, MPI_MAX, comm, &request,
+                                        comm->c_coll->coll_iallreduce_module);
+    if (OMPI_SUCCESS != err) {
+        free(bucket->agree_buf);
+        bucket->agree_buf = NULL;
+        return err;
+    }
+    bucket->agree_req = request;
+    return OMPI_SUCCESS;
+}
+
+/* Wait for the allreduce started TUNING_AGREE_CALLS calls earlier, which
+ * all the processes started, and choose the candidate */
+static int tuning_bucket_agree_finish(ompi_coll_adapt_tuning_bucket_t *bucket,
+                                      struct ompi_communicator_t *comm, int index)
+{
+    int err = ompi_request_wait(&bucket->agree_req, MPI_STATUS_IGNORE);
+
+    bucket->agree_req = NULL;
+    if (OMPI_SUCCESS == err) {
+        tuning_bucket_decide(bucket, bucket->agree_buf, comm, index);
+    }
+    free(bucket->agree_buf);
+    bucket->agree_buf = NULL;
+    return err;
+}
+
+void ompi_coll_adapt_tuning_fini(ompi_coll_adapt_tuning_t *tuning)
+{
+    for (int i = 0; i < OMPI_COLL_ADAPT_TUNING_BUCKETS; i++) {
+        ompi_coll_adapt_tuning_bucket_t *bucket = tuning->buckets[i];
+        if (NULL != bucket && NULL != bucket->agree_req) {
+            (void) ompi_request_wait(&bucket->agree_req, MPI_STATUS_IGNORE);
+            bucket->agree_req = NULL;
+        }
+    }
+}
+
+int ompi_coll_adapt_tuning_select(ompi_coll_adapt_tuning_t **tuning,
+                                  struct ompi_communicator_t *comm, size_t bytes,
+                                  ompi_coll_adapt_algorithm_t *algorithm, size_t *seg_size,
+                                  ompi_coll_adapt_tuning_probe_t *probe)
+{
+    ompi_coll_adapt_tuning_bucket_t *bucket;
+    int index = 0, call, err = OMPI_SUCCESS, trials = mca_coll_adapt_component.adapt_tuning_trials;
+
+    probe->tuning = NULL;
+    if (NULL == *tuning) {
+        *tuning = OBJ_NEW(ompi_coll_adapt_tuning_t);
+        if (NULL == *tuning) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+    }
+    while (index < OMPI_COLL_ADAPT_TUNING_BUCKETS - 1 && (bytes >> (index + 1)) > 0) {
+        index++;
+    }
+
+    bucket = (*tuning)->buckets[index];
+    if (NULL == bucket) {
+        bucket = (ompi_coll_adapt_tuning_bucket_t *) malloc(sizeof(*bucket));
+        if (NULL == bucket) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        tuning_bucket_init(bucket, index);
+        (*tuning)->buckets[index] = bucket;
+    }
+
+    if (bucket->selected >= 0) {
+        *algorithm = bucket->candidates[bucket->selected].algorithm;
+        *seg_size = bucket->candidates[bucket->selected].seg_size;
+        return OMPI_SUCCESS;
+    }
+
+    /* Try the candidates in turn, trials times each, then agree on one. The
+     * call that starts the agreement and the following ones use the fixed
+     * defaults, until the one that applies it (forever if it failed to
+     * start). */
+    call = bucket->num_calls++;
+    if (call >= bucket->num_candidates * trials) {
+        call -= bucket->num_candidates * trials;
+        if (0 == call) {
+            err = tuning_bucket_agree_start(*tuning, bucket, comm);
+        } else if (TUNING_AGREE_CALLS == call && NULL != bucket->agree_req) {
+            err = tuning_bucket_agree_finish(bucket, comm, index);
+            if (OMPI_SUCCESS == err) {
+                *algorithm = bucket->candidates[bucket->selected].algorithm;
+                *seg_size = bucket->candidates[bucket->selected].seg_size;
+                return OMPI_SUCCESS;
+            }
+        }
+        *algorithm = OMPI_COLL_ADAPT_ALGORITHM_BINOMIAL;
+        return err;
+    }
+    probe->candidate = call % bucket->num_candidates;
+    *algorithm = bucket->candidates[probe->candidate].algorithm;
+    *seg_size = bucket->candidates[probe->candidate].seg_size;
+
+    OBJ_RETAIN(*tuning);
+    probe->tuning = *tuning;
+    probe->bucket = index;
+    probe->bytes = bytes;
+    probe->start = opal_timer_base_get_usec();
+    return OMPI_SUCCESS;
+}
+
+void ompi_coll_adapt_tuning_record(ompi_coll_adapt_tuning_probe_t *probe)
+{
+    ompi_coll_adapt_tuning_t *tuning = probe->tuning;
+    ompi_coll_adapt_tuning_bucket_t *bucket;
+    double usec_per_byte;
+
+    if (NULL == tuning) {
+        return;
+    }
+    /* below the resolution of the timer, count half a microsecond so that
+     * the candidate is still seen as measured */
+    usec_per_byte = (double) (opal_timer_base_get_usec() - probe->start);
+    if (usec_per_byte < 0.5) {
+        usec_per_byte = 0.5;
+    }
+    usec_per_byte /= (double) probe->bytes;
+
+    bucket = tuning->buckets[probe->bucket];
+    OPAL_THREAD_LOCK(&tuning->lock);
+    if (0.0 == bucket->best[probe->candidate] || usec_per_byte < bucket->best[probe->candidate]) {
+        bucket->best[probe->candidate] = usec_per_byte;
+    }
+    OPAL_THREAD_UNLOCK(&tuning->lock);
+
+    probe->tuning = NULL;
+    OBJ_RELEASE(tuning);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef MCA_COLL_ADAPT_TUNING_H
+#define MCA_COLL_ADAPT_TUNING_H
+
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/adapt/coll_adapt.h"
+#include "opal/class/opal_object.h"
+#include "opal/mca/threads/mutex.h"
+#include "opal/mca/timer/base/base.h"
+
+/*
+ * Runtime selection of the tree and of the segment size of ibcast and
+ * ireduce (algorithm OMPI_COLL_ADAPT_ALGORITHM_ADAPTIVE). The messages are
+ * grouped by power of two of their size in bytes. For the first calls in a
+ * group, all the processes try in turn the same candidates (tree, segment
+ * size), and each process measures the time per byte until its part of the
+ * collective completes. Once all the candidates have been tried, the
+ * processes agree on the candidate with the lowest maximum time, which is
+ * used for all the later calls in the group on this communicator.
+ *
+ * Starting a nonblocking collective must not block, so the agreement is a
+ * nonblocking allreduce, started by the first call after the trials. Its
+ * result is applied a fixed number of calls later, when all the processes
+ * wait for it: the candidate of a call only depends on the number of calls
+ * before it, so the processes never use different trees for the same call.
+ * The calls in between use the binomial tree with the configured segment
+ * size, as without the adaptive algorithm.
+ */
+
+#define OMPI_COLL_ADAPT_TUNING_BUCKETS        64
+#define OMPI_COLL_ADAPT_TUNING_MAX_CANDIDATES 24
+
+typedef struct ompi_coll_adapt_tuning_candidate_t {
+    ompi_coll_adapt_algorithm_t algorithm;
+    size_t seg_size;
+} ompi_coll_adapt_tuning_candidate_t;
+
+typedef struct ompi_coll_adapt_tuning_bucket_t {
+    int num_candidates;
+    /* Number of calls started in this bucket, to pick the candidate to try */
+    int num_calls;
+    /* Index of the chosen candidate, -1 until the processes agree on it */
+    int selected;
+    /* Allreduce of the measurements, and its buffer, while the processes agree */
+    struct ompi_request_t *agree_req;
+    double *agree_buf;
+    ompi_coll_adapt_tuning_candidate_t candidates[OMPI_COLL_ADAPT_TUNING_MAX_CANDIDATES];
+    /* Lowest time per byte measured for each candidate, 0 if none */
+    double best[OMPI_COLL_ADAPT_TUNING_MAX_CANDIDATES];
+} ompi_coll_adapt_tuning_bucket_t;
+
+/* Tuning state of one collective on one communicator. The requests retain
+ * it until they complete, as they may outlive the module. */
+typedef struct ompi_coll_adapt_tuning_t {
+    opal_object_t super;
+    opal_mutex_t lock;
+    ompi_coll_adapt_tuning_bucket_t *buckets[OMPI_COLL_ADAPT_TUNING_BUCKETS];
+} ompi_coll_adapt_tuning_t;
+
+OBJ_CLASS_DECLARATION(ompi_coll_adapt_tuning_t);
+
+/* Measurement of one call, stored in the constant context of the request */
+typedef struct ompi_coll_adapt_tuning_probe_t {
+    ompi_coll_adapt_tuning_t *tuning;
+    int bucket;
+    int candidate;
+    size_t bytes;
+    opal_timer_t start;
+} ompi_coll_adapt_tuning_probe_t;
+
+/*
+ * Select the tree and the segment size of a call moving bytes bytes per
+ * process. *tuning is created on the first call. If the call is a trial,
+ * probe is armed and must be passed to ompi_coll_adapt_tuning_record() when
+ * the request completes; otherwise probe->tuning is NULL.
+ */
+int ompi_coll_adapt_tuning_select(ompi_coll_adapt_tuning_t **tuning,
+                                  struct ompi_communicator_t *comm, size_t bytes,
+                                  ompi_coll_adapt_algorithm_t *algorithm, size_t *seg_size,
+                                  ompi_coll_adapt_tuning_probe_t *probe);
+
+void ompi_coll_adapt_tuning_record(ompi_coll_adapt_tuning_probe_t *probe);
+
+/*
+ * Complete the agreements still running, before the communicator goes
+ * away. Called when the module is destroyed.
+ */
+void ompi_coll_adapt_tuning_fini(ompi_coll_adapt_tuning_t *tuning);
+
+#endif /* MCA_COLL_ADAPT_TUNING_H */
@@ -268,8 +268,9 @@ int ompi_coll_base_allgather_intra_sparbit(const void *sbuf, size_t scount,
     }
     tmpsend = tmprecv;
 
-    requests = (MPI_Request *) malloc(comm_size * sizeof(MPI_Request));
-    
+    requests = ompi_coll_base_comm_get_reqs(module->base_data, comm_size);
+    if (NULL == requests) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+
     /* ################# ALGORITHM LOGIC ######################## */
 
     /* calculate log2 of the total process count */
@@ -301,8 +302,6 @@ int ompi_coll_base_allgather_intra_sparbit(const void *sbuf, size_t scount,
        data_expected = (data_expected << 1) - exclusion;
        exclusion = 0;
     }
-    
-    free(requests);
 
     return OMPI_SUCCESS;
 
@@ -796,7 +795,8 @@ int ompi_coll_base_allgather_intra_k_bruck(const void *sbuf, size_t scount,
     if (0 != rank) {
         /* Compute the temporary buffer size, including datatypes empty gaps */
         rsize = opal_datatype_span(&rdtype->super, (size_t)rcount * (size - rank), &rgap);
-        tmp_buf = (char *) malloc(rsize);
+        tmp_buf = (char *) ompi_coll_base_comm_get_scratch(module->base_data, rsize);
+        if (NULL == tmp_buf) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
         tmp_buf_start = tmp_buf - rgap;
     }
 
@@ -891,7 +891,7 @@ int ompi_coll_base_allgather_intra_k_bruck(const void *sbuf, size_t scount,
         if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
     }
 
-    if(tmp_buf != NULL) free(tmp_buf);
+    ompi_coll_base_comm_put_scratch(module->base_data, tmp_buf);
     return MPI_SUCCESS;
 
 err_hndl:
@@ -910,11 +910,9 @@ err_hndl:
     }
     OPAL_OUTPUT((ompi_coll_base_framework.framework_output,  "%s:%4d\tError occurred %d, rank %2d",
                  __FILE__, line, err, rank));
-    if(tmp_buf != NULL) {
-        free(tmp_buf);
-        tmp_buf = NULL;
-        tmp_buf_start = NULL;
-    }
+    ompi_coll_base_comm_put_scratch(module->base_data, tmp_buf);
+    tmp_buf = NULL;
+    tmp_buf_start = NULL;
     (void)line;  // silence compiler warning
     return err;
 }
@@ -1017,3 +1015,214 @@ err_hndl:
     return err;
 }
 /* copied function (with appropriate renaming) ends here */
+
+/*
+ * ompi_coll_base_allgather_intra_recursive_multiplying
+ *
+ * Function:     allgather using O(log_k(N)) steps.
+ * Accepts:      Same arguments as MPI_Allgather, radix
+ * Returns:      MPI_SUCCESS or error code
+ *
+ * Description:  Generalization of recursive doubling to a radix k, and the
+ *               counterpart of the radix-k reduce_scatter_block: the ranks
+ *               are split in groups of k at distance 1, k, k^2... and in
+ *               each of the log_k(p') steps every rank sends the blocks it
+ *               has gathered so far to the k-1 other members of its group,
+ *               and receives theirs. The bandwidth term is the optimal
+ *               m(1-1/p)\beta, the latency term log_k(p)\alpha with k-1
+ *               concurrent messages per step.
+ *               For a non-power of k number of processes, the ranks above
+ *               the largest power of k p' hand their block to rank rank % p'
+ *               and receive the whole result at the end. The blocks are
+ *               then gathered in a temporary buffer, the block of every
+ *               folded rank following the one of the rank it is attached
+ *               to, and put back in order in the receive buffer.
+ *
+ * Memory requirements: a temporary buffer of the size of the receive
+ *               buffer when the number of processes is not a power of k.
+ *
+ * Example on 11 nodes, k = 3 (p' = 9):
+ *   Fold:    9 -> 0, 10 -> 1 (buffer order: 0 9 1 10 2 3 4 5 6 7 8)
+ *   Step 0:  {0,1,2} {3,4,5} {6,7,8} exchange their blocks
+ *   Step 1:  {0,3,6} {1,4,7} {2,5,8} exchange the blocks of their groups
+ *   Unfold:  0 -> 9, 1 -> 10
+ */
+int ompi_coll_base_allgather_intra_recursive_multiplying(const void *sbuf, size_t scount,
+                                                         struct ompi_datatype_t *sdtype,
+                                                         void* rbuf, size_t rcount,
+                                                         struct ompi_datatype_t *rdtype,
+                                                         struct ompi_communicator_t *comm,
+                                                         mca_coll_base_module_t *module,
+                                                         int radix)
+{
+    int line = -1, rank, size, peer, err = MPI_SUCCESS;
+    int pof_k, nfold, distance, digit, start, j;
+    ptrdiff_t rlb, rextent, blocksize;
+    ptrdiff_t rsize, rgap = 0;
+    size_t q, rem, lo, len;
+    ompi_request_t **reqs = NULL;
+    int num_reqs, max_reqs = 0;
+
+    char *tmpsend = NULL;
+    char *tmp_buf = NULL;
+    char *vbuf = NULL;
+
+    rank = ompi_comm_rank(comm);
+    size = ompi_comm_size(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allgather_intra_recursive_multiplying radix %d rank %d", radix, rank));
+    err = ompi_datatype_get_extent (rdtype, &rlb, &rextent);
+    if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    blocksize = (ptrdiff_t)rcount * rextent;
+
+    if (MPI_IN_PLACE != sbuf) {
+        tmpsend = (char*) sbuf;
+    } else {
+        tmpsend = (char*) rbuf + (ptrdiff_t)rank * blocksize;
+        scount = rcount;
+        sdtype = rdtype;
+    }
+
+    if (1 == size) {
+        if (MPI_IN_PLACE != sbuf) {
+            err = ompi_datatype_sndrcv(tmpsend, scount, sdtype, rbuf, rcount, rdtype);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        return MPI_SUCCESS;
+    }
+
+    if (radix < 2) {
+        radix = 2;
+    }
+    if (radix > size) {
+        radix = size;
+    }
+    /* Largest power of radix less than or equal to size */
+    for (pof_k = radix; pof_k <= size / radix; pof_k *= radix);
+    /* Vranks below pof_k own q or q + 1 consecutive blocks of the buffer */
+    q = size / pof_k;
+    rem = size % pof_k;
+
+    /* Fold: the ranks above pof_k only contribute their block and get the result */
+    if (rank >= pof_k) {
+        err = MCA_PML_CALL(send(tmpsend, scount, sdtype, rank % pof_k,
+                                MCA_COLL_BASE_TAG_ALLGATHER,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        err = MCA_PML_CALL(recv(rbuf, (size_t)size * rcount, rdtype, rank % pof_k,
+                                MCA_COLL_BASE_TAG_ALLGATHER, comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        return MPI_SUCCESS;
+    }
+    nfold = (size - 1 - rank) / pof_k;
+
+    if (size == pof_k) {
+        vbuf = (char*) rbuf;
+    } else {
+        /* Compute the temporary buffer size, including datatypes empty gaps */
+        rsize = opal_datatype_span(&rdtype->super, (size_t)size * rcount, &rgap);
+        tmp_buf = (char *) ompi_coll_base_comm_get_scratch(module->base_data, rsize);
+        if (NULL == tmp_buf) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+        vbuf = tmp_buf - rgap;
+    }
+
+    max_reqs = 2 * (radix - 1);
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, max_reqs);
+    if (NULL == reqs) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto err_hndl; }
+
+    /* Our block, followed by the ones of the folded ranks */
+    lo = ompi_coll_base_split_offset(rank, q, rem);
+    if (MPI_IN_PLACE != sbuf || vbuf != (char*) rbuf) {
+        err = ompi_datatype_sndrcv(tmpsend, scount, sdtype,
+                                   vbuf + (ptrdiff_t)lo * blocksize, rcount, rdtype);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    for (j = 0; j < nfold; j++) {
+        err = MCA_PML_CALL(irecv(vbuf + (ptrdiff_t)(lo + j + 1) * blocksize, rcount, rdtype,
+                                 rank + (j + 1) * pof_k, MCA_COLL_BASE_TAG_ALLGATHER,
+                                 comm, &reqs[j]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    if (nfold > 0) {
+        err = ompi_request_wait_all(nfold, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    /*
+     * Exchange within the groups of radix ranks at distance 1, radix,
+     * radix^2...: member j of the group holds the blocks of the distance
+     * vranks from start + j * distance.
+     */
+    for (distance = 1; distance < pof_k; distance *= radix) {
+        digit = (rank / distance) % radix;
+        start = rank - rank % (radix * distance);
+        lo = ompi_coll_base_split_offset(start + digit * distance, q, rem);
+        len = ompi_coll_base_split_offset(start + (digit + 1) * distance, q, rem) - lo;
+
+        num_reqs = 0;
+        for (j = 0; j < radix; j++) {
+            size_t jlo, jlen;
+            if (j == digit) continue;
+            peer = rank + (j - digit) * distance;
+            jlo = ompi_coll_base_split_offset(start + j * distance, q, rem);
+            jlen = ompi_coll_base_split_offset(start + (j + 1) * distance, q, rem) - jlo;
+            err = MCA_PML_CALL(irecv(vbuf + (ptrdiff_t)jlo * blocksize, jlen * rcount, rdtype,
+                                     peer, MCA_COLL_BASE_TAG_ALLGATHER, comm,
+                                     &reqs[num_reqs++]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+            err = MCA_PML_CALL(isend(vbuf + (ptrdiff_t)lo * blocksize, len * rcount, rdtype,
+                                     peer, MCA_COLL_BASE_TAG_ALLGATHER,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[num_reqs++]));
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+        err = ompi_request_wait_all(num_reqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    if (vbuf != (char*) rbuf) {
+        /* Put the blocks back in rank order */
+        for (int b = 0; b < size; b++) {
+            lo = ompi_coll_base_split_offset(b % pof_k, q, rem) + b / pof_k;
+            err = ompi_datatype_copy_content_same_ddt(rdtype, rcount,
+                                                      (char*) rbuf + (ptrdiff_t)b * blocksize,
+                                                      vbuf + (ptrdiff_t)lo * blocksize);
+            if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+        }
+    }
+
+    /* Unfold: send the result to the ranks above pof_k */
+    for (j = 0; j < nfold; j++) {
+        err = MCA_PML_CALL(isend(rbuf, (size_t)size * rcount, rdtype, rank + (j + 1) * pof_k,
+                                 MCA_COLL_BASE_TAG_ALLGATHER, MCA_PML_BASE_SEND_STANDARD,
+                                 comm, &reqs[j]));
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+    if (nfold > 0) {
+        err = ompi_request_wait_all(nfold, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { line = __LINE__; goto err_hndl; }
+    }
+
+    ompi_coll_base_comm_put_scratch(module->base_data, tmp_buf);
+    return MPI_SUCCESS;
+
+err_hndl:
+    if( NULL != reqs ) {
+        if (MPI_ERR_IN_STATUS == err) {
+            for( num_reqs = 0; num_reqs < max_reqs; num_reqs++ ) {
+                if (MPI_REQUEST_NULL == reqs[num_reqs]) continue;
+                if (MPI_ERR_PENDING == reqs[num_reqs]->req_status.MPI_ERROR) continue;
+                if (reqs[num_reqs]->req_status.MPI_ERROR != MPI_SUCCESS) {
+                    err = reqs[num_reqs]->req_status.MPI_ERROR;
+                    break;
+                }
+            }
+        }
+        ompi_coll_base_free_reqs(reqs, max_reqs);
+    }
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,  "%s:%4d\tError occurred %d, rank %2d",
+                 __FILE__, line, err, rank));
+    ompi_coll_base_comm_put_scratch(module->base_data, tmp_buf);
+    (void)line;  // silence compiler warning
+    return err;
+}
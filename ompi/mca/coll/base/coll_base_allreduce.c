@@ -160,7 +160,7 @@ ompi_coll_base_allreduce_intra_recursivedoubling(const void *sbuf, void *rbuf,
 
     /* Allocate and initialize temporary send buffer */
     span = opal_datatype_span(&dtype->super, count, &gap);
-    inplacebuf_free = (char*) malloc(span);
+    inplacebuf_free = (char*) ompi_coll_base_comm_get_scratch(module->base_data, span);
     if (NULL == inplacebuf_free) { ret = -1; line = __LINE__; goto error_hndl; }
     inplacebuf = inplacebuf_free - gap;
 
@@ -266,14 +266,14 @@ ompi_coll_base_allreduce_intra_recursivedoubling(const void *sbuf, void *rbuf,
         if (ret < 0) { line = __LINE__; goto error_hndl; }
     }
 
-    if (NULL != inplacebuf_free) free(inplacebuf_free);
+    ompi_coll_base_comm_put_scratch(module->base_data, inplacebuf_free);
     return MPI_SUCCESS;
 
  error_hndl:
     OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "%s:%4d\tRank %d Error occurred %d\n",
                  __FILE__, line, rank, ret));
     (void)line;  // silence compiler warning
-    if (NULL != inplacebuf_free) free(inplacebuf_free);
+    ompi_coll_base_comm_put_scratch(module->base_data, inplacebuf_free);
     return ret;
 }
 
@@ -401,10 +401,10 @@ ompi_coll_base_allreduce_intra_ring(const void *sbuf, void *rbuf, size_t count,
     max_real_segsize = true_extent + (max_segcount - 1) * extent;
 
 
-    inbuf[0] = (char*)malloc(max_real_segsize);
+    inbuf[0] = (char*)ompi_coll_base_comm_get_scratch(module->base_data, max_real_segsize);
     if (NULL == inbuf[0]) { ret = -1; line = __LINE__; goto error_hndl; }
     if (size > 2) {
-        inbuf[1] = (char*)malloc(max_real_segsize);
+        inbuf[1] = (char*)ompi_coll_base_comm_get_scratch(module->base_data, max_real_segsize);
         if (NULL == inbuf[1]) { ret = -1; line = __LINE__; goto error_hndl; }
     }
 
@@ -524,8 +524,8 @@ ompi_coll_base_allreduce_intra_ring(const void *sbuf, void *rbuf, size_t count,
 
     }
 
-    if (NULL != inbuf[0]) free(inbuf[0]);
-    if (NULL != inbuf[1]) free(inbuf[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf[0]);
 
     return MPI_SUCCESS;
 
@@ -534,8 +534,8 @@ ompi_coll_base_allreduce_intra_ring(const void *sbuf, void *rbuf, size_t count,
                  __FILE__, line, rank, ret));
     ompi_coll_base_free_reqs(reqs, 2);
     (void)line;  // silence compiler warning
-    if (NULL != inbuf[0]) free(inbuf[0]);
-    if (NULL != inbuf[1]) free(inbuf[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf[0]);
     return ret;
 }
 
@@ -689,10 +689,10 @@ ompi_coll_base_allreduce_intra_ring_segmented(const void *sbuf, void *rbuf, size
      max_real_segsize = opal_datatype_span(&dtype->super, max_segcount, &gap);
 
     /* Allocate and initialize temporary buffers */
-    inbuf[0] = (char*)malloc(max_real_segsize);
+    inbuf[0] = (char*)ompi_coll_base_comm_get_scratch(module->base_data, max_real_segsize);
     if (NULL == inbuf[0]) { ret = -1; line = __LINE__; goto error_hndl; }
     if (size > 2) {
-        inbuf[1] = (char*)malloc(max_real_segsize);
+        inbuf[1] = (char*)ompi_coll_base_comm_get_scratch(module->base_data, max_real_segsize);
         if (NULL == inbuf[1]) { ret = -1; line = __LINE__; goto error_hndl; }
     }
 
@@ -844,8 +844,8 @@ ompi_coll_base_allreduce_intra_ring_segmented(const void *sbuf, void *rbuf, size
 
     }
 
-    if (NULL != inbuf[0]) free(inbuf[0]);
-    if (NULL != inbuf[1]) free(inbuf[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf[0]);
 
     return MPI_SUCCESS;
 
@@ -854,8 +854,8 @@ ompi_coll_base_allreduce_intra_ring_segmented(const void *sbuf, void *rbuf, size
                  __FILE__, line, rank, ret));
     ompi_coll_base_free_reqs(reqs, 2);
     (void)line;  // silence compiler warning
-    if (NULL != inbuf[0]) free(inbuf[0]);
-    if (NULL != inbuf[1]) free(inbuf[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf[0]);
     return ret;
 }
 
@@ -1006,7 +1006,7 @@ int ompi_coll_base_allreduce_intra_redscat_allgather(
 
     /* Temporary buffer for receiving messages */
     char *tmp_buf = NULL;
-    char *tmp_buf_raw = (char *)malloc(dsize);
+    char *tmp_buf_raw = (char *)ompi_coll_base_comm_get_scratch(module->base_data, dsize);
     if (NULL == tmp_buf_raw)
         return OMPI_ERR_OUT_OF_RESOURCE;
     tmp_buf = tmp_buf_raw - gap;
@@ -1111,14 +1111,14 @@ int ompi_coll_base_allreduce_intra_redscat_allgather(
      * buffers are recursively halved, and the distance is doubled. At the end,
      * each of the p' processes has 1 / p' of the total reduction result.
      */
-    rindex = malloc(sizeof(*rindex) * nsteps);
-    sindex = malloc(sizeof(*sindex) * nsteps);
-    rcount = malloc(sizeof(*rcount) * nsteps);
-    scount = malloc(sizeof(*scount) * nsteps);
-    if (NULL == rindex || NULL == sindex || NULL == rcount || NULL == scount) {
+    rindex = (int *)ompi_coll_base_comm_get_scratch(module->base_data, 4 * sizeof(*rindex) * nsteps);
+    if (NULL == rindex) {
         err = OMPI_ERR_OUT_OF_RESOURCE;
         goto cleanup_and_return;
     }
+    sindex = rindex + nsteps;
+    rcount = sindex + nsteps;
+    scount = rcount + nsteps;
 
     if (vrank != -1) {
         step = 0;
@@ -1234,16 +1234,8 @@ int ompi_coll_base_allreduce_intra_redscat_allgather(
     }
 
   cleanup_and_return:
-    if (NULL != tmp_buf_raw)
-        free(tmp_buf_raw);
-    if (NULL != rindex)
-        free(rindex);
-    if (NULL != sindex)
-        free(sindex);
-    if (NULL != rcount)
-        free(rcount);
-    if (NULL != scount)
-        free(scount);
+    ompi_coll_base_comm_put_scratch(module->base_data, rindex);
+    ompi_coll_base_comm_put_scratch(module->base_data, tmp_buf_raw);
     return err;
 }
 
@@ -1342,3 +1334,598 @@ err_hndl:
 
 }
 /* copied function (with appropriate renaming) ends here */
+
+/*
+ *   ompi_coll_base_allreduce_intra_recursive_multiplying
+ *
+ *   Function:       Recursive multiplying algorithm for allreduce operation
+ *   Accepts:        Same as MPI_Allreduce(), radix
+ *   Returns:        MPI_SUCCESS or error code
+ *
+ *   Description:    Generalization of recursive doubling to a radix k: the
+ *                   ranks are split in groups of k at distance 1, k, k^2...
+ *                   and in each of the log_k(p) steps every rank exchanges its
+ *                   whole buffer with the k-1 other members of its group, so
+ *                   the number of steps on the critical path is divided by
+ *                   log2(k) compared to recursive doubling, at the price of
+ *                   k-1 concurrent messages per step.
+ *                   For a non-power of k number of processes, the ranks above
+ *                   the largest power of k p' first hand their data to rank
+ *                   (rank - p') % p', and get the result back at the end.
+ *                   All the members of a group reduce the k buffers in the
+ *                   same order, so all ranks get the same result.
+ *
+ *   Limitations:    The algorithm does not preserve the order of operations,
+ *                   non-commutative operations fall back to recursive
+ *                   doubling. It needs (k-1) temporary buffers of the size of
+ *                   the message, and is aimed at small and medium messages.
+ *
+ *         Example on 11 nodes, k = 3 (p' = 9):
+ *         Fold:     9 -> 0, 10 -> 1
+ *         Step 0:   {0,1,2} {3,4,5} {6,7,8} exchange with each other
+ *         Step 1:   {0,3,6} {1,4,7} {2,5,8} exchange with each other
+ *         Unfold:   0 -> 9, 1 -> 10
+ */
+int
+ompi_coll_base_allreduce_intra_recursive_multiplying(const void *sbuf, void *rbuf,
+                                                     size_t count,
+                                                     struct ompi_datatype_t *dtype,
+                                                     struct ompi_op_t *op,
+                                                     struct ompi_communicator_t *comm,
+                                                     mca_coll_base_module_t *module,
+                                                     int radix)
+{
+    int ret = MPI_SUCCESS, line, rank, size, pof_k, distance, digit, base, peer, j, nreqs = 0, max_reqs = 0;
+    char *tmpbuf_free = NULL, *tmpbuf, *acc, *src;
+    ompi_request_t **reqs = NULL;
+    ptrdiff_t span, gap = 0;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    if (!ompi_op_is_commute(op)) {
+        OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                     "coll:base:allreduce_intra_recursive_multiplying: rank %d/%d "
+                     "switching to recursive doubling for a non-commutative operation",
+                     rank, size));
+        return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype,
+                                                                 op, comm, module);
+    }
+
+    if (radix < 2) {
+        radix = 2;
+    }
+    if (radix > size) {
+        radix = size;
+    }
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allreduce_intra_recursive_multiplying rank %d radix %d", rank, radix));
+
+    if (MPI_IN_PLACE != sbuf) {
+        ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        if (ret < 0) { line = __LINE__; goto error_hndl; }
+    }
+
+    /* Special case for size == 1 */
+    if (1 == size) {
+        return MPI_SUCCESS;
+    }
+
+    /* One temporary buffer per peer of a group */
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    tmpbuf_free = (char*) ompi_coll_base_comm_get_scratch(module->base_data, span * (radix - 1));
+    if (NULL == tmpbuf_free) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+    tmpbuf = tmpbuf_free - gap;
+
+    max_reqs = 2 * (radix - 1);
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, max_reqs);
+    if (NULL == reqs) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+
+    /* Largest power of radix less than or equal to size */
+    for (pof_k = radix; pof_k <= size / radix; pof_k *= radix);
+
+    /* Fold: as size < radix * pof_k, each of the first pof_k ranks gets the
+     * data of at most radix - 1 of the remaining ones */
+    if (rank >= pof_k) {
+        ret = MCA_PML_CALL(send(rbuf, count, dtype, (rank - pof_k) % pof_k,
+                                MCA_COLL_BASE_TAG_ALLREDUCE,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    } else if (rank + pof_k < size) {
+        for (nreqs = 0, peer = rank + pof_k; peer < size; peer += pof_k, nreqs++) {
+            ret = MCA_PML_CALL(irecv(tmpbuf + (ptrdiff_t)nreqs * span, count, dtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE, comm, &reqs[nreqs]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+        ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        for (j = 0; j < nreqs; j++) {
+            ompi_op_reduce(op, tmpbuf + (ptrdiff_t)j * span, rbuf, count, dtype);
+        }
+    }
+
+    /* Exchange within the groups of radix ranks at distance 1, radix, radix^2... */
+    for (distance = 1; rank < pof_k && distance < pof_k; distance *= radix) {
+        digit = (rank / distance) % radix;
+        base = rank - digit * distance;
+
+        /* the buffer of member j (other than us) goes in slot j, or j-1 past us */
+        nreqs = 0;
+        for (j = 0; j < radix; j++) {
+            if (j == digit) continue;
+            peer = base + j * distance;
+            ret = MCA_PML_CALL(irecv(tmpbuf + (ptrdiff_t)(j < digit ? j : j - 1) * span,
+                                     count, dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            ret = MCA_PML_CALL(isend(rbuf, count, dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+        ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+        /* acc = buf[0] (op) (buf[1] (op) ... buf[radix-1]), the same on all members */
+        acc = (digit == radix - 1) ? (char*)rbuf : tmpbuf + (ptrdiff_t)(radix - 2) * span;
+        for (j = radix - 2; j >= 0; j--) {
+            src = (j == digit) ? (char*)rbuf : tmpbuf + (ptrdiff_t)(j < digit ? j : j - 1) * span;
+            ompi_op_reduce(op, src, acc, count, dtype);
+        }
+        if (acc != (char*)rbuf) {
+            ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, acc);
+            if (ret < 0) { line = __LINE__; goto error_hndl; }
+        }
+    }
+
+    /* Unfold: send the result back to the ranks above pof_k */
+    if (rank >= pof_k) {
+        ret = MCA_PML_CALL(recv(rbuf, count, dtype, (rank - pof_k) % pof_k,
+                                MCA_COLL_BASE_TAG_ALLREDUCE, comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    } else if (rank + pof_k < size) {
+        for (nreqs = 0, peer = rank + pof_k; peer < size; peer += pof_k, nreqs++) {
+            ret = MCA_PML_CALL(isend(rbuf, count, dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+        ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    }
+
+    ompi_coll_base_comm_put_scratch(module->base_data, tmpbuf_free);
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "%s:%4d\tRank %d Error occurred %d\n",
+                 __FILE__, line, rank, ret));
+    (void)line;  // silence compiler warning
+    if (NULL != reqs) {
+        if (MPI_ERR_IN_STATUS == ret) {
+            for (j = 0; j < max_reqs; j++) {
+                if (MPI_REQUEST_NULL == reqs[j]) continue;
+                if (MPI_ERR_PENDING == reqs[j]->req_status.MPI_ERROR) continue;
+                if (reqs[j]->req_status.MPI_ERROR != MPI_SUCCESS) {
+                    ret = reqs[j]->req_status.MPI_ERROR;
+                    break;
+                }
+            }
+        }
+        ompi_coll_base_free_reqs(reqs, max_reqs);
+    }
+    ompi_coll_base_comm_put_scratch(module->base_data, tmpbuf_free);
+    return ret;
+}
+
+/*
+ *   ompi_coll_base_allreduce_intra_swing
+ *
+ *   Function:       Swing algorithm for allreduce operation
+ *   Accepts:        Same as MPI_Allreduce()
+ *   Returns:        MPI_SUCCESS or error code
+ *
+ *   Description:    Latency-optimal variant of the Swing allreduce (D. De Sensi
+ *                   et al., "Swing: Short-cutting Rings for Higher Bandwidth
+ *                   Allreduce", NSDI 2024). Like recursive doubling it takes
+ *                   log2(p) steps exchanging the whole buffer, but at step s
+ *                   even ranks talk to rank + rho(s) and odd ranks to
+ *                   rank - rho(s) (modulo p), with
+ *                       rho(s) = sum_{i=0..s} (-2)^i = 1, -1, 3, -5, 11, ...
+ *                   so the peers are at distance 1, 1, 3, 5, 11... instead of
+ *                   1, 2, 4, 8... This keeps most of the traffic between
+ *                   neighbours of a ring or torus, where it crosses fewer
+ *                   links and shares them less with the other pairs.
+ *                   For a non-power of two number of processes the extra
+ *                   ranks are folded in and out as in recursive doubling.
+ *
+ *   Limitations:    The algorithm does not preserve the order of operations,
+ *                   non-commutative operations fall back to recursive
+ *                   doubling.
+ *
+ *         Example on 8 nodes, peers of rank 0/1/2/3:
+ *         Step 0 (rho =  1):  0<->1  1<->0  2<->3  3<->2
+ *         Step 1 (rho = -1):  0<->7  1<->2  2<->1  3<->4
+ *         Step 2 (rho =  3):  0<->3  1<->6  2<->5  3<->0
+ */
+int
+ompi_coll_base_allreduce_intra_swing(const void *sbuf, void *rbuf, size_t count,
+                                     struct ompi_datatype_t *dtype,
+                                     struct ompi_op_t *op,
+                                     struct ompi_communicator_t *comm,
+                                     mca_coll_base_module_t *module)
+{
+    int ret, line, rank, size, adjsize, remote, step, rho, power;
+    int newrank, newremote, extra_ranks;
+    char *tmpsend = NULL, *tmprecv = NULL, *tmpswap = NULL, *inplacebuf_free = NULL, *inplacebuf;
+    ptrdiff_t span, gap = 0;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    if (!ompi_op_is_commute(op)) {
+        OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                     "coll:base:allreduce_intra_swing: rank %d/%d "
+                     "switching to recursive doubling for a non-commutative operation",
+                     rank, size));
+        return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype,
+                                                                 op, comm, module);
+    }
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allreduce_intra_swing rank %d", rank));
+
+    /* Special case for size == 1 */
+    if (1 == size) {
+        if (MPI_IN_PLACE != sbuf) {
+            ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+            if (ret < 0) { line = __LINE__; goto error_hndl; }
+        }
+        return MPI_SUCCESS;
+    }
+
+    /* Allocate and initialize temporary send buffer */
+    span = opal_datatype_span(&dtype->super, count, &gap);
+    inplacebuf_free = (char*) ompi_coll_base_comm_get_scratch(module->base_data, span);
+    if (NULL == inplacebuf_free) { ret = -1; line = __LINE__; goto error_hndl; }
+    inplacebuf = inplacebuf_free - gap;
+
+    ret = ompi_datatype_copy_content_same_ddt(dtype, count, inplacebuf,
+                                              (MPI_IN_PLACE == sbuf) ? (char*)rbuf : (char*)sbuf);
+    if (ret < 0) { line = __LINE__; goto error_hndl; }
+
+    tmpsend = (char*) inplacebuf;
+    tmprecv = (char*) rbuf;
+
+    /* Determine nearest power of two less than or equal to size */
+    adjsize = opal_next_poweroftwo (size);
+    adjsize >>= 1;
+
+    /* Fold the extra ranks in, as in recursive doubling */
+    extra_ranks = size - adjsize;
+    if (rank <  (2 * extra_ranks)) {
+        if (0 == (rank % 2)) {
+            ret = MCA_PML_CALL(send(tmpsend, count, dtype, (rank + 1),
+                                    MCA_COLL_BASE_TAG_ALLREDUCE,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            newrank = -1;
+        } else {
+            ret = MCA_PML_CALL(recv(tmprecv, count, dtype, (rank - 1),
+                                    MCA_COLL_BASE_TAG_ALLREDUCE, comm,
+                                    MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            /* tmpsend = tmprecv (op) tmpsend */
+            ompi_op_reduce(op, tmprecv, tmpsend, count, dtype);
+            newrank = rank >> 1;
+        }
+    } else {
+        newrank = rank - extra_ranks;
+    }
+
+    /* Communication/Computation loop, rho(s) = rho(s-1) + (-2)^s */
+    for (step = 0, rho = 1, power = 1; (1 << step) < adjsize;
+         step++, power *= -2, rho += power) {
+        if (newrank < 0) break;
+        /* Determine remote node */
+        newremote = (0 == (newrank % 2)) ? newrank + rho : newrank - rho;
+        newremote = ((newremote % adjsize) + adjsize) % adjsize;
+        remote = (newremote < extra_ranks)?
+            (newremote * 2 + 1):(newremote + extra_ranks);
+
+        /* Exchange the data */
+        ret = ompi_coll_base_sendrecv_actual(tmpsend, count, dtype, remote,
+                                             MCA_COLL_BASE_TAG_ALLREDUCE,
+                                             tmprecv, count, dtype, remote,
+                                             MCA_COLL_BASE_TAG_ALLREDUCE,
+                                             comm, MPI_STATUS_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+
+        /* Apply operation, lower rank first so both peers get the same result */
+        if (rank < remote) {
+            /* tmprecv = tmpsend (op) tmprecv */
+            ompi_op_reduce(op, tmpsend, tmprecv, count, dtype);
+            tmpswap = tmprecv;
+            tmprecv = tmpsend;
+            tmpsend = tmpswap;
+        } else {
+            /* tmpsend = tmprecv (op) tmpsend */
+            ompi_op_reduce(op, tmprecv, tmpsend, count, dtype);
+        }
+    }
+
+    /* Fold the extra ranks out */
+    if (rank < (2 * extra_ranks)) {
+        if (0 == (rank % 2)) {
+            ret = MCA_PML_CALL(recv(rbuf, count, dtype, (rank + 1),
+                                    MCA_COLL_BASE_TAG_ALLREDUCE, comm,
+                                    MPI_STATUS_IGNORE));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            tmpsend = (char*)rbuf;
+        } else {
+            ret = MCA_PML_CALL(send(tmpsend, count, dtype, (rank - 1),
+                                    MCA_COLL_BASE_TAG_ALLREDUCE,
+                                    MCA_PML_BASE_SEND_STANDARD, comm));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+    }
+
+    /* Ensure that the final result is in rbuf */
+    if (tmpsend != rbuf) {
+        ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, tmpsend);
+        if (ret < 0) { line = __LINE__; goto error_hndl; }
+    }
+
+    ompi_coll_base_comm_put_scratch(module->base_data, inplacebuf_free);
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "%s:%4d\tRank %d Error occurred %d\n",
+                 __FILE__, line, rank, ret));
+    (void)line;  // silence compiler warning
+    ompi_coll_base_comm_put_scratch(module->base_data, inplacebuf_free);
+    return ret;
+}
+
+/*
+ *   ompi_coll_base_allreduce_intra_radix_k_redscat_allgather
+ *
+ *   Function:       Radix-k reduce-scatter followed by radix-k allgather
+ *   Accepts:        Same as MPI_Allreduce(), radix
+ *   Returns:        MPI_SUCCESS or error code
+ *
+ *   Description:    Generalization of Rabenseifner's algorithm
+ *                   (ompi_coll_base_allreduce_intra_redscat_allgather) to a
+ *                   radix k. The reduce-scatter phase splits the vector in k
+ *                   chunks at each of its log_k(p') steps: every rank sends
+ *                   k-1 chunks to the other members of its group of k ranks
+ *                   and reduces the one it keeps. The allgather phase
+ *                   replays the steps in reverse order. Each element is
+ *                   reduced on one rank only, so all ranks get the same
+ *                   result, and the bandwidth term stays the optimal
+ *                   2m(1-1/p)\beta while the latency term drops to
+ *                   2log_k(p)\alpha with k-1 concurrent messages per step.
+ *                   For a non-power of k number of processes, the ranks above
+ *                   the largest power of k p' first hand their data to rank
+ *                   (rank - p') % p', and get the result back at the end.
+ *
+ *   Limitations:    The algorithm does not preserve the order of operations,
+ *                   non-commutative operations fall back to recursive
+ *                   doubling. Counts smaller than p' use recursive
+ *                   multiplying instead. It needs (k-1)/k of the message
+ *                   size as temporary buffer, or up to (k-1) times the
+ *                   message size on the ranks with folded peers.
+ *
+ *         Example on 11 nodes, k = 3 (p' = 9), count = 9:
+ *         Fold:     9 -> 0, 10 -> 1
+ *         RS 0:     {0,3,6} {1,4,7} {2,5,8}: elements {0-2} {3-5} {6-8}
+ *         RS 1:     {0,1,2} {3,4,5} {6,7,8}: one element each
+ *         AG 0:     {0,1,2} {3,4,5} {6,7,8}: back to 3 elements each
+ *         AG 1:     {0,3,6} {1,4,7} {2,5,8}: the whole vector
+ *         Unfold:   0 -> 9, 1 -> 10
+ */
+int
+ompi_coll_base_allreduce_intra_radix_k_redscat_allgather(const void *sbuf, void *rbuf,
+                                                         size_t count,
+                                                         struct ompi_datatype_t *dtype,
+                                                         struct ompi_op_t *op,
+                                                         struct ompi_communicator_t *comm,
+                                                         mca_coll_base_module_t *module,
+                                                         int radix)
+{
+    int ret = MPI_SUCCESS, line, rank, size, pof_k, nfold = 0, distance, digit, start;
+    int peer, j, nreqs = 0, max_reqs = 0;
+    char *tmpbuf_free = NULL, *tmpbuf = NULL;
+    ompi_request_t **reqs = NULL;
+    ptrdiff_t extent, span, gap = 0, slot;
+    size_t q, rem, lo, len, jlo, jlen, tmpcount;
+
+    size = ompi_comm_size(comm);
+    rank = ompi_comm_rank(comm);
+
+    if (!ompi_op_is_commute(op)) {
+        OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                     "coll:base:allreduce_intra_radix_k_redscat_allgather: rank %d/%d "
+                     "switching to recursive doubling for a non-commutative operation",
+                     rank, size));
+        return ompi_coll_base_allreduce_intra_recursivedoubling(sbuf, rbuf, count, dtype,
+                                                                 op, comm, module);
+    }
+
+    /* Special case for size == 1 */
+    if (1 == size) {
+        if (MPI_IN_PLACE != sbuf) {
+            ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+            if (ret < 0) { line = __LINE__; goto error_hndl; }
+        }
+        return MPI_SUCCESS;
+    }
+
+    if (radix < 2) {
+        radix = 2;
+    }
+    if (radix > size) {
+        radix = size;
+    }
+    /* Largest power of radix less than or equal to size */
+    for (pof_k = radix; pof_k <= size / radix; pof_k *= radix);
+
+    if (count < (size_t)pof_k) {
+        OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                     "coll:base:allreduce_intra_radix_k_redscat_allgather: rank %d/%d "
+                     "count %zu switching to recursive multiplying", rank, size, count));
+        return ompi_coll_base_allreduce_intra_recursive_multiplying(sbuf, rbuf, count, dtype,
+                                                                    op, comm, module, radix);
+    }
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:allreduce_intra_radix_k_redscat_allgather rank %d radix %d",
+                 rank, radix));
+
+    if (MPI_IN_PLACE != sbuf) {
+        ret = ompi_datatype_copy_content_same_ddt(dtype, count, (char*)rbuf, (char*)sbuf);
+        if (ret < 0) { line = __LINE__; goto error_hndl; }
+    }
+
+    /* Vranks below pof_k own q or q + 1 consecutive elements of the vector */
+    q = count / pof_k;
+    rem = count % pof_k;
+    ompi_datatype_type_extent(dtype, &extent);
+
+    /* Temporary buffer: the vectors of the folded ranks, then the chunks of the first step */
+    nfold = (rank < pof_k) ? (size - 1 - rank) / pof_k : 0;
+    slot = (ptrdiff_t)ompi_coll_base_split_offset(pof_k / radix, q, rem);
+    tmpcount = (rank < pof_k) ? (size_t)(radix - 1) * slot : 0;
+    if (nfold * count > tmpcount) {
+        tmpcount = nfold * count;
+    }
+    if (tmpcount > 0) {
+        span = opal_datatype_span(&dtype->super, tmpcount, &gap);
+        tmpbuf_free = (char*) ompi_coll_base_comm_get_scratch(module->base_data, span);
+        if (NULL == tmpbuf_free) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+        tmpbuf = tmpbuf_free - gap;
+    }
+
+    max_reqs = 2 * (radix - 1);
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, max_reqs);
+    if (NULL == reqs) { ret = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
+
+    /* Fold: as size < radix * pof_k, each of the first pof_k ranks gets the
+     * data of at most radix - 1 of the remaining ones */
+    if (rank >= pof_k) {
+        ret = MCA_PML_CALL(send(rbuf, count, dtype, (rank - pof_k) % pof_k,
+                                MCA_COLL_BASE_TAG_ALLREDUCE,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    } else if (nfold > 0) {
+        for (nreqs = 0, peer = rank + pof_k; peer < size; peer += pof_k, nreqs++) {
+            ret = MCA_PML_CALL(irecv(tmpbuf + (ptrdiff_t)nreqs * count * extent, count, dtype,
+                                     peer, MCA_COLL_BASE_TAG_ALLREDUCE, comm, &reqs[nreqs]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+        ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        for (j = 0; j < nreqs; j++) {
+            ompi_op_reduce(op, tmpbuf + (ptrdiff_t)j * count * extent, rbuf, count, dtype);
+        }
+    }
+
+    /*
+     * Reduce-scatter within the groups of radix ranks at distance
+     * pof_k / radix, ..., radix, 1: the current vector is the share of the
+     * radix * distance vranks from start, chunk j the one of the distance
+     * vranks from start + j * distance, which is kept by member j.
+     */
+    for (distance = pof_k / radix; rank < pof_k && distance > 0; distance /= radix) {
+        digit = (rank / distance) % radix;
+        start = rank - rank % (radix * distance);
+        lo = ompi_coll_base_split_offset(start + digit * distance, q, rem);
+        len = ompi_coll_base_split_offset(start + (digit + 1) * distance, q, rem) - lo;
+
+        nreqs = 0;
+        for (j = 0; j < radix; j++) {
+            if (j == digit) continue;
+            peer = rank + (j - digit) * distance;
+            jlo = ompi_coll_base_split_offset(start + j * distance, q, rem);
+            jlen = ompi_coll_base_split_offset(start + (j + 1) * distance, q, rem) - jlo;
+            ret = MCA_PML_CALL(irecv(tmpbuf + (ptrdiff_t)(nreqs / 2) * slot * extent, len,
+                                     dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     comm, &reqs[nreqs]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            nreqs++;
+            ret = MCA_PML_CALL(isend((char*)rbuf + (ptrdiff_t)jlo * extent, jlen, dtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            nreqs++;
+        }
+        ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        for (j = 0; j < radix - 1; j++) {
+            ompi_op_reduce(op, tmpbuf + (ptrdiff_t)j * slot * extent,
+                           (char*)rbuf + (ptrdiff_t)lo * extent, len, dtype);
+        }
+    }
+
+    /* Allgather: replay the steps in reverse order, receiving in place */
+    for (distance = 1; rank < pof_k && distance < pof_k; distance *= radix) {
+        digit = (rank / distance) % radix;
+        start = rank - rank % (radix * distance);
+        lo = ompi_coll_base_split_offset(start + digit * distance, q, rem);
+        len = ompi_coll_base_split_offset(start + (digit + 1) * distance, q, rem) - lo;
+
+        nreqs = 0;
+        for (j = 0; j < radix; j++) {
+            if (j == digit) continue;
+            peer = rank + (j - digit) * distance;
+            jlo = ompi_coll_base_split_offset(start + j * distance, q, rem);
+            jlen = ompi_coll_base_split_offset(start + (j + 1) * distance, q, rem) - jlo;
+            ret = MCA_PML_CALL(irecv((char*)rbuf + (ptrdiff_t)jlo * extent, jlen, dtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE, comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+            ret = MCA_PML_CALL(isend((char*)rbuf + (ptrdiff_t)lo * extent, len, dtype, peer,
+                                     MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs++]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+        ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    }
+
+    /* Unfold: send the result back to the ranks above pof_k */
+    if (rank >= pof_k) {
+        ret = MCA_PML_CALL(recv(rbuf, count, dtype, (rank - pof_k) % pof_k,
+                                MCA_COLL_BASE_TAG_ALLREDUCE, comm, MPI_STATUS_IGNORE));
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    } else if (nfold > 0) {
+        for (nreqs = 0, peer = rank + pof_k; peer < size; peer += pof_k, nreqs++) {
+            ret = MCA_PML_CALL(isend(rbuf, count, dtype, peer, MCA_COLL_BASE_TAG_ALLREDUCE,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs]));
+            if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+        }
+        ret = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != ret) { line = __LINE__; goto error_hndl; }
+    }
+
+    ompi_coll_base_comm_put_scratch(module->base_data, tmpbuf_free);
+    return MPI_SUCCESS;
+
+ error_hndl:
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output, "%s:%4d\tRank %d Error occurred %d\n",
+                 __FILE__, line, rank, ret));
+    (void)line;  // silence compiler warning
+    if (NULL != reqs) {
+        if (MPI_ERR_IN_STATUS == ret) {
+            for (j = 0; j < max_reqs; j++) {
+                if (MPI_REQUEST_NULL == reqs[j]) continue;
+                if (MPI_ERR_PENDING == reqs[j]->req_status.MPI_ERROR) continue;
+                if (reqs[j]->req_status.MPI_ERROR != MPI_SUCCESS) {
+                    ret = reqs[j]->req_status.MPI_ERROR;
+                    break;
+                }
+            }
+        }
+        ompi_coll_base_free_reqs(reqs, max_reqs);
+    }
+    ompi_coll_base_comm_put_scratch(module->base_data, tmpbuf_free);
+    return ret;
+}
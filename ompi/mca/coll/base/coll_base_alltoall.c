@@ -92,7 +92,7 @@ mca_coll_base_alltoall_intra_basic_inplace(const void *rbuf, size_t rcount,
     ompi_datatype_type_extent(rdtype, &extent);
 
     /* Allocate a temporary buffer */
-    tmp_buffer = calloc (max_size, 1);
+    tmp_buffer = ompi_coll_base_comm_get_scratch(module->base_data, max_size);
     if( NULL == tmp_buffer) { err = OMPI_ERR_OUT_OF_RESOURCE; line = __LINE__; goto error_hndl; }
 
     for (i = 1 ; i <= (size >> 1) ; ++i) {
@@ -164,8 +164,7 @@ mca_coll_base_alltoall_intra_basic_inplace(const void *rbuf, size_t rcount,
 
  error_hndl:
     /* Free the temporary buffer */
-    if( NULL != tmp_buffer )
-        free (tmp_buffer);
+    ompi_coll_base_comm_put_scratch(module->base_data, tmp_buffer);
 
     if( MPI_SUCCESS != err ) {
         OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
@@ -269,7 +268,7 @@ int ompi_coll_base_alltoall_intra_bruck(const void *sbuf, size_t scount,
     span = opal_datatype_span(&rdtype->super, (int64_t)size * rcount, &gap);
 
     /* tmp buffer allocation for message data */
-    tmpbuf_free = (char *)malloc(span);
+    tmpbuf_free = (char *) ompi_coll_base_comm_get_scratch(module->base_data, span);
     if (tmpbuf_free == NULL) { line = __LINE__; err = -1; goto err_hndl; }
     tmpbuf = tmpbuf_free - gap;
 
@@ -345,7 +344,7 @@ int ompi_coll_base_alltoall_intra_bruck(const void *sbuf, size_t scount,
     }
 
     /* Step 4 - clean up */
-    if (tmpbuf_free != NULL) free(tmpbuf_free);
+    ompi_coll_base_comm_put_scratch(module->base_data, tmpbuf_free);
     return OMPI_SUCCESS;
 
  err_hndl:
@@ -353,7 +352,7 @@ int ompi_coll_base_alltoall_intra_bruck(const void *sbuf, size_t scount,
                  "%s:%4d\tError occurred %d, rank %2d", __FILE__, line, err,
                  rank));
     (void)line;  // silence compiler warning
-    if (tmpbuf_free != NULL) free(tmpbuf_free);
+    ompi_coll_base_comm_put_scratch(module->base_data, tmpbuf_free);
     if (displs != NULL) free(displs);
     return err;
 }
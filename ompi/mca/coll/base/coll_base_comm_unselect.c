@@ -147,6 +147,8 @@ int mca_coll_base_comm_unselect(ompi_communicator_t * comm)
 
     CHECK_CLEAN_COLL(comm, reduce_local);
 
+    CHECK_CLEAN_COLL(comm, allreduce_multi);
+
 #if OPAL_ENABLE_FT_MPI
     CHECK_CLEAN_COLL(comm, agree);
     CHECK_CLEAN_COLL(comm, iagree);
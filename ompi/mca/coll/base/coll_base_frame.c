@@ -35,6 +35,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/base.h"
 #include "ompi/mca/coll/base/coll_base_functions.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
 
 /*
  * The following file was created by configure.  It contains extern
@@ -83,6 +84,10 @@ coll_base_comm_destruct(mca_coll_base_comm_t *data)
     }
     assert(0 == data->mcct_num_reqs);
 
+    assert(0 == data->mcct_scratch_used);
+    free(data->mcct_scratch);
+    data->mcct_scratch = NULL;
+
     /* free any cached information that has been allocated */
     if (data->cached_ntree) { /* destroy general tree if defined */
         ompi_coll_base_topo_destroy_tree (&data->cached_ntree);
@@ -130,9 +135,94 @@ ompi_request_t** ompi_coll_base_comm_get_reqs(mca_coll_base_comm_t* data, int nr
     return data->mcct_reqs;
 }
 
+size_t ompi_coll_base_scratch_max = 65536;
+
+/* Alignment of the buffers carved from the scratch arena */
+#define COLL_BASE_SCRATCH_ALIGN 64
+#define COLL_BASE_SCRATCH_ROUND(size) \
+    (((size) + COLL_BASE_SCRATCH_ALIGN - 1) & ~((size_t)COLL_BASE_SCRATCH_ALIGN - 1))
+
+void *ompi_coll_base_comm_get_scratch(mca_coll_base_comm_t *data, size_t size)
+{
+    size_t offset, want, max;
+
+    if( OPAL_UNLIKELY(NULL == data) || 0 == size || size > ompi_coll_base_scratch_max ) {
+        return malloc(size);
+    }
+    size = COLL_BASE_SCRATCH_ROUND(size);
+    /* Rounded as the buffers, so that an empty arena of this size holds any
+     * buffer accepted above */
+    max = COLL_BASE_SCRATCH_ROUND(ompi_coll_base_scratch_max);
+    offset = data->mcct_scratch_used;
+    if( offset + size > data->mcct_scratch_want ) {
+        data->mcct_scratch_want = offset + size;
+    }
+
+    /* The buffers handed out pin the arena: only grow it at the first
+     * buffer of a collective, to what all the buffers of the largest
+     * collective so far need */
+    if( 0 == offset && data->mcct_scratch_want > data->mcct_scratch_size &&
+        data->mcct_scratch_size < max ) {
+        want = data->mcct_scratch_want;
+        if( want > max ) {
+            want = max;
+        }
+        free(data->mcct_scratch);
+        data->mcct_scratch = (char*)malloc(want);
+        if( NULL == data->mcct_scratch ) {
+            data->mcct_scratch_size = 0;
+            return malloc(size);
+        }
+        data->mcct_scratch_size = want;
+    }
+    if( offset + size > data->mcct_scratch_size ) {
+        return malloc(size);
+    }
+    data->mcct_scratch_used = offset + size;
+    return data->mcct_scratch + offset;
+}
+
+void ompi_coll_base_comm_put_scratch(mca_coll_base_comm_t *data, void *buf)
+{
+    char *ptr = (char*)buf;
+
+    if( NULL == buf ) return;
+
+    if( NULL != data && ptr >= data->mcct_scratch &&
+        ptr < data->mcct_scratch + data->mcct_scratch_size ) {
+        if( (size_t)(ptr - data->mcct_scratch) < data->mcct_scratch_used ) {
+            data->mcct_scratch_used = (size_t)(ptr - data->mcct_scratch);
+        }
+        return;
+    }
+    free(buf);
+}
+
 static int mca_coll_base_register(mca_base_register_flag_t flags)
 {
     (void) mca_base_alias_register("ompi", "coll", "accelerator", "cuda", MCA_BASE_ALIAS_FLAG_DEPRECATED);
+
+    ompi_coll_base_progress_thread_bind = true;
+    (void) mca_base_framework_var_register(&ompi_coll_base_framework, "progress_thread_bind",
+                                           "Bind the progress thread of the nonblocking collective "
+                                           "components (see coll_libnbc_progress_thread and "
+                                           "coll_adapt_progress_thread) to a core not used by the "
+                                           "local processes, if the node has one",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_base_progress_thread_bind);
+
+    ompi_coll_base_scratch_max = 65536;
+    (void) mca_base_framework_var_register(&ompi_coll_base_framework, "scratch_max",
+                                           "Size in bytes of the largest scratch arena a "
+                                           "communicator keeps for the temporary buffers of the "
+                                           "blocking collective algorithms. Larger buffers are "
+                                           "allocated at each call; 0 disables the arena",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0,
+                                           MCA_BASE_VAR_FLAG_SETTABLE, OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &ompi_coll_base_scratch_max);
     return OMPI_SUCCESS;
 }
 
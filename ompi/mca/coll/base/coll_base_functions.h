@@ -195,6 +195,7 @@ int ompi_coll_base_allgather_intra_basic_linear(ALLGATHER_ARGS);
 int ompi_coll_base_allgather_intra_two_procs(ALLGATHER_ARGS);
 int ompi_coll_base_allgather_intra_k_bruck(ALLGATHER_ARGS, int radix);
 int ompi_coll_base_allgather_direct_messaging(ALLGATHER_ARGS);
+int ompi_coll_base_allgather_intra_recursive_multiplying(ALLGATHER_ARGS, int radix);
 
 /* All GatherV */
 int ompi_coll_base_allgatherv_intra_bruck(ALLGATHERV_ARGS);
@@ -212,6 +213,9 @@ int ompi_coll_base_allreduce_intra_ring_segmented(ALLREDUCE_ARGS, uint32_t segsi
 int ompi_coll_base_allreduce_intra_basic_linear(ALLREDUCE_ARGS);
 int ompi_coll_base_allreduce_intra_redscat_allgather(ALLREDUCE_ARGS);
 int ompi_coll_base_allreduce_intra_allgather_reduce(ALLREDUCE_ARGS);
+int ompi_coll_base_allreduce_intra_recursive_multiplying(ALLREDUCE_ARGS, int radix);
+int ompi_coll_base_allreduce_intra_swing(ALLREDUCE_ARGS);
+int ompi_coll_base_allreduce_intra_radix_k_redscat_allgather(ALLREDUCE_ARGS, int radix);
 
 /* AlltoAll */
 int ompi_coll_base_alltoall_intra_pairwise(ALLTOALL_ARGS);
@@ -288,6 +292,7 @@ int ompi_coll_base_reduce_scatter_block_basic_linear(REDUCESCATTERBLOCK_ARGS);
 int ompi_coll_base_reduce_scatter_block_intra_recursivedoubling(REDUCESCATTERBLOCK_ARGS);
 int ompi_coll_base_reduce_scatter_block_intra_recursivehalving(REDUCESCATTERBLOCK_ARGS);
 int ompi_coll_base_reduce_scatter_block_intra_butterfly(REDUCESCATTERBLOCK_ARGS);
+int ompi_coll_base_reduce_scatter_block_intra_radix_k(REDUCESCATTERBLOCK_ARGS, int radix);
 
 /* Scan */
 int ompi_coll_base_scan_intra_recursivedoubling(SCAN_ARGS);
@@ -477,6 +482,15 @@ struct mca_coll_base_comm_t {
     ompi_request_t **mcct_reqs;
     int mcct_num_reqs;
 
+    /* Scratch arena for the temporary buffers of the blocking algorithms,
+     * see ompi_coll_base_comm_get_scratch. mcct_scratch_used is the part
+     * handed out to the running collective, and mcct_scratch_want the
+     * largest part a collective asked for, to grow the arena when empty. */
+    char *mcct_scratch;
+    size_t mcct_scratch_size;
+    size_t mcct_scratch_used;
+    size_t mcct_scratch_want;
+
     /*
      * base topo information caching per communicator
      *
@@ -562,4 +576,23 @@ static inline void ompi_coll_base_free_reqs(ompi_request_t **reqs, int count)
  */
 ompi_request_t** ompi_coll_base_comm_get_reqs(mca_coll_base_comm_t* data, int nreqs);
 
+/**
+ * Return a temporary buffer of size bytes for the running blocking
+ * collective. The buffer is carved from the scratch arena of the
+ * communicator. The arena grows, when a collective asks for its first
+ * buffer, to the total size of the buffers of the largest collective so far
+ * (at most coll_base_scratch_max), so that the following calls do not
+ * allocate. Buffers larger than coll_base_scratch_max, or that do not fit
+ * in the arena, are allocated with malloc instead.
+ *
+ * All the buffers must be returned with ompi_coll_base_comm_put_scratch
+ * before the collective returns, in any order; a buffer returned releases
+ * all the buffers obtained after it.
+ */
+void *ompi_coll_base_comm_get_scratch(mca_coll_base_comm_t *data, size_t size);
+void ompi_coll_base_comm_put_scratch(mca_coll_base_comm_t *data, void *buf);
+
+/* MCA parameter: largest scratch arena kept by a communicator */
+extern size_t ompi_coll_base_scratch_max;
+
 #endif /* MCA_COLL_BASE_EXPORT_H */
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * A progress thread shared by the components implementing nonblocking
+ * collectives. The thread calls opal_progress() as long as at least one
+ * collective handle is outstanding, and sleeps on a condition variable
+ * otherwise. The components account for their handles with
+ * ompi_coll_base_progress_thread_post() when a handle is started and
+ * ompi_coll_base_progress_thread_done() when it completes; only the
+ * transitions from and to zero outstanding handles touch the lock.
+ */
+
+#include "ompi_config.h"
+
+#include "opal/mca/hwloc/base/base.h"
+#include "opal/mca/threads/mutex.h"
+#include "opal/mca/threads/threads.h"
+#include "opal/runtime/opal_progress.h"
+#include "opal/util/output.h"
+#include "opal/util/proc.h"
+
+#include "ompi/constants.h"
+#include "ompi/mca/coll/base/base.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
+
+bool ompi_coll_base_progress_thread_bind = true;
+
+static opal_mutex_t progress_thread_lock = OPAL_MUTEX_STATIC_INIT;
+static opal_cond_t progress_thread_cond = OPAL_CONDITION_STATIC_INIT;
+static opal_thread_t progress_thread;
+static int progress_thread_refcount = 0;
+static volatile bool progress_thread_stop = false;
+static opal_atomic_int32_t progress_thread_outstanding = 0;
+
+/*
+ * Bind the calling thread to a core not used by the local processes, as
+ * long as the node has more cores than local processes. The processes are
+ * assumed to be mapped one per core from the first core on, the default
+ * mapping when there are not more processes than cores; the progress
+ * threads of the local processes are then spread over the remaining cores.
+ */
+static void progress_thread_bind(void)
+{
+    int ncores, nlocal, core;
+    hwloc_obj_t obj;
+
+    if (!ompi_coll_base_progress_thread_bind
+        || OPAL_SUCCESS != opal_hwloc_base_get_topology()) {
+        return;
+    }
+    ncores = hwloc_get_nbobjs_by_type(opal_hwloc_topology, HWLOC_OBJ_CORE);
+    nlocal = (int) opal_process_info.num_local_peers + 1;
+    if (ncores <= nlocal) {
+        return;
+    }
+    core = nlocal + opal_process_info.my_local_rank % (ncores - nlocal);
+    obj = hwloc_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_CORE, core);
+    if (NULL == obj
+        || 0 != hwloc_set_cpubind(opal_hwloc_topology, obj->cpuset, HWLOC_CPUBIND_THREAD)) {
+        opal_output_verbose(10, ompi_coll_base_framework.framework_output,
+                            "coll:base:progress_thread: cannot bind to core %d, left unbound",
+                            core);
+    }
+}
+
+static void *progress_thread_engine(opal_object_t *obj)
+{
+    (void) obj;
+
+    progress_thread_bind();
+
+    while (!progress_thread_stop) {
+        if (0 < progress_thread_outstanding) {
+            opal_progress();
+            continue;
+        }
+        opal_mutex_lock(&progress_thread_lock);
+        while (0 == progress_thread_outstanding && !progress_thread_stop) {
+            opal_cond_wait(&progress_thread_cond, &progress_thread_lock);
+        }
+        opal_mutex_unlock(&progress_thread_lock);
+    }
+    return NULL;
+}
+
+int ompi_coll_base_progress_thread_retain(void)
+{
+    int ret = OMPI_SUCCESS;
+
+    opal_mutex_lock(&progress_thread_lock);
+    if (0 == progress_thread_refcount) {
+        OBJ_CONSTRUCT(&progress_thread, opal_thread_t);
+        progress_thread.t_run = progress_thread_engine;
+        progress_thread.t_arg = NULL;
+        progress_thread_stop = false;
+        ret = opal_thread_start(&progress_thread);
+        if (OPAL_SUCCESS != ret) {
+            OBJ_DESTRUCT(&progress_thread);
+            opal_mutex_unlock(&progress_thread_lock);
+            opal_output_verbose(1, ompi_coll_base_framework.framework_output,
+                                "coll:base:progress_thread: cannot start the progress thread (%d)",
+                                ret);
+            return ret;
+        }
+    }
+    progress_thread_refcount++;
+    opal_mutex_unlock(&progress_thread_lock);
+    return ret;
+}
+
+void ompi_coll_base_progress_thread_release(void)
+{
+    opal_mutex_lock(&progress_thread_lock);
+    if (0 == progress_thread_refcount || 0 < --progress_thread_refcount) {
+        opal_mutex_unlock(&progress_thread_lock);
+        return;
+    }
+    progress_thread_stop = true;
+    opal_cond_signal(&progress_thread_cond);
+    opal_mutex_unlock(&progress_thread_lock);
+
+    opal_thread_join(&progress_thread, NULL);
+    OBJ_DESTRUCT(&progress_thread);
+}
+
+void ompi_coll_base_progress_thread_post(void)
+{
+    /* The thread checks the count under the lock before going to sleep, so
+     * taking the lock here guarantees that the wake up is not lost. */
+    if (0 == opal_atomic_fetch_add_32(&progress_thread_outstanding, 1)) {
+        opal_mutex_lock(&progress_thread_lock);
+        opal_cond_signal(&progress_thread_cond);
+        opal_mutex_unlock(&progress_thread_lock);
+    }
+}
+
+void ompi_coll_base_progress_thread_done(void)
+{
+    (void) opal_atomic_fetch_add_32(&progress_thread_outstanding, -1);
+}
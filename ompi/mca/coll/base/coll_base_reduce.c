@@ -106,7 +106,7 @@ int ompi_coll_base_reduce_generic( const void* sendbuf, void* recvbuf, size_t or
         if( (NULL == accumbuf) || (root != rank) ) {
             /* Allocate temporary accumulator buffer. */
             size = opal_datatype_span(&datatype->super, original_count, &gap);
-            accumbuf_free = (char*)malloc(size);
+            accumbuf_free = (char*)ompi_coll_base_comm_get_scratch(module->base_data, size);
             if (accumbuf_free == NULL) {
                 line = __LINE__; ret = -1; goto error_hndl;
             }
@@ -123,7 +123,7 @@ int ompi_coll_base_reduce_generic( const void* sendbuf, void* recvbuf, size_t or
         }
         /* Allocate two buffers for incoming segments */
         real_segment_size = opal_datatype_span(&datatype->super, count_by_segment, &gap);
-        inbuf_free[0] = (char*) malloc(real_segment_size);
+        inbuf_free[0] = (char*) ompi_coll_base_comm_get_scratch(module->base_data, real_segment_size);
         if( inbuf_free[0] == NULL ) {
             line = __LINE__; ret = -1; goto error_hndl;
         }
@@ -131,7 +131,7 @@ int ompi_coll_base_reduce_generic( const void* sendbuf, void* recvbuf, size_t or
         /* if there is chance to overlap communication -
            allocate second buffer */
         if( (num_segments > 1) || (tree->tree_nextsize > 1) ) {
-            inbuf_free[1] = (char*) malloc(real_segment_size);
+            inbuf_free[1] = (char*) ompi_coll_base_comm_get_scratch(module->base_data, real_segment_size);
             if( inbuf_free[1] == NULL ) {
                 line = __LINE__; ret = -1; goto error_hndl;
             }
@@ -242,9 +242,9 @@ int ompi_coll_base_reduce_generic( const void* sendbuf, void* recvbuf, size_t or
         } /* end of for each segment */
 
         /* clean up */
-        if( inbuf_free[0] != NULL) free(inbuf_free[0]);
-        if( inbuf_free[1] != NULL) free(inbuf_free[1]);
-        if( accumbuf_free != NULL ) free(accumbuf_free);
+        ompi_coll_base_comm_put_scratch(module->base_data, inbuf_free[1]);
+        ompi_coll_base_comm_put_scratch(module->base_data, inbuf_free[0]);
+        ompi_coll_base_comm_put_scratch(module->base_data, accumbuf_free);
     }
 
     /* leaf nodes
@@ -365,9 +365,9 @@ int ompi_coll_base_reduce_generic( const void* sendbuf, void* recvbuf, size_t or
         }
         ompi_coll_base_free_reqs(sreq, max_outstanding_reqs);
     }
-    if( inbuf_free[0] != NULL ) free(inbuf_free[0]);
-    if( inbuf_free[1] != NULL ) free(inbuf_free[1]);
-    if( accumbuf_free != NULL ) free(accumbuf);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf_free[1]);
+    ompi_coll_base_comm_put_scratch(module->base_data, inbuf_free[0]);
+    ompi_coll_base_comm_put_scratch(module->base_data, accumbuf_free);
     OPAL_OUTPUT (( ompi_coll_base_framework.framework_output,
                    "ERROR_HNDL: node %d file %s line %d error %d\n",
                    rank, __FILE__, line, ret ));
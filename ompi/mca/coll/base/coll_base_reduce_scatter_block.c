@@ -971,3 +971,235 @@ cleanup_and_return:
         free(tmpbuf[1]);
     return err;
 }
+
+/*
+ * ompi_coll_base_reduce_scatter_block_intra_radix_k
+ *
+ * Function:  Radix-k recursive vector splitting for reduce_scatter_block
+ * Accepts:   Same as MPI_Reduce_scatter_block, radix
+ * Returns:   MPI_SUCCESS or error code
+ *
+ * Description:  Generalization of recursive halving to a radix k: in each
+ *               of the log_k(p') steps the ranks are split in groups of k
+ *               (at distance p'/k, p'/k^2, ..., 1), the current vector is
+ *               split in k chunks, and every rank sends k-1 chunks to the
+ *               other members of its group while receiving and reducing the
+ *               chunk it keeps. The bandwidth term stays m(1-1/p)\beta as in
+ *               recursive halving, while the latency term drops from
+ *               log_2(p)\alpha to log_k(p)\alpha with k-1 concurrent
+ *               messages per step.
+ *               For a non-power of k number of processes, the ranks above
+ *               the largest power of k p' first hand their vector to rank
+ *               rank % p' and get their block back at the end. To keep the
+ *               chunks contiguous, the blocks are permuted so that the block
+ *               of every folded rank follows the one of the rank it is
+ *               attached to.
+ *
+ * Limitations:  Commutative operations only, the others fall back to the
+ *               basic linear algorithm.
+ *
+ * Memory requirements (per process):
+ *   rcount * comm_size * typesize for the permuted vector, plus up to
+ *   (k-1) * rcount * comm_size * typesize on the ranks with folded peers
+ *   and (k-1)/k of the vector on the others.
+ *
+ * Example: comm_size=11, radix=3, p'=9, blocks of 9 and 10 follow 0 and 1
+ *   Fold:    9 -> 0, 10 -> 1 (vector order: 0 9 1 10 2 3 4 5 6 7 8)
+ *   Step 0:  {0,3,6} {1,4,7} {2,5,8}: chunks {0-2} {3-5} {6-8}
+ *   Step 1:  {0,1,2} {3,4,5} {6,7,8}: one rank per chunk
+ *   Unfold:  0 -> 9, 1 -> 10
+ */
+int
+ompi_coll_base_reduce_scatter_block_intra_radix_k(
+    const void *sbuf, void *rbuf, size_t rcount, struct ompi_datatype_t *dtype,
+    struct ompi_op_t *op, struct ompi_communicator_t *comm,
+    mca_coll_base_module_t *module, int radix)
+{
+    char *tmpbuf_raw = NULL, *tmprecv_raw = NULL, *tmpbuf, *tmprecv, *pdata;
+    ptrdiff_t span, gap, extent, blocksize, slot = 0;
+    size_t totalcount, q, rem, lo, len;
+    ompi_request_t **reqs = NULL;
+    int err = MPI_SUCCESS, nreqs = 0, max_reqs = 0;
+    int pof_k, nfold = 0, distance, digit, start, peer, j;
+    int comm_size = ompi_comm_size(comm);
+    int rank = ompi_comm_rank(comm);
+
+    OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                 "coll:base:reduce_scatter_block_intra_radix_k: rank %d/%d radix %d",
+                 rank, comm_size, radix));
+    if (rcount == 0 || comm_size < 2)
+        return MPI_SUCCESS;
+
+    if (!ompi_op_is_commute(op)) {
+        OPAL_OUTPUT((ompi_coll_base_framework.framework_output,
+                     "coll:base:reduce_scatter_block_intra_radix_k: rank %d/%d "
+                     "switching to basic reduce_scatter_block", rank, comm_size));
+        return ompi_coll_base_reduce_scatter_block_basic_linear(sbuf, rbuf, rcount, dtype,
+                                                                op, comm, module);
+    }
+
+    if (radix < 2) {
+        radix = 2;
+    }
+    if (radix > comm_size) {
+        radix = comm_size;
+    }
+    /* Largest power of radix less than or equal to comm_size */
+    for (pof_k = radix; pof_k <= comm_size / radix; pof_k *= radix);
+    /* Vranks below pof_k own q or q + 1 consecutive blocks of the vector */
+    q = comm_size / pof_k;
+    rem = comm_size % pof_k;
+
+    totalcount = comm_size * (size_t)rcount;
+    ompi_datatype_type_extent(dtype, &extent);
+    blocksize = (ptrdiff_t)rcount * extent;
+    span = opal_datatype_span(&dtype->super, totalcount, &gap);
+    tmpbuf_raw = malloc(span);
+    if (NULL == tmpbuf_raw) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup_and_return;
+    }
+    tmpbuf = tmpbuf_raw - gap;
+
+    /* Permute the blocks: block b goes after the ones of the ranks b - p', b - 2p'... */
+    pdata = (sbuf != MPI_IN_PLACE) ? (char *)sbuf : rbuf;
+    if (comm_size == pof_k) {
+        err = ompi_datatype_copy_content_same_ddt(dtype, totalcount, tmpbuf, pdata);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    } else {
+        for (int b = 0; b < comm_size; b++) {
+            lo = ompi_coll_base_split_offset(b % pof_k, q, rem) + b / pof_k;
+            err = ompi_datatype_copy_content_same_ddt(dtype, rcount,
+                                                      tmpbuf + (ptrdiff_t)lo * blocksize,
+                                                      pdata + (ptrdiff_t)b * blocksize);
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+    }
+
+    /* Fold: the ranks above pof_k only contribute their vector and get their block */
+    if (rank >= pof_k) {
+        err = MCA_PML_CALL(send(tmpbuf, totalcount, dtype, rank % pof_k,
+                                MCA_COLL_BASE_TAG_REDUCE_SCATTER_BLOCK,
+                                MCA_PML_BASE_SEND_STANDARD, comm));
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        err = MCA_PML_CALL(recv(rbuf, rcount, dtype, rank % pof_k,
+                                MCA_COLL_BASE_TAG_REDUCE_SCATTER_BLOCK,
+                                comm, MPI_STATUS_IGNORE));
+        goto cleanup_and_return;
+    }
+    nfold = (comm_size - 1 - rank) / pof_k;
+
+    /* Receive buffer: the vectors of the folded ranks, then the chunks of the first step */
+    distance = pof_k / radix;
+    slot = (ptrdiff_t)ompi_coll_base_split_offset(distance, q, rem) * rcount;
+    len = (size_t)(radix - 1) * slot;
+    if (nfold * totalcount > len) {
+        len = nfold * totalcount;
+    }
+    span = opal_datatype_span(&dtype->super, len, &gap);
+    tmprecv_raw = malloc(span);
+    if (NULL == tmprecv_raw) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup_and_return;
+    }
+    tmprecv = tmprecv_raw - gap;
+
+    max_reqs = 2 * (radix - 1);
+    reqs = ompi_coll_base_comm_get_reqs(module->base_data, max_reqs);
+    if (NULL == reqs) {
+        err = OMPI_ERR_OUT_OF_RESOURCE;
+        goto cleanup_and_return;
+    }
+
+    if (nfold > 0) {
+        for (j = 0; j < nfold; j++) {
+            err = MCA_PML_CALL(irecv(tmprecv + (ptrdiff_t)j * totalcount * extent, totalcount,
+                                     dtype, rank + (j + 1) * pof_k,
+                                     MCA_COLL_BASE_TAG_REDUCE_SCATTER_BLOCK,
+                                     comm, &reqs[j]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+        err = ompi_request_wait_all(nfold, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        for (j = 0; j < nfold; j++) {
+            ompi_op_reduce(op, tmprecv + (ptrdiff_t)j * totalcount * extent,
+                           tmpbuf, totalcount, dtype);
+        }
+    }
+
+    /*
+     * Split the vector among the groups of radix ranks at distance
+     * pof_k / radix, ..., radix, 1: the current vector is the share of the
+     * radix * distance vranks from start, chunk j the one of the distance
+     * vranks from start + j * distance, which is kept by member j.
+     */
+    for (; distance > 0; distance /= radix) {
+        digit = (rank / distance) % radix;
+        start = rank - rank % (radix * distance);
+        lo = ompi_coll_base_split_offset(start + digit * distance, q, rem);
+        len = ompi_coll_base_split_offset(start + (digit + 1) * distance, q, rem) - lo;
+
+        nreqs = 0;
+        for (j = 0; j < radix; j++) {
+            size_t jlo, jlen;
+            if (j == digit) continue;
+            peer = rank + (j - digit) * distance;
+            jlo = ompi_coll_base_split_offset(start + j * distance, q, rem);
+            jlen = ompi_coll_base_split_offset(start + (j + 1) * distance, q, rem) - jlo;
+            err = MCA_PML_CALL(irecv(tmprecv + (ptrdiff_t)(nreqs / 2) * slot * extent,
+                                     len * rcount, dtype, peer,
+                                     MCA_COLL_BASE_TAG_REDUCE_SCATTER_BLOCK,
+                                     comm, &reqs[nreqs]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            nreqs++;
+            err = MCA_PML_CALL(isend(tmpbuf + (ptrdiff_t)jlo * blocksize, jlen * rcount,
+                                     dtype, peer, MCA_COLL_BASE_TAG_REDUCE_SCATTER_BLOCK,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[nreqs]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+            nreqs++;
+        }
+        err = ompi_request_wait_all(nreqs, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        for (j = 0; j < radix - 1; j++) {
+            ompi_op_reduce(op, tmprecv + (ptrdiff_t)j * slot * extent,
+                           tmpbuf + (ptrdiff_t)lo * blocksize, len * rcount, dtype);
+        }
+    }
+
+    /* Our block comes first in our share, then the ones of the folded ranks */
+    lo = ompi_coll_base_split_offset(rank, q, rem);
+    err = ompi_datatype_copy_content_same_ddt(dtype, rcount, rbuf,
+                                              tmpbuf + (ptrdiff_t)lo * blocksize);
+    if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    if (nfold > 0) {
+        for (j = 0; j < nfold; j++) {
+            err = MCA_PML_CALL(isend(tmpbuf + (ptrdiff_t)(lo + j + 1) * blocksize, rcount,
+                                     dtype, rank + (j + 1) * pof_k,
+                                     MCA_COLL_BASE_TAG_REDUCE_SCATTER_BLOCK,
+                                     MCA_PML_BASE_SEND_STANDARD, comm, &reqs[j]));
+            if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+        }
+        err = ompi_request_wait_all(nfold, reqs, MPI_STATUSES_IGNORE);
+        if (MPI_SUCCESS != err) { goto cleanup_and_return; }
+    }
+
+cleanup_and_return:
+    if (NULL != reqs) {
+        if (MPI_ERR_IN_STATUS == err) {
+            for (j = 0; j < max_reqs; j++) {
+                if (MPI_REQUEST_NULL == reqs[j]) continue;
+                if (MPI_ERR_PENDING == reqs[j]->req_status.MPI_ERROR) continue;
+                if (MPI_SUCCESS != reqs[j]->req_status.MPI_ERROR) {
+                    err = reqs[j]->req_status.MPI_ERROR;
+                    break;
+                }
+            }
+        }
+        ompi_coll_base_free_reqs(reqs, max_reqs);
+    }
+    if (tmpbuf_raw)
+        free(tmpbuf_raw);
+    if (tmprecv_raw)
+        free(tmprecv_raw);
+    return err;
+}
@@ -34,7 +34,12 @@
 #include "ompi/mca/pml/pml.h"
 #include "coll_base_util.h"
 #include "coll_base_functions.h"
+#include "opal/util/printf.h"
 #include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 int ompi_coll_base_sendrecv_actual( const void* sendbuf, size_t scount,
                                     ompi_datatype_t* sdatatype,
@@ -505,6 +510,157 @@ int ompi_coll_base_file_peek_next_char_isdigit(FILE *fptr)
     } while (1);
 }
 
+#define RULES_FILE_BYTE_ORDER 0x01020304
+#define RULES_FILE_ALIGN(x) (((x) + 7) & ~((size_t) 7))
+
+int ompi_coll_base_rules_file_map(const char *fname, const char *magic, uint32_t version,
+                                  int nsections, const uint32_t record_size[],
+                                  const void *sections[], size_t count[],
+                                  void **map, size_t *map_size)
+{
+    const ompi_coll_base_rules_file_header_t *header;
+    struct stat st;
+    size_t offset;
+    void *addr;
+    int fd, i;
+
+    *map = NULL;
+    *map_size = 0;
+
+    if (nsections > OMPI_COLL_BASE_RULES_FILE_MAX_SECTIONS) {
+        return OMPI_ERR_BAD_PARAM;
+    }
+
+    fd = open(fname, O_RDONLY);
+    if (fd < 0) {
+        return OMPI_ERR_NOT_FOUND;
+    }
+    if (0 != fstat(fd, &st) || (size_t) st.st_size < sizeof(*header)) {
+        close(fd);
+        return OMPI_ERR_NOT_FOUND;
+    }
+    addr = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  /* the mapping holds its own reference */
+    if (MAP_FAILED == addr) {
+        return OMPI_ERR_NOT_FOUND;
+    }
+
+    header = (const ompi_coll_base_rules_file_header_t *) addr;
+    if (0 != memcmp(header->magic, magic, sizeof(header->magic))) {
+        munmap(addr, st.st_size);
+        return OMPI_ERR_NOT_FOUND;
+    }
+    if (version != header->version || RULES_FILE_BYTE_ORDER != header->byte_order) {
+        goto bad_file;
+    }
+
+    offset = RULES_FILE_ALIGN(sizeof(*header));
+    for (i = 0; i < OMPI_COLL_BASE_RULES_FILE_MAX_SECTIONS; i++) {
+        if (i >= nsections) {
+            if (0 != header->count[i]) {
+                goto bad_file;
+            }
+            continue;
+        }
+        if (record_size[i] != header->record_size[i] ||
+            header->count[i] > ((size_t) st.st_size - offset) / record_size[i]) {
+            goto bad_file;
+        }
+        sections[i] = (const char *) addr + offset;
+        count[i] = header->count[i];
+        offset = RULES_FILE_ALIGN(offset + count[i] * record_size[i]);
+        if (offset > (size_t) st.st_size) {
+            goto bad_file;
+        }
+    }
+
+    *map = addr;
+    *map_size = st.st_size;
+    return OMPI_SUCCESS;
+
+ bad_file:
+    munmap(addr, st.st_size);
+    return OMPI_ERR_BAD_PARAM;
+}
+
+int ompi_coll_base_rules_file_unmap(void *map, size_t map_size)
+{
+    if (NULL == map) {
+        return OMPI_SUCCESS;
+    }
+    return (0 == munmap(map, map_size)) ? OMPI_SUCCESS : OMPI_ERROR;
+}
+
+int ompi_coll_base_rules_file_write(const char *fname, const char *magic, uint32_t version,
+                                    int nsections, const uint32_t record_size[],
+                                    const void *sections[], const size_t count[])
+{
+    static const char padding[8] = {0};
+    ompi_coll_base_rules_file_header_t header;
+    char *tmpname = NULL;
+    size_t len;
+    FILE *fptr;
+    int fd, i;
+
+    if (nsections > OMPI_COLL_BASE_RULES_FILE_MAX_SECTIONS) {
+        return OMPI_ERR_BAD_PARAM;
+    }
+
+    memset(&header, 0, sizeof(header));
+    strncpy(header.magic, magic, sizeof(header.magic));
+    header.version = version;
+    header.byte_order = RULES_FILE_BYTE_ORDER;
+    for (i = 0; i < nsections; i++) {
+        header.record_size[i] = record_size[i];
+        header.count[i] = count[i];
+    }
+
+    if (0 > opal_asprintf(&tmpname, "%s.XXXXXX", fname)) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    fd = mkstemp(tmpname);
+    if (fd < 0 || NULL == (fptr = fdopen(fd, "w"))) {
+        if (fd >= 0) {
+            close(fd);
+            unlink(tmpname);
+        }
+        free(tmpname);
+        return OMPI_ERROR;
+    }
+
+    len = sizeof(header);
+    if (1 != fwrite(&header, sizeof(header), 1, fptr) ||
+        RULES_FILE_ALIGN(len) - len != fwrite(padding, 1, RULES_FILE_ALIGN(len) - len, fptr)) {
+        goto write_error;
+    }
+    for (i = 0; i < nsections; i++) {
+        len = count[i] * record_size[i];
+        if (len != fwrite(sections[i], 1, len, fptr) ||
+            RULES_FILE_ALIGN(len) - len != fwrite(padding, 1, RULES_FILE_ALIGN(len) - len, fptr)) {
+            goto write_error;
+        }
+    }
+    if (0 != fclose(fptr)) {
+        fptr = NULL;
+        goto write_error;
+    }
+    fptr = NULL;
+    /* readers either see the previous file or the complete new one */
+    if (0 != rename(tmpname, fname)) {
+        goto write_error;
+    }
+    free(tmpname);
+    return OMPI_SUCCESS;
+
+ write_error:
+    if (NULL != fptr) {
+        fclose(fptr);
+    }
+    unlink(tmpname);
+    free(tmpname);
+    return OMPI_ERROR;
+}
+
 /**
  * There are certainly simpler implementation for this function when performance
  * is not a critical point. But, as this function is used during the collective
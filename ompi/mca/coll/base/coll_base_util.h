@@ -160,6 +160,18 @@ unsigned int ompi_mirror_perm(unsigned int x, int nbits);
  */
 int ompi_rounddown(int num, int factor);
 
+/*
+ * ompi_coll_base_split_offset: Offset of the share of rank v when n items
+ *     are split among p ranks, the first rem = n % p ranks getting one item
+ *     more than the q = n / p of the others.
+ *     split_offset(v=3, q=2, rem=1) = 7 for n = 11 items among 5 ranks
+ */
+static inline size_t
+ompi_coll_base_split_offset(int v, size_t q, size_t rem)
+{
+    return (size_t)v * q + ((size_t)v < rem ? (size_t)v : rem);
+}
+
 /**
  * If necessary, retain op and store it in the
  * request object, which should be of type ompi_coll_base_nbc_request_t
@@ -198,6 +210,50 @@ int ompi_coll_base_file_getnext_string(FILE *fptr, int *fileline, char** val);
 int ompi_coll_base_file_peek_next_char_is(FILE *fptr, int *fileline, int expected);
 int ompi_coll_base_file_peek_next_char_isdigit(FILE *fptr);
 
+/* Binary rules files: a fixed header followed by up to
+ * OMPI_COLL_BASE_RULES_FILE_MAX_SECTIONS arrays of fixed size records, each
+ * starting on an 8 bytes boundary. The records are the in-memory structures
+ * of the component that wrote the file, so a file can only be used by the
+ * same build on the same architecture; the header records the byte order and
+ * the size of each record to detect mismatches. The file is mapped read-only
+ * and shared, so all the processes of a node share a single copy.
+ */
+#define OMPI_COLL_BASE_RULES_FILE_MAX_SECTIONS 4
+
+typedef struct ompi_coll_base_rules_file_header_t {
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t record_size[OMPI_COLL_BASE_RULES_FILE_MAX_SECTIONS];
+    uint64_t count[OMPI_COLL_BASE_RULES_FILE_MAX_SECTIONS];
+} ompi_coll_base_rules_file_header_t;
+
+/* Map fname and return the start and record count of each of the nsections
+ * sections. Returns OMPI_ERR_NOT_FOUND if the file cannot be opened or does
+ * not start with magic (i.e. it is probably a text rules file), and
+ * OMPI_ERR_BAD_PARAM if it does but cannot be used.
+ */
+int ompi_coll_base_rules_file_map(const char *fname, const char *magic, uint32_t version,
+                                  int nsections, const uint32_t record_size[],
+                                  const void *sections[], size_t count[],
+                                  void **map, size_t *map_size);
+int ompi_coll_base_rules_file_unmap(void *map, size_t map_size);
+/* Write the sections to fname, through a temporary file renamed at the end */
+int ompi_coll_base_rules_file_write(const char *fname, const char *magic, uint32_t version,
+                                    int nsections, const uint32_t record_size[],
+                                    const void *sections[], const size_t count[]);
+
+/* Progress thread shared by the nonblocking collective components. The
+ * thread is started by the first retain and joined by the last release;
+ * it calls opal_progress() while at least one handle is outstanding, i.e.
+ * between a post and the matching done, and sleeps otherwise.
+ */
+OMPI_DECLSPEC extern bool ompi_coll_base_progress_thread_bind;
+int ompi_coll_base_progress_thread_retain(void);
+void ompi_coll_base_progress_thread_release(void);
+void ompi_coll_base_progress_thread_post(void);
+void ompi_coll_base_progress_thread_done(void);
+
 /* Miscellaneous function */
 const char* mca_coll_base_colltype_to_str(int collid);
 int mca_coll_base_name_to_colltype(const char* name);
@@ -194,6 +194,19 @@ typedef int
 (*mca_coll_base_module_enable_1_1_0_fn_t)(struct mca_coll_base_module_3_0_0_t* module,
                                           struct ompi_communicator_t *comm);
 
+/**
+ * Fused allreduce
+ *
+ * Performs n independent allreduce operations on the same communicator
+ * as a single collective, each with its own buffers, count, datatype and
+ * operation. Optional, used by the MPIX fusion extension. When no module
+ * provides it the operations are issued one by one.
+ */
+typedef int (*mca_coll_base_module_allreduce_multi_fn_t)
+  (int n, const void * const *sbufs, void * const *rbufs, const size_t *counts,
+   struct ompi_datatype_t * const *dtypes, struct ompi_op_t * const *ops,
+   struct ompi_communicator_t *comm, struct mca_coll_base_module_3_0_0_t *module);
+
 /* not #if conditional on OPAL_ENABLE_FT_MPI for ABI */
 /* Fault Tolerant Agreement - Consensus Protocol */
 
@@ -642,6 +655,9 @@ struct mca_coll_base_module_3_0_0_t {
 
     mca_coll_base_module_revoke_local_fn_t coll_revoke_local;
 
+    /* fused collective functions */
+    mca_coll_base_module_allreduce_multi_fn_t coll_allreduce_multi;
+
     /** Data storage for all the algorithms defined in the base. Should
         not be used by other modules */
     struct mca_coll_base_comm_t* base_data;
@@ -812,6 +828,9 @@ struct mca_coll_base_comm_coll_t {
     mca_coll_base_module_reduce_local_fn_t coll_reduce_local;
     mca_coll_base_module_3_0_0_t *coll_reduce_local_module;
 
+    mca_coll_base_module_allreduce_multi_fn_t coll_allreduce_multi;
+    mca_coll_base_module_3_0_0_t *coll_allreduce_multi_module;
+
     mca_coll_base_module_agree_fn_t coll_agree;
     mca_coll_base_module_3_0_0_t *coll_agree_module;
     mca_coll_base_module_iagree_fn_t coll_iagree;
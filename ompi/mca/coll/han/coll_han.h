@@ -151,6 +151,31 @@ struct mca_coll_han_reduce_args_s {
 };
 typedef struct mca_coll_han_reduce_args_s mca_coll_han_reduce_args_t;
 
+/*
+ * Per-communicator measurements of the pipelined allreduce. The time of one
+ * pipeline step (a t3 task, which overlaps the intra-node stages of one
+ * segment with the inter-node stages of the next ones) is modeled as
+ * alpha + beta * segment_bytes, fitted by least squares with exponential
+ * forgetting, and used to pick the segment size of the next operations.
+ * The cumulative stage times are exposed as MPI_T performance variables.
+ */
+typedef struct mca_coll_han_pipeline_stats_s {
+    /* decayed sums of the (segment bytes, step seconds) samples */
+    double n, sum_b, sum_t, sum_bb, sum_bt;
+    /* model agreed upon by all ranks (segment choices must match) */
+    double alpha, beta;
+    bool model_valid;
+    unsigned int calls;
+    /* seconds spent in the intra-node (low_comm) stages */
+    double intra_time;
+    /* seconds spent waiting on the inter-node (up_comm) stages,
+     * i.e. the part of them that was not overlapped */
+    double inter_wait_time;
+    unsigned long long segments;
+    /* segment size (bytes) used by the last operation */
+    unsigned long long segsize;
+} mca_coll_han_pipeline_stats_t;
+
 struct mca_coll_han_allreduce_args_s {
     mca_coll_task_t *cur_task;
     ompi_communicator_t *up_comm;
@@ -169,6 +194,7 @@ struct mca_coll_han_allreduce_args_s {
     int last_seg_count;
     bool noop;
     int *completed;
+    mca_coll_han_pipeline_stats_t *stats;
 };
 typedef struct mca_coll_han_allreduce_args_s mca_coll_han_allreduce_args_t;
 
@@ -268,6 +294,21 @@ typedef struct mca_coll_han_op_module_name_t {
     mca_coll_han_op_up_low_module_name_t alltoallv;
 } mca_coll_han_op_module_name_t;
 
+/**
+ * Topological domains along which the processes of a node can be split
+ * (coll_han_intra_node_domain). Only one of them is used at a time: the
+ * INTRA_DOMAIN and INTER_DOMAIN levels are fixed entries of
+ * TOPO_LVL_T, like the other levels, so nesting several domains would
+ * need a variable number of levels in the dynamic selection. Only the
+ * simple bcast and allreduce cross these levels.
+ */
+typedef enum mca_coll_han_domain_t {
+    HAN_DOMAIN_NONE = 0,
+    HAN_DOMAIN_SOCKET,
+    HAN_DOMAIN_NUMA,
+    HAN_DOMAIN_L3CACHE
+} mca_coll_han_domain_t;
+
 /**
  * Structure to hold the han coll component.  First it holds the
  * base coll component, and then holds a bunch of
@@ -301,6 +342,11 @@ typedef struct mca_coll_han_component_t {
     uint32_t han_allreduce_up_module;
     /* low level module for allreduce */
     uint32_t han_allreduce_low_module;
+    /* pick the allreduce segment size from the measured pipeline step time */
+    bool han_allreduce_adaptive_segsize;
+    /* bounds of the adaptive allreduce segment size */
+    uint32_t han_allreduce_min_segsize;
+    uint32_t han_allreduce_max_segsize;
     /* up level module for allgather */
     uint32_t han_allgather_up_module;
     /* low level module for allgather */
@@ -339,6 +385,8 @@ typedef struct mca_coll_han_component_t {
      * (but disables topological optimisations)
      */
     bool han_reproducible;
+    /* topological domain splitting the node level (mca_coll_han_domain_t) */
+    int han_intra_node_domain;
     bool use_simple_algorithm[COLLCOUNT];
     int use_algorithm[COLLCOUNT];
     int use_algorithm_param[COLLCOUNT]; // MCA parmeter id for algo, to know if user provided
@@ -347,6 +395,7 @@ typedef struct mca_coll_han_component_t {
     bool use_dynamic_file_rules;
     bool dump_dynamic_rules;
     char* dynamic_rules_filename;
+    char* dynamic_rules_binary_output;
     /* Dynamic rules from file */
     mca_coll_han_dynamic_rules_t dynamic_rules;
     /* Dynamic rules from mca parameter */
@@ -429,6 +478,10 @@ typedef struct mca_coll_han_module_t {
     struct ompi_communicator_t **cached_low_comms;
     struct ompi_communicator_t **cached_up_comms;
     int *cached_vranks;
+    /* vranks inside the node when the intra/inter domain levels exist:
+     * <domain index> * domain_size + <rank in the domain> */
+    int *cached_domain_vranks;
+    int domain_size;
     int *cached_topo;
     bool is_mapbycore;
     bool are_ppn_imbalanced;
@@ -471,6 +524,9 @@ typedef struct mca_coll_han_module_t {
      * (e.g., allgather uses a gather buffer and a reorder buffer). */
     char *scratch_buf[2];
     size_t scratch_buf_size[2];
+
+    /* Measurements of the pipelined allreduce on this communicator */
+    mca_coll_han_pipeline_stats_t allreduce_stats;
 } mca_coll_han_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_han_module_t);
 
@@ -636,6 +692,9 @@ mca_coll_han_scatter_intra_dynamic(SCATTER_BASE_ARGS,
 int
 mca_coll_han_scatterv_intra_dynamic(SCATTERV_BASE_ARGS,
                                     mca_coll_base_module_t *module);
+mca_coll_han_module_t *
+mca_coll_han_comm_module(struct ompi_communicator_t *comm);
+
 int
 mca_coll_han_revoke_local(struct ompi_communicator_t *comm,
                           mca_coll_base_module_t *module);
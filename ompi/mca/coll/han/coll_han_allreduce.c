@@ -26,6 +26,8 @@
 #include "ompi/mca/coll/base/coll_tags.h"
 #include "ompi/mca/pml/pml.h"
 #include "coll_han_trigger.h"
+#include "opal/mca/timer/base/base.h"
+#include "opal/util/minmax.h"
 
 static int mca_coll_han_allreduce_t0_task(void *task_args);
 static int mca_coll_han_allreduce_t1_task(void *task_args);
@@ -50,7 +52,8 @@ mca_coll_han_set_allreduce_args(mca_coll_han_allreduce_args_t * args,
                                 int cur_seg,
                                 int w_rank,
                                 int last_seg_count,
-                                bool noop, ompi_request_t * req, int *completed)
+                                bool noop, ompi_request_t * req, int *completed,
+                                mca_coll_han_pipeline_stats_t *stats)
 {
     args->cur_task = cur_task;
     args->sbuf = sbuf;
@@ -69,6 +72,146 @@ mca_coll_han_set_allreduce_args(mca_coll_han_allreduce_args_t * args,
     args->noop = noop;
     args->req = req;
     args->completed = completed;
+    args->stats = stats;
+}
+
+/* Forgetting factor of the pipeline step model, applied per sample */
+#define HAN_ALLREDUCE_MODEL_DECAY 0.99
+/* Number of pipelined allreduces between two agreements on the model */
+#define HAN_ALLREDUCE_MODEL_INTERVAL 16
+/* Number of pipeline steps (t3 tasks) overlapping in the steady state */
+#define HAN_ALLREDUCE_PIPELINE_DEPTH 4
+
+/*
+ * Account the time of a task in the pipeline stats: the intra-node stages
+ * run from start to wait_start, the rest is spent waiting for the
+ * inter-node ones. Pipeline steps, ending with the broadcast of a segment
+ * of step_count elements, are also fed to the step model (0 otherwise).
+ */
+static inline void
+han_allreduce_account(mca_coll_han_allreduce_args_t *t, opal_timer_t start,
+                      opal_timer_t wait_start, int step_count)
+{
+    mca_coll_han_pipeline_stats_t *stats = t->stats;
+    opal_timer_t end = opal_timer_base_get_usec();
+
+    stats->intra_time += (double) (wait_start - start) * 1e-6;
+    stats->inter_wait_time += (double) (end - wait_start) * 1e-6;
+
+    if (step_count > 0) {
+        size_t dtype_size;
+        ompi_datatype_type_size(t->dtype, &dtype_size);
+
+        double b = (double) step_count * dtype_size;
+        double sec = (double) (end - start) * 1e-6;
+
+        stats->n = stats->n * HAN_ALLREDUCE_MODEL_DECAY + 1.0;
+        stats->sum_b = stats->sum_b * HAN_ALLREDUCE_MODEL_DECAY + b;
+        stats->sum_t = stats->sum_t * HAN_ALLREDUCE_MODEL_DECAY + sec;
+        stats->sum_bb = stats->sum_bb * HAN_ALLREDUCE_MODEL_DECAY + b * b;
+        stats->sum_bt = stats->sum_bt * HAN_ALLREDUCE_MODEL_DECAY + b * sec;
+        stats->segments++;
+    }
+}
+
+/*
+ * Refresh the step model, collectively. The local least squares fits are
+ * combined with a max over the communicator, so that all the ranks keep
+ * choosing the same segment size; an unusable fit on any rank (e.g. all
+ * samples of the same size) invalidates the model.
+ */
+static void
+han_allreduce_update_model(mca_coll_han_module_t *han_module, struct ompi_communicator_t *comm)
+{
+    mca_coll_han_pipeline_stats_t *stats = &han_module->allreduce_stats;
+    double fit[3] = {0.0, 0.0, 1.0};
+    double det = stats->n * stats->sum_bb - stats->sum_b * stats->sum_b;
+
+    if (stats->n >= 2.0 && det > 1e-9 * stats->n * stats->sum_bb) {
+        double beta = (stats->n * stats->sum_bt - stats->sum_b * stats->sum_t) / det;
+        double alpha = (stats->sum_t - beta * stats->sum_b) / stats->n;
+
+        if (beta > 0.0) {
+            fit[0] = (alpha > 0.0 ? alpha : 0.0);
+            fit[1] = beta;
+            fit[2] = 0.0;
+        }
+    }
+
+    if (OMPI_SUCCESS != han_module->previous_allreduce(MPI_IN_PLACE, fit, 3, MPI_DOUBLE, MPI_MAX,
+                                                       comm, han_module->previous_allreduce_module)) {
+        return;
+    }
+
+    stats->model_valid = (0.0 == fit[2]);
+    stats->alpha = fit[0];
+    stats->beta = fit[1];
+}
+
+/*
+ * Segment count of the pipelined allreduce. With the adaptive segment size,
+ * the segment size s minimizing the modeled completion time
+ *     (ceil(m / s) + depth - 1) * (alpha + beta * s)
+ * of an m-byte message is picked among powers of two between the bounds.
+ * Since the model is measured on this communicator, it reflects its intra-
+ * and inter-node throughput, and thus its node count.
+ *
+ * Steps of a single size cannot be fitted, so the last two calls before
+ * each refresh of the model explore half and twice the segment size. The
+ * call count is the same on all the ranks, and so are their choices.
+ */
+static int
+han_allreduce_seg_count(mca_coll_han_module_t *han_module, struct ompi_communicator_t *comm,
+                        size_t count, size_t dtype_size)
+{
+    mca_coll_han_pipeline_stats_t *stats = &han_module->allreduce_stats;
+    size_t segsize = mca_coll_han_component.han_allreduce_segsize;
+    int seg_count = count;
+
+    if (mca_coll_han_component.han_allreduce_adaptive_segsize) {
+        size_t s_min = opal_max(mca_coll_han_component.han_allreduce_min_segsize, dtype_size);
+        size_t s_max = opal_max(mca_coll_han_component.han_allreduce_max_segsize, s_min);
+        int phase = ++stats->calls % HAN_ALLREDUCE_MODEL_INTERVAL;
+
+        if (0 == phase) {
+            han_allreduce_update_model(han_module, comm);
+        }
+
+        if (stats->model_valid) {
+            size_t m = count * dtype_size;
+            double best = -1.0;
+
+            for (size_t s = s_min; s <= s_max; s *= 2) {
+                double nseg = (double) ((m + s - 1) / s);
+                double step = stats->alpha + stats->beta * (double) opal_min(s, m);
+                double cost = (nseg + HAN_ALLREDUCE_PIPELINE_DEPTH - 1) * step;
+
+                if (best < 0.0 || cost < best) {
+                    best = cost;
+                    segsize = s;
+                }
+                if (s >= m) {
+                    break;
+                }
+            }
+
+            OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
+                                 "HAN Allreduce adaptive segsize %zu for %zu bytes "
+                                 "(alpha %g s, beta %g s/B)\n", segsize, count * dtype_size,
+                                 stats->alpha, stats->beta));
+        }
+
+        if (HAN_ALLREDUCE_MODEL_INTERVAL - 2 == phase && segsize / 2 >= s_min) {
+            segsize /= 2;
+        } else if (HAN_ALLREDUCE_MODEL_INTERVAL - 1 == phase && segsize * 2 <= s_max) {
+            segsize *= 2;
+        }
+    }
+
+    COLL_BASE_COMPUTED_SEGCOUNT(segsize, dtype_size, seg_count);
+    stats->segsize = (unsigned long long) seg_count * dtype_size;
+
+    return seg_count;
 }
 
 /*
@@ -128,13 +271,12 @@ mca_coll_han_allreduce_intra(const void *sbuf,
     /* use MCA parameters for now */
     low_comm = han_module->cached_low_comms[mca_coll_han_component.han_allreduce_low_module];
     up_comm = han_module->cached_up_comms[mca_coll_han_component.han_allreduce_up_module];
-    COLL_BASE_COMPUTED_SEGCOUNT(mca_coll_han_component.han_allreduce_segsize, dtype_size,
-                                seg_count);
+    seg_count = han_allreduce_seg_count(han_module, comm, count, dtype_size);
 
     /* Determine number of elements sent per task. */
     OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
-                         "In HAN Allreduce seg_size %d seg_count %d count %zu\n",
-                         mca_coll_han_component.han_allreduce_segsize, seg_count, count));
+                         "In HAN Allreduce seg_size %llu seg_count %d count %zu\n",
+                         han_module->allreduce_stats.segsize, seg_count, count));
     int num_segments = (count + seg_count - 1) / seg_count;
 
     int low_rank = ompi_comm_rank(low_comm);
@@ -149,7 +291,8 @@ mca_coll_han_allreduce_intra(const void *sbuf,
     mca_coll_han_set_allreduce_args(t, t0, (char *) sbuf, (char *) rbuf, seg_count, dtype, op,
                                     root_up_rank, root_low_rank, up_comm, low_comm, num_segments, 0,
                                     w_rank, count - (num_segments - 1) * seg_count,
-                                    low_rank != root_low_rank, NULL, completed);
+                                    low_rank != root_low_rank, NULL, completed,
+                                    &han_module->allreduce_stats);
     /* Init t0 task */
     init_task(t0, mca_coll_han_allreduce_t0_task, (void *) (t));
     /* Issure t0 task */
@@ -211,6 +354,7 @@ int mca_coll_han_allreduce_t0_task(void *task_args)
                          "[%d] HAN Allreduce:  t0 %d r_buf %d\n", t->w_rank, t->cur_seg,
                          ((int *) t->rbuf)[0]));
     OBJ_RELEASE(t->cur_task);
+    opal_timer_t start = opal_timer_base_get_usec(), wait_start;
     ptrdiff_t extent, lb;
     ompi_datatype_get_extent(t->dtype, &lb, &extent);
     if (MPI_IN_PLACE == t->sbuf) {
@@ -230,6 +374,8 @@ int mca_coll_han_allreduce_t0_task(void *task_args)
                                          t->op, t->root_low_rank, t->low_comm,
                                          t->low_comm->c_coll->coll_reduce_module);
     }
+    wait_start = opal_timer_base_get_usec();
+    han_allreduce_account(t, start, wait_start, 0);
     return OMPI_SUCCESS;
 }
 
@@ -241,6 +387,7 @@ int mca_coll_han_allreduce_t1_task(void *task_args)
                          "[%d] HAN Allreduce:  t1 %d r_buf %d\n", t->w_rank, t->cur_seg,
                          ((int *) t->rbuf)[0]));
     OBJ_RELEASE(t->cur_task);
+    opal_timer_t start = opal_timer_base_get_usec(), wait_start;
     ptrdiff_t extent, lb;
     ompi_datatype_get_extent(t->dtype, &lb, &extent);
     ompi_request_t *ireduce_req;
@@ -284,9 +431,11 @@ int mca_coll_han_allreduce_t1_task(void *task_args)
                                              t->low_comm->c_coll->coll_reduce_module);
 	}
     }
+    wait_start = opal_timer_base_get_usec();
     if (!t->noop) {
         ompi_request_wait(&ireduce_req, MPI_STATUS_IGNORE);
     }
+    han_allreduce_account(t, start, wait_start, 0);
 
     return OMPI_SUCCESS;
 }
@@ -299,6 +448,7 @@ int mca_coll_han_allreduce_t2_task(void *task_args)
                          "[%d] HAN Allreduce:  t2 %d r_buf %d\n", t->w_rank, t->cur_seg,
                          ((int *) t->rbuf)[0]));
     OBJ_RELEASE(t->cur_task);
+    opal_timer_t start = opal_timer_base_get_usec(), wait_start;
     ptrdiff_t extent, lb;
     ompi_datatype_get_extent(t->dtype, &lb, &extent);
     ompi_request_t *reqs[2];
@@ -358,10 +508,11 @@ int mca_coll_han_allreduce_t2_task(void *task_args)
                                              t->low_comm->c_coll->coll_reduce_module);
 	}
     }
+    wait_start = opal_timer_base_get_usec();
     if (!t->noop && req_count > 0) {
         ompi_request_wait_all(req_count, reqs, MPI_STATUSES_IGNORE);
     }
-
+    han_allreduce_account(t, start, wait_start, 0);
 
     return OMPI_SUCCESS;
 }
@@ -374,6 +525,7 @@ int mca_coll_han_allreduce_t3_task(void *task_args)
                          "[%d] HAN Allreduce:  t3 %d r_buf %d\n", t->w_rank, t->cur_seg,
                          ((int *) t->rbuf)[0]));
     OBJ_RELEASE(t->cur_task);
+    opal_timer_t start = opal_timer_base_get_usec(), wait_start;
     ptrdiff_t extent, lb;
     ompi_datatype_get_extent(t->dtype, &lb, &extent);
     ompi_request_t *reqs[2];
@@ -446,9 +598,11 @@ int mca_coll_han_allreduce_t3_task(void *task_args)
 
     t->low_comm->c_coll->coll_bcast((char *) t->rbuf, tmp_count, t->dtype, t->root_low_rank,
                                     t->low_comm, t->low_comm->c_coll->coll_bcast_module);
+    wait_start = opal_timer_base_get_usec();
     if (!t->noop && req_count > 0) {
         ompi_request_wait_all(req_count, reqs, MPI_STATUSES_IGNORE);
     }
+    han_allreduce_account(t, start, wait_start, tmp_count);
 
     t->completed[0]++;
     OPAL_OUTPUT_VERBOSE((30, mca_coll_han_component.han_output,
@@ -458,6 +612,27 @@ int mca_coll_han_allreduce_t3_task(void *task_args)
     return OMPI_SUCCESS;
 }
 
+/*
+ * Reduce on rank 0 of comm, the data of the other ranks coming from sbuf,
+ * or from rbuf when sbuf is MPI_IN_PLACE.
+ */
+static inline int
+han_allreduce_reduce_to_zero(const void *sbuf, void *rbuf, size_t count,
+                             struct ompi_datatype_t *dtype, struct ompi_op_t *op,
+                             struct ompi_communicator_t *comm)
+{
+    if (MPI_IN_PLACE == sbuf) {
+        if (0 == ompi_comm_rank(comm)) {
+            return comm->c_coll->coll_reduce(MPI_IN_PLACE, (char *)rbuf,
+                count, dtype, op, 0, comm, comm->c_coll->coll_reduce_module);
+        }
+        return comm->c_coll->coll_reduce((char *)rbuf, NULL,
+            count, dtype, op, 0, comm, comm->c_coll->coll_reduce_module);
+    }
+    return comm->c_coll->coll_reduce((char *)sbuf, (char *)rbuf,
+        count, dtype, op, 0, comm, comm->c_coll->coll_reduce_module);
+}
+
 /*
  * Short implementation of allreduce that only does hierarchical
  * communications without tasks.
@@ -473,6 +648,7 @@ mca_coll_han_allreduce_intra_simple(const void *sbuf,
 {
     ompi_communicator_t *low_comm;
     ompi_communicator_t *up_comm;
+    ompi_communicator_t *intra_comm, *inter_comm;
     int root_low_rank = 0;
     int low_rank;
     int ret;
@@ -503,25 +679,15 @@ mca_coll_han_allreduce_intra_simple(const void *sbuf,
 
     low_comm = han_module->sub_comm[INTRA_NODE];
     up_comm = han_module->sub_comm[INTER_NODE];
+    intra_comm = han_module->sub_comm[INTRA_DOMAIN];
+    inter_comm = han_module->sub_comm[INTER_DOMAIN];
     low_rank = ompi_comm_rank(low_comm);
 
-    /* Low_comm reduce */
-    if (MPI_IN_PLACE == sbuf) {
-        if (low_rank == root_low_rank) {
-            ret = low_comm->c_coll->coll_reduce(MPI_IN_PLACE, (char *)rbuf,
-                count, dtype, op, root_low_rank,
-                low_comm, low_comm->c_coll->coll_reduce_module);
-        }
-        else {
-            ret = low_comm->c_coll->coll_reduce((char *)rbuf, NULL,
-                count, dtype, op, root_low_rank,
-                low_comm, low_comm->c_coll->coll_reduce_module);
-        }
-    }
-    else {
-        ret = low_comm->c_coll->coll_reduce((char *)sbuf, (char *)rbuf,
-                count, dtype, op, root_low_rank,
-                low_comm, low_comm->c_coll->coll_reduce_module);
+    /* Low_comm reduce, first inside each domain of the node when they exist */
+    if (NULL != intra_comm) {
+        ret = han_allreduce_reduce_to_zero(sbuf, rbuf, count, dtype, op, intra_comm);
+    } else {
+        ret = han_allreduce_reduce_to_zero(sbuf, rbuf, count, dtype, op, low_comm);
     }
     if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
         OPAL_OUTPUT_VERBOSE((30, cs->han_output,
@@ -530,6 +696,17 @@ mca_coll_han_allreduce_intra_simple(const void *sbuf,
         goto prev_allreduce;
     }
 
+    /* Domain leaders combine their partial results on the node leader */
+    if (NULL != intra_comm && 0 == ompi_comm_rank(intra_comm)) {
+        ret = han_allreduce_reduce_to_zero(MPI_IN_PLACE, rbuf, count, dtype, op, inter_comm);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
+            OPAL_OUTPUT_VERBOSE((30, cs->han_output,
+                             "HAN/ALLREDUCE: inter domain reduce failed. \n"));
+            /* Only the domain leaders are here, do not fallback */
+            return ret;
+        }
+    }
+
     /* Local roots perform a allreduce on the upper comm */
     if (low_rank == root_low_rank) {
         ret = up_comm->c_coll->coll_allreduce(MPI_IN_PLACE, rbuf, count, dtype, op,
@@ -547,9 +724,23 @@ mca_coll_han_allreduce_intra_simple(const void *sbuf,
         }
     }
 
-    /* Low_comm bcast */
-    ret = low_comm->c_coll->coll_bcast(rbuf, count, dtype,
-                root_low_rank, low_comm, low_comm->c_coll->coll_bcast_module);
+    /* Low_comm bcast, through the domain leaders when the domains exist */
+    if (NULL != intra_comm) {
+        if (0 == ompi_comm_rank(intra_comm)) {
+            ret = inter_comm->c_coll->coll_bcast(rbuf, count, dtype,
+                        0, inter_comm, inter_comm->c_coll->coll_bcast_module);
+            if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
+                OPAL_OUTPUT_VERBOSE((30, cs->han_output,
+                                 "HAN/ALLREDUCE: inter domain bcast failed. \n"));
+                return ret;
+            }
+        }
+        ret = intra_comm->c_coll->coll_bcast(rbuf, count, dtype,
+                    0, intra_comm, intra_comm->c_coll->coll_bcast_module);
+    } else {
+        ret = low_comm->c_coll->coll_bcast(rbuf, count, dtype,
+                    root_low_rank, low_comm, low_comm->c_coll->coll_bcast_module);
+    }
     if (OPAL_UNLIKELY(OMPI_SUCCESS != ret)) {
         OPAL_OUTPUT_VERBOSE((30, cs->han_output,
                              "HAN/ALLREDUCE: low comm bcast failed. "
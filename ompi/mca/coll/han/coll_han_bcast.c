@@ -289,6 +289,26 @@ mca_coll_han_bcast_intra_simple(void *buf,
         //ompi_request_wait(&req, MPI_STATUS_IGNORE);
 
     }
+
+    if (NULL != han_module->sub_comm[INTRA_DOMAIN]) {
+        /* Cross the domains of the node once, then broadcast inside each one */
+        ompi_communicator_t *intra_comm = han_module->sub_comm[INTRA_DOMAIN];
+        ompi_communicator_t *inter_comm = han_module->sub_comm[INTER_DOMAIN];
+        int root_intra_rank, root_inter_rank;
+
+        mca_coll_han_get_ranks(han_module->cached_domain_vranks, root_low_rank,
+                               han_module->domain_size, &root_intra_rank, &root_inter_rank);
+        if (ompi_comm_rank(intra_comm) == root_intra_rank) {
+            err = inter_comm->c_coll->coll_bcast(buf, count, dtype, root_inter_rank, inter_comm,
+                                                 inter_comm->c_coll->coll_bcast_module);
+            if (OMPI_SUCCESS != err) {
+                return err;
+            }
+        }
+        return intra_comm->c_coll->coll_bcast(buf, count, dtype, root_intra_rank, intra_comm,
+                                              intra_comm->c_coll->coll_bcast_module);
+    }
+
     low_comm->c_coll->coll_bcast(buf, count, dtype, root_low_rank,
                                  low_comm, low_comm->c_coll->coll_bcast_module);
 
@@ -24,6 +24,8 @@
 
 #include "ompi_config.h"
 
+#include <stddef.h>
+
 #include "opal/util/show_help.h"
 #include "opal/util/argv.h"
 #include "ompi/constants.h"
@@ -33,6 +35,7 @@
 #include "coll_han_dynamic_file.h"
 #include "coll_han_algorithms.h"
 #include "ompi/mca/coll/base/coll_base_util.h"
+#include "opal/mca/base/mca_base_pvar.h"
 
 /*
  * Public string showing the coll ompi_han component version number
@@ -62,6 +65,7 @@ opal_mutex_t mca_coll_han_lock = OPAL_MUTEX_STATIC_INIT;
 static int han_open(void);
 static int han_close(void);
 static int han_register(void);
+static void han_register_pvars(void);
 
 /*
  * Instantiate the public struct with all of our public information
@@ -219,6 +223,17 @@ static mca_base_var_enum_value_t level_enumerator[] = {
     { INTRA_NODE, "intra_node" },
     { INTER_NODE, "inter_node" },
     { GLOBAL_COMMUNICATOR, "global_communicator" },
+    { INTRA_DOMAIN, "intra_domain" },
+    { INTER_DOMAIN, "inter_domain" },
+    { 0 }
+};
+
+/* Domains along which the node level can be split */
+static mca_base_var_enum_value_t domain_enumerator[] = {
+    { HAN_DOMAIN_NONE, "none" },
+    { HAN_DOMAIN_SOCKET, "socket" },
+    { HAN_DOMAIN_NUMA, "numa" },
+    { HAN_DOMAIN_L3CACHE, "l3cache" },
     { 0 }
 };
 
@@ -289,6 +304,7 @@ static int han_register(void)
     COLLTYPE_T coll;
     TOPO_LVL_T topo_lvl;
     COMPONENT_T component;
+    mca_base_var_enum_t *new_enum;
 
     (void) mca_base_component_var_register(c, "priority", "Priority of the HAN coll component",
                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
@@ -347,6 +363,30 @@ static int han_register(void)
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_ALL, &cs->han_allreduce_segsize);
 
+    cs->han_allreduce_adaptive_segsize = false;
+    (void) mca_base_component_var_register(c, "allreduce_adaptive_segsize",
+                                           "Choose the segment size of the pipelined allreduce per "
+                                           "message size and communicator from the measured time of "
+                                           "the pipeline steps, instead of using allreduce_segsize. "
+                                           "The latter is used until enough measurements exist",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_ALL, &cs->han_allreduce_adaptive_segsize);
+
+    cs->han_allreduce_min_segsize = 16384;
+    (void) mca_base_component_var_register(c, "allreduce_min_segsize",
+                                           "Smallest segment size considered by the adaptive allreduce",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_ALL, &cs->han_allreduce_min_segsize);
+
+    cs->han_allreduce_max_segsize = 4194304;
+    (void) mca_base_component_var_register(c, "allreduce_max_segsize",
+                                           "Largest segment size considered by the adaptive allreduce",
+                                           MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_ALL, &cs->han_allreduce_max_segsize);
+
     cs->han_allreduce_up_module = 0;
     (void) mca_coll_han_query_module_from_mca(c, "allreduce_up_module",
                                               "up level module for allreduce, 0 libnbc, 1 adapt",
@@ -460,6 +500,25 @@ static int han_register(void)
                                            OPAL_INFO_LVL_3,
                                            MCA_BASE_VAR_SCOPE_ALL, &cs->han_reproducible);
 
+    cs->han_intra_node_domain = HAN_DOMAIN_NONE;
+    (void) mca_base_var_enum_create("coll_han_intra_node_domain",
+                                    domain_enumerator, &new_enum);
+    (void) mca_base_component_var_register(c, "intra_node_domain",
+                                           "Split the processes of each node further along this "
+                                           "topological domain, adding the intra_domain and "
+                                           "inter_domain levels below the node. Only used by the "
+                                           "simple bcast and allreduce algorithms (e.g. "
+                                           "coll_han_use_simple_bcast); the default pipelined ones keep "
+                                           "a flat intra-node level. The domains of a node must "
+                                           "hold the same number of processes. Only one domain level "
+                                           "is supported (not nested socket, NUMA and L3 levels): "
+                                           "the dynamic selection gives every level a fixed id and "
+                                           "its own per-collective module parameters",
+                                           MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL, &cs->han_intra_node_domain);
+    OBJ_RELEASE(new_enum);
+
     cs->han_packbuf_bytes = 128*1024;
     (void) mca_base_component_var_register(c, "packbuf_bytes",
                                            "The number of bytes in each HAN packbuf.",
@@ -481,7 +540,6 @@ static int han_register(void)
        return OMPI_ERROR;
     }
 
-    mca_base_var_enum_t *new_enum;
     for(coll = 0 ; coll < COLLCOUNT ; coll++) {
         if (!mca_coll_han_is_coll_dynamic_implemented(coll)
             || (0 == mca_coll_han_component.num_available_algorithms[coll])) {
@@ -537,7 +595,7 @@ static int han_register(void)
 
     /* Dynamic rules MCA parameters */
     memset(cs->mca_sub_components, 0,
-           COLLCOUNT * (GLOBAL_COMMUNICATOR+1) * sizeof(COMPONENT_T));
+           COLLCOUNT * NB_TOPO_LVL * sizeof(COMPONENT_T));
 
     for(coll = 0; coll < COLLCOUNT; coll++) {
         if(!mca_coll_han_is_coll_dynamic_implemented(coll)) {
@@ -546,7 +604,7 @@ static int han_register(void)
         /*
          * Default values
          */
-        for (topo_lvl = 0 ; topo_lvl < GLOBAL_COMMUNICATOR ; topo_lvl++) {
+        for (topo_lvl = 0 ; topo_lvl < NB_TOPO_LVL ; topo_lvl++) {
             cs->mca_sub_components[coll][topo_lvl] = TUNED;
         }
         cs->mca_sub_components[coll][GLOBAL_COMMUNICATOR] = HAN;
@@ -611,6 +669,19 @@ static int han_register(void)
                                            MCA_BASE_VAR_SCOPE_ALL,
                                            &(cs->dynamic_rules_filename));
 
+    cs->dynamic_rules_binary_output = NULL;
+    (void) mca_base_component_var_register(&mca_coll_han_component.super.collm_version,
+                                           "dynamic_rules_binary_output",
+                                           "If set, the first process of the job writes the rules read from the "
+                                           "dynamic rules file to this file in a binary format. Giving the binary "
+                                           "file as dynamic_rules_filename then avoids parsing the rules on every "
+                                           "process: the file is mapped read-only and shared by the processes of "
+                                           "each node. It is only valid for the same Open MPI build and architecture",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &(cs->dynamic_rules_binary_output));
+
     cs->dump_dynamic_rules = false;
     (void) mca_base_component_var_register(&mca_coll_han_component.super.collm_version,
                                            "dump_dynamic_rules",
@@ -667,5 +738,81 @@ static int han_register(void)
                                            MCA_BASE_VAR_SCOPE_ALL,
                                            &(cs->han_large_fragment_size));
 
+    han_register_pvars();
+
     return OMPI_SUCCESS;
 }
+
+/*
+ * MPI_T performance variables of the pipelined allreduce. They are bound
+ * to a communicator and expose a field of the allreduce_stats of the HAN
+ * module serving it.
+ */
+typedef struct han_pvar_desc_s {
+    size_t offset;
+    size_t size;
+} han_pvar_desc_t;
+
+static han_pvar_desc_t han_pvar_desc[] = {
+    {offsetof(mca_coll_han_pipeline_stats_t, intra_time), sizeof(double)},
+    {offsetof(mca_coll_han_pipeline_stats_t, inter_wait_time), sizeof(double)},
+    {offsetof(mca_coll_han_pipeline_stats_t, segments), sizeof(unsigned long long)},
+    {offsetof(mca_coll_han_pipeline_stats_t, segsize), sizeof(unsigned long long)},
+};
+
+static int han_pvar_notify(mca_base_pvar_t *pvar, mca_base_pvar_event_t event,
+                           void *obj_handle, int *count)
+{
+    if (MCA_BASE_PVAR_HANDLE_BIND == event) {
+        *count = 1;
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int han_pvar_read(const struct mca_base_pvar_t *pvar, void *value, void *obj_handle)
+{
+    const han_pvar_desc_t *desc = (const han_pvar_desc_t *) pvar->ctx;
+    mca_coll_han_module_t *han_module =
+        mca_coll_han_comm_module((struct ompi_communicator_t *) obj_handle);
+
+    if (NULL == han_module) {
+        memset(value, 0, desc->size);
+    } else {
+        memcpy(value, (char *) &han_module->allreduce_stats + desc->offset, desc->size);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static void han_register_one_pvar(han_pvar_desc_t *desc, const char *name,
+                                  const char *description, int var_class,
+                                  mca_base_var_type_t type)
+{
+    (void) mca_base_component_pvar_register(&mca_coll_han_component.super.collm_version,
+                                            name, description, OPAL_INFO_LVL_4, var_class,
+                                            type, NULL, MCA_BASE_VAR_BIND_MPI_COMM,
+                                            MCA_BASE_PVAR_FLAG_READONLY
+                                                | MCA_BASE_PVAR_FLAG_CONTINUOUS,
+                                            han_pvar_read, NULL, han_pvar_notify, desc);
+}
+
+static void han_register_pvars(void)
+{
+    han_register_one_pvar(&han_pvar_desc[0], "allreduce_intra_time",
+                          "Seconds spent in the intra-node (low_comm) stages of the "
+                          "pipelined allreduce",
+                          MCA_BASE_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE);
+    han_register_one_pvar(&han_pvar_desc[1], "allreduce_inter_wait_time",
+                          "Seconds spent waiting for the inter-node (up_comm) stages of the "
+                          "pipelined allreduce, i.e. not overlapped with intra-node work. "
+                          "Large values relative to allreduce_intra_time mean the inter-node "
+                          "stage is the bottleneck",
+                          MCA_BASE_PVAR_CLASS_TIMER, MCA_BASE_VAR_TYPE_DOUBLE);
+    han_register_one_pvar(&han_pvar_desc[2], "allreduce_segments",
+                          "Number of segments processed by the pipelined allreduce",
+                          MCA_BASE_PVAR_CLASS_COUNTER, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG);
+    han_register_one_pvar(&han_pvar_desc[3], "allreduce_segsize",
+                          "Segment size in bytes used by the last pipelined allreduce",
+                          MCA_BASE_PVAR_CLASS_LEVEL, MCA_BASE_VAR_TYPE_UNSIGNED_LONG_LONG);
+}
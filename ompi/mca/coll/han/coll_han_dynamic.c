@@ -135,9 +135,30 @@ mca_coll_han_get_all_coll_modules(struct ompi_communicator_t *comm,
     return OMPI_SUCCESS;
 }
 
+/*
+ * Index of the last element of the sorted array whose field is lower than
+ * or equal to key (-1 if there is none), i.e. the element a reverse linear
+ * scan would find first.
+ */
+#define HAN_RULES_BSEARCH_LAST_LE(array, nb, field, key, idx)  \
+    do {                                                       \
+        int _lo = 0, _hi = (nb) - 1, _mid;                     \
+        (idx) = -1;                                            \
+        while (_lo <= _hi) {                                   \
+            _mid = _lo + (_hi - _lo) / 2;                      \
+            if ((array)[_mid].field <= (key)) {                \
+                (idx) = _mid;                                  \
+                _lo = _mid + 1;                                \
+            } else {                                           \
+                _hi = _mid - 1;                                \
+            }                                                  \
+        }                                                      \
+    } while (0)
+
 /*
  * Find the correct rule in the dynamic rules
- * Assume rules are sorted by increasing value
+ * Assume rules are sorted by increasing value (when they are, which is
+ * checked once at load time, the searches are done by bisection)
  */
 static const msg_size_rule_t*
 get_dynamic_rule(COLLTYPE_T collective,
@@ -198,11 +219,19 @@ get_dynamic_rule(COLLTYPE_T collective,
     }
 
     /* Find the configuration rule */
-    for(conf_idx = topo_rule->nb_rules-1;
-        conf_idx >= 0; conf_idx--) {
-        if(topo_rule->configuration_rules[conf_idx].configuration_size <= comm_size) {
+    if(dynamic_rules->sorted) {
+        HAN_RULES_BSEARCH_LAST_LE(topo_rule->configuration_rules, topo_rule->nb_rules,
+                                  configuration_size, comm_size, conf_idx);
+        if(conf_idx >= 0) {
             conf_rule = &(topo_rule->configuration_rules[conf_idx]);
-            break;
+        }
+    } else {
+        for(conf_idx = topo_rule->nb_rules-1;
+            conf_idx >= 0; conf_idx--) {
+            if(topo_rule->configuration_rules[conf_idx].configuration_size <= comm_size) {
+                conf_rule = &(topo_rule->configuration_rules[conf_idx]);
+                break;
+            }
         }
     }
     if(conf_idx < 0 || NULL == conf_rule) {
@@ -219,11 +248,19 @@ get_dynamic_rule(COLLTYPE_T collective,
     }
 
     /* Find the message size rule */
-    for(msg_size_idx = conf_rule->nb_msg_size-1;
-        msg_size_idx >= 0; msg_size_idx--) {
-        if(conf_rule->msg_size_rules[msg_size_idx].msg_size <= msg_size) {
+    if(dynamic_rules->sorted) {
+        HAN_RULES_BSEARCH_LAST_LE(conf_rule->msg_size_rules, conf_rule->nb_msg_size,
+                                  msg_size, msg_size, msg_size_idx);
+        if(msg_size_idx >= 0) {
             msg_size_rule = &(conf_rule->msg_size_rules[msg_size_idx]);
-            break;
+        }
+    } else {
+        for(msg_size_idx = conf_rule->nb_msg_size-1;
+            msg_size_idx >= 0; msg_size_idx--) {
+            if(conf_rule->msg_size_rules[msg_size_idx].msg_size <= msg_size) {
+                msg_size_rule = &(conf_rule->msg_size_rules[msg_size_idx]);
+                break;
+            }
         }
     }
     if(msg_size_idx < 0 || NULL == msg_size_rule) {
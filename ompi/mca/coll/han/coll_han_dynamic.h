@@ -124,6 +124,13 @@ typedef enum TOPO_LVL {
     INTER_NODE,
     /* Identifies the global communicator as a topologic level */
     GLOBAL_COMMUNICATOR,
+    /*
+     * Optional levels below the node (see coll_han_intra_node_domain).
+     * They come after GLOBAL_COMMUNICATOR to keep the numeric identifiers
+     * used by existing dynamic rules files.
+     */
+    INTRA_DOMAIN,
+    INTER_DOMAIN,
     NB_TOPO_LVL
 } TOPO_LVL_T;
 
@@ -196,6 +203,12 @@ typedef struct collective_rule_s {
 typedef struct mca_coll_han_dynamic_rule_s {
     int nb_collectives;
     collective_rule_t *collective_rules;
+    /* Configuration and message sizes are sorted everywhere,
+     * the rules can be binary searched */
+    bool sorted;
+    /* Mapping of a binary rules file, holding the message size rules */
+    void *map;
+    size_t map_size;
 } mca_coll_han_dynamic_rules_t;
 
 /* Module storage */
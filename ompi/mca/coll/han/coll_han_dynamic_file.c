@@ -32,16 +32,42 @@
 #include "coll_han_algorithms.h"
 
 #include "ompi/mca/coll/base/coll_base_util.h"
+#include "ompi/runtime/ompi_rte.h"
 
 #define getnext_long(fptr, pval)     ompi_coll_base_file_getnext_long(fptr, &fileline, pval)
 #define getnext_string(fptr, pval)   ompi_coll_base_file_getnext_string(fptr, &fileline, pval)
 #define getnext_size_t(fptr, pval)   ompi_coll_base_file_getnext_size_t(fptr, &fileline, pval)
 
 static void check_dynamic_rules(void);
+static int read_dynamic_rules_binary(const char *fname);
 
 /* Current file line for verbose message */
 static int fileline = 1;
 
+/* Binary rules file: the records of each level of the stack, in file order */
+#define HAN_RULES_FILE_MAGIC   "OMPIHANR"
+#define HAN_RULES_FILE_VERSION 1
+
+typedef struct {
+    int32_t collective_id;
+    int32_t nb_topologic_levels;
+} han_rules_file_coll_t;
+
+typedef struct {
+    int32_t topologic_level;
+    int32_t nb_rules;
+} han_rules_file_topo_t;
+
+typedef struct {
+    int32_t configuration_size;
+    int32_t nb_msg_size;
+} han_rules_file_conf_t;
+
+static const uint32_t han_rules_file_record_size[4] = {
+    sizeof(han_rules_file_coll_t), sizeof(han_rules_file_topo_t),
+    sizeof(han_rules_file_conf_t), sizeof(msg_size_rule_t)
+};
+
 /*
  * File parsing function. Allocated memory depending on the number of rules.
  * This functions expects a file formatted as described in coll_han_dynamic_file.h.
@@ -97,6 +123,24 @@ mca_coll_han_init_dynamic_rules(void)
         return OMPI_SUCCESS;
     }
 
+    rc = read_dynamic_rules_binary(fname);
+    if( OMPI_ERR_NOT_FOUND != rc ) {
+        if( OMPI_SUCCESS != rc ) {
+            opal_output_verbose(0, mca_coll_han_component.han_output,
+                                "coll:han:mca_coll_han_init_dynamic_rules "
+                                "%s is a binary rules file, but it is corrupted or was written "
+                                "by a different build or architecture. "
+                                "Will use mca parameters defined rules.\n", fname);
+            mca_coll_han_free_dynamic_rules();
+            return OMPI_SUCCESS;
+        }
+        if(mca_coll_han_component.dump_dynamic_rules) {
+            mca_coll_han_dump_dynamic_rules();
+        }
+        check_dynamic_rules();
+        return OMPI_SUCCESS;
+    }
+
     fptr = fopen(fname, "r");
     if( NULL == fptr ) {
         opal_output_verbose(5, mca_coll_han_component.han_output,
@@ -443,6 +487,16 @@ mca_coll_han_init_dynamic_rules(void)
     fclose(fptr);
 
     check_dynamic_rules();
+
+    if( NULL != mca_coll_han_component.dynamic_rules_binary_output &&
+        (0 == OMPI_PROC_MY_NAME->vpid || OPAL_VPID_INVALID == OMPI_PROC_MY_NAME->vpid) ) {
+        rc = mca_coll_han_write_dynamic_rules_binary(mca_coll_han_component.dynamic_rules_binary_output);
+        opal_output_verbose(5, mca_coll_han_component.han_output,
+                            "coll:han:mca_coll_han_init_dynamic_rules %s binary rules file %s\n",
+                            (OMPI_SUCCESS == rc) ? "wrote" : "failed to write",
+                            mca_coll_han_component.dynamic_rules_binary_output);
+    }
+
     free(coll_name);
     free(algorithm_name);
     free(target_comp_name);
@@ -507,7 +561,8 @@ mca_coll_han_free_dynamic_rules(void)
             nb_conf = topo_rules[j].nb_rules;
             conf_rules = topo_rules[j].configuration_rules;
 
-            for(k=0 ; k<nb_conf ; k++) {
+            /* The message size rules of a binary file are in the mapping */
+            for(k=0 ; NULL == mca_coll_han_component.dynamic_rules.map && k<nb_conf ; k++) {
                 if(conf_rules[k].nb_msg_size > 0) {
                     free(conf_rules[k].msg_size_rules);
                 }
@@ -527,6 +582,10 @@ mca_coll_han_free_dynamic_rules(void)
         free(coll_rules);
     }
 
+    ompi_coll_base_rules_file_unmap(mca_coll_han_component.dynamic_rules.map,
+                                    mca_coll_han_component.dynamic_rules.map_size);
+    mca_coll_han_component.dynamic_rules.map = NULL;
+    mca_coll_han_component.dynamic_rules.sorted = false;
     mca_coll_han_component.dynamic_rules.nb_collectives = 0;
 }
 
@@ -561,6 +620,7 @@ static void check_dynamic_rules(void)
 
     nb_coll = mca_coll_han_component.dynamic_rules.nb_collectives;
     coll_rules = mca_coll_han_component.dynamic_rules.collective_rules;
+    mca_coll_han_component.dynamic_rules.sorted = true;
 
     for( i = 0; i < nb_coll; i++ ) {
         coll_id = coll_rules[i].collective_id;
@@ -578,6 +638,7 @@ static void check_dynamic_rules(void)
                 msg_size_rules = conf_rules[k].msg_size_rules;
 
                 if( k >= 1 && conf_rules[k-1].configuration_size > conf_size) {
+                    mca_coll_han_component.dynamic_rules.sorted = false;
                     opal_output_verbose(5, mca_coll_han_component.han_output,
                                         "coll:han:check_dynamic_rules HAN found an issue on dynamic rules "
                                         "for collective %d on topological level %d: "
@@ -590,6 +651,7 @@ static void check_dynamic_rules(void)
                     component = msg_size_rules[l].component;
 
                     if( l >= 1 && msg_size_rules[l-1].msg_size > msg_size) {
+                        mca_coll_han_component.dynamic_rules.sorted = false;
                         opal_output_verbose(5, mca_coll_han_component.han_output,
                                             "coll:han:check_dynamic_rules HAN found an issue on dynamic rules "
                                             "for collective %d on topological level %d with configuration size %d: "
@@ -673,3 +735,177 @@ void mca_coll_han_dump_dynamic_rules(void)
         }
     }
 }
+
+/*
+ * Map a binary rules file and rebuild the rule stack on top of it.
+ * Returns OMPI_ERR_NOT_FOUND if fname is not a binary rules file.
+ */
+static int read_dynamic_rules_binary(const char *fname)
+{
+    mca_coll_han_dynamic_rules_t *rules = &mca_coll_han_component.dynamic_rules;
+    const han_rules_file_coll_t *colls;
+    const han_rules_file_topo_t *topos;
+    const han_rules_file_conf_t *confs;
+    msg_size_rule_t *msgs;
+    const void *sections[4];
+    size_t count[4], t = 0, c = 0, m = 0;
+    int i, j, k, l, rc;
+
+    rc = ompi_coll_base_rules_file_map(fname, HAN_RULES_FILE_MAGIC, HAN_RULES_FILE_VERSION,
+                                       4, han_rules_file_record_size, sections, count,
+                                       &rules->map, &rules->map_size);
+    if( OMPI_SUCCESS != rc ) {
+        return rc;
+    }
+    colls = (const han_rules_file_coll_t *) sections[0];
+    topos = (const han_rules_file_topo_t *) sections[1];
+    confs = (const han_rules_file_conf_t *) sections[2];
+    msgs = (msg_size_rule_t *) sections[3];
+
+    if( 0 == count[0] || count[0] > INT_MAX ) {
+        return OMPI_ERR_BAD_PARAM;
+    }
+    rules->collective_rules = calloc(count[0], sizeof(collective_rule_t));
+    if( NULL == rules->collective_rules ) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    rules->nb_collectives = (int) count[0];
+
+    for( i = 0; i < rules->nb_collectives; i++ ) {
+        collective_rule_t *coll_rule = &rules->collective_rules[i];
+        if( colls[i].collective_id < ALLGATHER || colls[i].collective_id >= COLLCOUNT ||
+            colls[i].nb_topologic_levels < 0 || colls[i].nb_topologic_levels > count[1] - t ) {
+            return OMPI_ERR_BAD_PARAM;
+        }
+        coll_rule->collective_id = (COLLTYPE_T) colls[i].collective_id;
+        if( 0 == colls[i].nb_topologic_levels ) {
+            continue;
+        }
+        coll_rule->topologic_rules = calloc(colls[i].nb_topologic_levels, sizeof(topologic_rule_t));
+        if( NULL == coll_rule->topologic_rules ) {
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        coll_rule->nb_topologic_levels = colls[i].nb_topologic_levels;
+
+        for( j = 0; j < coll_rule->nb_topologic_levels; j++, t++ ) {
+            topologic_rule_t *topo_rule = &coll_rule->topologic_rules[j];
+            if( topos[t].topologic_level < INTRA_NODE || topos[t].topologic_level >= NB_TOPO_LVL ||
+                topos[t].nb_rules < 0 || topos[t].nb_rules > count[2] - c ) {
+                return OMPI_ERR_BAD_PARAM;
+            }
+            topo_rule->collective_id = coll_rule->collective_id;
+            topo_rule->topologic_level = (TOPO_LVL_T) topos[t].topologic_level;
+            if( 0 == topos[t].nb_rules ) {
+                continue;
+            }
+            topo_rule->configuration_rules = calloc(topos[t].nb_rules, sizeof(configuration_rule_t));
+            if( NULL == topo_rule->configuration_rules ) {
+                return OMPI_ERR_OUT_OF_RESOURCE;
+            }
+            topo_rule->nb_rules = topos[t].nb_rules;
+
+            for( k = 0; k < topo_rule->nb_rules; k++, c++ ) {
+                configuration_rule_t *conf_rule = &topo_rule->configuration_rules[k];
+                if( confs[c].configuration_size < 1 || confs[c].nb_msg_size < 0 ||
+                    confs[c].nb_msg_size > count[3] - m ) {
+                    return OMPI_ERR_BAD_PARAM;
+                }
+                conf_rule->collective_id = coll_rule->collective_id;
+                conf_rule->topologic_level = topo_rule->topologic_level;
+                conf_rule->configuration_size = confs[c].configuration_size;
+                conf_rule->nb_msg_size = confs[c].nb_msg_size;
+                conf_rule->msg_size_rules = (conf_rule->nb_msg_size > 0) ? &msgs[m] : NULL;
+
+                for( l = 0; l < conf_rule->nb_msg_size; l++, m++ ) {
+                    if( msgs[m].collective_id != conf_rule->collective_id ||
+                        msgs[m].topologic_level != conf_rule->topologic_level ||
+                        msgs[m].configuration_size != conf_rule->configuration_size ||
+                        msgs[m].component < SELF || msgs[m].component >= COMPONENTS_COUNT ||
+                        (HAN == msgs[m].component &&
+                         !mca_coll_han_algorithm_id_is_valid(msgs[m].collective_id, msgs[m].algorithm_id)) ) {
+                        return OMPI_ERR_BAD_PARAM;
+                    }
+                }
+            }
+        }
+    }
+
+    opal_output_verbose(5, mca_coll_han_component.han_output,
+                        "coll:han:mca_coll_han_init_dynamic_rules mapped %" PRIsize_t " rules from %s\n",
+                        m, fname);
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Write the rules in the binary format, flattening each level of the stack
+ */
+int mca_coll_han_write_dynamic_rules_binary(const char *fname)
+{
+    const mca_coll_han_dynamic_rules_t *rules = &mca_coll_han_component.dynamic_rules;
+    han_rules_file_coll_t *colls = NULL;
+    han_rules_file_topo_t *topos = NULL;
+    han_rules_file_conf_t *confs = NULL;
+    msg_size_rule_t *msgs = NULL;
+    const void *sections[4];
+    size_t count[4] = {0, 0, 0, 0};
+    int i, j, k, rc = OMPI_ERR_OUT_OF_RESOURCE;
+
+    count[0] = rules->nb_collectives;
+    for( i = 0; i < rules->nb_collectives; i++ ) {
+        const collective_rule_t *coll_rule = &rules->collective_rules[i];
+        count[1] += coll_rule->nb_topologic_levels;
+        for( j = 0; j < coll_rule->nb_topologic_levels; j++ ) {
+            const topologic_rule_t *topo_rule = &coll_rule->topologic_rules[j];
+            count[2] += topo_rule->nb_rules;
+            for( k = 0; k < topo_rule->nb_rules; k++ ) {
+                count[3] += topo_rule->configuration_rules[k].nb_msg_size;
+            }
+        }
+    }
+
+    colls = calloc(count[0] + 1, sizeof(han_rules_file_coll_t));
+    topos = calloc(count[1] + 1, sizeof(han_rules_file_topo_t));
+    confs = calloc(count[2] + 1, sizeof(han_rules_file_conf_t));
+    msgs = calloc(count[3] + 1, sizeof(msg_size_rule_t));
+    if( NULL == colls || NULL == topos || NULL == confs || NULL == msgs ) {
+        goto cleanup;
+    }
+
+    count[1] = count[2] = count[3] = 0;
+    for( i = 0; i < rules->nb_collectives; i++ ) {
+        const collective_rule_t *coll_rule = &rules->collective_rules[i];
+        colls[i].collective_id = coll_rule->collective_id;
+        colls[i].nb_topologic_levels = coll_rule->nb_topologic_levels;
+        for( j = 0; j < coll_rule->nb_topologic_levels; j++ ) {
+            const topologic_rule_t *topo_rule = &coll_rule->topologic_rules[j];
+            topos[count[1]].topologic_level = topo_rule->topologic_level;
+            topos[count[1]].nb_rules = topo_rule->nb_rules;
+            count[1]++;
+            for( k = 0; k < topo_rule->nb_rules; k++ ) {
+                const configuration_rule_t *conf_rule = &topo_rule->configuration_rules[k];
+                confs[count[2]].configuration_size = conf_rule->configuration_size;
+                confs[count[2]].nb_msg_size = conf_rule->nb_msg_size;
+                count[2]++;
+                if( conf_rule->nb_msg_size > 0 ) {
+                    memcpy(&msgs[count[3]], conf_rule->msg_size_rules,
+                           conf_rule->nb_msg_size * sizeof(msg_size_rule_t));
+                    count[3] += conf_rule->nb_msg_size;
+                }
+            }
+        }
+    }
+
+    sections[0] = colls;
+    sections[1] = topos;
+    sections[2] = confs;
+    sections[3] = msgs;
+    rc = ompi_coll_base_rules_file_write(fname, HAN_RULES_FILE_MAGIC, HAN_RULES_FILE_VERSION,
+                                         4, han_rules_file_record_size, sections, count);
+
+ cleanup:
+    free(colls);
+    free(topos);
+    free(confs);
+    free(msgs);
+    return rc;
+}
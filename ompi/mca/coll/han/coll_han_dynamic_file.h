@@ -103,10 +103,21 @@
  * attempt to read x rules of the corresponding type. If a set of rules
  * has an invalid count, this is an error and it might not be detected by
  * the reader.
+ *
+ * #######################
+ * # Binary file format  #
+ * #######################
+ * When dynamic_rules_binary_output is set, the rules read from a text file
+ * are also written to that file in a binary format, which can then be given
+ * as dynamic_rules_filename. It holds the same stack flattened in four
+ * arrays (collectives, topologic levels, configurations and message sizes),
+ * and is mapped read-only instead of being parsed. A binary file is only
+ * valid for the Open MPI build and architecture that wrote it.
  */
 
 int mca_coll_han_init_dynamic_rules(void);
 void mca_coll_han_free_dynamic_rules(void);
 void mca_coll_han_dump_dynamic_rules(void);
+int mca_coll_han_write_dynamic_rules_binary(const char *fname);
 
 #endif
@@ -204,6 +204,8 @@ static void mca_coll_han_module_construct(mca_coll_han_module_t * module)
     module->cached_low_comms = NULL;
     module->cached_up_comms = NULL;
     module->cached_vranks = NULL;
+    module->cached_domain_vranks = NULL;
+    module->domain_size = 0;
     module->cached_topo = NULL;
     module->scratch_buf[0] = NULL;
     module->scratch_buf_size[0] = 0;
@@ -220,6 +222,8 @@ static void mca_coll_han_module_construct(mca_coll_han_module_t * module)
 
     module->dynamic_errors = 0;
 
+    memset(&module->allreduce_stats, 0, sizeof(module->allreduce_stats));
+
     han_module_clear(module);
 
     module->super.coll_revoke_local = mca_coll_han_revoke_local;
@@ -273,6 +277,10 @@ mca_coll_han_module_destruct(mca_coll_han_module_t * module)
         free(module->cached_vranks);
         module->cached_vranks = NULL;
     }
+    if (module->cached_domain_vranks != NULL) {
+        free(module->cached_domain_vranks);
+        module->cached_domain_vranks = NULL;
+    }
     if (module->cached_topo != NULL) {
         free(module->cached_topo);
         module->cached_topo = NULL;
@@ -363,13 +371,23 @@ mca_coll_han_comm_query(struct ompi_communicator_t * comm, int *priority)
                       &info_str, &flag);
 
         if (flag) {
-            topologic_level = strcmp(info_str->string, "INTER_NODE") ? INTRA_NODE : INTER_NODE;
+            if (0 == strcmp(info_str->string, "INTER_NODE")) {
+                topologic_level = INTER_NODE;
+            } else if (0 == strcmp(info_str->string, "INTRA_DOMAIN")) {
+                topologic_level = INTRA_DOMAIN;
+            } else if (0 == strcmp(info_str->string, "INTER_DOMAIN")) {
+                topologic_level = INTER_DOMAIN;
+            } else {
+                topologic_level = INTRA_NODE;
+            }
             OBJ_RELEASE(info_str);
         }
     }
 
     if( !ompi_group_have_remote_peers(comm->c_local_group)
-            && INTRA_NODE != topologic_level ) {
+            && (INTRA_NODE != topologic_level)
+            && (INTRA_DOMAIN != topologic_level)
+            && (INTER_DOMAIN != topologic_level) ) {
         /* The group only contains local processes, and this is not a
          * intra-node subcomm we created. Disable HAN for now */
         opal_output_verbose(10, ompi_coll_base_framework.framework_output,
@@ -473,6 +491,27 @@ mca_coll_han_module_enable(mca_coll_base_module_t * module,
     return OMPI_SUCCESS;
 }
 
+/*
+ * Lookup of the HAN module serving the allreduce of a communicator,
+ * used by the MPI_T performance variables
+ */
+mca_coll_han_module_t *
+mca_coll_han_comm_module(struct ompi_communicator_t *comm)
+{
+    mca_coll_base_module_t *module;
+
+    if ((NULL == comm) || (NULL == comm->c_coll)) {
+        return NULL;
+    }
+
+    module = comm->c_coll->coll_allreduce_module;
+    if ((NULL == module) || (mca_coll_han_module_enable != module->coll_module_enable)) {
+        return NULL;
+    }
+
+    return (mca_coll_han_module_t *) module;
+}
+
 /*
  * Module disable
  */
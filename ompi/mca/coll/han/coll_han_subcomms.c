@@ -46,6 +46,137 @@
         (COMM)->c_coll->coll_##COLL##_module = (FALLBACKS).COLL.module;      \
     } while (0)
 
+/*
+ * Split the intra-node sub-communicator along the topological domain selected
+ * by coll_han_intra_node_domain (socket, NUMA node or L3 cache, a single
+ * level; see mca_coll_han_domain_t):
+ *  - INTRA_DOMAIN contains the processes that share my domain;
+ *  - INTER_DOMAIN contains one process per domain of my node: processes with
+ *    the same rank in their domain share such a sub-communicator.
+ * Domains are ordered by the intra-node rank of their first process, so that
+ * the process with intra-node rank 0 is rank 0 in both sub-communicators.
+ * The levels are only kept if all the domains of the node have the same
+ * number of processes (more than one) and there is more than one domain;
+ * otherwise the node keeps its flat intra-node level. This is decided from
+ * data gathered on the whole node, so all its processes agree.
+ */
+static int
+mca_coll_han_comm_create_domains(mca_coll_han_module_t *han_module,
+                                 opal_info_t *comm_info)
+{
+    ompi_communicator_t *low_comm = han_module->sub_comm[INTRA_NODE];
+    ompi_communicator_t **intra_comm = &(han_module->sub_comm[INTRA_DOMAIN]);
+    ompi_communicator_t **inter_comm = &(han_module->sub_comm[INTER_DOMAIN]);
+    int low_size = ompi_comm_size(low_comm);
+    int split_type, domain_size, rc, i, j;
+    int mine[3], *all, *vranks;
+
+    switch (mca_coll_han_component.han_intra_node_domain) {
+    case HAN_DOMAIN_SOCKET:
+        split_type = OMPI_COMM_TYPE_SOCKET;
+        break;
+    case HAN_DOMAIN_NUMA:
+        split_type = OMPI_COMM_TYPE_NUMA;
+        break;
+    case HAN_DOMAIN_L3CACHE:
+        split_type = OMPI_COMM_TYPE_L3CACHE;
+        break;
+    default:
+        return OMPI_SUCCESS;
+    }
+    if (low_size < 2) {
+        return OMPI_SUCCESS;
+    }
+
+    opal_info_set(comm_info, "ompi_comm_coll_han_topo_level", "INTRA_DOMAIN");
+    rc = ompi_comm_split_type(low_comm, split_type, 0, comm_info, intra_comm);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
+    /* <intra-node rank of the domain leader, rank in the domain, domain size> */
+    if (MPI_COMM_NULL == *intra_comm) {
+        /* The locality of this process is unknown (e.g. unbound) */
+        *intra_comm = NULL;
+        mine[0] = -1;
+        mine[1] = 0;
+        mine[2] = 0;
+    } else {
+        mine[0] = ompi_comm_rank(low_comm);
+        rc = (*intra_comm)->c_coll->coll_bcast(&mine[0], 1, MPI_INT, 0, *intra_comm,
+                                               (*intra_comm)->c_coll->coll_bcast_module);
+        if (OMPI_SUCCESS != rc) {
+            return rc;
+        }
+        mine[1] = ompi_comm_rank(*intra_comm);
+        mine[2] = ompi_comm_size(*intra_comm);
+    }
+
+    all = (int *)malloc(3 * low_size * sizeof(int));
+    if (NULL == all) {
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    rc = low_comm->c_coll->coll_allgather(mine, 3, MPI_INT, all, 3, MPI_INT,
+                                          low_comm, low_comm->c_coll->coll_allgather_module);
+    if (OMPI_SUCCESS != rc) {
+        free(all);
+        return rc;
+    }
+
+    domain_size = all[2];
+    for (i = 0; i < low_size; i++) {
+        if (all[3 * i] < 0 || all[3 * i + 2] != domain_size) {
+            domain_size = 0;
+            break;
+        }
+    }
+    if (domain_size < 2 || domain_size == low_size) {
+        opal_output_verbose(30, mca_coll_han_component.han_output,
+                            "coll:han:comm_create_domains: the %s domains do not split "
+                            "this node evenly, keeping a single intra-node level\n",
+                            (HAN_DOMAIN_SOCKET == mca_coll_han_component.han_intra_node_domain) ? "socket" :
+                            (HAN_DOMAIN_NUMA == mca_coll_han_component.han_intra_node_domain) ? "numa" : "l3cache");
+        free(all);
+        if (NULL != *intra_comm) {
+            ompi_comm_free(intra_comm);
+            *intra_comm = NULL;
+        }
+        return OMPI_SUCCESS;
+    }
+
+    opal_info_set(comm_info, "ompi_comm_coll_han_topo_level", "INTER_DOMAIN");
+    rc = ompi_comm_split_with_info(low_comm, mine[1], mine[0], comm_info, inter_comm, false);
+    if (OMPI_SUCCESS != rc) {
+        free(all);
+        return rc;
+    }
+
+    /* The index of a domain is the rank of its processes in INTER_DOMAIN */
+    vranks = (int *)malloc(low_size * sizeof(int));
+    if (NULL == vranks) {
+        free(all);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    for (i = 0; i < low_size; i++) {
+        int domain_index = 0;
+        for (j = 0; j < low_size; j++) {
+            if (0 == all[3 * j + 1] && all[3 * j] < all[3 * i]) {
+                domain_index++;
+            }
+        }
+        vranks[i] = domain_index * domain_size + all[3 * i + 1];
+    }
+    free(all);
+
+    if (NULL != han_module->cached_domain_vranks) {
+        free(han_module->cached_domain_vranks);
+    }
+    han_module->cached_domain_vranks = vranks;
+    han_module->domain_size = domain_size;
+
+    return OMPI_SUCCESS;
+}
+
 /*
  * Routine that creates the local hierarchical sub-communicators
  * Called each time a collective is called.
@@ -162,6 +293,14 @@ int mca_coll_han_comm_create_new(struct ompi_communicator_t *comm,
 
     up_rank = ompi_comm_rank(*up_comm);
 
+    /*
+     * Optional levels inside the node
+     */
+    rc = mca_coll_han_comm_create_domains(han_module, &comm_info);
+    if( OMPI_SUCCESS != rc ) {
+        goto return_with_error;
+    }
+
     /*
      * Set my virtual rank number.
      * my rank # = <intra-node comm size> * <inter-node rank number>
@@ -210,6 +349,10 @@ int mca_coll_han_comm_create_new(struct ompi_communicator_t *comm,
     /* Retain sub-communicators so they survive finalize ordering */
     OBJ_RETAIN(*low_comm);
     OBJ_RETAIN(*up_comm);
+    if( NULL != han_module->sub_comm[INTRA_DOMAIN] ) {
+        OBJ_RETAIN(han_module->sub_comm[INTRA_DOMAIN]);
+        OBJ_RETAIN(han_module->sub_comm[INTER_DOMAIN]);
+    }
 
     return OMPI_SUCCESS;
 
@@ -223,6 +366,12 @@ return_with_error:
         ompi_comm_free(up_comm);
         *up_comm = NULL;  /* don't leave the MPI_COMM_NULL set by ompi_comm_free */
     }
+    for( int i = INTRA_DOMAIN; i <= INTER_DOMAIN; i++ ) {
+        if( NULL != han_module->sub_comm[i] ) {
+            ompi_comm_free(&han_module->sub_comm[i]);
+            han_module->sub_comm[i] = NULL;
+        }
+    }
     return rc;
 }
 
@@ -30,6 +30,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/coll_base_util.h"
 #include "opal/sys/atomic.h"
+#include "opal/class/opal_fifo.h"
 
 BEGIN_C_DECLS
 
@@ -38,20 +39,6 @@ BEGIN_C_DECLS
 /* the debug level */
 #define NBC_DLEVEL 0
 
-/* enable schedule caching - undef NBC_CACHE_SCHEDULE to deactivate it */
-/* TODO: this whole schedule cache stuff does not work with the tmbuf
- * :-( - first, the tmpbuf must not be freed if a schedule using it is
- * still in the cache and second, the tmpbuf used by the schedule must
- * be attached to the handle that uses this schedule !!!!
- * I.E., THIS IS EXPERIMENTAL AND MIGHT NOT WORK */
-/* It also leaks memory because the schedule is never cleaned up when
-   the communicator is destroyed, so don't use it for now */
-#ifdef NBC_CACHE_SCHEDULE
-#undef NBC_CACHE_SCHEDULE
-#endif
-#define NBC_SCHED_DICT_UPPER 1024 /* max. number of dict entries */
-#define NBC_SCHED_DICT_LOWER 512  /* number of dict entries after wipe, if SCHED_DICT_UPPER is reached */
-
 /********************* end of LibNBC tuning parameters ************************/
 
 /* Function return codes  */
@@ -67,23 +54,29 @@ BEGIN_C_DECLS
 #define NBC_INVALID_TOPOLOGY_COMM 8 /* invalid topology attached to communicator */
 
 /* number of implemented collective functions */
-#define NBC_NUM_COLL 17
+#define NBC_NUM_COLL 22
 
 extern bool libnbc_ibcast_skip_dt_decision;
 extern int libnbc_iallgather_algorithm;
 extern int libnbc_iallreduce_algorithm;
+extern int libnbc_iallreduce_ring_segsize;
 extern int libnbc_ibcast_algorithm;
 extern int libnbc_ibcast_knomial_radix;
 extern int libnbc_iexscan_algorithm;
 extern int libnbc_ireduce_algorithm;
 extern int libnbc_iscan_algorithm;
+extern int libnbc_schedule_cache_size;
+extern size_t libnbc_schedule_cache_max_bytes;
+extern bool libnbc_persistent_compile;
+extern bool libnbc_progress_thread;
+extern bool libnbc_hierarchical;
 
 struct ompi_coll_libnbc_component_t {
     mca_coll_base_component_3_0_0_t super;
     opal_free_list_t requests;
-    opal_list_t active_requests;
+    opal_list_t active_requests;      /* only accessed by the thread progressing libnbc */
+    opal_fifo_t pending_requests;     /* started requests, moved to active_requests by the progress */
     opal_atomic_int32_t active_comms;
-    opal_mutex_t lock;                /* protect access to the active_requests list */
 };
 typedef struct ompi_coll_libnbc_component_t ompi_coll_libnbc_component_t;
 
@@ -94,14 +87,16 @@ struct ompi_coll_libnbc_module_t {
     mca_coll_base_module_t super;
     opal_mutex_t mutex;
     bool comm_registered;
-#ifdef NBC_CACHE_SCHEDULE
-  void *NBC_Dict[NBC_NUM_COLL]; /* this should point to a struct
-                                      hb_tree, but since this is a
-                                      public header-file, this would be
-                                      an include mess :-(. So let's void
-                                      it ...*/
-  int NBC_Dict_size[NBC_NUM_COLL];
-#endif
+    /* schedule cache: an hb_tree of the cached schedules keyed by their
+     * arguments (void to keep libdict out of this header), and the same
+     * entries least recently used first */
+    void *sched_cache;
+    opal_list_t sched_cache_lru;
+    size_t sched_cache_bytes;
+    /* node locality for the hierarchical schedules (an NBC_Comm_locality,
+     * NULL if unusable), computed at the first use */
+    void *locality;
+    bool locality_known;
 };
 typedef struct ompi_coll_libnbc_module_t ompi_coll_libnbc_module_t;
 OBJ_CLASS_DECLARATION(ompi_coll_libnbc_module_t);
@@ -130,6 +125,9 @@ struct ompi_coll_libnbc_request_t {
     NBC_Comminfo *comminfo;
     NBC_Schedule *schedule;
     void *tmpbuf; /* temporary buffer e.g. used for Reduce */
+    struct NBC_Sched_cache_entry *cache_entry; /* owner of schedule and tmpbuf if cached */
+    struct NBC_Compiled_schedule *compiled; /* schedule of a persistent request, row_offset
+                                             * is then the index of the current round */
     /* TODO: we should make a handle pointer to a state later (that the user
      * can move request handles) */
 };
@@ -45,9 +45,16 @@ const char *mca_coll_libnbc_component_version_string =
 
 
 static int libnbc_priority = 10;
-static bool libnbc_in_progress = false;     /* protect from recursive calls */
+static opal_atomic_int32_t libnbc_in_progress = 0;  /* protect from recursive and concurrent calls */
+static bool libnbc_progress_thread_retained = false;
 bool libnbc_ibcast_skip_dt_decision = true;
 
+int libnbc_schedule_cache_size = 32;            /* cached schedules per communicator */
+size_t libnbc_schedule_cache_max_bytes = 4 * 1024 * 1024;
+bool libnbc_persistent_compile = true;         /* compile the schedules of persistent requests */
+bool libnbc_progress_thread = false;           /* progress the requests from a dedicated thread */
+bool libnbc_hierarchical = true;               /* node aware schedules on multi-node communicators */
+
 int libnbc_iallgather_algorithm = 0;             /* iallgather user forced algorithm */
 static mca_base_var_enum_value_t iallgather_algorithms[] = {
     {0, "ignore"},
@@ -57,12 +64,15 @@ static mca_base_var_enum_value_t iallgather_algorithms[] = {
 };
 
 int libnbc_iallreduce_algorithm = 0;             /* iallreduce user forced algorithm */
+int libnbc_iallreduce_ring_segsize = 65536;      /* pipeline segment of the ring_segmented iallreduce */
 static mca_base_var_enum_value_t iallreduce_algorithms[] = {
     {0, "ignore"},
     {1, "ring"},
     {2, "binomial"},
     {3, "rabenseifner"},
     {4, "recursive_doubling"},
+    {5, "ring_segmented"},
+    {6, "hierarchical"},
     {0, NULL}
 };
 
@@ -74,6 +84,7 @@ static mca_base_var_enum_value_t ibcast_algorithms[] = {
     {2, "binomial"},
     {3, "chain"},
     {4, "knomial"},
+    {5, "hierarchical"},
     {0, NULL}
 };
 
@@ -152,7 +163,7 @@ libnbc_open(void)
 
     OBJ_CONSTRUCT(&mca_coll_libnbc_component.requests, opal_free_list_t);
     OBJ_CONSTRUCT(&mca_coll_libnbc_component.active_requests, opal_list_t);
-    OBJ_CONSTRUCT(&mca_coll_libnbc_component.lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&mca_coll_libnbc_component.pending_requests, opal_fifo_t);
     ret = opal_free_list_init (&mca_coll_libnbc_component.requests,
                                sizeof(ompi_coll_libnbc_request_t), 8,
                                OBJ_CLASS(ompi_coll_libnbc_request_t),
@@ -173,9 +184,14 @@ libnbc_close(void)
         opal_progress_unregister(ompi_coll_libnbc_progress);
     }
 
+    if (libnbc_progress_thread_retained) {
+        ompi_coll_base_progress_thread_release();
+        libnbc_progress_thread_retained = false;
+    }
+
     OBJ_DESTRUCT(&mca_coll_libnbc_component.requests);
     OBJ_DESTRUCT(&mca_coll_libnbc_component.active_requests);
-    OBJ_DESTRUCT(&mca_coll_libnbc_component.lock);
+    OBJ_DESTRUCT(&mca_coll_libnbc_component.pending_requests);
 
     return OMPI_SUCCESS;
 }
@@ -216,6 +232,46 @@ libnbc_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &libnbc_ibcast_skip_dt_decision);
 
+    libnbc_schedule_cache_size = 32;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "schedule_cache_size",
+                                           "Maximum number of schedules cached per communicator and reused by the nonblocking collectives called again with the same arguments (0 disables the cache)",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_ALL,
+                                           &libnbc_schedule_cache_size);
+
+    libnbc_schedule_cache_max_bytes = 4 * 1024 * 1024;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "schedule_cache_max_bytes",
+                                           "Maximum memory used by the cached schedules of a communicator, including their temporary buffers",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_ALL,
+                                           &libnbc_schedule_cache_max_bytes);
+
+    libnbc_persistent_compile = true;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "persistent_compile",
+                                           "Compile the schedules of persistent collectives at initialization, creating their sends and receives as persistent point-to-point requests that are only restarted by MPI_Start",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_persistent_compile);
+
+    libnbc_progress_thread = false;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "progress_thread",
+                                           "Progress the started nonblocking and persistent collectives from a dedicated thread, so that they advance while the application computes without calling MPI (see coll_base_progress_thread_bind)",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_progress_thread);
+
+    libnbc_hierarchical = true;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "hierarchical",
+                                           "Let the automatic algorithm selection of ibcast and iallreduce use hierarchical schedules, with inter-node stages between one leader per node and intra-node stages, on communicators spanning several nodes with several processes on some of them",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &libnbc_hierarchical);
+
     libnbc_iallgather_algorithm = 0;
     (void) mca_base_var_enum_create("coll_libnbc_iallgather_algorithms", iallgather_algorithms, &new_enum);
     mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
@@ -230,17 +286,25 @@ libnbc_register(void)
     (void) mca_base_var_enum_create("coll_libnbc_iallreduce_algorithms", iallreduce_algorithms, &new_enum);
     mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
                                     "iallreduce_algorithm",
-                                    "Which iallreduce algorithm is used: 0 ignore, 1 ring, 2 binomial, 3 rabenseifner, 4 recursive_doubling",
+                                    "Which iallreduce algorithm is used: 0 ignore, 1 ring, 2 binomial, 3 rabenseifner, 4 recursive_doubling, 5 ring_segmented (commutative operations only, binomial otherwise), 6 hierarchical",
                                     MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                     OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL,
                                     &libnbc_iallreduce_algorithm);
     OBJ_RELEASE(new_enum);
 
+    libnbc_iallreduce_ring_segsize = 65536;
+    (void) mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
+                                           "iallreduce_ring_segsize",
+                                           "Segment size in bytes of the ring_segmented iallreduce algorithm: the blocks of the ring are pipelined in segments of at most this size, so that the reduction of a segment overlaps the reception of the next one",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6, MCA_BASE_VAR_SCOPE_ALL,
+                                           &libnbc_iallreduce_ring_segsize);
+
     libnbc_ibcast_algorithm = 0;
     (void) mca_base_var_enum_create("coll_libnbc_ibcast_algorithms", ibcast_algorithms, &new_enum);
     mca_base_component_var_register(&mca_coll_libnbc_component.super.collm_version,
                                     "ibcast_algorithm",
-                                    "Which ibcast algorithm is used: 0 ignore, 1 linear, 2 binomial, 3 chain, 4 knomial",
+                                    "Which ibcast algorithm is used: 0 ignore, 1 linear, 2 binomial, 3 chain, 4 knomial, 5 hierarchical",
                                     MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                     OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_ALL,
                                     &libnbc_ibcast_algorithm);
@@ -296,7 +360,16 @@ static int
 libnbc_init_query(bool enable_progress_threads,
                   bool enable_mpi_threads)
 {
-    /* Nothing to do */
+    if (libnbc_progress_thread && !libnbc_progress_thread_retained) {
+        /* the progress thread calls into the PML concurrently with the
+         * application threads */
+        opal_set_using_threads(true);
+        if (OMPI_SUCCESS == ompi_coll_base_progress_thread_retain()) {
+            libnbc_progress_thread_retained = true;
+        } else {
+            libnbc_progress_thread = false;
+        }
+    }
     return OMPI_SUCCESS;
 }
 
@@ -555,52 +628,59 @@ int
 ompi_coll_libnbc_progress(void)
 {
     ompi_coll_libnbc_request_t* request, *next;
+    opal_list_item_t *item;
+    int32_t idle = 0;
     int res;
     int completed = 0;
 
-    if (0 == opal_list_get_size (&mca_coll_libnbc_component.active_requests)) {
-        /* no requests -- nothing to do. do not grab a lock */
+    if (opal_list_is_empty (&mca_coll_libnbc_component.active_requests) &&
+        opal_fifo_is_empty (&mca_coll_libnbc_component.pending_requests)) {
+        /* no requests -- nothing to do */
         return 0;
     }
 
-    /* process active requests, and use mca_coll_libnbc_component.lock to access the
-     * mca_coll_libnbc_component.active_requests list */
-    OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
-    /* return if invoked recursively */
-    if (!libnbc_in_progress) {
-        libnbc_in_progress = true;
-
-        OPAL_LIST_FOREACH_SAFE(request, next, &mca_coll_libnbc_component.active_requests,
-                               ompi_coll_libnbc_request_t) {
-            OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
-            res = NBC_Progress(request);
-            if( NBC_CONTINUE != res ) {
-                /* done, remove and complete */
-                OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
-                opal_list_remove_item(&mca_coll_libnbc_component.active_requests,
-                                      &request->super.super.super.super);
-                OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
-
-                if( OMPI_SUCCESS == res || NBC_OK == res || NBC_SUCCESS == res ) {
-                    request->super.super.req_status.MPI_ERROR = OMPI_SUCCESS;
-                }
-                else {
-                    request->super.super.req_status.MPI_ERROR = res;
-                }
-                if(request->super.super.req_persistent) {
-                    /* reset for the next communication */
-                    request->row_offset = 0;
-                }
-                if(!request->super.super.req_persistent || !REQUEST_COMPLETE(&request->super.super)) {
-            	    ompi_request_complete(&request->super.super, true);
-                }
-                completed++;
+    /* a single thread at a time progresses the requests; it owns the
+     * active_requests list, and moves the newly started requests to it
+     * from the pending_requests fifo. Return if invoked recursively or
+     * concurrently. */
+    if (!OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_32(&libnbc_in_progress, &idle, 1)) {
+        return 0;
+    }
+
+    while (NULL != (item = opal_fifo_pop_atomic (&mca_coll_libnbc_component.pending_requests))) {
+        opal_list_append (&mca_coll_libnbc_component.active_requests, item);
+    }
+
+    OPAL_LIST_FOREACH_SAFE(request, next, &mca_coll_libnbc_component.active_requests,
+                           ompi_coll_libnbc_request_t) {
+        res = NBC_Progress(request);
+        if( NBC_CONTINUE != res ) {
+            /* done, remove and complete */
+            opal_list_remove_item(&mca_coll_libnbc_component.active_requests,
+                                  &request->super.super.super.super);
+
+            if( OMPI_SUCCESS == res || NBC_OK == res || NBC_SUCCESS == res ) {
+                request->super.super.req_status.MPI_ERROR = OMPI_SUCCESS;
+            }
+            else {
+                request->super.super.req_status.MPI_ERROR = res;
+            }
+            if(request->super.super.req_persistent) {
+                /* reset for the next communication */
+                request->row_offset = 0;
             }
-            OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
+            if (libnbc_progress_thread) {
+                ompi_coll_base_progress_thread_done();
+            }
+            if(!request->super.super.req_persistent || !REQUEST_COMPLETE(&request->super.super)) {
+                ompi_request_complete(&request->super.super, true);
+            }
+            completed++;
         }
-        libnbc_in_progress = false;
     }
-    OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
+
+    opal_atomic_wmb();
+    libnbc_in_progress = 0;
 
     return completed;
 }
@@ -611,12 +691,20 @@ libnbc_module_construct(ompi_coll_libnbc_module_t *module)
 {
     OBJ_CONSTRUCT(&module->mutex, opal_mutex_t);
     module->comm_registered = false;
+    module->sched_cache = NULL;
+    OBJ_CONSTRUCT(&module->sched_cache_lru, opal_list_t);
+    module->sched_cache_bytes = 0;
+    module->locality = NULL;
+    module->locality_known = false;
 }
 
 
 static void
 libnbc_module_destruct(ompi_coll_libnbc_module_t *module)
 {
+    NBC_Sched_cache_fini(module);
+    NBC_Comm_locality_fini(module);
+    OBJ_DESTRUCT(&module->sched_cache_lru);
     OBJ_DESTRUCT(&module->mutex);
 
     /* if we ever were used for a collective op, do the progress cleanup. */
@@ -692,7 +780,8 @@ request_free(struct ompi_request_t **ompi_req)
         return MPI_ERR_REQUEST;
     }
 
-    OMPI_COLL_LIBNBC_REQUEST_RETURN(request);
+    /* release what a persistent request kept between its starts */
+    NBC_Return_handle(request);
     *ompi_req = MPI_REQUEST_NULL;
 
     return OMPI_SUCCESS;
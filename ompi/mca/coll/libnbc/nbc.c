@@ -33,6 +33,7 @@
 
 /* only used in this file */
 static inline int NBC_Start_round(NBC_Handle *handle);
+static void nbc_compiled_free (NBC_Compiled_schedule *compiled);
 
 /* #define NBC_TIMING */
 
@@ -305,9 +306,22 @@ static inline void NBC_Free (NBC_Handle* handle) {
     handle->schedule = NULL;
   }
 
+  /* the temporary buffer of a cached schedule belongs to the cache entry,
+   * which can be reused as soon as this request is done with it */
+  if (NULL != handle->cache_entry) {
+    handle->tmpbuf = NULL;
+    opal_atomic_wmb ();
+    handle->cache_entry->busy = 0;
+    OBJ_RELEASE(handle->cache_entry);
+    handle->cache_entry = NULL;
+  }
+
+  if (NULL != handle->compiled) {
+    nbc_compiled_free (handle->compiled);
+    handle->compiled = NULL;
+  }
+
   /* if the nbc_I<collective> attached some data */
-  /* problems with schedule cache here, see comment (TODO) in
-   * nbc_internal.h */
   if (NULL != handle->tmpbuf) {
     free((void*)handle->tmpbuf);
     handle->tmpbuf = NULL;
@@ -357,7 +371,10 @@ int NBC_Progress(NBC_Handle *handle) {
                 handle->super.super.req_status.MPI_ERROR = subreq->req_status.MPI_ERROR;
             }
             handle->req_count--;
-            ompi_request_free(&subreq);
+            /* the requests of a compiled schedule are persistent and restarted */
+            if (NULL == handle->compiled) {
+              ompi_request_free(&subreq);
+            }
         } else {
             flag = false;
             break;
@@ -371,7 +388,9 @@ int NBC_Progress(NBC_Handle *handle) {
   /* a round is finished */
   if (flag) {
     /* reset handle for next round */
-    if (NULL != handle->req_array) {
+    if (NULL != handle->compiled) {
+      handle->req_array = NULL;
+    } else if (NULL != handle->req_array) {
       /* free request array */
       free (handle->req_array);
       handle->req_array = NULL;
@@ -390,6 +409,24 @@ int NBC_Progress(NBC_Handle *handle) {
       return res;
     }
 
+    if (NULL != handle->compiled) {
+      if (++handle->row_offset == handle->compiled->nrounds) {
+        handle->nbc_complete = true;
+        if (!handle->super.super.req_persistent) {
+          NBC_Free(handle);
+        }
+        return NBC_OK;
+      }
+
+      res = NBC_Start_round(handle);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        NBC_Error ("Error in NBC_Start_round() (%i)", res);
+        return res;
+      }
+
+      return ret;
+    }
+
     /* adjust delim to start of current round */
     NBC_DEBUG(5, "NBC_Progress: going in schedule %p to row-offset: %li\n", handle->schedule, handle->row_offset);
     delim = handle->schedule->data + handle->row_offset;
@@ -426,6 +463,247 @@ int NBC_Progress(NBC_Handle *handle) {
   return ret;
 }
 
+/* Compiled schedules
+ *
+ * A persistent request runs the same schedule at each MPI_Start, with the
+ * same buffers. Rather than decoding the schedule and creating new
+ * point-to-point requests for every round of every start, the schedule is
+ * compiled once when the request is created: each round becomes an array of
+ * steps with resolved buffers, consecutive sends and receives being
+ * created as persistent PML requests and started together. handle->row_offset
+ * is then the index of the current round. */
+
+static void nbc_compiled_free (NBC_Compiled_schedule *compiled) {
+  for (int i = 0 ; i < compiled->nreqs ; ++i) {
+    if (NULL != compiled->reqs[i]) {
+      ompi_request_free (compiled->reqs + i);
+    }
+  }
+
+  free (compiled->reqs);
+  free (compiled->steps);
+  free (compiled->rounds);
+  free (compiled);
+}
+
+/* add the request in *req to the round, in the current batch of requests if
+ * the previous step was one */
+static inline void nbc_compiled_add_request (NBC_Compiled_round *round, ompi_request_t **req) {
+  NBC_Compiled_step *step = round->steps + round->nsteps - 1;
+
+  if (0 == round->nsteps || SEND != step->type) {
+    step = round->steps + round->nsteps++;
+    step->type = SEND;
+    step->nreqs = 0;
+    step->reqs = req;
+  }
+
+  step->nreqs++;
+  round->nreqs++;
+}
+
+static inline void *nbc_compiled_buf (NBC_Handle *handle, const void *buf, char tmpbuf) {
+  return tmpbuf ? (char *) handle->tmpbuf + (intptr_t) buf : (void *) buf;
+}
+
+int NBC_Compile_schedule (NBC_Handle *handle) {
+  int nrounds = 0, nsteps = 0, nreqs = 0, num, res = OMPI_SUCCESS;
+  NBC_Compiled_schedule *compiled;
+  NBC_Compiled_step *steps;
+  ompi_request_t **req;
+  NBC_Fn_type type;
+  NBC_Args_send sendargs;
+  NBC_Args_recv recvargs;
+  NBC_Args_op opargs;
+  NBC_Args_copy copyargs;
+  NBC_Args_unpack unpackargs;
+  char *ptr;
+
+  /* count the rounds, operations and requests */
+  ptr = handle->schedule->data;
+  do {
+    NBC_GET_BYTES(ptr,num);
+    for (int i = 0 ; i < num ; ++i) {
+      memcpy (&type, ptr, sizeof (type));
+      switch (type) {
+        case SEND:
+          ptr += sizeof (NBC_Args_send);
+          ++nreqs;
+          break;
+        case RECV:
+          ptr += sizeof (NBC_Args_recv);
+          ++nreqs;
+          break;
+        case OP:
+          ptr += sizeof (NBC_Args_op);
+          break;
+        case COPY:
+          ptr += sizeof (NBC_Args_copy);
+          break;
+        case UNPACK:
+          ptr += sizeof (NBC_Args_unpack);
+          break;
+        default:
+          return OMPI_ERROR;
+      }
+    }
+    nsteps += num;
+    ++nrounds;
+  } while (0 != *ptr++);
+
+  compiled = (NBC_Compiled_schedule *) calloc (1, sizeof (*compiled));
+  if (OPAL_UNLIKELY(NULL == compiled)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+
+  compiled->nrounds = nrounds;
+  compiled->nreqs = nreqs;
+  compiled->rounds = (NBC_Compiled_round *) calloc (nrounds, sizeof (NBC_Compiled_round));
+  compiled->steps = (NBC_Compiled_step *) calloc (nsteps ? nsteps : 1, sizeof (NBC_Compiled_step));
+  compiled->reqs = (ompi_request_t **) calloc (nreqs ? nreqs : 1, sizeof (ompi_request_t *));
+  if (OPAL_UNLIKELY(NULL == compiled->rounds || NULL == compiled->steps || NULL == compiled->reqs)) {
+    nbc_compiled_free (compiled);
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+
+  ptr = handle->schedule->data;
+  steps = compiled->steps;
+  req = compiled->reqs;
+  for (int r = 0 ; r < nrounds && OMPI_SUCCESS == res ; ++r) {
+    NBC_Compiled_round *round = compiled->rounds + r;
+    NBC_Compiled_step *step;
+
+    round->steps = steps;
+    round->reqs = req;
+
+    NBC_GET_BYTES(ptr,num);
+    for (int i = 0 ; i < num && OMPI_SUCCESS == res ; ++i) {
+      memcpy (&type, ptr, sizeof (type));
+      switch (type) {
+        case SEND:
+          NBC_GET_BYTES(ptr,sendargs);
+          res = MCA_PML_CALL(isend_init(nbc_compiled_buf (handle, sendargs.buf, sendargs.tmpbuf),
+                                        sendargs.count, sendargs.datatype, sendargs.dest, handle->tag,
+                                        MCA_PML_BASE_SEND_STANDARD,
+                                        sendargs.local ? handle->comm->c_local_comm : handle->comm, req));
+          if (OMPI_SUCCESS == res) {
+            nbc_compiled_add_request (round, req++);
+          }
+          break;
+        case RECV:
+          NBC_GET_BYTES(ptr,recvargs);
+          res = MCA_PML_CALL(irecv_init(nbc_compiled_buf (handle, recvargs.buf, recvargs.tmpbuf),
+                                        recvargs.count, recvargs.datatype, recvargs.source, handle->tag,
+                                        recvargs.local ? handle->comm->c_local_comm : handle->comm, req));
+          if (OMPI_SUCCESS == res) {
+            nbc_compiled_add_request (round, req++);
+          }
+          break;
+        case OP:
+          NBC_GET_BYTES(ptr,opargs);
+          step = round->steps + round->nsteps++;
+          step->type = OP;
+          step->buf1 = nbc_compiled_buf (handle, opargs.buf1, opargs.tmpbuf1);
+          step->buf2 = nbc_compiled_buf (handle, opargs.buf2, opargs.tmpbuf2);
+          step->count1 = opargs.count;
+          step->type1 = opargs.datatype;
+          step->op = opargs.op;
+          break;
+        case COPY:
+          NBC_GET_BYTES(ptr,copyargs);
+          step = round->steps + round->nsteps++;
+          step->type = COPY;
+          step->buf1 = nbc_compiled_buf (handle, copyargs.src, copyargs.tmpsrc);
+          step->buf2 = nbc_compiled_buf (handle, copyargs.tgt, copyargs.tmptgt);
+          step->count1 = copyargs.srccount;
+          step->type1 = copyargs.srctype;
+          step->count2 = copyargs.tgtcount;
+          step->type2 = copyargs.tgttype;
+          break;
+        case UNPACK:
+          NBC_GET_BYTES(ptr,unpackargs);
+          step = round->steps + round->nsteps++;
+          step->type = UNPACK;
+          step->buf1 = nbc_compiled_buf (handle, unpackargs.inbuf, unpackargs.tmpinbuf);
+          step->buf2 = nbc_compiled_buf (handle, unpackargs.outbuf, unpackargs.tmpoutbuf);
+          step->count1 = unpackargs.count;
+          step->type1 = unpackargs.datatype;
+          break;
+        default:
+          res = OMPI_ERROR;
+      }
+    }
+
+    steps += round->nsteps;
+    /* skip the delimiter */
+    ++ptr;
+  }
+
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    nbc_compiled_free (compiled);
+    return res;
+  }
+
+  /* the byte stream is not needed anymore */
+  handle->compiled = compiled;
+  OBJ_RELEASE(handle->schedule);
+  handle->schedule = NULL;
+
+  return OMPI_SUCCESS;
+}
+
+static inline int nbc_start_compiled_round (NBC_Handle *handle) {
+  NBC_Compiled_round *round = handle->compiled->rounds + handle->row_offset;
+  int res;
+
+  for (int i = 0 ; i < round->nsteps ; ++i) {
+    NBC_Compiled_step *step = round->steps + i;
+
+    switch (step->type) {
+      case SEND:
+        res = MCA_PML_CALL(start(step->nreqs, step->reqs));
+        if (OMPI_SUCCESS != res) {
+          NBC_Error ("Error in MCA_PML_CALL(start) of %i requests (%i)", step->nreqs, res);
+          return res;
+        }
+        break;
+      case OP:
+        ompi_op_reduce (step->op, step->buf1, step->buf2, step->count1, step->type1);
+        break;
+      case COPY:
+        res = NBC_Copy (step->buf1, step->count1, step->type1, step->buf2, step->count2, step->type2,
+                        handle->comm);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          return res;
+        }
+        break;
+      case UNPACK:
+        res = NBC_Unpack ((void *) step->buf1, step->count1, step->type1, step->buf2, handle->comm);
+        if (OMPI_SUCCESS != res) {
+          NBC_Error ("NBC_Unpack() failed (code: %i)", res);
+          return res;
+        }
+        break;
+      default:
+        NBC_Error ("nbc_start_compiled_round: bad type %li", (long) step->type);
+        return OMPI_ERROR;
+    }
+  }
+
+  handle->req_array = round->reqs;
+  handle->req_count = round->nreqs;
+
+  /* same as NBC_Start_round() */
+  if (handle->row_offset) {
+    res = NBC_Progress(handle);
+    if ((NBC_OK != res) && (NBC_CONTINUE != res)) {
+      return OMPI_ERROR;
+    }
+  }
+
+  return OMPI_SUCCESS;
+}
+
 static inline int NBC_Start_round(NBC_Handle *handle) {
   int num; /* number of operations */
   int res;
@@ -439,6 +717,10 @@ static inline int NBC_Start_round(NBC_Handle *handle) {
   NBC_Args_unpack unpackargs;
   void *buf1,  *buf2;
 
+  if (NULL != handle->compiled) {
+    return nbc_start_compiled_round (handle);
+  }
+
   /* get round-schedule address */
   ptr = handle->schedule->data + handle->row_offset;
 
@@ -610,53 +892,295 @@ void NBC_Return_handle(ompi_coll_libnbc_request_t *request) {
   OMPI_COLL_LIBNBC_REQUEST_RETURN(request);
 }
 
+/* Schedule cache
+ *
+ * Building a schedule costs a few allocations and a walk over the whole
+ * communication pattern, while most applications repeat the same
+ * nonblocking collectives with the same arguments over and over. Each
+ * module keeps the schedules of its non persistent requests, along with
+ * their temporary buffer, in a tree keyed by all the arguments the schedule
+ * depends on. A cached schedule serves a single request at a time: a call
+ * matching a busy entry builds a new schedule as usual. The datatypes and
+ * ops of the key are retained by the entry, so that their address cannot be
+ * reused by another object while it is cached. The cache is bounded both in
+ * number of entries and in bytes, evicting the least recently used idle
+ * entries first, and is released with the communicator. */
+static inline void nbc_sched_cache_retain_type (MPI_Datatype type) {
+  if (NULL != type && !ompi_datatype_is_predefined (type)) {
+    OBJ_RETAIN(type);
+  }
+}
+
+static inline void nbc_sched_cache_release_type (MPI_Datatype type) {
+  if (NULL != type && !ompi_datatype_is_predefined (type)) {
+    OBJ_RELEASE(type);
+  }
+}
+
+/* retains (retain true) or releases the datatypes and the op of key */
+static void nbc_sched_key_objects (const NBC_Sched_key *key, bool retain) {
+  void (*fn) (MPI_Datatype) = retain ? nbc_sched_cache_retain_type : nbc_sched_cache_release_type;
+
+  fn (key->sendtype);
+  fn (key->recvtype);
+  for (int i = 0 ; i < key->nvec ; ++i) {
+    if (key->vec_types & (1 << i)) {
+      MPI_Datatype const *types = (MPI_Datatype const *) key->vec[i];
+      for (size_t j = 0 ; j < key->vec_size[i] / sizeof (*types) ; ++j) {
+        fn (types[j]);
+      }
+    }
+  }
+
+  if (NULL != key->op && !ompi_op_is_intrinsic (key->op)) {
+    ompi_op_t *op = key->op;
+    if (retain) {
+      OBJ_RETAIN(op);
+    } else {
+      OBJ_RELEASE(op);
+    }
+  }
+}
+
+static void nbc_sched_cache_entry_constructor (NBC_Sched_cache_entry *entry) {
+  entry->vec_data = NULL;
+  entry->schedule = NULL;
+  entry->tmpbuf = NULL;
+  entry->bytes = 0;
+  entry->retained = false;
+  entry->busy = 0;
+}
+
+static void nbc_sched_cache_entry_destructor (NBC_Sched_cache_entry *entry) {
+  if (entry->retained) {
+    nbc_sched_key_objects (&entry->key, false);
+  }
+  if (NULL != entry->schedule) {
+    OBJ_RELEASE(entry->schedule);
+  }
+  free (entry->tmpbuf);
+  free (entry->vec_data);
+}
+
+OBJ_CLASS_INSTANCE(NBC_Sched_cache_entry, opal_list_item_t, nbc_sched_cache_entry_constructor,
+                   nbc_sched_cache_entry_destructor);
+
+#define NBC_SCHED_KEY_CMP(a, b) do {            \
+    if ((a) != (b)) {                           \
+      return (a) < (b) ? -1 : 1;                \
+    }                                           \
+  } while (0)
+
+static int nbc_sched_key_compare (const void *k1, const void *k2) {
+  const NBC_Sched_key *a = (const NBC_Sched_key *) k1, *b = (const NBC_Sched_key *) k2;
+  int res;
+
+  NBC_SCHED_KEY_CMP(a->coll, b->coll);
+  NBC_SCHED_KEY_CMP(a->alg, b->alg);
+  NBC_SCHED_KEY_CMP(a->alg_param, b->alg_param);
+  NBC_SCHED_KEY_CMP(a->root, b->root);
+  NBC_SCHED_KEY_CMP((uintptr_t) a->sendbuf, (uintptr_t) b->sendbuf);
+  NBC_SCHED_KEY_CMP((uintptr_t) a->recvbuf, (uintptr_t) b->recvbuf);
+  NBC_SCHED_KEY_CMP(a->sendcount, b->sendcount);
+  NBC_SCHED_KEY_CMP(a->recvcount, b->recvcount);
+  NBC_SCHED_KEY_CMP((uintptr_t) a->sendtype, (uintptr_t) b->sendtype);
+  NBC_SCHED_KEY_CMP((uintptr_t) a->recvtype, (uintptr_t) b->recvtype);
+  NBC_SCHED_KEY_CMP((uintptr_t) a->op, (uintptr_t) b->op);
+  NBC_SCHED_KEY_CMP(a->nvec, b->nvec);
+  NBC_SCHED_KEY_CMP(a->vec_types, b->vec_types);
+  for (int i = 0 ; i < a->nvec ; ++i) {
+    NBC_SCHED_KEY_CMP(a->vec_size[i], b->vec_size[i]);
+  }
+  for (int i = 0 ; i < a->nvec ; ++i) {
+    if (a->vec_size[i] > 0 && 0 != (res = memcmp (a->vec[i], b->vec[i], a->vec_size[i]))) {
+      return res;
+    }
+  }
+
+  return 0;
+}
+
+static size_t nbc_sched_key_vec_size (const NBC_Sched_key *key) {
+  size_t size = 0;
+
+  for (int i = 0 ; i < key->nvec ; ++i) {
+    size += key->vec_size[i];
+  }
+
+  return size;
+}
+
+static NBC_Sched_cache_entry *nbc_sched_cache_entry_new (const NBC_Sched_key *key, NBC_Schedule *schedule,
+                                                         void *tmpbuf, size_t bytes) {
+  NBC_Sched_cache_entry *entry;
+  size_t vec_size = nbc_sched_key_vec_size (key);
+
+  entry = OBJ_NEW(NBC_Sched_cache_entry);
+  if (OPAL_UNLIKELY(NULL == entry)) {
+    return NULL;
+  }
+
+  entry->key = *key;
+  if (vec_size > 0) {
+    char *ptr = entry->vec_data = malloc (vec_size);
+    if (OPAL_UNLIKELY(NULL == ptr)) {
+      OBJ_RELEASE(entry);
+      return NULL;
+    }
+
+    for (int i = 0 ; i < key->nvec ; ++i) {
+      if (key->vec_size[i] > 0) {
+        memcpy (ptr, key->vec[i], key->vec_size[i]);
+      }
+      entry->key.vec[i] = ptr;
+      ptr += key->vec_size[i];
+    }
+  }
+
+  nbc_sched_key_objects (&entry->key, true);
+  entry->retained = true;
+
+  OBJ_RETAIN(schedule);
+  entry->schedule = schedule;
+  entry->tmpbuf = tmpbuf;
+  entry->bytes = bytes;
+
+  return entry;
+}
+
+/* to be called with the module mutex held */
+static void nbc_sched_cache_evict (ompi_coll_libnbc_module_t *module, NBC_Sched_cache_entry *entry) {
+  ompi_coll_libnbc_hb_tree_remove ((hb_tree *) module->sched_cache, &entry->key, 0);
+  opal_list_remove_item (&module->sched_cache_lru, &entry->super);
+  module->sched_cache_bytes -= entry->bytes;
+  OBJ_RELEASE(entry);
+}
+
+/* evicts the least recently used idle entries until the cache fits in its
+ * bounds. to be called with the module mutex held */
+static void nbc_sched_cache_trim (ompi_coll_libnbc_module_t *module) {
+  NBC_Sched_cache_entry *entry, *next;
+
+  OPAL_LIST_FOREACH_SAFE(entry, next, &module->sched_cache_lru, NBC_Sched_cache_entry) {
+    if (opal_list_get_size (&module->sched_cache_lru) <= (size_t) libnbc_schedule_cache_size &&
+        module->sched_cache_bytes <= libnbc_schedule_cache_max_bytes) {
+      break;
+    }
+    if (0 == entry->busy) {
+      nbc_sched_cache_evict (module, entry);
+    }
+  }
+}
+
+int NBC_Sched_cache_request(NBC_Sched_key *key, ompi_communicator_t *comm,
+                            ompi_coll_libnbc_module_t *module, bool persistent,
+                            ompi_request_t **request) {
+  NBC_Sched_cache_entry *entry;
+  int32_t idle = 0;
+  int res;
+
+  if (persistent || 0 >= libnbc_schedule_cache_size || NULL == module->sched_cache) {
+    return OMPI_ERR_NOT_FOUND;
+  }
+
+  OPAL_THREAD_LOCK(&module->mutex);
+  entry = (NBC_Sched_cache_entry *) ompi_coll_libnbc_hb_tree_search ((hb_tree *) module->sched_cache, key);
+  if (NULL == entry || !OPAL_ATOMIC_COMPARE_EXCHANGE_STRONG_32(&entry->busy, &idle, 1)) {
+    OPAL_THREAD_UNLOCK(&module->mutex);
+    return OMPI_ERR_NOT_FOUND;
+  }
+
+  /* keep the list least recently used first */
+  opal_list_remove_item (&module->sched_cache_lru, &entry->super);
+  opal_list_append (&module->sched_cache_lru, &entry->super);
+  OBJ_RETAIN(entry);
+  OPAL_THREAD_UNLOCK(&module->mutex);
+
+  OBJ_RETAIN(entry->schedule);
+  res = NBC_Schedule_request (entry->schedule, comm, module, false, request, entry->tmpbuf);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(entry->schedule);
+    entry->busy = 0;
+    OBJ_RELEASE(entry);
+    return res;
+  }
+
+  ((NBC_Handle *) *request)->cache_entry = entry;
+
+  return OMPI_SUCCESS;
+}
+
+int NBC_Schedule_request_cached(NBC_Sched_key *key, size_t tmpbuf_size,
+                                NBC_Schedule *schedule, ompi_communicator_t *comm,
+                                ompi_coll_libnbc_module_t *module, bool persistent,
+                                ompi_request_t **request, void *tmpbuf) {
+  NBC_Sched_cache_entry *entry;
+  size_t bytes;
+  bool cache;
+  int res;
+
+  /* no operation schedules are released by NBC_Schedule_request() */
+  cache = !persistent && 0 < libnbc_schedule_cache_size && NULL != module->sched_cache &&
+    !(((int *)schedule->data)[0] == 0 && schedule->data[sizeof(int)] == 0);
+  bytes = sizeof (NBC_Sched_cache_entry) + (size_t) schedule->size + tmpbuf_size +
+    nbc_sched_key_vec_size (key);
+
+  res = NBC_Schedule_request (schedule, comm, module, persistent, request, tmpbuf);
+  if (OMPI_SUCCESS != res || !cache || bytes > libnbc_schedule_cache_max_bytes) {
+    return res;
+  }
+
+  /* failing to cache the schedule is not an error */
+  entry = nbc_sched_cache_entry_new (key, schedule, tmpbuf, bytes);
+  if (OPAL_UNLIKELY(NULL == entry)) {
+    return OMPI_SUCCESS;
+  }
+  entry->busy = 1;
+
+  OPAL_THREAD_LOCK(&module->mutex);
+  if (0 != ompi_coll_libnbc_hb_tree_insert ((hb_tree *) module->sched_cache, &entry->key, entry, 0)) {
+    /* another thread cached the same arguments in the meantime, the
+     * temporary buffer stays with the request */
+    OPAL_THREAD_UNLOCK(&module->mutex);
+    entry->tmpbuf = NULL;
+    OBJ_RELEASE(entry);
+    return OMPI_SUCCESS;
+  }
+
+  opal_list_append (&module->sched_cache_lru, &entry->super);
+  module->sched_cache_bytes += bytes;
+  nbc_sched_cache_trim (module);
+
+  OBJ_RETAIN(entry);
+  ((NBC_Handle *) *request)->cache_entry = entry;
+  OPAL_THREAD_UNLOCK(&module->mutex);
+
+  return OMPI_SUCCESS;
+}
+
+void NBC_Sched_cache_fini(ompi_coll_libnbc_module_t *module) {
+  NBC_Sched_cache_entry *entry;
+
+  if (NULL == module->sched_cache) {
+    return;
+  }
+
+  while (NULL != (entry = (NBC_Sched_cache_entry *) opal_list_remove_first (&module->sched_cache_lru))) {
+    ompi_coll_libnbc_hb_tree_remove ((hb_tree *) module->sched_cache, &entry->key, 0);
+    OBJ_RELEASE(entry);
+  }
+
+  ompi_coll_libnbc_hb_tree_destroy ((hb_tree *) module->sched_cache, 0);
+  module->sched_cache = NULL;
+  module->sched_cache_bytes = 0;
+}
+
 int  NBC_Init_comm(MPI_Comm comm, NBC_Comminfo *comminfo) {
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* initialize the NBC_ALLTOALL SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLTOALL] = hb_tree_new((dict_cmp_func)NBC_Alltoall_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLTOALL] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLTOALL]);
-  comminfo->NBC_Dict_size[NBC_ALLTOALL] = 0;
-  /* initialize the NBC_ALLGATHER SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLGATHER] = hb_tree_new((dict_cmp_func)NBC_Allgather_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLGATHER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLGATHER]);
-  comminfo->NBC_Dict_size[NBC_ALLGATHER] = 0;
-  /* initialize the NBC_ALLREDUCE SchedCache tree */
-  comminfo->NBC_Dict[NBC_ALLREDUCE] = hb_tree_new((dict_cmp_func)NBC_Allreduce_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_ALLREDUCE] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_ALLREDUCE]);
-  comminfo->NBC_Dict_size[NBC_ALLREDUCE] = 0;
-  /* initialize the NBC_BARRIER SchedCache tree - is not needed -
-   * schedule is hung off directly */
-  comminfo->NBC_Dict_size[NBC_BARRIER] = 0;
-  /* initialize the NBC_BCAST SchedCache tree */
-  comminfo->NBC_Dict[NBC_BCAST] = hb_tree_new((dict_cmp_func)NBC_Bcast_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_BCAST] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_BCAST]);
-  comminfo->NBC_Dict_size[NBC_BCAST] = 0;
-  /* initialize the NBC_GATHER SchedCache tree */
-  comminfo->NBC_Dict[NBC_GATHER] = hb_tree_new((dict_cmp_func)NBC_Gather_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_GATHER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_GATHER]);
-  comminfo->NBC_Dict_size[NBC_GATHER] = 0;
-  /* initialize the NBC_REDUCE SchedCache tree */
-  comminfo->NBC_Dict[NBC_REDUCE] = hb_tree_new((dict_cmp_func)NBC_Reduce_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_REDUCE] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_REDUCE]);
-  comminfo->NBC_Dict_size[NBC_REDUCE] = 0;
-  /* initialize the NBC_SCAN SchedCache tree */
-  comminfo->NBC_Dict[NBC_SCAN] = hb_tree_new((dict_cmp_func)NBC_Scan_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_SCAN] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_SCAN]);
-  comminfo->NBC_Dict_size[NBC_SCAN] = 0;
-  /* initialize the NBC_SCATTER SchedCache tree */
-  comminfo->NBC_Dict[NBC_SCATTER] = hb_tree_new((dict_cmp_func)NBC_Scatter_args_compare, NBC_SchedCache_args_delete_key_dummy, NBC_SchedCache_args_delete);
-  if(comminfo->NBC_Dict[NBC_SCATTER] == NULL) { printf("Error in hb_tree_new()\n"); return OMPI_ERROR;; }
-  NBC_DEBUG(1, "added tree at address %lu\n", (unsigned long)comminfo->NBC_Dict[NBC_SCATTER]);
-  comminfo->NBC_Dict_size[NBC_SCATTER] = 0;
-#endif
+  comminfo->sched_cache = ompi_coll_libnbc_hb_tree_new(nbc_sched_key_compare, NULL, NULL);
+  if (NULL == comminfo->sched_cache) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
   return OMPI_SUCCESS;
 }
@@ -677,9 +1201,11 @@ int NBC_Start(NBC_Handle *handle) {
     return res;
   }
 
-  OPAL_THREAD_LOCK(&mca_coll_libnbc_component.lock);
-  opal_list_append(&mca_coll_libnbc_component.active_requests, (opal_list_item_t *)handle);
-  OPAL_THREAD_UNLOCK(&mca_coll_libnbc_component.lock);
+  /* hand the request over to the thread progressing libnbc */
+  opal_fifo_push_atomic(&mca_coll_libnbc_component.pending_requests, (opal_list_item_t *)handle);
+  if (libnbc_progress_thread) {
+    ompi_coll_base_progress_thread_post();
+  }
 
   return OMPI_SUCCESS;
 }
@@ -712,6 +1238,8 @@ int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
   if (NULL == handle) return OMPI_ERR_OUT_OF_RESOURCE;
 
   handle->tmpbuf = NULL;
+  handle->cache_entry = NULL;
+  handle->compiled = NULL;
   handle->req_count = 0;
   handle->req_array = NULL;
   handle->comm = comm;
@@ -749,20 +1277,13 @@ int NBC_Schedule_request(NBC_Schedule *schedule, ompi_communicator_t *comm,
 
   handle->tmpbuf = tmpbuf;
   handle->schedule = schedule;
-  *request = (ompi_request_t *) handle;
 
-  return OMPI_SUCCESS;
-}
+  /* the schedule is interpreted if it cannot be compiled */
+  if (persistent && libnbc_persistent_compile) {
+    (void) NBC_Compile_schedule (handle);
+  }
 
-#ifdef NBC_CACHE_SCHEDULE
-void NBC_SchedCache_args_delete_key_dummy(void *k) {
-    /* do nothing because the key and the data element are identical :-)
-     * both (the single one :) is freed in NBC_<COLLOP>_args_delete() */
-}
+  *request = (ompi_request_t *) handle;
 
-void NBC_SchedCache_args_delete(void *entry) {
-  struct NBC_dummyarg *tmp = (struct NBC_dummyarg*)entry;
-  OBJ_RELEASE(tmp->schedule);
-  free(entry);
+  return OMPI_SUCCESS;
 }
-#endif
@@ -0,0 +1,244 @@
+/* -*- Mode: C; c-basic-offset:2 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Node locality of the communicators, and schedule builders operating on a
+ * subset of the ranks of a communicator, used to assemble the hierarchical
+ * schedules: a stage between the leaders of the nodes, and stages between
+ * the ranks of each node, all in the same schedule.
+ */
+
+#include "nbc_internal.h"
+#include "opal/mca/pmix/pmix-internal.h"
+#include "ompi/proc/proc.h"
+
+typedef struct {
+  uint32_t nodeid;
+  int rank;
+} nbc_rank_node_t;
+
+static int nbc_rank_node_cmp (const void *a, const void *b) {
+  const nbc_rank_node_t *x = (const nbc_rank_node_t *) a, *y = (const nbc_rank_node_t *) b;
+
+  if (x->nodeid != y->nodeid) {
+    return x->nodeid < y->nodeid ? -1 : 1;
+  }
+  return x->rank - y->rank;
+}
+
+static int nbc_int_cmp (const void *a, const void *b) {
+  return *(const int *) a - *(const int *) b;
+}
+
+static void nbc_comm_locality_free (NBC_Comm_locality *locality) {
+  if (NULL != locality) {
+    free (locality->node_of);
+    free (locality);
+  }
+}
+
+/* group the ranks of comm by node; returns NULL if the node of a rank is
+ * unknown, or if a hierarchy would not help: all the ranks on a single
+ * node, or a single rank on each node.
+ *
+ * All the ranks must take the same decision without communicating, or some
+ * would build flat schedules and the others hierarchical ones. It thus only
+ * depends on the PMIX_NODEID of the processes, which is job-level data seen
+ * identically by all the processes of a job, and not on the local view of
+ * each process (such as OPAL_PROC_ON_LOCAL_NODE). Communicators spanning
+ * several jobs, whose node ids may not be known everywhere, are flat. */
+static NBC_Comm_locality *nbc_comm_locality_create (ompi_communicator_t *comm) {
+  int p = ompi_comm_size (comm), rank = ompi_comm_rank (comm);
+  nbc_rank_node_t *pairs;
+  NBC_Comm_locality *locality;
+  int res, nnodes;
+
+  for (int i = 0 ; i < p ; ++i) {
+    ompi_proc_t *proc = ompi_comm_peer_lookup (comm, i);
+    if (proc->super.proc_name.jobid != OMPI_PROC_MY_NAME->jobid) {
+      NBC_DEBUG(1, "communicator spans several jobs, no hierarchical schedules\n");
+      return NULL;
+    }
+  }
+
+  pairs = (nbc_rank_node_t *) malloc (p * sizeof (*pairs));
+  if (NULL == pairs) {
+    return NULL;
+  }
+
+  for (int i = 0 ; i < p ; ++i) {
+    ompi_proc_t *proc = ompi_comm_peer_lookup (comm, i);
+    uint32_t nodeid, *pnodeid = &nodeid;
+
+    OPAL_MODEX_RECV_VALUE_OPTIONAL(res, PMIX_NODEID, &proc->super.proc_name, &pnodeid, PMIX_UINT32);
+    if (PMIX_SUCCESS != res) {
+      NBC_DEBUG(1, "node of rank %i unknown, no hierarchical schedules\n", i);
+      free (pairs);
+      return NULL;
+    }
+    pairs[i].nodeid = nodeid;
+    pairs[i].rank = i;
+  }
+
+  qsort (pairs, p, sizeof (*pairs), nbc_rank_node_cmp);
+  nnodes = 1;
+  for (int i = 1 ; i < p ; ++i) {
+    if (pairs[i].nodeid != pairs[i - 1].nodeid) {
+      nnodes++;
+    }
+  }
+  if (1 == nnodes || p == nnodes) {
+    free (pairs);
+    return NULL;
+  }
+
+  locality = (NBC_Comm_locality *) malloc (sizeof (*locality));
+  if (NULL == locality) {
+    free (pairs);
+    return NULL;
+  }
+  /* a single allocation for the arrays: node_of and node_ranks (p each),
+   * node_start (nnodes + 1) and leaders (nnodes) */
+  locality->node_of = (int *) malloc ((2 * p + 2 * nnodes + 1) * sizeof (int));
+  if (NULL == locality->node_of) {
+    free (locality);
+    free (pairs);
+    return NULL;
+  }
+  locality->nnodes = nnodes;
+  locality->node_ranks = locality->node_of + p;
+  locality->node_start = locality->node_ranks + p;
+  locality->leaders = locality->node_start + nnodes + 1;
+
+  /* the leader of a node is its lowest rank, and the nodes are numbered in
+   * the order of their leaders so that all the ranks agree on the numbers */
+  for (int i = 0, n = 0 ; i < p ; ++i) {
+    if (0 == i || pairs[i].nodeid != pairs[i - 1].nodeid) {
+      locality->leaders[n++] = pairs[i].rank;
+    }
+  }
+  qsort (locality->leaders, nnodes, sizeof (int), nbc_int_cmp);
+  for (int n = 0 ; n < nnodes ; ++n) {
+    locality->node_of[locality->leaders[n]] = n;
+  }
+  for (int i = 0, leader = 0 ; i < p ; ++i) {
+    if (0 == i || pairs[i].nodeid != pairs[i - 1].nodeid) {
+      leader = pairs[i].rank;
+    }
+    locality->node_of[pairs[i].rank] = locality->node_of[leader];
+  }
+  free (pairs);
+
+  /* counting sort of the ranks by node, keeping the rank order */
+  memset (locality->node_start, 0, (nnodes + 1) * sizeof (int));
+  for (int i = 0 ; i < p ; ++i) {
+    locality->node_start[locality->node_of[i] + 1]++;
+  }
+  for (int n = 0 ; n < nnodes ; ++n) {
+    locality->node_start[n + 1] += locality->node_start[n];
+  }
+  for (int i = 0 ; i < p ; ++i) {
+    locality->node_ranks[locality->node_start[locality->node_of[i]]++] = i;
+  }
+  for (int n = nnodes ; n > 0 ; --n) {
+    locality->node_start[n] = locality->node_start[n - 1];
+  }
+  locality->node_start[0] = 0;
+
+  locality->my_node = locality->node_of[rank];
+  for (int i = locality->node_start[locality->my_node] ; ; ++i) {
+    if (rank == locality->node_ranks[i]) {
+      locality->my_local_idx = i - locality->node_start[locality->my_node];
+      break;
+    }
+  }
+
+  return locality;
+}
+
+NBC_Comm_locality *NBC_Comm_locality_get (ompi_communicator_t *comm, ompi_coll_libnbc_module_t *module) {
+  if (OMPI_COMM_IS_INTER(comm)) {
+    return NULL;
+  }
+  if (!module->locality_known) {
+    module->locality = nbc_comm_locality_create (comm);
+    module->locality_known = true;
+  }
+  return (NBC_Comm_locality *) module->locality;
+}
+
+void NBC_Comm_locality_fini (ompi_coll_libnbc_module_t *module) {
+  nbc_comm_locality_free ((NBC_Comm_locality *) module->locality);
+  module->locality = NULL;
+  module->locality_known = false;
+}
+
+/* binomial broadcast among the n ranks of the ranks array, from the rank at
+ * index root_idx; me is the index of the calling rank */
+int NBC_Sched_bcast_group (void *buf, char tmpbuf, size_t count, MPI_Datatype datatype, const int *ranks,
+                           int n, int root_idx, int me, NBC_Schedule *schedule) {
+  int vrank = (me - root_idx + n) % n, mask = 1, res;
+
+  /* receive from the parent: the rank without the lowest set bit of vrank */
+  if (0 != vrank) {
+    while (0 == (vrank & mask)) {
+      mask <<= 1;
+    }
+    res = NBC_Sched_recv (buf, tmpbuf, count, datatype, ranks[(vrank - mask + root_idx) % n], schedule, true);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      return res;
+    }
+  } else {
+    while (mask < n) {
+      mask <<= 1;
+    }
+  }
+
+  /* and send to the children, the largest subtree first */
+  for (mask >>= 1 ; mask > 0 ; mask >>= 1) {
+    if (vrank + mask < n) {
+      res = NBC_Sched_send (buf, tmpbuf, count, datatype, ranks[(vrank + mask + root_idx) % n], schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        return res;
+      }
+    }
+  }
+
+  return OMPI_SUCCESS;
+}
+
+/* binomial reduction of buf among the n ranks of the ranks array, to the
+ * rank at index root_idx, for commutative operations; the contributions of
+ * the children are received in the temporary buffer at offset tmpoffset and
+ * reduced into buf. The send to the parent ends the round, so that buf can
+ * be reused by the next stage. */
+int NBC_Sched_reduce_group (void *buf, ptrdiff_t tmpoffset, size_t count, MPI_Datatype datatype, MPI_Op op,
+                            const int *ranks, int n, int root_idx, int me, NBC_Schedule *schedule) {
+  int vrank = (me - root_idx + n) % n, res;
+
+  for (int mask = 1 ; mask < n ; mask <<= 1) {
+    if (vrank & mask) {
+      return NBC_Sched_send (buf, false, count, datatype, ranks[(vrank - mask + root_idx) % n], schedule, true);
+    }
+    if (vrank + mask < n) {
+      res = NBC_Sched_recv ((void *) tmpoffset, true, count, datatype, ranks[(vrank + mask + root_idx) % n],
+                            schedule, true);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        return res;
+      }
+      res = NBC_Sched_op ((void *) tmpoffset, true, buf, false, count, datatype, op, schedule, false);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        return res;
+      }
+    }
+  }
+
+  return OMPI_SUCCESS;
+}
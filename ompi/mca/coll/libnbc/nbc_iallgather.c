@@ -29,26 +29,6 @@ static inline int allgather_sched_recursivedoubling(
     size_t scount, struct ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
     struct ompi_datatype_t *rdtype);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Allgather_args_compare(NBC_Allgather_args *a, NBC_Allgather_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->sendcount == b->sendcount) &&
-      (a->sendtype == b->sendtype) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->recvcount == b->recvcount) &&
-      (a->recvtype == b->recvtype) ) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatype sendtype, void* recvbuf, size_t recvcount,
                               MPI_Datatype recvtype, struct ompi_communicator_t *comm, ompi_request_t ** request,
                               mca_coll_base_module_t *module, bool persistent)
@@ -57,9 +37,6 @@ static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatyp
   MPI_Aint rcvext;
   NBC_Schedule *schedule;
   char *rbuf, inplace;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Allgather_args *args, *found, search;
-#endif
   enum { NBC_ALLGATHER_LINEAR, NBC_ALLGATHER_RDBL} alg;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -102,86 +79,54 @@ static int nbc_allgather_init(const void* sendbuf, size_t sendcount, MPI_Datatyp
     return nbc_get_noop_request(persistent, request);
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.sendcount = sendcount;
-  search.sendtype = sendtype;
-  search.recvbuf = recvbuf;
-  search.recvcount = recvcount;
-  search.recvtype = recvtype;
-  found = (NBC_Allgather_args *) hb_tree_search ((hb_tree*)libnbc_module->NBC_Dict[NBC_ALLGATHER], &search);
-  if (NULL == found) {
-#endif
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-      return OMPI_ERR_OUT_OF_RESOURCE;
-    }
-
-    if (persistent && !inplace) {
-      /* for nonblocking, data has been copied already */
-      /* copy my data to receive buffer (= send buffer of NBC_Sched_send) */
-      rbuf = (char *)recvbuf + (MPI_Aint) rcvext * rank * recvcount;
-      res = NBC_Sched_copy((void *)sendbuf, false, sendcount, sendtype,
-                            rbuf, false, recvcount, recvtype, schedule, true);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
-      }
-    }
+  NBC_Sched_key key = {.coll = NBC_ALLGATHER, .alg = alg, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendcount = sendcount, .recvcount = recvcount,
+                       .sendtype = sendtype, .recvtype = recvtype};
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
 
-    switch (alg) {
-      case NBC_ALLGATHER_LINEAR:
-        res = allgather_sched_linear(rank, p, schedule, sendbuf, sendcount, sendtype,
-                                     recvbuf, recvcount, recvtype);
-        break;
-      case NBC_ALLGATHER_RDBL:
-        res = allgather_sched_recursivedoubling(rank, p, schedule, sendbuf, sendcount,
-                                                sendtype, recvbuf, recvcount, recvtype);
-        break;
-    }
+  schedule = OBJ_NEW(NBC_Schedule);
+  if (OPAL_UNLIKELY(NULL == schedule)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
+  if (persistent && !inplace) {
+    /* for nonblocking, data has been copied already */
+    /* copy my data to receive buffer (= send buffer of NBC_Sched_send) */
+    rbuf = (char *)recvbuf + (MPI_Aint) rcvext * rank * recvcount;
+    res = NBC_Sched_copy((void *)sendbuf, false, sendcount, sendtype,
+                          rbuf, false, recvcount, recvtype, schedule, true);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
+  }
 
-    res = NBC_Sched_commit(schedule);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
-    }
+  switch (alg) {
+    case NBC_ALLGATHER_LINEAR:
+      res = allgather_sched_linear(rank, p, schedule, sendbuf, sendcount, sendtype,
+                                   recvbuf, recvcount, recvtype);
+      break;
+    case NBC_ALLGATHER_RDBL:
+      res = allgather_sched_recursivedoubling(rank, p, schedule, sendbuf, sendcount,
+                                              sendtype, recvbuf, recvcount, recvtype);
+      break;
+  }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Allgather_args *) malloc (sizeof (args));
-    args->sendbuf = sendbuf;
-    args->sendcount = sendcount;
-    args->sendtype = sendtype;
-    args->recvbuf = recvbuf;
-    args->recvcount = recvcount;
-    args->recvtype = recvtype;
-    args->schedule = schedule;
-
-    res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLGATHER], args, args, 0);
-    if (res != 0) {
-      free (args);
-    } else {
-      OBJ_RETAIN(schedule);
-    }
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    return res;
+  }
 
-    /* increase number of elements for A2A */
-    if (++libnbc_module->NBC_Dict_size[NBC_ALLGATHER] > NBC_SCHED_DICT_UPPER) {
-      NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLGATHER], &libnbc_module->NBC_Dict_size[NBC_ALLGATHER]);
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+  res = NBC_Sched_commit(schedule);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    return res;
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -228,6 +173,14 @@ static int nbc_allgather_inter_init(const void* sendbuf, size_t sendcount, MPI_D
 
   rsize = ompi_comm_remote_size (comm);
 
+  NBC_Sched_key key = {.coll = NBC_ALLGATHER, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendcount = sendcount, .recvcount = recvcount,
+                       .sendtype = sendtype, .recvtype = recvtype};
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   /* set up schedule */
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
@@ -258,7 +211,7 @@ static int nbc_allgather_inter_init(const void* sendbuf, size_t sendcount, MPI_D
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
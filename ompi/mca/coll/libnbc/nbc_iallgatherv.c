@@ -68,6 +68,15 @@ static int nbc_allgatherv_init(const void* sendbuf, int sendcount, MPI_Datatype
     }
   }
 
+  NBC_Sched_key key = {.coll = NBC_ALLGATHERV, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendcount = sendcount, .sendtype = sendtype, .recvtype = recvtype};
+  NBC_Sched_key_counts(&key, recvcounts, p);
+  NBC_Sched_key_displs(&key, displs, p);
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (NULL == schedule) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -111,7 +120,7 @@ static int nbc_allgatherv_init(const void* sendbuf, int sendcount, MPI_Datatype
     return res;
   }
 
-  res = NBC_Schedule_request (schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -158,6 +167,15 @@ static int nbc_allgatherv_inter_init(const void* sendbuf, int sendcount, MPI_Dat
     return res;
   }
 
+  NBC_Sched_key key = {.coll = NBC_ALLGATHERV, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendcount = sendcount, .sendtype = sendtype, .recvtype = recvtype};
+  NBC_Sched_key_counts(&key, recvcounts, rsize);
+  NBC_Sched_key_displs(&key, displs, rsize);
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (NULL == schedule) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -192,7 +210,7 @@ static int nbc_allgatherv_inter_init(const void* sendbuf, int sendcount, MPI_Dat
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -23,6 +23,7 @@
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/op/op.h"
 #include "opal/util/bit_ops.h"
+#include "opal/util/minmax.h"
 
 #include <assert.h>
 
@@ -34,6 +35,12 @@ static inline int allred_sched_recursivedoubling(int rank, int p, const void *se
 static inline int allred_sched_ring(int rank, int p, size_t count, MPI_Datatype datatype, const void *sendbuf,
                                     void *recvbuf, MPI_Op op, int size, int ext, NBC_Schedule *schedule,
                                     void *tmpbuf);
+static inline int allred_sched_ring_segmented(int r, int p, size_t count, MPI_Datatype datatype, ptrdiff_t gap,
+                                              const void *sendbuf, void *recvbuf, MPI_Op op, char inplace,
+                                              size_t size, ptrdiff_t ext, int segsize, NBC_Schedule *schedule);
+static inline int allred_sched_hier(NBC_Comm_locality *locality, size_t count, MPI_Datatype datatype, ptrdiff_t gap,
+                                    const void *sendbuf, void *recvbuf, MPI_Op op, char inplace,
+                                    NBC_Schedule *schedule);
 static inline int allred_sched_linear(int rank, int p, const void *sendbuf, void *recvbuf, size_t count,
                                       MPI_Datatype datatype, ptrdiff_t gap, MPI_Op op, int ext, int size,
                                       NBC_Schedule *schedule, void *tmpbuf);
@@ -42,25 +49,6 @@ static inline int allred_sched_redscat_allgather(
     const void *sbuf, void *rbuf, MPI_Op op, char inplace,
     NBC_Schedule *schedule, void *tmpbuf, struct ompi_communicator_t *comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Allreduce_args_compare(NBC_Allreduce_args *a, NBC_Allreduce_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->count == b->count) &&
-      (a->datatype == b->datatype) &&
-      (a->op == b->op)) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count, MPI_Datatype datatype, MPI_Op op,
                               struct ompi_communicator_t *comm, ompi_request_t ** request,
                               mca_coll_base_module_t *module, bool persistent)
@@ -69,10 +57,9 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count,
   ptrdiff_t ext, lb;
   NBC_Schedule *schedule;
   size_t size;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Allreduce_args *args, *found, search;
-#endif
-  enum { NBC_ARED_BINOMIAL, NBC_ARED_RING, NBC_ARED_REDSCAT_ALLGATHER, NBC_ARED_RDBL } alg;
+  enum { NBC_ARED_BINOMIAL, NBC_ARED_RING, NBC_ARED_REDSCAT_ALLGATHER, NBC_ARED_RDBL, NBC_ARED_RING_SEGMENTED,
+         NBC_ARED_HIER } alg;
+  NBC_Comm_locality *locality = NULL;
   char inplace;
   void *tmpbuf = NULL;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
@@ -106,12 +93,6 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count,
     return nbc_get_noop_request(persistent, request);
   }
 
-  span = opal_datatype_span(&datatype->super, count, &gap);
-  tmpbuf = malloc (span);
-  if (OPAL_UNLIKELY(NULL == tmpbuf)) {
-    return OMPI_ERR_OUT_OF_RESOURCE;
-  }
-
   alg = NBC_ARED_RING;  /* default generic selection */
   /* algorithm selection */
   int nprocs_pof2 = opal_next_poweroftwo(p) >> 1;
@@ -121,6 +102,11 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count,
     } else if (count >= (size_t) nprocs_pof2 && ompi_op_is_commute(op)) {
       alg = NBC_ARED_REDSCAT_ALLGATHER;
     }
+    /* on several nodes, reduce on each node first for the small messages */
+    if (size*count < 65536 && ompi_op_is_commute(op) && libnbc_hierarchical &&
+        NULL != (locality = NBC_Comm_locality_get(comm, libnbc_module))) {
+      alg = NBC_ARED_HIER;
+    }
   } else {
     if (libnbc_iallreduce_algorithm == 1)
       alg = NBC_ARED_RING;
@@ -130,88 +116,77 @@ static int nbc_allreduce_init(const void* sendbuf, void* recvbuf, size_t count,
       alg = NBC_ARED_REDSCAT_ALLGATHER;
     else if (libnbc_iallreduce_algorithm == 4)
       alg = NBC_ARED_RDBL;
+    else if (libnbc_iallreduce_algorithm == 5)
+      /* the ring reorders the operands */
+      alg = ompi_op_is_commute(op) ? NBC_ARED_RING_SEGMENTED : NBC_ARED_BINOMIAL;
+    else if (libnbc_iallreduce_algorithm == 6 && ompi_op_is_commute(op) &&
+             NULL != (locality = NBC_Comm_locality_get(comm, libnbc_module)))
+      alg = NBC_ARED_HIER;
   }
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.recvbuf = recvbuf;
-  search.count = count;
-  search.datatype = datatype;
-  search.op = op;
-  found = (NBC_Allreduce_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE], &search);
-  if (NULL == found) {
-#endif
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (NULL == schedule) {
-      free(tmpbuf);
-      return OMPI_ERR_OUT_OF_RESOURCE;
-    }
 
-    if (p == 1) {
-      res = NBC_Sched_copy((void *)sendbuf, false, count, datatype,
-                           recvbuf, false, count, datatype, schedule, false);
-    } else {
-      switch(alg) {
-        case NBC_ARED_BINOMIAL:
-          res = allred_sched_diss(rank, p, count, datatype, gap, sendbuf, recvbuf, op, inplace, schedule, tmpbuf);
-          break;
-        case NBC_ARED_REDSCAT_ALLGATHER:
-          res = allred_sched_redscat_allgather(rank, p, count, datatype, gap, sendbuf, recvbuf, op, inplace, schedule, tmpbuf, comm);
-          break;
-        case NBC_ARED_RING:
-          res = allred_sched_ring(rank, p, count, datatype, sendbuf, recvbuf, op, size, ext, schedule, tmpbuf);
-          break;
-        case NBC_ARED_RDBL:
-          res = allred_sched_recursivedoubling(rank, p, sendbuf, recvbuf, count, datatype, gap, op, inplace, schedule, tmpbuf);
-          break;
-      }
-    }
+  NBC_Sched_key key = {.coll = NBC_ALLREDUCE, .alg = alg, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendcount = count, .sendtype = datatype, .op = op};
+  if (NBC_ARED_RING_SEGMENTED == alg) {
+    key.alg_param = libnbc_iallreduce_ring_segsize;
+  }
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
 
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      free(tmpbuf);
-      return res;
-    }
+  span = opal_datatype_span(&datatype->super, count, &gap);
+  tmpbuf = malloc (span);
+  if (OPAL_UNLIKELY(NULL == tmpbuf)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
-    res = NBC_Sched_commit(schedule);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      free(tmpbuf);
-      return res;
-    }
+  schedule = OBJ_NEW(NBC_Schedule);
+  if (NULL == schedule) {
+    free(tmpbuf);
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Allreduce_args *) malloc (sizeof(args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->recvbuf = recvbuf;
-      args->count = count;
-      args->datatype = datatype;
-      args->op = op;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_ALLREDUCE] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_ALLREDUCE],
-                                   &libnbc_module->NBC_Dict_size[NBC_ALLREDUCE]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
+  if (p == 1) {
+    res = NBC_Sched_copy((void *)sendbuf, false, count, datatype,
+                         recvbuf, false, count, datatype, schedule, false);
   } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+    switch(alg) {
+      case NBC_ARED_BINOMIAL:
+        res = allred_sched_diss(rank, p, count, datatype, gap, sendbuf, recvbuf, op, inplace, schedule, tmpbuf);
+        break;
+      case NBC_ARED_REDSCAT_ALLGATHER:
+        res = allred_sched_redscat_allgather(rank, p, count, datatype, gap, sendbuf, recvbuf, op, inplace, schedule, tmpbuf, comm);
+        break;
+      case NBC_ARED_RING:
+        res = allred_sched_ring(rank, p, count, datatype, sendbuf, recvbuf, op, size, ext, schedule, tmpbuf);
+        break;
+      case NBC_ARED_RDBL:
+        res = allred_sched_recursivedoubling(rank, p, sendbuf, recvbuf, count, datatype, gap, op, inplace, schedule, tmpbuf);
+        break;
+      case NBC_ARED_RING_SEGMENTED:
+        res = allred_sched_ring_segmented(rank, p, count, datatype, gap, sendbuf, recvbuf, op, inplace, size, ext,
+                                          libnbc_iallreduce_ring_segsize, schedule);
+        break;
+      case NBC_ARED_HIER:
+        res = allred_sched_hier(locality, count, datatype, gap, sendbuf, recvbuf, op, inplace, schedule);
+        break;
+    }
   }
-#endif
 
-  res = NBC_Schedule_request (schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    free(tmpbuf);
+    return res;
+  }
+
+  res = NBC_Sched_commit(schedule);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    free(tmpbuf);
+    return res;
+  }
+
+  res = NBC_Schedule_request_cached(&key, span, schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -267,6 +242,13 @@ static int nbc_allreduce_inter_init(const void* sendbuf, void* recvbuf, size_t c
     return res;
   }
 
+  NBC_Sched_key key = {.coll = NBC_ALLREDUCE, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendcount = count, .sendtype = datatype, .op = op};
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   span = opal_datatype_span(&datatype->super, count, &gap);
   tmpbuf = malloc (span);
   if (OPAL_UNLIKELY(NULL == tmpbuf)) {
@@ -294,7 +276,7 @@ static int nbc_allreduce_inter_init(const void* sendbuf, void* recvbuf, size_t c
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_cached(&key, span, schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -828,6 +810,156 @@ free_and_return:
   return res;
 }
 
+/*
+ * allred_sched_ring_segmented
+ *
+ * The ring algorithm above, with each block split into nsegs segments of at
+ * most segsize bytes that are pipelined through the ring: step t of the
+ * schedule moves segment t % nsegs of the blocks of ring round t / nsegs.
+ * A schedule round posts the receive of step t, then reduces the segment
+ * received by step t - 1, and sends the segment of step t. The reduction
+ * thus overlaps the reception of the next segment, instead of waiting for
+ * the whole block. The send of step t depends on the reduction of step
+ * t - nsegs (same segment, previous ring round), done at the latest in the
+ * same schedule round just before it.
+ *
+ * Blocks are received directly into recvbuf, or into the same location in
+ * tmpbuf for MPI_IN_PLACE.
+ */
+static inline int
+allred_sched_ring_segmented(int r, int p, size_t count, MPI_Datatype datatype, ptrdiff_t gap,
+                            const void *sendbuf, void *recvbuf, MPI_Op op, char inplace,
+                            size_t size, ptrdiff_t ext, int segsize, NBC_Schedule *schedule)
+{
+  size_t *blocksizes, *blockoffsets, *segcounts; /* per block: elements, first element and elements per segment */
+  int speer, rpeer, nsegs = 1, nsteps, nredsteps;
+  int res = OMPI_SUCCESS;
+
+  if (0 == count) {
+    return OMPI_SUCCESS;
+  }
+
+  blocksizes = (size_t *) malloc(3 * p * sizeof (size_t));
+  if (NULL == blocksizes) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
+  blockoffsets = blocksizes + p;
+  segcounts = blockoffsets + p;
+
+  /* same blocks as the ring algorithm, the remainder going to the first ones */
+  for (int i = 0; i < p; ++i) {
+    blocksizes[i] = count / p + ((size_t) i < count % p ? 1 : 0);
+    blockoffsets[i] = 0 == i ? 0 : blockoffsets[i - 1] + blocksizes[i - 1];
+  }
+  /* the first block is the largest */
+  if (segsize > 0 && blocksizes[0] * size > (size_t) segsize) {
+    nsegs = (int) ((blocksizes[0] * size + segsize - 1) / segsize);
+  }
+  for (int i = 0; i < p; ++i) {
+    segcounts[i] = (blocksizes[i] + nsegs - 1) / nsegs;
+  }
+
+  speer = (r + 1) % p;
+  rpeer = (r - 1 + p) % p;
+
+  nredsteps = (p - 1) * nsegs;     /* the first p-1 ring rounds are reductions */
+  nsteps = 2 * nredsteps;
+  for (int t = 0; t < nsteps; ++t) {
+    int round = t / nsegs, seg = t % nsegs;
+    int relement = (r - round + 2 * p) % p;    /* the block I receive from my neighbor */
+    int selement = (r + 1 - round + 2 * p) % p; /* the block I am sending */
+    size_t start, scount, rcount;
+    ptrdiff_t soffset, roffset;
+
+    start = seg * segcounts[relement];
+    rcount = start < blocksizes[relement] ? opal_min(segcounts[relement], blocksizes[relement] - start) : 0;
+    roffset = (ptrdiff_t) (blockoffsets[relement] + start) * ext;
+    if (t < nredsteps && inplace) {
+      res = NBC_Sched_recv ((void *)(roffset - gap), true, rcount, datatype, rpeer, schedule, false);
+    } else {
+      res = NBC_Sched_recv ((char *) recvbuf + roffset, false, rcount, datatype, rpeer, schedule, false);
+    }
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      goto free_and_return;
+    }
+
+    if (t > 0 && t - 1 < nredsteps) {
+      /* reduce the segment received by the previous step */
+      int pround = (t - 1) / nsegs, pseg = (t - 1) % nsegs;
+      int pelement = (r - pround + 2 * p) % p;
+      size_t pcount;
+      ptrdiff_t poffset;
+
+      start = pseg * segcounts[pelement];
+      pcount = start < blocksizes[pelement] ? opal_min(segcounts[pelement], blocksizes[pelement] - start) : 0;
+      poffset = (ptrdiff_t) (blockoffsets[pelement] + start) * ext;
+      if (inplace) {
+        res = NBC_Sched_op ((void *)(poffset - gap), true, (char *) recvbuf + poffset, false,
+                            pcount, datatype, op, schedule, false);
+      } else {
+        res = NBC_Sched_op ((char *) sendbuf + poffset, false, (char *) recvbuf + poffset, false,
+                            pcount, datatype, op, schedule, false);
+      }
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        goto free_and_return;
+      }
+    }
+
+    start = seg * segcounts[selement];
+    scount = start < blocksizes[selement] ? opal_min(segcounts[selement], blocksizes[selement] - start) : 0;
+    soffset = (ptrdiff_t) (blockoffsets[selement] + start) * ext;
+    /* the first ring round sends the own contributions */
+    res = NBC_Sched_send ((char *) (0 == round ? sendbuf : recvbuf) + soffset, false, scount, datatype,
+                          speer, schedule, true);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      goto free_and_return;
+    }
+  }
+
+free_and_return:
+  free (blocksizes);
+
+  return res;
+}
+
+/*
+ * allred_sched_hier
+ *
+ * Hierarchical allreduce for commutative operations: a binomial reduction
+ * on each node to its leader, an allreduce between the leaders (binomial
+ * reduction and broadcast), and a binomial broadcast from the leader on each
+ * node. Only the leaders communicate across the network.
+ */
+static inline int allred_sched_hier(NBC_Comm_locality *locality, size_t count, MPI_Datatype datatype, ptrdiff_t gap,
+                                    const void *sendbuf, void *recvbuf, MPI_Op op, char inplace,
+                                    NBC_Schedule *schedule) {
+  int my_node = locality->my_node, res;
+  const int *local = locality->node_ranks + locality->node_start[my_node];
+  int nlocal = locality->node_start[my_node + 1] - locality->node_start[my_node];
+
+  /* the reductions accumulate in recvbuf, and receive in tmpbuf */
+  if (!inplace) {
+    res = NBC_Sched_copy ((void *) sendbuf, false, count, datatype, recvbuf, false, count, datatype, schedule, false);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) { return res; }
+  }
+
+  res = NBC_Sched_reduce_group (recvbuf, -gap, count, datatype, op, local, nlocal, 0,
+                                locality->my_local_idx, schedule);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) { return res; }
+
+  /* the leaders are the first rank of each node */
+  if (0 == locality->my_local_idx) {
+    res = NBC_Sched_reduce_group (recvbuf, -gap, count, datatype, op, locality->leaders, locality->nnodes, 0,
+                                  my_node, schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) { return res; }
+    res = NBC_Sched_bcast_group (recvbuf, false, count, datatype, locality->leaders, locality->nnodes, 0,
+                                 my_node, schedule);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) { return res; }
+  }
+
+  return NBC_Sched_bcast_group (recvbuf, false, count, datatype, local, nlocal, 0, locality->my_local_idx, schedule);
+}
+
 static inline int allred_sched_linear(int rank, int rsize, const void *sendbuf, void *recvbuf, size_t count, MPI_Datatype datatype,
 				      ptrdiff_t gap, MPI_Op op, int ext, int size, NBC_Schedule *schedule, void *tmpbuf) {
   int res;
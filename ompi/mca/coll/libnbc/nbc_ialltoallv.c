@@ -37,10 +37,6 @@ static inline int a2av_sched_inplace(int rank, int p, NBC_Schedule *schedule,
                                     void *buf, ompi_count_array_t counts, ompi_disp_array_t displs,
                                     MPI_Aint ext, MPI_Datatype type, const size_t dtype_size, ptrdiff_t gap);
 
-/* an alltoallv schedule can not be cached easily because the contents
- * of the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
-
 /* simple linear Alltoallv */
 static int nbc_alltoallv_init(const void* sendbuf, ompi_count_array_t sendcounts, ompi_disp_array_t sdispls,
                               MPI_Datatype sendtype, void* recvbuf, ompi_count_array_t recvcounts, ompi_disp_array_t rdispls,
@@ -52,7 +48,7 @@ static int nbc_alltoallv_init(const void* sendbuf, ompi_count_array_t sendcounts
   MPI_Aint sndext, rcvext;
   NBC_Schedule *schedule;
   char *rbuf, *sbuf, inplace;
-  ptrdiff_t gap = 0, span;
+  ptrdiff_t gap = 0, span = 0;
   void * tmpbuf = NULL;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
@@ -86,10 +82,6 @@ static int nbc_alltoallv_init(const void* sendbuf, ompi_count_array_t sendcounts
       ompi_coll_base_nbc_reserve_tags(comm, 1);
       return nbc_get_noop_request(persistent, request);
     }
-    tmpbuf = malloc(span);
-    if (OPAL_UNLIKELY(NULL == tmpbuf)) {
-      return OMPI_ERR_OUT_OF_RESOURCE;
-    }
 
     sendcounts = recvcounts;
     sdispls = rdispls;
@@ -104,6 +96,27 @@ static int nbc_alltoallv_init(const void* sendbuf, ompi_count_array_t sendcounts
     }
   }
 
+  NBC_Sched_key key = {.coll = NBC_ALLTOALLV, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .recvtype = recvtype};
+  if (!inplace) {
+    key.sendtype = sendtype;
+    NBC_Sched_key_counts(&key, sendcounts, p);
+    NBC_Sched_key_displs(&key, sdispls, p);
+  }
+  NBC_Sched_key_counts(&key, recvcounts, p);
+  NBC_Sched_key_displs(&key, rdispls, p);
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
+  if (inplace) {
+    tmpbuf = malloc(span);
+    if (OPAL_UNLIKELY(NULL == tmpbuf)) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
     free(tmpbuf);
@@ -142,7 +155,7 @@ static int nbc_alltoallv_init(const void* sendbuf, ompi_count_array_t sendcounts
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_cached(&key, span, schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -202,6 +215,17 @@ static int nbc_alltoallv_inter_init (const void* sendbuf, ompi_count_array_t sen
 
   rsize = ompi_comm_remote_size (comm);
 
+  NBC_Sched_key key = {.coll = NBC_ALLTOALLV, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendtype = sendtype, .recvtype = recvtype};
+  NBC_Sched_key_counts(&key, sendcounts, rsize);
+  NBC_Sched_key_displs(&key, sdispls, rsize);
+  NBC_Sched_key_counts(&key, recvcounts, rsize);
+  NBC_Sched_key_displs(&key, rdispls, rsize);
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -234,7 +258,7 @@ static int nbc_alltoallv_inter_init (const void* sendbuf, ompi_count_array_t sen
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -36,10 +36,6 @@ static inline int a2aw_sched_inplace(int rank, int p, NBC_Schedule *schedule,
                                     void *buf, ompi_count_array_t counts, ompi_disp_array_t displs,
                                     struct ompi_datatype_t * const * types);
 
-/* an alltoallw schedule can not be cached easily because the contents
- * of the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
-
 /* simple linear Alltoallw */
 static int nbc_alltoallw_init(const void* sendbuf, ompi_count_array_t sendcounts, ompi_disp_array_t sdispls,
                               struct ompi_datatype_t * const *sendtypes, void* recvbuf, ompi_count_array_t recvcounts, ompi_disp_array_t rdispls,
@@ -76,13 +72,30 @@ static int nbc_alltoallw_init(const void* sendbuf, ompi_count_array_t sendcounts
       ompi_coll_base_nbc_reserve_tags(comm, 1);
       return nbc_get_noop_request(persistent, request);
     }
+    sendcounts = recvcounts;
+    sdispls = rdispls;
+    sendtypes = recvtypes;
+  }
+
+  NBC_Sched_key key = {.coll = NBC_ALLTOALLW, .sendbuf = sendbuf, .recvbuf = recvbuf};
+  if (!inplace) {
+    NBC_Sched_key_counts(&key, sendcounts, p);
+    NBC_Sched_key_displs(&key, sdispls, p);
+    NBC_Sched_key_types(&key, sendtypes, p);
+  }
+  NBC_Sched_key_counts(&key, recvcounts, p);
+  NBC_Sched_key_displs(&key, rdispls, p);
+  NBC_Sched_key_types(&key, recvtypes, p);
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
+  if (inplace) {
     tmpbuf = malloc(span);
     if (OPAL_UNLIKELY(NULL == tmpbuf)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
     }
-    sendcounts = recvcounts;
-    sdispls = rdispls;
-    sendtypes = recvtypes;
   }
 
   schedule = OBJ_NEW(NBC_Schedule);
@@ -122,7 +135,7 @@ static int nbc_alltoallw_init(const void* sendbuf, ompi_count_array_t sendcounts
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_cached(&key, span, schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -166,6 +179,18 @@ static int nbc_alltoallw_inter_init (const void* sendbuf, ompi_count_array_t sen
 
   rsize = ompi_comm_remote_size (comm);
 
+  NBC_Sched_key key = {.coll = NBC_ALLTOALLW, .sendbuf = sendbuf, .recvbuf = recvbuf};
+  NBC_Sched_key_counts(&key, sendcounts, rsize);
+  NBC_Sched_key_displs(&key, sdispls, rsize);
+  NBC_Sched_key_types(&key, sendtypes, rsize);
+  NBC_Sched_key_counts(&key, recvcounts, rsize);
+  NBC_Sched_key_displs(&key, rdispls, rsize);
+  NBC_Sched_key_types(&key, recvtypes, rsize);
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -198,7 +223,7 @@ static int nbc_alltoallw_inter_init (const void* sendbuf, ompi_count_array_t sen
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -32,65 +32,56 @@ static int nbc_barrier_init(struct ompi_communicator_t *comm, ompi_request_t **
   rank = ompi_comm_rank (comm);
   p = ompi_comm_size (comm);
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* there only one argument set per communicator -> hang it directly at
-   * the tree-position, NBC_Dict_size[...] is 0 for not initialized and
-   * 1 for initialized. NBC_Dict[...] is a pointer to the schedule in
-   * this case */
-  if (libnbc_module->NBC_Dict_size[NBC_BARRIER] == 0) {
-    /* we did not init it yet */
-#endif
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-      return OMPI_ERR_OUT_OF_RESOURCE;
-    }
+  /* there is only one argument set per communicator */
+  NBC_Sched_key key = {.coll = NBC_BARRIER};
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
 
-    maxround = ceil_of_log2(p) -1;
+  schedule = OBJ_NEW(NBC_Schedule);
+  if (OPAL_UNLIKELY(NULL == schedule)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
-    for (int round = 0 ; round <= maxround ; ++round) {
-      sendpeer = (rank + (1 << round)) % p;
-      /* add p because modulo does not work with negative values */
-      recvpeer = ((rank - (1 << round)) + p) % p;
+  maxround = ceil_of_log2(p) -1;
 
-      /* send msg to sendpeer */
-      res = NBC_Sched_send (NULL, false, 0, MPI_BYTE, sendpeer, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
-      }
-
-      /* recv msg from recvpeer */
-      res = NBC_Sched_recv (NULL, false, 0, MPI_BYTE, recvpeer, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
-      }
+  for (int round = 0 ; round <= maxround ; ++round) {
+    sendpeer = (rank + (1 << round)) % p;
+    /* add p because modulo does not work with negative values */
+    recvpeer = ((rank - (1 << round)) + p) % p;
 
-      /* end communication round */
-      if (round < maxround) {
-        res = NBC_Sched_barrier (schedule);
-        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-          OBJ_RELEASE(schedule);
-          return res;
-        }
-      }
+    /* send msg to sendpeer */
+    res = NBC_Sched_send (NULL, false, 0, MPI_BYTE, sendpeer, schedule, false);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      OBJ_RELEASE(schedule);
+      return res;
     }
 
-    res = NBC_Sched_commit (schedule);
+    /* recv msg from recvpeer */
+    res = NBC_Sched_recv (NULL, false, 0, MPI_BYTE, recvpeer, schedule, false);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* add it */
-    libnbc_module->NBC_Dict[NBC_BARRIER] = (hb_tree *) schedule;
-    libnbc_module->NBC_Dict_size[NBC_BARRIER] = 1;
+    /* end communication round */
+    if (round < maxround) {
+      res = NBC_Sched_barrier (schedule);
+      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+        OBJ_RELEASE(schedule);
+        return res;
+      }
+    }
   }
-  OBJ_RETAIN(schedule);
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Sched_commit (schedule);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    return res;
+  }
+
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -126,6 +117,12 @@ static int nbc_barrier_inter_init(struct ompi_communicator_t *comm, ompi_request
   rank = ompi_comm_rank (comm);
   rsize = ompi_comm_remote_size (comm);
 
+  NBC_Sched_key key = {.coll = NBC_BARRIER};
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -178,7 +175,7 @@ static int nbc_barrier_inter_init(struct ompi_communicator_t *comm, ompi_request
       return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
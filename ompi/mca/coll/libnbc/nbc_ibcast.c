@@ -28,24 +28,8 @@ static inline int bcast_sched_chain(int rank, int p, int root, NBC_Schedule *sch
                                     MPI_Datatype datatype, size_t fragsize, size_t size);
 static inline int bcast_sched_knomial(int rank, int comm_size, int root, NBC_Schedule *schedule, void *buf,
                                       size_t count, MPI_Datatype datatype, int knomial_radix);
-
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Bcast_args_compare(NBC_Bcast_args *a, NBC_Bcast_args *b, void *param) {
-  if ((a->buffer == b->buffer) &&
-      (a->count == b->count) &&
-      (a->datatype == b->datatype) &&
-      (a->root == b->root) ) {
-    return 0;
-  }
-
-  if( a->buffer < b->buffer ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
+static inline int bcast_sched_hier(int rank, int root, NBC_Comm_locality *locality, NBC_Schedule *schedule,
+                                   void *buffer, size_t count, MPI_Datatype datatype);
 
 static int nbc_bcast_init(void *buffer, size_t count, MPI_Datatype datatype, int root,
                           struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -54,11 +38,9 @@ static int nbc_bcast_init(void *buffer, size_t count, MPI_Datatype datatype, int
   int rank, p, res, segsize;
   size_t size;
   NBC_Schedule *schedule;
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Bcast_args *args, *found, search;
-#endif
-  enum { NBC_BCAST_LINEAR, NBC_BCAST_BINOMIAL, NBC_BCAST_CHAIN, NBC_BCAST_KNOMIAL } alg;
+  enum { NBC_BCAST_LINEAR, NBC_BCAST_BINOMIAL, NBC_BCAST_CHAIN, NBC_BCAST_KNOMIAL, NBC_BCAST_HIER } alg;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
+  NBC_Comm_locality *locality = NULL;
 
   rank = ompi_comm_rank (comm);
   p = ompi_comm_size (comm);
@@ -97,6 +79,11 @@ static int nbc_bcast_init(void *buffer, size_t count, MPI_Datatype datatype, int
         segsize = 32768;
       }
     }
+    /* on several nodes, send the data only once to each node */
+    if (NBC_BCAST_CHAIN != alg && libnbc_hierarchical &&
+        NULL != (locality = NBC_Comm_locality_get(comm, libnbc_module))) {
+      alg = NBC_BCAST_HIER;
+    }
   } else {
     /* user forced dynamic decision */
     if (libnbc_ibcast_algorithm == 1) {
@@ -107,82 +94,57 @@ static int nbc_bcast_init(void *buffer, size_t count, MPI_Datatype datatype, int
       alg = NBC_BCAST_CHAIN;
     } else if (libnbc_ibcast_algorithm == 4 && libnbc_ibcast_knomial_radix > 1) {
       alg = NBC_BCAST_KNOMIAL;
+    } else if (libnbc_ibcast_algorithm == 5) {
+      locality = NBC_Comm_locality_get(comm, libnbc_module);
+      alg = NULL != locality ? NBC_BCAST_HIER : NBC_BCAST_BINOMIAL;
     } else {
       alg = NBC_BCAST_LINEAR;
     }
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  /* search schedule in communicator specific tree */
-  search.buffer = buffer;
-  search.count = count;
-  search.datatype = datatype;
-  search.root = root;
-  found = (NBC_Bcast_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_BCAST], &search);
-  if (NULL == found) {
-#endif
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-      return OMPI_ERR_OUT_OF_RESOURCE;
-    }
+  NBC_Sched_key key = {.coll = NBC_BCAST, .alg = alg, .root = root,
+                       .recvbuf = buffer, .recvcount = count, .recvtype = datatype};
+  key.alg_param = NBC_BCAST_CHAIN == alg ? segsize : libnbc_ibcast_knomial_radix;
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
 
-    switch(alg) {
-      case NBC_BCAST_LINEAR:
-        res = bcast_sched_linear(rank, p, root, schedule, buffer, count, datatype);
-        break;
-      case NBC_BCAST_BINOMIAL:
-        res = bcast_sched_binomial(rank, p, root, schedule, buffer, count, datatype);
-        break;
-      case NBC_BCAST_CHAIN:
-        res = bcast_sched_chain(rank, p, root, schedule, buffer, count, datatype, segsize, size);
-        break;
-      case NBC_BCAST_KNOMIAL:
-        res = bcast_sched_knomial(rank, p, root, schedule, buffer, count, datatype, libnbc_ibcast_knomial_radix);
-        break;
-    }
+  schedule = OBJ_NEW(NBC_Schedule);
+  if (OPAL_UNLIKELY(NULL == schedule)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
-    }
+  switch(alg) {
+    case NBC_BCAST_LINEAR:
+      res = bcast_sched_linear(rank, p, root, schedule, buffer, count, datatype);
+      break;
+    case NBC_BCAST_BINOMIAL:
+      res = bcast_sched_binomial(rank, p, root, schedule, buffer, count, datatype);
+      break;
+    case NBC_BCAST_CHAIN:
+      res = bcast_sched_chain(rank, p, root, schedule, buffer, count, datatype, segsize, size);
+      break;
+    case NBC_BCAST_KNOMIAL:
+      res = bcast_sched_knomial(rank, p, root, schedule, buffer, count, datatype, libnbc_ibcast_knomial_radix);
+      break;
+    case NBC_BCAST_HIER:
+      res = bcast_sched_hier(rank, root, locality, schedule, buffer, count, datatype);
+      break;
+  }
 
-    res = NBC_Sched_commit (schedule);
-    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-      OBJ_RELEASE(schedule);
-      return res;
-    }
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    return res;
+  }
 
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Bcast_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->buffer = buffer;
-      args->count = count;
-      args->datatype = datatype;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_BCAST], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN (schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_BCAST] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_BCAST],
-                                   &libnbc_module->NBC_Dict_size[NBC_BCAST]);
-        }
-      } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
-      }
-    }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
+  res = NBC_Sched_commit (schedule);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    return res;
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -274,6 +236,42 @@ static inline int bcast_sched_binomial(int rank, int p, int root, NBC_Schedule *
   return OMPI_SUCCESS;
 }
 
+/*
+ * Hierarchical broadcast: a binomial broadcast between the leaders of the
+ * nodes, followed on each node by a binomial broadcast from the leader to the
+ * other ranks of the node. The root stands in for the leader of its node, so
+ * that the data crosses the network only once per node.
+ */
+static inline int bcast_sched_hier(int rank, int root, NBC_Comm_locality *locality, NBC_Schedule *schedule,
+                                   void *buffer, size_t count, MPI_Datatype datatype) {
+  int root_node = locality->node_of[root], my_node = locality->my_node;
+  const int *local = locality->node_ranks + locality->node_start[my_node];
+  int nlocal = locality->node_start[my_node + 1] - locality->node_start[my_node];
+  int local_root = my_node == root_node ? root : locality->leaders[my_node];
+  int local_root_idx = 0, res;
+
+  if (rank == local_root) {
+    int *leaders = (int *) malloc (locality->nnodes * sizeof (int));
+    if (NULL == leaders) {
+      return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    memcpy (leaders, locality->leaders, locality->nnodes * sizeof (int));
+    leaders[root_node] = root;
+    res = NBC_Sched_bcast_group (buffer, false, count, datatype, leaders, locality->nnodes, root_node,
+                                 my_node, schedule);
+    free (leaders);
+    if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+      return res;
+    }
+  }
+
+  while (local[local_root_idx] != local_root) {
+    ++local_root_idx;
+  }
+  return NBC_Sched_bcast_group (buffer, false, count, datatype, local, nlocal, local_root_idx,
+                                locality->my_local_idx, schedule);
+}
+
 /* simple linear MPI_Ibcast */
 static inline int bcast_sched_linear(int rank, int p, int root, NBC_Schedule *schedule, void *buffer, size_t count, MPI_Datatype datatype) {
   int res;
@@ -415,6 +413,13 @@ static int nbc_bcast_inter_init(void *buffer, size_t count, MPI_Datatype datatyp
   NBC_Schedule *schedule;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
+  NBC_Sched_key key = {.coll = NBC_BCAST, .root = root, .recvbuf = buffer, .recvcount = count,
+                       .recvtype = datatype};
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -451,7 +456,7 @@ static int nbc_bcast_inter_init(void *buffer, size_t count, MPI_Datatype datatyp
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
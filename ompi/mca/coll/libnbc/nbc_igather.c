@@ -23,27 +23,6 @@
  */
 #include "nbc_internal.h"
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Gather_args_compare(NBC_Gather_args *a, NBC_Gather_args *b, void *param) {
-  if ((a->sendbuf == b->sendbuf) &&
-      (a->sendcount == b->sendcount) &&
-      (a->sendtype == b->sendtype) &&
-      (a->recvbuf == b->recvbuf) &&
-      (a->recvcount == b->recvcount) &&
-      (a->recvtype == b->recvtype) &&
-      (a->root == b->root)) {
-    return 0;
-  }
-
-  if( a->sendbuf < b->sendbuf ) {
-    return -1;
-  }
-
-  return 1;
-}
-#endif
-
 static int nbc_gather_init(const void* sendbuf, size_t sendcount, MPI_Datatype sendtype, void* recvbuf,
                            size_t recvcount, MPI_Datatype recvtype, int root,
                            struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -73,98 +52,63 @@ static int nbc_gather_init(const void* sendbuf, size_t sendcount, MPI_Datatype s
     sendtype = recvtype;
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Gather_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sendbuf = sendbuf;
-  search.sendcount = sendcount;
-  search.sendtype = sendtype;
-  search.recvbuf = recvbuf;
-  search.recvcount = recvcount;
-  search.recvtype = recvtype;
-  search.root = root;
-  found = (NBC_Gather_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER],
-                                              &search);
-  if (NULL == found) {
-#endif
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-      return OMPI_ERR_OUT_OF_RESOURCE;
-    }
+  /* the receive arguments are only significant at the root */
+  NBC_Sched_key key = {.coll = NBC_GATHER, .root = root, .sendbuf = sendbuf,
+                       .sendcount = sendcount, .sendtype = sendtype};
+  if (rank == root) {
+    key.recvbuf = recvbuf;
+    key.recvcount = recvcount;
+    key.recvtype = recvtype;
+  }
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
 
-    /* send to root */
-    if (rank != root) {
-      /* send msg to root */
-      res = NBC_Sched_send(sendbuf, false, sendcount, sendtype, root, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
-      }
-    } else {
-      for (int i = 0 ; i < p ; ++i) {
-        rbuf = (char *)recvbuf + (MPI_Aint) rcvext * i * recvcount;
-        if (i == root) {
-          if (!inplace) {
-            /* if I am the root - just copy the message */
-            res = NBC_Sched_copy ((void *)sendbuf, false, sendcount, sendtype,
-                                  rbuf, false, recvcount, recvtype, schedule, false);
-            if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-              OBJ_RELEASE(schedule);
-              return res;
-            }
-          }
-        } else {
-          /* root receives message to the right buffer */
-          res = NBC_Sched_recv (rbuf, false, recvcount, recvtype, i, schedule, false);
-          if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-            OBJ_RELEASE(schedule);
-            return res;
-          }
-        }
-      }
-    }
+  schedule = OBJ_NEW(NBC_Schedule);
+  if (OPAL_UNLIKELY(NULL == schedule)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
-    res = NBC_Sched_commit (schedule);
+  /* send to root */
+  if (rank != root) {
+    /* send msg to root */
+    res = NBC_Sched_send(sendbuf, false, sendcount, sendtype, root, schedule, false);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
-
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Gather_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->sendcount = sendcount;
-      args->sendtype = sendtype;
-      args->recvbuf = recvbuf;
-      args->recvcount = recvcount;
-      args->recvtype = recvtype;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_GATHER] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_GATHER],
-                                   &libnbc_module->NBC_Dict_size[NBC_GATHER]);
+  } else {
+    for (int i = 0 ; i < p ; ++i) {
+      rbuf = (char *)recvbuf + (MPI_Aint) rcvext * i * recvcount;
+      if (i == root) {
+        if (!inplace) {
+          /* if I am the root - just copy the message */
+          res = NBC_Sched_copy ((void *)sendbuf, false, sendcount, sendtype,
+                                rbuf, false, recvcount, recvtype, schedule, false);
+          if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            return res;
+          }
         }
       } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
+        /* root receives message to the right buffer */
+        res = NBC_Sched_recv (rbuf, false, recvcount, recvtype, i, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
     }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Sched_commit (schedule);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    return res;
+  }
+
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -213,6 +157,21 @@ static int nbc_gather_inter_init (const void* sendbuf, size_t sendcount, MPI_Dat
         }
     }
 
+    NBC_Sched_key key = {.coll = NBC_GATHER, .root = root};
+    if (MPI_ROOT == root) {
+        key.recvbuf = recvbuf;
+        key.recvcount = recvcount;
+        key.recvtype = recvtype;
+    } else if (MPI_PROC_NULL != root) {
+        key.sendbuf = sendbuf;
+        key.sendcount = sendcount;
+        key.sendtype = sendtype;
+    }
+    res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+    if (OMPI_ERR_NOT_FOUND != res) {
+        return res;
+    }
+
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -244,7 +203,7 @@ static int nbc_gather_inter_init (const void* sendbuf, size_t sendcount, MPI_Dat
       return res;
     }
 
-    res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+    res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
@@ -24,11 +24,6 @@
  */
 #include "nbc_internal.h"
 
-/* an gatherv schedule can not be cached easily because the contents
- * of the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
-
-
 static int nbc_gatherv_init(const void* sendbuf, int sendcount, MPI_Datatype sendtype,
                             void* recvbuf, ompi_count_array_t recvcounts, ompi_disp_array_t displs, MPI_Datatype recvtype,
                             int root, struct ompi_communicator_t *comm, ompi_request_t ** request,
@@ -53,6 +48,23 @@ static int nbc_gatherv_init(const void* sendbuf, int sendcount, MPI_Datatype sen
     }
   }
 
+  /* the receive arguments are only significant at the root */
+  NBC_Sched_key key = {.coll = NBC_GATHERV, .root = root, .sendbuf = sendbuf};
+  if (!inplace) {
+    key.sendcount = sendcount;
+    key.sendtype = sendtype;
+  }
+  if (rank == root) {
+    key.recvbuf = recvbuf;
+    key.recvtype = recvtype;
+    NBC_Sched_key_counts(&key, recvcounts, p);
+    NBC_Sched_key_displs(&key, displs, p);
+  }
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -96,7 +108,7 @@ static int nbc_gatherv_init(const void* sendbuf, int sendcount, MPI_Datatype sen
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -145,6 +157,22 @@ static int nbc_gatherv_inter_init (const void* sendbuf, size_t sendcount, MPI_Da
     }
   }
 
+  NBC_Sched_key key = {.coll = NBC_GATHERV, .root = root};
+  if (MPI_ROOT == root) {
+    key.recvbuf = recvbuf;
+    key.recvtype = recvtype;
+    NBC_Sched_key_counts(&key, recvcounts, rsize);
+    NBC_Sched_key_displs(&key, displs, rsize);
+  } else if (MPI_PROC_NULL != root) {
+    key.sendbuf = sendbuf;
+    key.sendcount = sendcount;
+    key.sendtype = sendtype;
+  }
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -176,7 +204,7 @@ static int nbc_gatherv_inter_init (const void* sendbuf, size_t sendcount, MPI_Da
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -81,6 +81,12 @@ ceil_of_log2 (int val) {
 #define NBC_SCAN 13
 #define NBC_SCATTER 14
 #define NBC_SCATTERV 15
+#define NBC_REDUCESCAT_BLOCK 16
+#define NBC_NEIGHBOR_ALLGATHER 17
+#define NBC_NEIGHBOR_ALLGATHERV 18
+#define NBC_NEIGHBOR_ALLTOALL 19
+#define NBC_NEIGHBOR_ALLTOALLV 20
+#define NBC_NEIGHBOR_ALLTOALLW 21
 /* set the number of collectives in nbc.h !!!! */
 
 /* several typedefs for NBC */
@@ -167,106 +173,116 @@ int NBC_Sched_unpack (void *inbuf, char tmpinbuf, size_t count, MPI_Datatype dat
 int NBC_Sched_barrier (NBC_Schedule *schedule);
 int NBC_Sched_commit (NBC_Schedule *schedule);
 
-#ifdef NBC_CACHE_SCHEDULE
-/* this is a dummy structure which is used to get the schedule out of
- * the collop specific structure. The schedule pointer HAS to be at the
- * first position and should NOT BE REORDERED by the compiler (C
- * guarantees that */
-struct NBC_dummyarg {
-  NBC_Schedule *schedule;
-};
-
+/* Key of a cached schedule: everything the schedule of a collective call
+ * depends on, besides the communicator the cache belongs to. The fields that
+ * do not apply to a collective are left to 0. Vector arguments (counts,
+ * displacements, datatypes) are added with the NBC_Sched_key_* helpers, and
+ * compared byte by byte. */
+#define NBC_SCHED_KEY_MAX_VEC 6
 typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
+  int coll;                 /* NBC_ALLGATHER ... */
+  int alg;                  /* algorithm selected for the call */
+  int alg_param;            /* segment size, radix... of the algorithm */
+  int root;
+  const void *sendbuf;
+  const void *recvbuf;
   size_t sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
   size_t recvcount;
-  MPI_Datatype recvtype;
-} NBC_Alltoall_args;
-int NBC_Alltoall_args_compare(NBC_Alltoall_args *a, NBC_Alltoall_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  size_t sendcount;
   MPI_Datatype sendtype;
-  void* recvbuf;
-  size_t recvcount;
   MPI_Datatype recvtype;
-} NBC_Allgather_args;
-int NBC_Allgather_args_compare(NBC_Allgather_args *a, NBC_Allgather_args *b, void *param);
-
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  size_t count;
-  MPI_Datatype datatype;
   MPI_Op op;
-} NBC_Allreduce_args;
-int NBC_Allreduce_args_compare(NBC_Allreduce_args *a, NBC_Allreduce_args *b, void *param);
+  int nvec;
+  int vec_types;            /* bitmask of the vectors holding datatypes */
+  const void *vec[NBC_SCHED_KEY_MAX_VEC];
+  size_t vec_size[NBC_SCHED_KEY_MAX_VEC];
+} NBC_Sched_key;
+
+static inline void NBC_Sched_key_vec(NBC_Sched_key *key, const void *vec, size_t size) {
+  assert(key->nvec < NBC_SCHED_KEY_MAX_VEC);
+  key->vec[key->nvec] = vec;
+  key->vec_size[key->nvec] = size;
+  key->nvec++;
+}
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *buffer;
-  size_t count;
-  MPI_Datatype datatype;
-  int root;
-} NBC_Bcast_args;
-int NBC_Bcast_args_compare(NBC_Bcast_args *a, NBC_Bcast_args *b, void *param);
+static inline void NBC_Sched_key_counts(NBC_Sched_key *key, ompi_count_array_t counts, int n) {
+  NBC_Sched_key_vec(key, ompi_count_array_ptr(counts),
+                    (size_t) n * (ompi_count_array_is_64bit(counts) ? sizeof(size_t) : sizeof(int)));
+}
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  size_t sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  size_t recvcount;
-  MPI_Datatype recvtype;
-  int root;
-} NBC_Gather_args;
-int NBC_Gather_args_compare(NBC_Gather_args *a, NBC_Gather_args *b, void *param);
+static inline void NBC_Sched_key_displs(NBC_Sched_key *key, ompi_disp_array_t displs, int n) {
+  NBC_Sched_key_vec(key, ompi_disp_array_ptr(displs),
+                    (size_t) n * (ompi_disp_array_is_64bit(displs) ? sizeof(ptrdiff_t) : sizeof(int)));
+}
 
-typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  size_t count;
-  MPI_Datatype datatype;
-  MPI_Op op;
-  int root;
-} NBC_Reduce_args;
-int NBC_Reduce_args_compare(NBC_Reduce_args *a, NBC_Reduce_args *b, void *param);
+/* the datatypes are retained as long as the schedule is cached */
+static inline void NBC_Sched_key_types(NBC_Sched_key *key, struct ompi_datatype_t * const *types, int n) {
+  key->vec_types |= 1 << key->nvec;
+  NBC_Sched_key_vec(key, types, (size_t) n * sizeof(*types));
+}
 
-typedef struct {
+/* a cached schedule, see nbc.c */
+struct NBC_Sched_cache_entry {
+  opal_list_item_t super;
+  NBC_Sched_key key;          /* the vectors point into vec_data */
+  void *vec_data;
   NBC_Schedule *schedule;
-  void *sendbuf;
-  void* recvbuf;
-  size_t count;
-  MPI_Datatype datatype;
+  void *tmpbuf;
+  size_t bytes;               /* accounted in sched_cache_bytes */
+  bool retained;              /* the datatypes and op of the key are retained */
+  opal_atomic_int32_t busy;   /* a request is using schedule and tmpbuf */
+};
+typedef struct NBC_Sched_cache_entry NBC_Sched_cache_entry;
+OBJ_CLASS_DECLARATION(NBC_Sched_cache_entry);
+
+/* Schedule cache functions: NBC_Sched_cache_request() starts a request on a
+ * cached schedule matching the key, if there is an idle one, and returns
+ * OMPI_ERR_NOT_FOUND otherwise. NBC_Schedule_request_cached() is
+ * NBC_Schedule_request() adding the new schedule and its temporary buffer
+ * to the cache. Persistent requests are never cached. */
+int NBC_Sched_cache_request(NBC_Sched_key *key, ompi_communicator_t *comm,
+                            ompi_coll_libnbc_module_t *module, bool persistent,
+                            ompi_request_t **request);
+int NBC_Schedule_request_cached(NBC_Sched_key *key, size_t tmpbuf_size,
+                                NBC_Schedule *schedule, ompi_communicator_t *comm,
+                                ompi_coll_libnbc_module_t *module, bool persistent,
+                                ompi_request_t **request, void *tmpbuf);
+void NBC_Sched_cache_fini(ompi_coll_libnbc_module_t *module);
+
+/* A schedule compiled for a persistent request. The rounds are decoded once,
+ * the buffers are resolved against the temporary buffer of the request, and
+ * the sends and receives are created as persistent PML requests: starting a
+ * round only restarts its requests and runs its local operations. */
+typedef struct {
+  NBC_Fn_type type;           /* SEND: start nreqs requests (sends and receives) */
+  int nreqs;
+  ompi_request_t **reqs;
+  const void *buf1;
+  void *buf2;
+  size_t count1;
+  size_t count2;
+  MPI_Datatype type1;
+  MPI_Datatype type2;
   MPI_Op op;
-} NBC_Scan_args;
-int NBC_Scan_args_compare(NBC_Scan_args *a, NBC_Scan_args *b, void *param);
+} NBC_Compiled_step;
 
 typedef struct {
-  NBC_Schedule *schedule;
-  void *sendbuf;
-  size_t sendcount;
-  MPI_Datatype sendtype;
-  void* recvbuf;
-  size_t recvcount;
-  MPI_Datatype recvtype;
-  int root;
-} NBC_Scatter_args;
-int NBC_Scatter_args_compare(NBC_Scatter_args *a, NBC_Scatter_args *b, void *param);
-
-/* Schedule cache structures/functions */
-void NBC_SchedCache_args_delete(void *entry);
-void NBC_SchedCache_args_delete_key_dummy(void *k);
+  int nsteps;
+  int nreqs;
+  NBC_Compiled_step *steps;
+  ompi_request_t **reqs;      /* the requests of the round, slots of the schedule */
+} NBC_Compiled_round;
+
+struct NBC_Compiled_schedule {
+  int nrounds;
+  int nreqs;
+  NBC_Compiled_round *rounds;
+  NBC_Compiled_step *steps;
+  ompi_request_t **reqs;
+};
+typedef struct NBC_Compiled_schedule NBC_Compiled_schedule;
 
-#endif
+/* compile the schedule of a persistent request, see nbc.c */
+int NBC_Compile_schedule(NBC_Handle *handle);
 
 
 int NBC_Start(NBC_Handle *handle);
@@ -565,18 +581,6 @@ static inline int NBC_Unpack(void *src, size_t srccount, MPI_Datatype srctype, v
   return OMPI_SUCCESS;
 }
 
-/* deletes elements from dict_in until low watermark is reached */
-static inline void NBC_SchedCache_dictwipe(hb_tree *dict_in, int *size) {
-  hb_itor *itor;
-
-  itor = ompi_coll_libnbc_hb_itor_new(dict_in);
-  for (; ompi_coll_libnbc_hb_itor_valid(itor) && (*size>NBC_SCHED_DICT_LOWER); ompi_coll_libnbc_hb_itor_next(itor)) {
-    ompi_coll_libnbc_hb_tree_remove(dict_in, ompi_coll_libnbc_hb_itor_key(itor), 0);
-    *size = *size-1;
-  }
-  ompi_coll_libnbc_hb_itor_destroy(itor);
-}
-
 #define NBC_IN_PLACE(sendbuf, recvbuf, inplace) \
 { \
   inplace = 0; \
@@ -596,6 +600,27 @@ static inline void NBC_SchedCache_dictwipe(hb_tree *dict_in, int *size) {
 int NBC_Comm_neighbors_count (ompi_communicator_t *comm, int *indegree, int *outdegree);
 int NBC_Comm_neighbors (ompi_communicator_t *comm, int **sources, int *source_count, int **destinations, int *dest_count);
 
+/* Node locality of a communicator, for the hierarchical schedules. The nodes
+ * are numbered in the order of their leaders, the lowest rank of each node. */
+typedef struct NBC_Comm_locality {
+  int nnodes;
+  int my_node;
+  int my_local_idx;  /* index of this rank among the ranks of its node */
+  int *node_of;      /* node of each rank */
+  int *node_ranks;   /* ranks of each node in increasing order, node after node */
+  int *node_start;   /* index in node_ranks of the first rank of each node, nnodes + 1 entries */
+  int *leaders;      /* leader of each node */
+} NBC_Comm_locality;
+
+/* the locality of comm, or NULL if the communicator does not span several
+ * nodes with several ranks on some of them */
+NBC_Comm_locality *NBC_Comm_locality_get (ompi_communicator_t *comm, ompi_coll_libnbc_module_t *module);
+void NBC_Comm_locality_fini (ompi_coll_libnbc_module_t *module);
+int NBC_Sched_bcast_group (void *buf, char tmpbuf, size_t count, MPI_Datatype datatype, const int *ranks,
+                           int n, int root_idx, int me, NBC_Schedule *schedule);
+int NBC_Sched_reduce_group (void *buf, ptrdiff_t tmpoffset, size_t count, MPI_Datatype datatype, MPI_Op op,
+                            const int *ranks, int n, int root_idx, int me, NBC_Schedule *schedule);
+
 #ifdef __cplusplus
 }
 #endif
@@ -83,6 +83,14 @@ static int nbc_reduce_scatter_init(const void* sendbuf, void* recvbuf, ompi_coun
     return nbc_get_noop_request(persistent, request);
   }
 
+  NBC_Sched_key key = {.coll = NBC_REDUCESCAT, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendtype = datatype, .op = op};
+  NBC_Sched_key_counts(&key, recvcounts, p);
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   maxr = ceil_of_log2(p);
 
   span = opal_datatype_span(&datatype->super, count, &gap);
@@ -201,7 +209,7 @@ static int nbc_reduce_scatter_init(const void* sendbuf, void* recvbuf, ompi_coun
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_cached(&key, span_align + span, schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -254,6 +262,14 @@ static int nbc_reduce_scatter_inter_init (const void* sendbuf, void* recvbuf, om
     count += ompi_count_array_get(recvcounts, r);
   }
 
+  NBC_Sched_key key = {.coll = NBC_REDUCESCAT, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .sendtype = datatype, .op = op};
+  NBC_Sched_key_counts(&key, recvcounts, lsize);
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   span = opal_datatype_span(&datatype->super, count, &gap);
   span_align = OPAL_ALIGN(span, datatype->super.align, ptrdiff_t);
 
@@ -345,7 +361,7 @@ static int nbc_reduce_scatter_inter_init (const void* sendbuf, void* recvbuf, om
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_cached(&key, span_align + span, schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -46,7 +46,7 @@ static int nbc_reduce_scatter_block_init(const void* sendbuf, void* recvbuf, siz
   int peer, rank, maxr, p, res;
   size_t count;
   MPI_Aint ext;
-  ptrdiff_t gap, span;
+  ptrdiff_t gap, span, tmpsize = 0;
   char *redbuf, *sbuf, inplace;
   NBC_Schedule *schedule;
   void *tmpbuf = NULL;
@@ -63,6 +63,13 @@ static int nbc_reduce_scatter_block_init(const void* sendbuf, void* recvbuf, siz
     return (MPI_SUCCESS == res) ? MPI_ERR_SIZE : res;
   }
 
+  NBC_Sched_key key = {.coll = NBC_REDUCESCAT_BLOCK, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .recvcount = recvcount, .recvtype = datatype, .op = op};
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (NULL == schedule) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -78,7 +85,8 @@ static int nbc_reduce_scatter_block_init(const void* sendbuf, void* recvbuf, siz
 
     span = opal_datatype_span(&datatype->super, count, &gap);
     span_align = OPAL_ALIGN(span, datatype->super.align, ptrdiff_t);
-    tmpbuf = malloc (span_align + span);
+    tmpsize = span_align + span;
+    tmpbuf = malloc (tmpsize);
     if (NULL == tmpbuf) {
       OBJ_RELEASE(schedule);
       return OMPI_ERR_OUT_OF_RESOURCE;
@@ -199,7 +207,7 @@ static int nbc_reduce_scatter_block_init(const void* sendbuf, void* recvbuf, siz
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_cached(&key, tmpsize, schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -250,6 +258,13 @@ static int nbc_reduce_scatter_block_inter_init(const void *sendbuf, void *recvbu
 
   count = (size_t)rcount * lsize;
 
+  NBC_Sched_key key = {.coll = NBC_REDUCESCAT_BLOCK, .sendbuf = sendbuf, .recvbuf = recvbuf,
+                       .recvcount = rcount, .recvtype = dtype, .op = op};
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   span = opal_datatype_span(&dtype->super, count, &gap);
   span_align = OPAL_ALIGN(span, dtype->super.align, ptrdiff_t);
 
@@ -339,7 +354,7 @@ static int nbc_reduce_scatter_block_inter_init(const void *sendbuf, void *recvbu
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, tmpbuf);
+  res = NBC_Schedule_request_cached(&key, span_align + span, schedule, comm, libnbc_module, persistent, request, tmpbuf);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     free(tmpbuf);
@@ -23,27 +23,6 @@
  */
 #include "nbc_internal.h"
 
-#ifdef NBC_CACHE_SCHEDULE
-/* tree comparison function for schedule cache */
-int NBC_Scatter_args_compare(NBC_Scatter_args *a, NBC_Scatter_args *b, void *param) {
-    if ((a->sendbuf == b->sendbuf) &&
-        (a->sendcount == b->sendcount) &&
-        (a->sendtype == b->sendtype) &&
-        (a->recvbuf == b->recvbuf) &&
-        (a->recvcount == b->recvcount) &&
-        (a->recvtype == b->recvtype) &&
-        (a->root == b->root)) {
-        return 0;
-    }
-
-    if (a->sendbuf < b->sendbuf) {
-        return -1;
-    }
-
-    return 1;
-}
-#endif
-
 /* simple linear MPI_Iscatter */
 static int nbc_scatter_init (const void* sendbuf, size_t sendcount, MPI_Datatype sendtype,
                              void* recvbuf, size_t recvcount, MPI_Datatype recvtype, int root,
@@ -55,7 +34,6 @@ static int nbc_scatter_init (const void* sendbuf, size_t sendcount, MPI_Datatype
   char *sbuf, inplace = 0;
   ompi_coll_libnbc_module_t *libnbc_module = (ompi_coll_libnbc_module_t*) module;
 
-
   rank = ompi_comm_rank (comm);
   if (root == rank) {
     NBC_IN_PLACE(sendbuf, recvbuf, inplace);
@@ -70,96 +48,66 @@ static int nbc_scatter_init (const void* sendbuf, size_t sendcount, MPI_Datatype
     }
   }
 
-#ifdef NBC_CACHE_SCHEDULE
-  NBC_Scatter_args *args, *found, search;
-
-  /* search schedule in communicator specific tree */
-  search.sendbuf=sendbuf;
-  search.sendcount=sendcount;
-  search.sendtype=sendtype;
-  search.recvbuf=recvbuf;
-  search.recvcount=recvcount;
-  search.recvtype=recvtype;
-  search.root=root;
-  found = (NBC_Scatter_args *) hb_tree_search ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCATTER], &search);
-  if (NULL == found) {
-#endif
-    schedule = OBJ_NEW(NBC_Schedule);
-    if (OPAL_UNLIKELY(NULL == schedule)) {
-      return OMPI_ERR_OUT_OF_RESOURCE;
-    }
+  /* the send arguments are only significant at the root */
+  NBC_Sched_key key = {.coll = NBC_SCATTER, .root = root, .recvbuf = recvbuf};
+  if (!inplace) {
+    key.recvcount = recvcount;
+    key.recvtype = recvtype;
+  }
+  if (rank == root) {
+    key.sendbuf = sendbuf;
+    key.sendcount = sendcount;
+    key.sendtype = sendtype;
+  }
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
 
-    /* receive from root */
-    if (rank != root) {
-      /* recv msg from root */
-      res = NBC_Sched_recv (recvbuf, false, recvcount, recvtype, root, schedule, false);
-      if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-        OBJ_RELEASE(schedule);
-        return res;
-      }
-    } else {
-      for (int i = 0 ; i < p ; ++i) {
-        sbuf = (char *) sendbuf + (MPI_Aint) sndext * i * sendcount;
-        if (i == root) {
-          if (!inplace) {
-            /* if I am the root - just copy the message */
-            res = NBC_Sched_copy (sbuf, false, sendcount, sendtype,
-                                  recvbuf, false, recvcount, recvtype, schedule, false);
-            if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-              OBJ_RELEASE(schedule);
-              return res;
-            }
-          }
-        } else {
-          /* root sends the right buffer to the right receiver */
-          res = NBC_Sched_send (sbuf, false, sendcount, sendtype, i, schedule, false);
-          if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
-            OBJ_RELEASE(schedule);
-            return res;
-          }
-        }
-      }
-    }
+  schedule = OBJ_NEW(NBC_Schedule);
+  if (OPAL_UNLIKELY(NULL == schedule)) {
+    return OMPI_ERR_OUT_OF_RESOURCE;
+  }
 
-    res = NBC_Sched_commit (schedule);
+  /* receive from root */
+  if (rank != root) {
+    /* recv msg from root */
+    res = NBC_Sched_recv (recvbuf, false, recvcount, recvtype, root, schedule, false);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
       OBJ_RELEASE(schedule);
       return res;
     }
-#ifdef NBC_CACHE_SCHEDULE
-    /* save schedule to tree */
-    args = (NBC_Scatter_args *) malloc (sizeof (args));
-    if (NULL != args) {
-      args->sendbuf = sendbuf;
-      args->sendcount = sendcount;
-      args->sendtype = sendtype;
-      args->recvbuf = recvbuf;
-      args->recvcount = recvcount;
-      args->recvtype = recvtype;
-      args->root = root;
-      args->schedule = schedule;
-      res = hb_tree_insert ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCATTER], args, args, 0);
-      if (0 == res) {
-        OBJ_RETAIN(schedule);
-
-        /* increase number of elements for A2A */
-        if (++libnbc_module->NBC_Dict_size[NBC_SCATTER] > NBC_SCHED_DICT_UPPER) {
-          NBC_SchedCache_dictwipe ((hb_tree *) libnbc_module->NBC_Dict[NBC_SCATTER],
-                                   &libnbc_module->NBC_Dict_size[NBC_SCATTER]);
+  } else {
+    for (int i = 0 ; i < p ; ++i) {
+      sbuf = (char *) sendbuf + (MPI_Aint) sndext * i * sendcount;
+      if (i == root) {
+        if (!inplace) {
+          /* if I am the root - just copy the message */
+          res = NBC_Sched_copy (sbuf, false, sendcount, sendtype,
+                                recvbuf, false, recvcount, recvtype, schedule, false);
+          if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+            OBJ_RELEASE(schedule);
+            return res;
+          }
         }
       } else {
-        NBC_Error("error in dict_insert() (%i)", res);
-        free (args);
+        /* root sends the right buffer to the right receiver */
+        res = NBC_Sched_send (sbuf, false, sendcount, sendtype, i, schedule, false);
+        if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+          OBJ_RELEASE(schedule);
+          return res;
+        }
       }
     }
-  } else {
-    /* found schedule */
-    schedule = found->schedule;
-    OBJ_RETAIN(schedule);
   }
-#endif
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Sched_commit (schedule);
+  if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
+    OBJ_RELEASE(schedule);
+    return res;
+  }
+
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -207,6 +155,21 @@ static int nbc_scatter_inter_init (const void* sendbuf, size_t sendcount, MPI_Da
         }
     }
 
+    NBC_Sched_key key = {.coll = NBC_SCATTER, .root = root};
+    if (MPI_ROOT == root) {
+        key.sendbuf = sendbuf;
+        key.sendcount = sendcount;
+        key.sendtype = sendtype;
+    } else if (MPI_PROC_NULL != root) {
+        key.recvbuf = recvbuf;
+        key.recvcount = recvcount;
+        key.recvtype = recvtype;
+    }
+    res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+    if (OMPI_ERR_NOT_FOUND != res) {
+        return res;
+    }
+
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
         return OMPI_ERR_OUT_OF_RESOURCE;
@@ -238,7 +201,7 @@ static int nbc_scatter_inter_init (const void* sendbuf, size_t sendcount, MPI_Da
         return res;
     }
 
-    res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+    res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         return res;
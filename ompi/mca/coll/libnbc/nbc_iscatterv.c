@@ -23,10 +23,6 @@
  */
 #include "nbc_internal.h"
 
-/* a scatterv schedule can not be cached easily because the contents
- * of the recvcounts array may change, so a comparison of the address
- * would not be sufficient ... we simply do not cache it */
-
 /* simple linear MPI_Iscatterv */
 static int nbc_scatterv_init(const void* sendbuf, ompi_count_array_t sendcounts, ompi_disp_array_t displs, MPI_Datatype sendtype,
                              void* recvbuf, size_t recvcount, MPI_Datatype recvtype, int root,
@@ -45,6 +41,23 @@ static int nbc_scatterv_init(const void* sendbuf, ompi_count_array_t sendcounts,
 
   p = ompi_comm_size (comm);
 
+  /* the send arguments are only significant at the root */
+  NBC_Sched_key key = {.coll = NBC_SCATTERV, .root = root, .recvbuf = recvbuf};
+  if (!inplace) {
+    key.recvcount = recvcount;
+    key.recvtype = recvtype;
+  }
+  if (rank == root) {
+    key.sendbuf = sendbuf;
+    key.sendtype = sendtype;
+    NBC_Sched_key_counts(&key, sendcounts, p);
+    NBC_Sched_key_displs(&key, displs, p);
+  }
+  res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+  if (OMPI_ERR_NOT_FOUND != res) {
+    return res;
+  }
+
   schedule = OBJ_NEW(NBC_Schedule);
   if (OPAL_UNLIKELY(NULL == schedule)) {
     return OMPI_ERR_OUT_OF_RESOURCE;
@@ -94,7 +107,7 @@ static int nbc_scatterv_init(const void* sendbuf, ompi_count_array_t sendcounts,
     return res;
   }
 
-  res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+  res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
   if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
     OBJ_RELEASE(schedule);
     return res;
@@ -134,6 +147,22 @@ static int nbc_scatterv_inter_init (const void* sendbuf, ompi_count_array_t send
 
     rsize = ompi_comm_remote_size (comm);
 
+    NBC_Sched_key key = {.coll = NBC_SCATTERV, .root = root};
+    if (MPI_ROOT == root) {
+        key.sendbuf = sendbuf;
+        key.sendtype = sendtype;
+        NBC_Sched_key_counts(&key, sendcounts, rsize);
+        NBC_Sched_key_displs(&key, displs, rsize);
+    } else if (MPI_PROC_NULL != root) {
+        key.recvbuf = recvbuf;
+        key.recvcount = recvcount;
+        key.recvtype = recvtype;
+    }
+    res = NBC_Sched_cache_request(&key, comm, libnbc_module, persistent, request);
+    if (OMPI_ERR_NOT_FOUND != res) {
+        return res;
+    }
+
     schedule = OBJ_NEW(NBC_Schedule);
     if (OPAL_UNLIKELY(NULL == schedule)) {
         return OMPI_ERR_OUT_OF_RESOURCE;
@@ -172,7 +201,7 @@ static int nbc_scatterv_inter_init (const void* sendbuf, ompi_count_array_t send
         return res;
     }
 
-    res = NBC_Schedule_request(schedule, comm, libnbc_module, persistent, request, NULL);
+    res = NBC_Schedule_request_cached(&key, 0, schedule, comm, libnbc_module, persistent, request, NULL);
     if (OPAL_UNLIKELY(OMPI_SUCCESS != res)) {
         OBJ_RELEASE(schedule);
         return res;
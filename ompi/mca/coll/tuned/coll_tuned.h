@@ -26,6 +26,7 @@
 #include "ompi/request/request.h"
 #include "ompi/mca/coll/base/coll_base_functions.h"
 #include "opal/util/output.h"
+#include "opal/mca/timer/base/base.h"
 
 /* also need the dynamic rule structures */
 #include "coll_tuned_dynamic_rules.h"
@@ -39,6 +40,7 @@ extern int   ompi_coll_tuned_stream;
 extern int   ompi_coll_tuned_priority;
 extern bool  ompi_coll_tuned_use_dynamic_rules;
 extern char* ompi_coll_tuned_dynamic_rules_filename;
+extern char* ompi_coll_tuned_dynamic_rules_binary_output;
 extern int   ompi_coll_tuned_init_tree_fanout;
 extern int   ompi_coll_tuned_init_chain_fanout;
 extern int   ompi_coll_tuned_init_max_requests;
@@ -47,6 +49,9 @@ extern int   ompi_coll_tuned_scatter_intermediate_msg;
 extern int   ompi_coll_tuned_scatter_large_msg;
 extern int   ompi_coll_tuned_scatter_min_procs;
 extern int   ompi_coll_tuned_scatter_blocking_send_ratio;
+extern bool  ompi_coll_tuned_autotune;
+extern int   ompi_coll_tuned_autotune_trials;
+extern char* ompi_coll_tuned_autotune_cache_filename;
 
 /* forced algorithm choices */
 /* this structure is for storing the indexes to the forced algorithm mca params... */
@@ -197,6 +202,9 @@ struct mca_coll_tuned_component_t {
 
 	/* cached decision table stuff (moved from MCW module) */
 	ompi_coll_alg_rule_t *all_base_rules;
+	/* mapping of a binary rules file, if all_base_rules was loaded from one */
+	void *rules_map;
+	size_t rules_map_size;
 };
 /**
  * Convenience typedef
@@ -217,10 +225,44 @@ struct mca_coll_tuned_module_t {
 
     /* the communicator rules for each MPI collective for ONLY my comsize */
     ompi_coll_com_rule_t *com_rules[COLLCOUNT];
+
+    /* online tuning state, per message size bucket (allocated on first use) */
+    struct ompi_coll_tuned_autotune_entry_t *autotune[COLLCOUNT];
 };
 typedef struct mca_coll_tuned_module_t mca_coll_tuned_module_t;
 OBJ_CLASS_DECLARATION(mca_coll_tuned_module_t);
 
+/* Online tuning (coll_tuned_autotune.c) */
+#define COLL_TUNED_AUTOTUNE_MAX_CANDIDATES 16
+/* message sizes are bucketed by powers of two */
+#define COLL_TUNED_AUTOTUNE_BUCKETS (8 * sizeof(size_t) + 1)
+
+typedef struct ompi_coll_tuned_autotune_entry_t {
+    int state;
+    int algorithm;      /* selected algorithm, once locked */
+    int calls;          /* invocations measured so far */
+    double best[COLL_TUNED_AUTOTUNE_MAX_CANDIDATES];  /* fastest run of each candidate (usec) */
+} ompi_coll_tuned_autotune_entry_t;
+
+typedef struct ompi_coll_tuned_autotune_trial_t {
+    ompi_coll_tuned_autotune_entry_t *entry;  /* NULL if nothing to measure */
+    int coll;
+    int bucket;
+    int candidate;
+    opal_timer_t start;
+} ompi_coll_tuned_autotune_trial_t;
+
+int ompi_coll_tuned_autotune_init(void);
+void ompi_coll_tuned_autotune_fini(void);
+bool ompi_coll_tuned_autotune_supported(int coll);
+void ompi_coll_tuned_autotune_module_fini(mca_coll_tuned_module_t *tuned_module);
+int ompi_coll_tuned_autotune_begin(mca_coll_tuned_module_t *tuned_module, int coll,
+                                   size_t dsize, struct ompi_communicator_t *comm,
+                                   ompi_coll_tuned_autotune_trial_t *trial);
+int ompi_coll_tuned_autotune_end(mca_coll_tuned_module_t *tuned_module,
+                                 ompi_coll_tuned_autotune_trial_t *trial,
+                                 struct ompi_communicator_t *comm);
+
 int coll_tuned_alg_from_str(int collective_id, const char *alg_name, int *alg_index);
 int coll_tuned_alg_to_str(int collective_id, int alg_value, char **alg_string);
 int coll_tuned_alg_register_options(int collective_id, mca_base_var_enum_t *options);
@@ -44,6 +44,7 @@ static const mca_base_var_enum_value_t allgather_algorithms[] = {
     {6, "two_proc"},
     {7, "sparbit"},
     {8, "direct-messaging"},
+    {9, "recursive_multiplying"},
     {0, NULL}
 };
 
@@ -82,7 +83,7 @@ ompi_coll_tuned_allgather_intra_check_forced_init(coll_tuned_force_algorithm_mca
     mca_param_indices->algorithm_param_index =
         mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                         "allgather_algorithm",
-                                        "Which allgather algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 bruck with radix k, 3 recursive doubling, 4 ring, 5 neighbor exchange, 6: two proc only, 7: sparbit, 8: direct messaging. "
+                                        "Which allgather algorithm is used. Can be locked down to choice of: 0 ignore, 1 basic linear, 2 bruck with radix k, 3 recursive doubling, 4 ring, 5 neighbor exchange, 6: two proc only, 7: sparbit, 8: direct messaging, 9: recursive multiplying (radix given by the tree fanout). "
                                         "Only relevant if coll_tuned_use_dynamic_rules is true.",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
@@ -175,6 +176,10 @@ int ompi_coll_tuned_allgather_intra_do_this(const void *sbuf, size_t scount,
         return ompi_coll_base_allgather_direct_messaging(sbuf, scount, sdtype,
                                                          rbuf, rcount, rdtype,
                                                          comm, module);
+    case (9):
+        return ompi_coll_base_allgather_intra_recursive_multiplying(sbuf, scount, sdtype,
+                                                                    rbuf, rcount, rdtype,
+                                                                    comm, module, faninout);
     } /* switch */
     OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream,
                  "coll:tuned:allgather_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
@@ -0,0 +1,374 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The University of Tennessee and The University
+ *                         of Tennessee Research Foundation.  All rights
+ *                         reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Online tuning of the decision functions.
+ *
+ * For each (collective, message size bucket) of a communicator, the first
+ * invocations rotate over a list of candidate algorithms and measure them.
+ * Once every candidate has been run coll_tuned_autotune_trials times, the
+ * ranks agree on the best one (smallest of the per rank fastest runs, taking
+ * the slowest rank into account), and all the following invocations in this
+ * bucket use it. Message sizes are bucketed by powers of two.
+ *
+ * The winners are kept per (collective, communicator size, bucket) and, when
+ * coll_tuned_autotune_cache_filename is set, are loaded from this file at
+ * startup and written back to it at finalize, so later jobs can start from
+ * the decisions of previous ones. As the file might be seen differently by
+ * different processes, a cached decision is only used after checking that all
+ * the ranks of the communicator found the same one.
+ *
+ * All the steps only depend on the sequence of collective calls on the
+ * communicator, which is the same on all ranks, so the ranks always use the
+ * same algorithm and take part in the agreements at the same invocations.
+ */
+
+#include "ompi_config.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "mpi.h"
+#include "opal/mca/timer/base/base.h"
+#include "opal/mca/threads/mutex.h"
+#include "opal/util/output.h"
+#include "opal/util/printf.h"
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
+#include "ompi/op/op.h"
+#include "ompi/runtime/ompi_rte.h"
+#include "coll_tuned.h"
+
+/* Algorithms tried for each collective; collectives without candidates are
+ * not tuned online. The ids are those of coll_tuned_<coll>_algorithm. */
+static const int allgather_candidates[] = {2, 3, 4, 5, 7, 8, 9, 0};
+static const int allreduce_candidates[] = {2, 3, 4, 5, 6, 8, 9, 10, 0};
+static const int bcast_candidates[] = {2, 3, 4, 5, 6, 7, 8, 9, 0};
+static const int reduce_candidates[] = {2, 3, 4, 5, 7, 8, 0};
+
+enum {
+    COLL_TUNED_AUTOTUNE_NEW = 0,
+    COLL_TUNED_AUTOTUNE_TUNING,
+    COLL_TUNED_AUTOTUNE_LOCKED
+};
+
+/* A decision, as stored in the cache file */
+typedef struct coll_tuned_autotune_decision_t {
+    int coll;
+    int comm_size;
+    int bucket;
+    int algorithm;
+} coll_tuned_autotune_decision_t;
+
+static coll_tuned_autotune_decision_t *autotune_decisions = NULL;
+static int autotune_decisions_count = 0;
+static int autotune_decisions_size = 0;
+static bool autotune_decisions_dirty = false;
+static opal_mutex_t autotune_lock = OPAL_MUTEX_STATIC_INIT;
+
+static const int *autotune_candidates(int coll)
+{
+    switch (coll) {
+    case ALLGATHER: return allgather_candidates;
+    case ALLREDUCE: return allreduce_candidates;
+    case BCAST:     return bcast_candidates;
+    case REDUCE:    return reduce_candidates;
+    default:        return NULL;
+    }
+}
+
+static int autotune_candidates_count(const int *candidates)
+{
+    int n = 0;
+    while (0 != candidates[n]) n++;
+    return n;
+}
+
+/* 0 for empty messages, i + 1 for messages in [2^i, 2^(i+1)) */
+static int autotune_bucket(size_t dsize)
+{
+    int bucket = 0;
+    while (0 != dsize) {
+        bucket++;
+        dsize >>= 1;
+    }
+    return bucket;
+}
+
+/* Must be called with autotune_lock held */
+static coll_tuned_autotune_decision_t *
+autotune_find_decision(int coll, int comm_size, int bucket)
+{
+    for (int i = 0; i < autotune_decisions_count; i++) {
+        coll_tuned_autotune_decision_t *d = &autotune_decisions[i];
+        if (d->coll == coll && d->comm_size == comm_size && d->bucket == bucket) {
+            return d;
+        }
+    }
+    return NULL;
+}
+
+/* Must be called with autotune_lock held */
+static void autotune_store_decision(int coll, int comm_size, int bucket, int algorithm)
+{
+    coll_tuned_autotune_decision_t *d = autotune_find_decision(coll, comm_size, bucket);
+
+    if (NULL == d) {
+        if (autotune_decisions_count == autotune_decisions_size) {
+            int size = (0 == autotune_decisions_size) ? 32 : 2 * autotune_decisions_size;
+            void *tmp = realloc(autotune_decisions, size * sizeof(*d));
+            if (NULL == tmp) {
+                return;
+            }
+            autotune_decisions = (coll_tuned_autotune_decision_t *) tmp;
+            autotune_decisions_size = size;
+        }
+        d = &autotune_decisions[autotune_decisions_count++];
+        d->coll = coll;
+        d->comm_size = comm_size;
+        d->bucket = bucket;
+    }
+    d->algorithm = algorithm;
+}
+
+/*
+ * Cache file: one decision per line,
+ *   <collective> <communicator size> <message size> <algorithm>
+ * with names as in the MCA parameters, e.g. "allreduce 64 65536 ring". The
+ * message size can be any size of the bucket. Lines starting with '#' and
+ * invalid decisions are ignored.
+ */
+int ompi_coll_tuned_autotune_init(void)
+{
+    char line[256], coll_name[64], alg_name[64];
+    size_t msg_size;
+    int comm_size, coll, alg;
+    FILE *fptr;
+
+    if (NULL == ompi_coll_tuned_autotune_cache_filename) {
+        return OMPI_SUCCESS;
+    }
+    fptr = fopen(ompi_coll_tuned_autotune_cache_filename, "r");
+    if (NULL == fptr) {
+        /* Nothing cached yet */
+        return OMPI_SUCCESS;
+    }
+
+    while (NULL != fgets(line, sizeof(line), fptr)) {
+        if ('#' == line[0] ||
+            4 != sscanf(line, "%63s %d %zu %63s", coll_name, &comm_size, &msg_size, alg_name)) {
+            continue;
+        }
+        coll = mca_coll_base_name_to_colltype(coll_name);
+        if (coll < 0 || NULL == autotune_candidates(coll) || comm_size < 1 ||
+            OPAL_SUCCESS != coll_tuned_alg_from_str(coll, alg_name, &alg) || alg <= 0) {
+            OPAL_OUTPUT_VERBOSE((5, ompi_coll_tuned_stream,
+                "coll:tuned:autotune ignoring invalid cache entry \"%s %d %zu %s\"",
+                coll_name, comm_size, msg_size, alg_name));
+            continue;
+        }
+        autotune_store_decision(coll, comm_size, autotune_bucket(msg_size), alg);
+    }
+    fclose(fptr);
+
+    OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream,
+        "coll:tuned:autotune loaded %d decisions from %s",
+        autotune_decisions_count, ompi_coll_tuned_autotune_cache_filename));
+    return OMPI_SUCCESS;
+}
+
+/*
+ * Write the decisions back to the cache file. A single process writes it, to
+ * a temporary file renamed over the cache so that readers never see a
+ * partial file; it only knows about the communicators it belongs to.
+ */
+void ompi_coll_tuned_autotune_fini(void)
+{
+    char *tmpname = NULL, *alg_name;
+    FILE *fptr;
+
+    if (NULL != ompi_coll_tuned_autotune_cache_filename && autotune_decisions_dirty &&
+        0 == OMPI_PROC_MY_NAME->vpid &&
+        0 < opal_asprintf(&tmpname, "%s.%d", ompi_coll_tuned_autotune_cache_filename, (int) getpid())) {
+        fptr = fopen(tmpname, "w");
+        if (NULL != fptr) {
+            fprintf(fptr, "# coll/tuned autotune cache: <collective> <communicator size> "
+                    "<message size> <algorithm>\n");
+            for (int i = 0; i < autotune_decisions_count; i++) {
+                coll_tuned_autotune_decision_t *d = &autotune_decisions[i];
+                size_t msg_size = (0 == d->bucket) ? 0 : ((size_t) 1) << (d->bucket - 1);
+                if (OPAL_SUCCESS != coll_tuned_alg_to_str(d->coll, d->algorithm, &alg_name)) {
+                    continue;
+                }
+                fprintf(fptr, "%s %d %zu %s\n", mca_coll_base_colltype_to_str(d->coll),
+                        d->comm_size, msg_size, alg_name);
+                free(alg_name);
+            }
+            if (0 != fclose(fptr) || 0 != rename(tmpname, ompi_coll_tuned_autotune_cache_filename)) {
+                opal_output_verbose(1, ompi_coll_tuned_stream,
+                                    "coll:tuned:autotune could not write the cache file %s",
+                                    ompi_coll_tuned_autotune_cache_filename);
+                unlink(tmpname);
+            }
+        }
+        free(tmpname);
+    }
+
+    free(autotune_decisions);
+    autotune_decisions = NULL;
+    autotune_decisions_count = autotune_decisions_size = 0;
+    autotune_decisions_dirty = false;
+}
+
+bool ompi_coll_tuned_autotune_supported(int coll)
+{
+    return NULL != autotune_candidates(coll);
+}
+
+void ompi_coll_tuned_autotune_module_fini(mca_coll_tuned_module_t *tuned_module)
+{
+    for (int i = 0; i < COLLCOUNT; i++) {
+        free(tuned_module->autotune[i]);
+        tuned_module->autotune[i] = NULL;
+    }
+}
+
+/*
+ * Pick the algorithm for this invocation. Returns 0 if the collective is not
+ * tuned online (the caller continues with its usual decision), otherwise the
+ * algorithm to run, after which ompi_coll_tuned_autotune_end() must be called.
+ */
+int ompi_coll_tuned_autotune_begin(mca_coll_tuned_module_t *tuned_module, int coll,
+                                   size_t dsize, struct ompi_communicator_t *comm,
+                                   ompi_coll_tuned_autotune_trial_t *trial)
+{
+    const int *candidates = autotune_candidates(coll);
+    ompi_coll_tuned_autotune_entry_t *entry;
+    int bucket, ncand;
+
+    trial->entry = NULL;
+    if (NULL == candidates) {
+        return 0;
+    }
+
+    if (NULL == tuned_module->autotune[coll]) {
+        tuned_module->autotune[coll] = (ompi_coll_tuned_autotune_entry_t *)
+            calloc(COLL_TUNED_AUTOTUNE_BUCKETS, sizeof(ompi_coll_tuned_autotune_entry_t));
+        if (NULL == tuned_module->autotune[coll]) {
+            return 0;
+        }
+    }
+    bucket = autotune_bucket(dsize);
+    entry = &tuned_module->autotune[coll][bucket];
+    ncand = autotune_candidates_count(candidates);
+
+    if (COLL_TUNED_AUTOTUNE_NEW == entry->state) {
+        entry->state = COLL_TUNED_AUTOTUNE_TUNING;
+        for (int i = 0; i < ncand; i++) {
+            entry->best[i] = -1.0;
+        }
+
+        if (NULL != ompi_coll_tuned_autotune_cache_filename) {
+            coll_tuned_autotune_decision_t *d;
+            int cached[2] = {0, 0};
+
+            OPAL_THREAD_LOCK(&autotune_lock);
+            d = autotune_find_decision(coll, ompi_comm_size(comm), bucket);
+            if (NULL != d) {
+                cached[0] = d->algorithm;
+                cached[1] = -d->algorithm;
+            }
+            OPAL_THREAD_UNLOCK(&autotune_lock);
+
+            /* max and -min of the cached decisions */
+            if (OMPI_SUCCESS == ompi_coll_tuned_allreduce_intra_dec_fixed(MPI_IN_PLACE, cached, 2, MPI_INT,
+                                                                          MPI_MAX, comm, &tuned_module->super)
+                && cached[0] > 0 && cached[0] == -cached[1]) {
+                entry->state = COLL_TUNED_AUTOTUNE_LOCKED;
+                entry->algorithm = cached[0];
+                OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream,
+                    "coll:tuned:autotune %s bucket %d on %s: cached algorithm %d",
+                    mca_coll_base_colltype_to_str(coll), bucket,
+                    ompi_comm_print_cid(comm), entry->algorithm));
+            }
+        }
+    }
+
+    if (COLL_TUNED_AUTOTUNE_LOCKED == entry->state) {
+        return entry->algorithm;
+    }
+
+    trial->entry = entry;
+    trial->coll = coll;
+    trial->bucket = bucket;
+    trial->candidate = entry->calls % ncand;
+    trial->start = opal_timer_base_get_usec();
+    return candidates[trial->candidate];
+}
+
+/*
+ * Account for the invocation started by ompi_coll_tuned_autotune_begin(), and
+ * lock in the winner once all candidates have been measured enough.
+ */
+int ompi_coll_tuned_autotune_end(mca_coll_tuned_module_t *tuned_module,
+                                 ompi_coll_tuned_autotune_trial_t *trial,
+                                 struct ompi_communicator_t *comm)
+{
+    ompi_coll_tuned_autotune_entry_t *entry = trial->entry;
+    const int *candidates;
+    double elapsed;
+    int ncand, err, winner;
+
+    if (NULL == entry) {
+        return OMPI_SUCCESS;
+    }
+
+    elapsed = (double) (opal_timer_base_get_usec() - trial->start);
+    if (entry->best[trial->candidate] < 0.0 || elapsed < entry->best[trial->candidate]) {
+        entry->best[trial->candidate] = elapsed;
+    }
+
+    candidates = autotune_candidates(trial->coll);
+    ncand = autotune_candidates_count(candidates);
+    if (++entry->calls < ncand * ompi_coll_tuned_autotune_trials) {
+        return OMPI_SUCCESS;
+    }
+
+    /* A candidate is as fast as its slowest rank */
+    err = ompi_coll_tuned_allreduce_intra_dec_fixed(MPI_IN_PLACE, entry->best, ncand, MPI_DOUBLE,
+                                                    MPI_MAX, comm, &tuned_module->super);
+    if (OMPI_SUCCESS != err) {
+        return err;
+    }
+    winner = 0;
+    for (int i = 1; i < ncand; i++) {
+        if (entry->best[i] < entry->best[winner]) {
+            winner = i;
+        }
+    }
+    entry->state = COLL_TUNED_AUTOTUNE_LOCKED;
+    entry->algorithm = candidates[winner];
+
+    OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream,
+        "coll:tuned:autotune %s bucket %d on %s: algorithm %d wins (%.1f usec)",
+        mca_coll_base_colltype_to_str(trial->coll), trial->bucket,
+        ompi_comm_print_cid(comm), entry->algorithm, entry->best[winner]));
+
+    OPAL_THREAD_LOCK(&autotune_lock);
+    autotune_store_decision(trial->coll, ompi_comm_size(comm), trial->bucket, entry->algorithm);
+    autotune_decisions_dirty = true;
+    OPAL_THREAD_UNLOCK(&autotune_lock);
+
+    return OMPI_SUCCESS;
+}
@@ -41,6 +41,8 @@
 #include "ompi/mca/coll/coll.h"
 #include "coll_tuned.h"
 #include "coll_tuned_dynamic_file.h"
+#include "ompi/mca/coll/base/coll_base_util.h"
+#include "ompi/runtime/ompi_rte.h"
 
 /*
  * Public string showing the coll ompi_tuned component version number
@@ -55,9 +57,13 @@ int   ompi_coll_tuned_stream = -1;
 int   ompi_coll_tuned_priority = 30;
 bool  ompi_coll_tuned_use_dynamic_rules = false;
 char* ompi_coll_tuned_dynamic_rules_filename = (char*) NULL;
+char* ompi_coll_tuned_dynamic_rules_binary_output = (char*) NULL;
 int   ompi_coll_tuned_init_tree_fanout = 4;
 int   ompi_coll_tuned_init_chain_fanout = 4;
 int   ompi_coll_tuned_init_max_requests = 128;
+bool  ompi_coll_tuned_autotune = false;
+int   ompi_coll_tuned_autotune_trials = 3;
+char* ompi_coll_tuned_autotune_cache_filename = (char*) NULL;
 int   ompi_coll_tuned_verbose = 0;
 
 /* Set it to the same value as intermediate msg by default, so it does not affect
@@ -196,6 +202,45 @@ static int tuned_register(void)
                                            MCA_BASE_VAR_SCOPE_ALL,
                                            &ompi_coll_tuned_dynamic_rules_filename);
 
+    ompi_coll_tuned_dynamic_rules_binary_output = NULL;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "dynamic_rules_binary_output",
+                                           "If set, the first process of the job writes the rules read from the (text or json) dynamic rules file to this file in a binary format. Using the binary file as coll_tuned_dynamic_rules_filename then avoids parsing the rules on every process: the file is mapped read-only and shared by the processes of each node, and is only valid for the same Open MPI build and architecture",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &ompi_coll_tuned_dynamic_rules_binary_output);
+
+    ompi_coll_tuned_autotune = false;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "autotune",
+                                           "Select the allgather, allreduce, bcast and reduce algorithms online: the first invocations for each message size (rounded to a power of two) try the candidate algorithms, and the fastest one is then used on this communicator. A user forced algorithm or a matching dynamic rule takes precedence",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &ompi_coll_tuned_autotune);
+
+    ompi_coll_tuned_autotune_trials = 3;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "autotune_trials",
+                                           "Number of times each candidate algorithm is measured before the online tuning picks one",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &ompi_coll_tuned_autotune_trials);
+    if (ompi_coll_tuned_autotune_trials < 1) {
+        ompi_coll_tuned_autotune_trials = 1;
+    }
+
+    ompi_coll_tuned_autotune_cache_filename = NULL;
+    (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
+                                           "autotune_cache_filename",
+                                           "File caching the algorithms selected by the online tuning, per collective, communicator size and message size. Read at startup and rewritten at finalize by the first process of the job",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                           OPAL_INFO_LVL_6,
+                                           MCA_BASE_VAR_SCOPE_ALL,
+                                           &ompi_coll_tuned_autotune_cache_filename);
+
     ompi_coll_tuned_verbose = 0;
     (void) mca_base_component_var_register(&mca_coll_tuned_component.super.collm_version,
                                            "verbose",
@@ -252,6 +297,16 @@ static int tuned_open(void)
             if( rc == OPAL_SUCCESS ) {
                 OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream,
                     "coll:tuned:module_open Read a valid rules file"));
+                if (NULL != ompi_coll_tuned_dynamic_rules_binary_output &&
+                    NULL == mca_coll_tuned_component.rules_map &&
+                    (0 == OMPI_PROC_MY_NAME->vpid || OPAL_VPID_INVALID == OMPI_PROC_MY_NAME->vpid)) {
+                    rc = ompi_coll_tuned_write_rules_binary_file(ompi_coll_tuned_dynamic_rules_binary_output,
+                                                                 mca_coll_tuned_component.all_base_rules);
+                    opal_output_verbose(1, ompi_coll_tuned_stream,
+                        "coll:tuned:component_open %s binary rules file [%s]",
+                        (OMPI_SUCCESS == rc) ? "Wrote" : "Failed to write",
+                        ompi_coll_tuned_dynamic_rules_binary_output);
+                }
             } else {
                 OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream,
                     "coll:tuned:module_open Reading collective rules file failed\n"));
@@ -260,6 +315,10 @@ static int tuned_open(void)
         }
     }
 
+    if (ompi_coll_tuned_autotune) {
+        ompi_coll_tuned_autotune_init();
+    }
+
     OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream,
         "coll:tuned:component_open: done!"));
 
@@ -283,6 +342,13 @@ static int tuned_close(void)
         ompi_coll_tuned_free_all_rules(mca_coll_tuned_component.all_base_rules);
         mca_coll_tuned_component.all_base_rules = NULL;
     }
+    /* the message rules may point into the mapping */
+    ompi_coll_base_rules_file_unmap(mca_coll_tuned_component.rules_map,
+                                    mca_coll_tuned_component.rules_map_size);
+    mca_coll_tuned_component.rules_map = NULL;
+
+    /* needs the algorithm names, released below */
+    ompi_coll_tuned_autotune_fini();
 
     for (int i=0; i<COLLCOUNT; i++) {
         if (coll_tuned_algorithm_enums[i] != NULL) {
@@ -301,9 +367,16 @@ mca_coll_tuned_module_construct(mca_coll_tuned_module_t *module)
     for( int i = 0; i < COLLCOUNT; i++ ) {
         tuned_module->user_forced[i].algorithm = 0;
         tuned_module->com_rules[i] = NULL;
+        tuned_module->autotune[i] = NULL;
     }
 }
 
+static void
+mca_coll_tuned_module_destruct(mca_coll_tuned_module_t *module)
+{
+    ompi_coll_tuned_autotune_module_fini(module);
+}
+
 int coll_tuned_alg_from_str(int collective_id, const char *alg_name, int *alg_value) {
     int rc;
     if (collective_id >= COLLCOUNT || collective_id < 0) { return OPAL_ERROR; };
@@ -340,4 +413,4 @@ int coll_tuned_alg_register_options(int collective_id, mca_base_var_enum_t *opti
 
 
 OBJ_CLASS_INSTANCE(mca_coll_tuned_module_t, mca_coll_base_module_t,
-                   mca_coll_tuned_module_construct, NULL);
+                   mca_coll_tuned_module_construct, mca_coll_tuned_module_destruct);
@@ -30,6 +30,7 @@
 #include "ompi/mca/coll/base/base.h"
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/coll_tags.h"
+#include "ompi/op/op.h"
 #include "coll_tuned.h"
 
 /*
@@ -91,6 +92,28 @@ ompi_coll_tuned_allreduce_intra_dec_dynamic (const void *sbuf, void *rbuf, size_
         } /* found a method */
     } /*end if any com rules to check */
 
+    /* online tuning, only for commutative operations as not all candidates handle the others */
+    if (ompi_coll_tuned_autotune && ompi_op_is_commute(op)) {
+        ompi_coll_tuned_autotune_trial_t trial;
+        int alg, err;
+        size_t dsize;
+
+        ompi_datatype_type_size (dtype, &dsize);
+        dsize *= count;
+
+        alg = ompi_coll_tuned_autotune_begin(tuned_module, ALLREDUCE, dsize, comm, &trial);
+        if (alg) {
+            err = ompi_coll_tuned_allreduce_intra_do_this (sbuf, rbuf, count, dtype, op,
+                                                           comm, module, alg,
+                                                           tuned_module->user_forced[ALLREDUCE].tree_fanout,
+                                                           tuned_module->user_forced[ALLREDUCE].segsize);
+            if (OMPI_SUCCESS == err) {
+                err = ompi_coll_tuned_autotune_end(tuned_module, &trial, comm);
+            }
+            return err;
+        }
+    }
+
     return ompi_coll_tuned_allreduce_intra_dec_fixed (sbuf, rbuf, count, dtype, op,
                                                       comm, module);
 }
@@ -294,6 +317,28 @@ int ompi_coll_tuned_bcast_intra_dec_dynamic(void *buf, size_t count,
     } /*end if any com rules to check */
 
 
+    /* online tuning */
+    if (ompi_coll_tuned_autotune) {
+        ompi_coll_tuned_autotune_trial_t trial;
+        int alg, err;
+        size_t dsize;
+
+        ompi_datatype_type_size (dtype, &dsize);
+        dsize *= count;
+
+        alg = ompi_coll_tuned_autotune_begin(tuned_module, BCAST, dsize, comm, &trial);
+        if (alg) {
+            err = ompi_coll_tuned_bcast_intra_do_this (buf, count, dtype, root,
+                                                       comm, module, alg,
+                                                       tuned_module->user_forced[BCAST].chain_fanout,
+                                                       tuned_module->user_forced[BCAST].segsize);
+            if (OMPI_SUCCESS == err) {
+                err = ompi_coll_tuned_autotune_end(tuned_module, &trial, comm);
+            }
+            return err;
+        }
+    }
+
     return ompi_coll_tuned_bcast_intra_dec_fixed (buf, count, dtype, root,
                                                   comm, module);
 }
@@ -349,6 +394,29 @@ int ompi_coll_tuned_reduce_intra_dec_dynamic( const void *sbuf, void *rbuf,
         } /* found a method */
     } /*end if any com rules to check */
 
+    /* online tuning, only for commutative operations as not all candidates handle the others */
+    if (ompi_coll_tuned_autotune && ompi_op_is_commute(op)) {
+        ompi_coll_tuned_autotune_trial_t trial;
+        int alg, err;
+        size_t dsize;
+
+        ompi_datatype_type_size(dtype, &dsize);
+        dsize *= count;
+
+        alg = ompi_coll_tuned_autotune_begin(tuned_module, REDUCE, dsize, comm, &trial);
+        if (alg) {
+            err = ompi_coll_tuned_reduce_intra_do_this (sbuf, rbuf, count, dtype,
+                                                        op, root, comm, module, alg,
+                                                        tuned_module->user_forced[REDUCE].chain_fanout,
+                                                        tuned_module->user_forced[REDUCE].segsize,
+                                                        tuned_module->user_forced[REDUCE].max_requests);
+            if (OMPI_SUCCESS == err) {
+                err = ompi_coll_tuned_autotune_end(tuned_module, &trial, comm);
+            }
+            return err;
+        }
+    }
+
     return ompi_coll_tuned_reduce_intra_dec_fixed (sbuf, rbuf, count, dtype,
                                                    op, root, comm, module);
 }
@@ -519,6 +587,30 @@ int ompi_coll_tuned_allgather_intra_dec_dynamic(const void *sbuf, size_t scount,
         }
     }
 
+    /* online tuning */
+    if (ompi_coll_tuned_autotune) {
+        ompi_coll_tuned_autotune_trial_t trial;
+        int alg, err;
+        size_t dsize;
+
+        /* the receive side is valid on all ranks, even with MPI_IN_PLACE */
+        ompi_datatype_type_size (rdtype, &dsize);
+        dsize *= (ptrdiff_t)ompi_comm_size(comm) * (ptrdiff_t)rcount;
+
+        alg = ompi_coll_tuned_autotune_begin(tuned_module, ALLGATHER, dsize, comm, &trial);
+        if (alg) {
+            err = ompi_coll_tuned_allgather_intra_do_this (sbuf, scount, sdtype,
+                                                           rbuf, rcount, rdtype,
+                                                           comm, module, alg,
+                                                           tuned_module->user_forced[ALLGATHER].tree_fanout,
+                                                           tuned_module->user_forced[ALLGATHER].segsize);
+            if (OMPI_SUCCESS == err) {
+                err = ompi_coll_tuned_autotune_end(tuned_module, &trial, comm);
+            }
+            return err;
+        }
+    }
+
     /* Use default decision */
     return ompi_coll_tuned_allgather_intra_dec_fixed (sbuf, scount, sdtype,
                                                       rbuf, rcount, rdtype,
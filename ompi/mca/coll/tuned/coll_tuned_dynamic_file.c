@@ -670,14 +670,171 @@ static int ompi_coll_tuned_read_rules_config_file_classic (char *fname, ompi_col
     return OPAL_ERROR;
 }
 
+/*
+ * Binary rules files (see ompi_coll_base_rules_file_map): a section of com
+ * rules, ordered by collective, each owning a range of the second section,
+ * the message rules. The message rules are used in place from the mapping.
+ */
+#define COLL_TUNED_RULES_FILE_MAGIC   "OMPITUNR"
+#define COLL_TUNED_RULES_FILE_VERSION 1
+
+typedef struct coll_tuned_rules_file_com_s {
+    int32_t coll_id;
+    int32_t mpi_comsize_min;
+    int32_t mpi_comsize_max;
+    int32_t comm_rank_distribution;
+    uint64_t first_msg_rule;
+    uint64_t n_msg_rules;
+} coll_tuned_rules_file_com_t;
+
+static const uint32_t coll_tuned_rules_file_record_size[2] = {
+    sizeof(coll_tuned_rules_file_com_t), sizeof(ompi_coll_msg_rule_t)
+};
+
+static int ompi_coll_tuned_read_rules_binary (const char *fname, ompi_coll_alg_rule_t** rules)
+{
+    const coll_tuned_rules_file_com_t *coms;
+    const ompi_coll_msg_rule_t *msgs;
+    const void *sections[2];
+    size_t count[2], i, j;
+    ompi_coll_alg_rule_t *alg_rules = NULL;
+    int n_coms[COLLCOUNT] = {0}, next[COLLCOUNT] = {0};
+    void *map;
+    size_t map_size;
+    int rc;
+
+    rc = ompi_coll_base_rules_file_map(fname, COLL_TUNED_RULES_FILE_MAGIC, COLL_TUNED_RULES_FILE_VERSION,
+                                       2, coll_tuned_rules_file_record_size, sections, count,
+                                       &map, &map_size);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+    coms = (const coll_tuned_rules_file_com_t *) sections[0];
+    msgs = (const ompi_coll_msg_rule_t *) sections[1];
+
+    for (i = 0; i < count[0]; i++) {
+        if (coms[i].coll_id < 0 || coms[i].coll_id >= COLLCOUNT ||
+            coms[i].comm_rank_distribution < 0 || coms[i].comm_rank_distribution >= COLL_RULES_DISTRO_COUNT ||
+            coms[i].first_msg_rule > count[1] || coms[i].n_msg_rules > count[1] - coms[i].first_msg_rule ||
+            coms[i].n_msg_rules > INT_MAX) {
+            goto bad_file;
+        }
+        for (j = coms[i].first_msg_rule; j < coms[i].first_msg_rule + coms[i].n_msg_rules; j++) {
+            if (msgs[j].coll_id != coms[i].coll_id) {
+                goto bad_file;
+            }
+        }
+        n_coms[coms[i].coll_id]++;
+    }
+
+    alg_rules = ompi_coll_tuned_mk_alg_rules(COLLCOUNT);
+    if (NULL == alg_rules) {
+        goto bad_file;
+    }
+    for (i = 0; i < COLLCOUNT; i++) {
+        if (0 == n_coms[i]) {
+            continue;
+        }
+        alg_rules[i].com_rules = ompi_coll_tuned_mk_com_rules(n_coms[i], i);
+        if (NULL == alg_rules[i].com_rules) {
+            goto bad_file;
+        }
+        alg_rules[i].n_com_sizes = n_coms[i];
+    }
+
+    /* the com rules of each collective keep their order in the file */
+    for (i = 0; i < count[0]; i++) {
+        ompi_coll_com_rule_t *com_p = &alg_rules[coms[i].coll_id].com_rules[next[coms[i].coll_id]++];
+        com_p->mpi_comsize_min = coms[i].mpi_comsize_min;
+        com_p->mpi_comsize_max = coms[i].mpi_comsize_max;
+        com_p->comm_rank_distribution = coms[i].comm_rank_distribution;
+        com_p->n_rules = (int) coms[i].n_msg_rules;
+        if (com_p->n_rules > 0) {
+            com_p->msg_rules = (ompi_coll_msg_rule_t *) &msgs[coms[i].first_msg_rule];
+            com_p->msg_rules_mapped = true;
+        }
+    }
+
+    opal_output_verbose(1, ompi_coll_tuned_stream,
+        "Mapped binary rules file %s: %" PRIsize_t " communicator rules, %" PRIsize_t " message rules\n",
+        fname, count[0], count[1]);
+
+    mca_coll_tuned_component.rules_map = map;
+    mca_coll_tuned_component.rules_map_size = map_size;
+    *rules = alg_rules;
+    return OMPI_SUCCESS;
+
+ bad_file:
+    if (NULL != alg_rules) {
+        ompi_coll_tuned_free_all_rules(alg_rules);
+    }
+    ompi_coll_base_rules_file_unmap(map, map_size);
+    return OMPI_ERR_BAD_PARAM;
+}
+
+/**
+ * Writes the rules in the binary format, so that later runs can map them
+ * instead of parsing a text file.
+ */
+int ompi_coll_tuned_write_rules_binary_file (const char *fname, ompi_coll_alg_rule_t* rules)
+{
+    coll_tuned_rules_file_com_t *coms = NULL;
+    ompi_coll_msg_rule_t *msgs = NULL;
+    const void *sections[2];
+    size_t count[2] = {0, 0};
+    int i, j, rc;
+
+    for (i = 0; i < COLLCOUNT; i++) {
+        count[0] += rules[i].n_com_sizes;
+        for (j = 0; j < rules[i].n_com_sizes; j++) {
+            count[1] += rules[i].com_rules[j].n_rules;
+        }
+    }
+    coms = (coll_tuned_rules_file_com_t *) calloc(count[0] + 1, sizeof(coll_tuned_rules_file_com_t));
+    msgs = (ompi_coll_msg_rule_t *) calloc(count[1] + 1, sizeof(ompi_coll_msg_rule_t));
+    if (NULL == coms || NULL == msgs) {
+        free(coms);
+        free(msgs);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+
+    count[0] = count[1] = 0;
+    for (i = 0; i < COLLCOUNT; i++) {
+        for (j = 0; j < rules[i].n_com_sizes; j++) {
+            ompi_coll_com_rule_t *com_p = &rules[i].com_rules[j];
+            coms[count[0]].coll_id = i;
+            coms[count[0]].mpi_comsize_min = com_p->mpi_comsize_min;
+            coms[count[0]].mpi_comsize_max = com_p->mpi_comsize_max;
+            coms[count[0]].comm_rank_distribution = com_p->comm_rank_distribution;
+            coms[count[0]].first_msg_rule = count[1];
+            coms[count[0]].n_msg_rules = com_p->n_rules;
+            count[0]++;
+            if (com_p->n_rules > 0) {
+                memcpy(&msgs[count[1]], com_p->msg_rules, com_p->n_rules * sizeof(ompi_coll_msg_rule_t));
+                count[1] += com_p->n_rules;
+            }
+        }
+    }
+
+    sections[0] = coms;
+    sections[1] = msgs;
+    rc = ompi_coll_base_rules_file_write(fname, COLL_TUNED_RULES_FILE_MAGIC, COLL_TUNED_RULES_FILE_VERSION,
+                                         2, coll_tuned_rules_file_record_size, sections, count);
+    free(coms);
+    free(msgs);
+    return rc;
+}
+
 /**
  * Reads a rule file called fname
  *
  * In Open MPI 6.0 we introduced json-based rule file, but we continue to read
  * the original format for now.
  *
- * This funtion attempts a json read, and if it fails, falls back to classic
- * read.  If both fail, we fall back to fixed rules.
+ * This funtion first checks for a binary rules file (written by
+ * ompi_coll_tuned_write_rules_binary_file), then attempts a json read, and if
+ * it fails, falls back to classic read.  If all fail, we fall back to fixed
+ * rules.
  *
  * Errors will be entirely hidden from the user unless coll_base_verbose is set
  * to at least 1.
@@ -701,24 +858,38 @@ int ompi_coll_tuned_read_rules_config_file (char *fname, ompi_coll_alg_rule_t**
     }
 
     const opal_json_t *json;
-    opal_output_verbose(1, ompi_coll_tuned_stream, "Attempting to read tuned rules as JSON...\n");
-    int ret = opal_json_load_file(fname, &json, 0);
-    if (ret == OPAL_SUCCESS) {
-        ret = ompi_coll_tuned_read_rules_json(json, rules);
-        opal_json_free(&json);
-        if (ret != OPAL_SUCCESS) {
-            opal_output_verbose(1, ompi_coll_tuned_stream,
-                "ERROR: %s is valid json, but there were errors reading the rules from the file. "
-                "Falling back to default tuning and ignoring the file.\n", fname);
-        }
-    } else {
-        opal_output_verbose(1, ompi_coll_tuned_stream, "Failed to parse %s as valid json.  Assuming classic format.\n",fname);
-        ret = ompi_coll_tuned_read_rules_config_file_classic(fname, rules);
-        if (ret != OPAL_SUCCESS) {
-            opal_output_verbose(1, ompi_coll_tuned_stream, "Failed to load %s in either json or classic readers.  Check format.\n",fname);
+    int ret = ompi_coll_tuned_read_rules_binary(fname, rules);
+    if (OMPI_ERR_BAD_PARAM == ret) {
+        opal_output_verbose(1, ompi_coll_tuned_stream,
+            "ERROR: %s is a binary rules file, but it is corrupted or was written by a different "
+            "build or architecture. Falling back to default tuning and ignoring the file.\n", fname);
+        return OPAL_ERROR;
+    }
+
+    if (ret != OMPI_SUCCESS) {
+        opal_output_verbose(1, ompi_coll_tuned_stream, "Attempting to read tuned rules as JSON...\n");
+        ret = opal_json_load_file(fname, &json, 0);
+        if (ret == OPAL_SUCCESS) {
+            ret = ompi_coll_tuned_read_rules_json(json, rules);
+            opal_json_free(&json);
+            if (ret != OPAL_SUCCESS) {
+                opal_output_verbose(1, ompi_coll_tuned_stream,
+                    "ERROR: %s is valid json, but there were errors reading the rules from the file. "
+                    "Falling back to default tuning and ignoring the file.\n", fname);
+            }
+        } else {
+            opal_output_verbose(1, ompi_coll_tuned_stream, "Failed to parse %s as valid json.  Assuming classic format.\n",fname);
+            ret = ompi_coll_tuned_read_rules_config_file_classic(fname, rules);
+            if (ret != OPAL_SUCCESS) {
+                opal_output_verbose(1, ompi_coll_tuned_stream, "Failed to load %s in either json or classic readers.  Check format.\n",fname);
+            }
         }
     }
 
+    if (ret == OPAL_SUCCESS) {
+        ompi_coll_tuned_check_sorted_rules(*rules);
+    }
+
     if (ret == OPAL_SUCCESS && opal_output_check_verbosity( 2, ompi_coll_tuned_stream)) {
         opal_output_verbose( 2, ompi_coll_tuned_stream, "Dumping rules:\n");
         ompi_coll_tuned_dump_all_rules(*rules);
@@ -30,6 +30,7 @@
 BEGIN_C_DECLS
 
 int ompi_coll_tuned_read_rules_config_file (char *fname, ompi_coll_alg_rule_t** rules);
+int ompi_coll_tuned_write_rules_binary_file (const char *fname, ompi_coll_alg_rule_t* rules);
 
 
 END_C_DECLS
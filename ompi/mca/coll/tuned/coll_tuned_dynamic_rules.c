@@ -230,8 +230,11 @@ int ompi_coll_tuned_free_msg_rules_in_com_rule (ompi_coll_com_rule_t* com_p)
             rc = -1; /* some error */
         }
         else {
-            /* ok, memory exists for the msg rules so free that first */
-            free (com_p->msg_rules);
+            /* ok, memory exists for the msg rules so free that first,
+             * unless it belongs to a mapped binary rules file */
+            if (!com_p->msg_rules_mapped) {
+                free (com_p->msg_rules);
+            }
             com_p->msg_rules = (ompi_coll_msg_rule_t*) NULL;
         }
 
@@ -289,6 +292,34 @@ int ompi_coll_tuned_free_all_rules (ompi_coll_alg_rule_t* alg_p)
     return (rc);
 }
 
+/*
+ * The message rules of a com rule are usually disjoint ranges given in
+ * increasing order (the classic format always builds them that way). The
+ * first matching rule is then the last one starting at or below the message
+ * size, which can be found with a binary search instead of walking the list.
+ */
+void ompi_coll_tuned_check_sorted_rules (ompi_coll_alg_rule_t* alg_p)
+{
+    ompi_coll_com_rule_t* com_p;
+    ompi_coll_msg_rule_t* msg_p;
+    int i, j, k;
+
+    for (i = 0; i < COLLCOUNT; i++) {
+        for (j = 0; j < alg_p[i].n_com_sizes; j++) {
+            com_p = &alg_p[i].com_rules[j];
+            msg_p = com_p->msg_rules;
+            com_p->msg_rules_sorted = (com_p->n_rules > 0);
+            for (k = 0; k < com_p->n_rules; k++) {
+                if (msg_p[k].msg_size_min > msg_p[k].msg_size_max ||
+                    (k > 0 && msg_p[k].msg_size_min <= msg_p[k-1].msg_size_max)) {
+                    com_p->msg_rules_sorted = false;
+                    break;
+                }
+            }
+        }
+    }
+}
+
 /*
  * query functions
  * i.e. the functions that get me the algorithm, topo fanin/out and segment size fast
@@ -395,13 +426,32 @@ int ompi_coll_tuned_get_target_method_params (ompi_coll_com_rule_t* base_com_rul
         return (0);
     }
 
-    /* search for the first comm rule that matches */
-    for(i=0; i<base_com_rule->n_rules; i++) {
-        msg_p = &base_com_rule->msg_rules[i];
-        if (msg_p->msg_size_min <= mpi_msgsize &&
-                                   mpi_msgsize <= msg_p->msg_size_max ) {
+    if (base_com_rule->msg_rules_sorted) {
+        /* find the last rule starting at or below the message size */
+        int lo = 0, hi = base_com_rule->n_rules - 1, mid;
+        i = -1;
+        while (lo <= hi) {
+            mid = lo + (hi - lo) / 2;
+            if (base_com_rule->msg_rules[mid].msg_size_min <= mpi_msgsize) {
+                i = mid;
+                lo = mid + 1;
+            } else {
+                hi = mid - 1;
+            }
+        }
+        msg_p = &base_com_rule->msg_rules[(i < 0) ? 0 : i];
+        if (i >= 0 && mpi_msgsize <= msg_p->msg_size_max) {
             best_msg_p = msg_p;
-            break;
+        }
+    } else {
+        /* search for the first comm rule that matches */
+        for(i=0; i<base_com_rule->n_rules; i++) {
+            msg_p = &base_com_rule->msg_rules[i];
+            if (msg_p->msg_size_min <= mpi_msgsize &&
+                                       mpi_msgsize <= msg_p->msg_size_max ) {
+                best_msg_p = msg_p;
+                break;
+            }
         }
     }
 
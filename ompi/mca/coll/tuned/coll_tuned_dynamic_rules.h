@@ -73,6 +73,8 @@ typedef struct com_rule_s {
     /* RULE */
     int n_rules;
     ompi_coll_msg_rule_t *msg_rules;
+    bool msg_rules_mapped;   /* msg_rules points into a mapped binary rules file */
+    bool msg_rules_sorted;   /* msg_rules are disjoint and sorted, use a binary search */
 
 }  ompi_coll_com_rule_t;
 
@@ -94,6 +96,9 @@ ompi_coll_alg_rule_t* ompi_coll_tuned_mk_alg_rules (int n_alg);
 ompi_coll_com_rule_t* ompi_coll_tuned_mk_com_rules (int n_com_rules, int coll_id);
 ompi_coll_msg_rule_t* ompi_coll_tuned_mk_msg_rules (int n_msg_rules, int coll_id, int mpi_comsize);
 
+/* flag the com rules whose message rules can be binary searched */
+void ompi_coll_tuned_check_sorted_rules (ompi_coll_alg_rule_t* alg_p);
+
 /* debugging support */
 int ompi_coll_tuned_dump_msg_rule (ompi_coll_msg_rule_t* msg_p);
 int ompi_coll_tuned_dump_com_rule (ompi_coll_com_rule_t* com_p);
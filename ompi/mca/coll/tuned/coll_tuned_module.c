@@ -182,6 +182,10 @@ ompi_coll_tuned_forced_getvalues( enum COLLTYPE type,
         if( 0 != (TMOD)->user_forced[(TYPE)].algorithm ) {              \
             need_dynamic_decision = 1;                                  \
         }                                                               \
+        if( ompi_coll_tuned_autotune &&                                 \
+            ompi_coll_tuned_autotune_supported(TYPE) ) {                \
+            need_dynamic_decision = 1;                                  \
+        }                                                               \
         if( NULL != mca_coll_tuned_component.all_base_rules ) {         \
             (TMOD)->com_rules[(TYPE)]                                   \
                 = ompi_coll_tuned_get_com_rule_ptr( mca_coll_tuned_component.all_base_rules, \
@@ -226,7 +230,7 @@ tuned_module_enable( mca_coll_base_module_t *module,
         return OMPI_ERROR;
     }
 
-    if (ompi_coll_tuned_use_dynamic_rules) {
+    if (ompi_coll_tuned_use_dynamic_rules || ompi_coll_tuned_autotune) {
         OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream, "coll:tuned:module_init MCW & Dynamic"));
 
         /**
@@ -42,6 +42,7 @@ static const mca_base_var_enum_value_t reduce_scatter_block_algorithms[] = {
     {2, "recursive_doubling"},
     {3, "recursive_halving"},
     {4, "butterfly"},
+    {5, "radix_k"},
     {0, NULL}
 };
 
@@ -82,7 +83,7 @@ int ompi_coll_tuned_reduce_scatter_block_intra_check_forced_init (coll_tuned_for
                                         "reduce_scatter_block_algorithm",
                                         "Which reduce reduce_scatter_block algorithm is used. "
                                         "Can be locked down to choice of: 0 ignore, 1 basic_linear, 2 recursive_doubling, "
-                                        "3 recursive_halving, 4 butterfly. "
+                                        "3 recursive_halving, 4 butterfly, 5 radix_k (radix given by the tree fanout). "
                                         "Only relevant if coll_tuned_use_dynamic_rules is true.",
                                         MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
                                         OPAL_INFO_LVL_5,
@@ -140,6 +141,8 @@ int ompi_coll_tuned_reduce_scatter_block_intra_do_this(const void *sbuf, void *r
                                                                                 dtype, op, comm, module);
     case (4): return ompi_coll_base_reduce_scatter_block_intra_butterfly(sbuf, rbuf, rcount, dtype, op, comm,
                                                                          module);
+    case (5): return ompi_coll_base_reduce_scatter_block_intra_radix_k(sbuf, rbuf, rcount, dtype, op, comm,
+                                                                       module, faninout);
     } /* switch */
     OPAL_OUTPUT_VERBOSE((COLL_TUNED_TRACING_VERBOSE, ompi_coll_tuned_stream,
         "coll:tuned:reduce_scatter_block_intra_do_this attempt to select algorithm %d when only 0-%d is valid?",
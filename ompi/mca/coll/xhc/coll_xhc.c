@@ -27,7 +27,7 @@
 
 // ------------------------------------------------
 
-static int xhc_alloc_bcast_cico(xhc_module_t *module,
+static int xhc_alloc_cico(xhc_module_t *module,
     ompi_communicator_t *comm);
 
 static int xhc_print_config_info(xhc_module_t *module,
@@ -132,8 +132,9 @@ int mca_coll_xhc_init_op(xhc_module_t *module,
     data->colltype = colltype;
     data->seq = 0;
 
-    if(XHC_BCAST == colltype) {
-        err = xhc_alloc_bcast_cico(module, comm);
+    if(XHC_BCAST == colltype || XHC_ALLGATHER == colltype
+            || XHC_GATHER == colltype || XHC_SCATTER == colltype) {
+        err = xhc_alloc_cico(module, comm);
         if(OMPI_SUCCESS != err) {RETURN_WITH_ERROR(return_code, err, end);}
     }
 
@@ -216,7 +217,10 @@ int mca_coll_xhc_init_op(xhc_module_t *module,
     return return_code;
 }
 
-static int xhc_alloc_bcast_cico(xhc_module_t *module, ompi_communicator_t *comm) {
+/* The per-rank CICO buffer is shared by all primitives that use it, and is
+ * sized for the largest of their CICO thresholds. It's allocated when the
+ * first one of them is initialized (all ranks do this collectively). */
+static int xhc_alloc_cico(xhc_module_t *module, ompi_communicator_t *comm) {
     opal_shmem_ds_t *ds_list = NULL;
     opal_shmem_ds_t cico_ds;
     void *cico_buffer = NULL;
@@ -227,7 +231,18 @@ static int xhc_alloc_bcast_cico(xhc_module_t *module, ompi_communicator_t *comm)
     int comm_size = ompi_comm_size(comm);
     int rank = ompi_comm_rank(comm);
 
-    size_t cico_size = module->op_config[XHC_BCAST].cico_max;
+    const XHC_COLLTYPE_T cico_ops[] = {XHC_BCAST,
+        XHC_ALLGATHER, XHC_GATHER, XHC_SCATTER};
+
+    size_t cico_size = 0;
+
+    if(NULL != module->peer_info[rank].cico_buffer) {
+        return OMPI_SUCCESS;
+    }
+
+    for(size_t i = 0; i < sizeof(cico_ops)/sizeof(cico_ops[0]); i++) {
+        cico_size = opal_max(cico_size, module->op_config[cico_ops[i]].cico_max);
+    }
 
     if(0 == cico_size) {
         return OMPI_SUCCESS;
@@ -317,6 +332,7 @@ void mca_coll_xhc_fini(mca_coll_xhc_module_t *module) {
     }
 
     free(module->rbuf);
+    free(module->stage_buf);
 }
 
 // ------------------------------------------------
@@ -449,7 +465,7 @@ int mca_coll_xhc_read_op_config(xhc_module_t *module,
 
     /* Enforce a resonable minimum chunk size */
 
-    if(XHC_BARRIER != colltype) {
+    if(xhc_colltype_is_chunked(colltype)) {
         bool altered_chunks = false;
         for(int i = 0; i < config->chunks_len; i++) {
             if(config->chunks[i] < XHC_MIN_CHUNK_SIZE) {
@@ -536,6 +552,14 @@ static int xhc_print_config_info(xhc_module_t *module, ompi_communicator_t *comm
                 "    Hierarchy: %s (source: %s)\n",
                 xhc_colltype_to_str(t),
                 config->hierarchy_string, xhc_config_source_to_str(config->hierarchy_source));
+        } else if(!xhc_colltype_is_chunked(t)) {
+            printf("\n"
+                "  [%s]\n"
+                "    Hierarchy: %s (source: %s)\n"
+                "    CICO: Up to %zu bytes (source: %s)\n",
+                xhc_colltype_to_str(t),
+                config->hierarchy_string, xhc_config_source_to_str(config->hierarchy_source),
+                config->cico_max, xhc_config_source_to_str(config->cico_max_source));
         } else {
             printf("\n"
                 "  [%s]\n"
@@ -592,6 +616,11 @@ static int xhc_print_op_info(xhc_module_t *module,
             printf("XHC_COMM ompi_comm=%s rank=%d op=%s loc=0x%08x members=%d [%s]\n",
                 comm->c_name, rank, xhc_colltype_to_str(colltype), comms[i].locality,
                 comms[i].size, memb_list);
+        } else if(!xhc_colltype_is_chunked(colltype)) {
+            printf("XHC_COMM ompi_comm=%s rank=%d op=%s loc=0x%08x "
+                "cico_size=%zu members=%d [%s]\n", comm->c_name, rank,
+                xhc_colltype_to_str(colltype), comms[i].locality,
+                comms[i].cico_size, comms[i].size, memb_list);
         } else {
             printf("XHC_COMM ompi_comm=%s rank=%d op=%s loc=0x%08x chunk_size=%zu "
                 "cico_size=%zu members=%d [%s]\n", comm->c_name, rank,
@@ -653,6 +682,10 @@ static int xhc_print_op_hierarchy_dot(xhc_module_t *module,
                 dir = "back"; break;
             case XHC_BARRIER:
                 dir = "both"; break;
+            case XHC_SCATTER:
+                dir = "forward"; break;
+            case XHC_ALLGATHER: case XHC_GATHER:
+                dir = "back"; break;
             default:
                 dir = "none";
         }
@@ -792,6 +825,21 @@ int mca_coll_xhc_copy_from(xhc_peer_info_t *peer_info,
     return (OPAL_SUCCESS == status ? 0 : -1);
 }
 
+int mca_coll_xhc_copy_to(xhc_peer_info_t *peer_info,
+        void *src, void *dst, size_t size, void *access_token) {
+
+    mca_smsc_endpoint_t *smsc_ep = xhc_smsc_ep(peer_info);
+
+    if(NULL == smsc_ep) {
+        return -1;
+    }
+
+    int status = MCA_SMSC_CALL(copy_to, smsc_ep,
+        src, dst, size, access_token);
+
+    return (OPAL_SUCCESS == status ? 0 : -1);
+}
+
 void mca_coll_xhc_copy_close_region(xhc_copy_data_t *region_data) {
     if(mca_smsc_base_has_feature(MCA_SMSC_FEATURE_REQUIRE_REGISTRATION)) {
         MCA_SMSC_CALL(deregister_region, region_data);
@@ -27,8 +27,11 @@
 #include "ompi/communicator/communicator.h"
 #include "ompi/datatype/ompi_datatype.h"
 #include "ompi/op/op.h"
+#include "ompi/request/request.h"
 
 #include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_list.h"
+#include "opal/mca/threads/mutex.h"
 #include "opal/mca/shmem/shmem.h"
 #include "opal/mca/smsc/smsc.h"
 #include "opal/util/minmax.h"
@@ -61,6 +64,13 @@
         (module)->prev_colls.coll_module[colltype]; \
 } while(0)
 
+#define XHC_INSTALL_NB_FALLBACK(module, comm, nb_colltype, op) do { \
+    (comm)->c_coll->coll_ ## op = (mca_coll_base_module_ ## op ## _fn_t) \
+        (module)->prev_nb_colls.coll_fn[nb_colltype]; \
+    (comm)->c_coll->coll_ ## op ## _module = (mca_coll_base_module_t *) \
+        (module)->prev_nb_colls.coll_module[nb_colltype]; \
+} while(0)
+
 #define WARN_ONCE(...) do { \
     static bool warn_shown = false; \
     if(!warn_shown) { \
@@ -112,12 +122,15 @@ typedef struct mca_coll_xhc_module_t mca_coll_xhc_module_t;
 typedef struct mca_coll_xhc_module_t xhc_module_t;
 
 typedef struct xhc_coll_fns_t xhc_coll_fns_t;
+typedef struct xhc_nb_coll_fns_t xhc_nb_coll_fns_t;
 typedef struct xhc_peer_info_t xhc_peer_info_t;
 
 typedef struct xhc_op_mca_t xhc_op_mca_t;
 typedef struct xhc_op_config_t xhc_op_config_t;
 typedef struct xhc_op_data_t xhc_op_data_t;
 
+typedef struct xhc_request_t xhc_request_t;
+
 typedef struct xhc_comm_t xhc_comm_t;
 typedef struct xhc_comm_ctrl_t xhc_comm_ctrl_t;
 typedef struct xhc_member_ctrl_t xhc_member_ctrl_t;
@@ -168,16 +181,32 @@ typedef enum xhc_reduce_load_balance_enum_t {
  * 1. xhc_colltype_to_universal_map[]
  * 2. xhc_colltype_to_c_coll_fn_offset_map[]
  * 3. xhc_colltype_to_c_coll_module_offset_map[]
- * 4. xhc_colltype_to_coll_base_fn_offset_map[] */
+ * 4. xhc_colltype_to_coll_base_fn_offset_map[]
+ * 5. op_mca_default[] */
 typedef enum XHC_COLLTYPE_T {
     XHC_BCAST = 0,
     XHC_BARRIER,
     XHC_REDUCE,
     XHC_ALLREDUCE,
+    XHC_ALLGATHER,
+    XHC_GATHER,
+    XHC_SCATTER,
 
     XHC_COLLCOUNT
 } XHC_COLLTYPE_T;
 
+/* Nonblocking and persistent variants. These share the configuration and
+ * the state of their blocking counterpart (e.g. XHC_IBCAST -> XHC_BCAST);
+ * only their fallback pointers are kept separately (prev_nb_colls). */
+typedef enum XHC_NB_COLLTYPE_T {
+    XHC_IBCAST = 0,
+    XHC_IALLREDUCE,
+    XHC_BCAST_INIT,
+    XHC_ALLREDUCE_INIT,
+
+    XHC_NB_COLLCOUNT
+} XHC_NB_COLLTYPE_T;
+
 typedef enum xhc_config_source_t {
     XHC_CONFIG_SOURCE_INFO_GLOBAL = 0,
     XHC_CONFIG_SOURCE_INFO_OP,
@@ -225,6 +254,13 @@ struct mca_coll_xhc_component_t {
     } op_mca[XHC_COLLCOUNT];
 
     xhc_op_mca_t op_mca_global;
+
+    // started nonblocking/persistent requests, of all modules
+    opal_list_t active_requests;
+    opal_mutex_t lock;
+    bool in_progress;
+
+    opal_atomic_int32_t active_comms;
 };
 
 struct mca_coll_xhc_module_t {
@@ -237,6 +273,11 @@ struct mca_coll_xhc_module_t {
         void *coll_module[XHC_COLLCOUNT];
     } prev_colls;
 
+    struct xhc_nb_coll_fns_t {
+        void (*coll_fn[XHC_NB_COLLCOUNT])(void);
+        void *coll_module[XHC_NB_COLLCOUNT];
+    } prev_nb_colls;
+
     // copied from OMPI comm
     int comm_size;
     int rank;
@@ -246,10 +287,18 @@ struct mca_coll_xhc_module_t {
     bool zcopy_support;
     bool zcopy_map_support;
 
+    /* Single-copy (all)reduce without CAN_MAP, through copy_from/copy_to.
+     * Requires an smsc module without mandatory registration (e.g. CMA). */
+    bool zcopy_reduce_support;
+
     // temporary (private) internal buffer, for methods like Reduce
     void *rbuf;
     size_t rbuf_size;
 
+    // staging space for reductions on peers' data in XHC_COPY_SMSC_NO_MAP
+    void *stage_buf;
+    size_t stage_buf_size;
+
     // book-keeping for info on other ranks
     struct xhc_peer_info_t {
         xhc_loc_t locality;
@@ -291,6 +340,11 @@ struct mca_coll_xhc_module_t {
         bool init;
     } op_data[XHC_COLLCOUNT];
 
+    // nonblocking/persistent requests started and not yet completed
+    xhc_request_t *nb_current;
+    int nb_pending;
+    bool nb_registered;
+
     bool init;
     bool error;
 };
@@ -367,6 +421,11 @@ struct xhc_comm_t {
         xhc_reg_t *sbuf_reg, *rbuf_reg;
         void *sbuf, *rbuf;
         bool attach, join;
+
+        /* In XHC_COPY_SMSC_NO_MAP, sbuf/rbuf may be addresses in the
+         * member's address space, to be accessed through peer. */
+        xhc_peer_info_t *peer;
+        bool sbuf_remote, rbuf_remote;
     } *member_info;
 
     xhc_member_info_t *my_info; // = &member_info[my_id]
@@ -505,8 +564,71 @@ typedef struct xhc_bcast_ctx_t {
     size_t bytes_total;
     size_t bytes_avail;
     size_t bytes_done;
+
+    // non-blocking progress state
+    bool started;
+    bool self_acked;
+    xhc_comm_t *ack_comm;
 } xhc_bcast_ctx_t;
 
+typedef struct xhc_allreduce_ctx_t {
+    const void *sbuf;
+    void *rbuf;
+    size_t count;
+    ompi_datatype_t *datatype;
+    ompi_op_t *op;
+    ompi_communicator_t *ompi_comm;
+    xhc_module_t *module;
+
+    int rank;
+
+    xf_sig_t seq;
+    xhc_comm_t *comms;
+
+    xhc_copy_method_t method;
+    bool out_of_order_reduce;
+
+    size_t dtype_size;
+    size_t bytes_total;
+    size_t bytes_done;
+
+    xhc_bcast_ctx_t bcast_ctx;
+
+    bool self_acked;
+} xhc_allreduce_ctx_t;
+
+/* Nonblocking and persistent xhc operations. Since all ops on a
+ * communicator share the same control structures, they are executed
+ * one at a time per module, in the order they were started. */
+struct xhc_request_t {
+    ompi_request_t super;
+
+    xhc_module_t *module;
+
+    /* Invoked when the request reaches the head of the module's queue,
+     * and then repeatedly until it stops returning OMPI_ERR_WOULD_BLOCK */
+    int (*begin)(struct xhc_request_t *req);
+    int (*progress)(struct xhc_request_t *req);
+
+    struct {
+        const void *sbuf;
+        void *buf;
+        size_t count;
+        ompi_datatype_t *datatype;
+        ompi_op_t *op;
+        int root;
+    } args;
+
+    union {
+        xhc_bcast_ctx_t bcast;
+        xhc_allreduce_ctx_t allreduce;
+    } ctx;
+
+    bool begun;
+};
+
+OBJ_CLASS_DECLARATION(xhc_request_t);
+
 // ----------------------------------------
 
 // coll_xhc_component.c
@@ -574,6 +696,7 @@ void mca_coll_xhc_module_set_coll_fns(ompi_communicator_t *comm,
 #define xhc_copy_expose_region(...) mca_coll_xhc_copy_expose_region(__VA_ARGS__)
 #define xhc_copy_region_post(...) mca_coll_xhc_copy_region_post(__VA_ARGS__)
 #define xhc_copy_from(...) mca_coll_xhc_copy_from(__VA_ARGS__)
+#define xhc_copy_to(...) mca_coll_xhc_copy_to(__VA_ARGS__)
 #define xhc_copy_close_region(...) mca_coll_xhc_copy_close_region(__VA_ARGS__)
 
 #define xhc_get_registration(...) mca_coll_xhc_get_registration(__VA_ARGS__)
@@ -598,6 +721,8 @@ int mca_coll_xhc_copy_expose_region(void *base, size_t len,
 void mca_coll_xhc_copy_region_post(void *dst, xhc_copy_data_t *region_data);
 int mca_coll_xhc_copy_from(xhc_peer_info_t *peer_info, void *dst,
     void *src, size_t size, void *access_token);
+int mca_coll_xhc_copy_to(xhc_peer_info_t *peer_info, void *src,
+    void *dst, size_t size, void *access_token);
 void mca_coll_xhc_copy_close_region(xhc_copy_data_t *region_data);
 
 void *mca_coll_xhc_get_registration(xhc_peer_info_t *peer_info,
@@ -641,6 +766,40 @@ int mca_coll_xhc_allreduce(const void *sbuf, void *rbuf,
     size_t count, ompi_datatype_t *datatype, ompi_op_t *op,
     ompi_communicator_t *comm, mca_coll_base_module_t *module);
 
+int mca_coll_xhc_ibcast(void *buf, size_t count, ompi_datatype_t *datatype,
+    int root, ompi_communicator_t *comm, ompi_request_t **request,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_iallreduce(const void *sbuf, void *rbuf,
+    size_t count, ompi_datatype_t *datatype, ompi_op_t *op,
+    ompi_communicator_t *comm, ompi_request_t **request,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_bcast_persistent_init(void *buf, size_t count,
+    ompi_datatype_t *datatype, int root, ompi_communicator_t *comm,
+    ompi_info_t *info, ompi_request_t **request,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_allreduce_persistent_init(const void *sbuf, void *rbuf,
+    size_t count, ompi_datatype_t *datatype, ompi_op_t *op,
+    ompi_communicator_t *comm, ompi_info_t *info, ompi_request_t **request,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_allgather(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+    ompi_datatype_t *rdtype, ompi_communicator_t *comm,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_gather(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+    ompi_datatype_t *rdtype, int root, ompi_communicator_t *comm,
+    mca_coll_base_module_t *module);
+
+int mca_coll_xhc_scatter(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+    ompi_datatype_t *rdtype, int root, ompi_communicator_t *comm,
+    mca_coll_base_module_t *module);
+
 // coll_xhc_bcast.c
 // ----------------
 
@@ -649,6 +808,7 @@ int mca_coll_xhc_allreduce(const void *sbuf, void *rbuf,
 #define xhc_bcast_start(...) mca_coll_xhc_bcast_start(__VA_ARGS__)
 #define xhc_bcast_work(...) mca_coll_xhc_bcast_work(__VA_ARGS__)
 #define xhc_bcast_ack(...) mca_coll_xhc_bcast_ack(__VA_ARGS__)
+#define xhc_bcast_ack_test(...) mca_coll_xhc_bcast_ack_test(__VA_ARGS__)
 #define xhc_bcast_fini(...) mca_coll_xhc_bcast_fini(__VA_ARGS__)
 
 void mca_coll_xhc_bcast_notify(xhc_bcast_ctx_t *ctx,
@@ -661,19 +821,63 @@ int mca_coll_xhc_bcast_init(void *buf, size_t count, ompi_datatype_t *datatype,
 int mca_coll_xhc_bcast_start(xhc_bcast_ctx_t *ctx);
 int mca_coll_xhc_bcast_work(xhc_bcast_ctx_t *ctx);
 void mca_coll_xhc_bcast_ack(xhc_bcast_ctx_t *ctx);
+int mca_coll_xhc_bcast_ack_test(xhc_bcast_ctx_t *ctx);
 void mca_coll_xhc_bcast_fini(xhc_bcast_ctx_t *ctx);
 
 // coll_xhc_allreduce.c
 // --------------------
 
 #define xhc_allreduce_internal(...) mca_coll_xhc_allreduce_internal(__VA_ARGS__)
+#define xhc_allreduce_init(...) mca_coll_xhc_allreduce_init(__VA_ARGS__)
+#define xhc_allreduce_progress(...) mca_coll_xhc_allreduce_progress(__VA_ARGS__)
+#define xhc_allreduce_ack_test(...) mca_coll_xhc_allreduce_ack_test(__VA_ARGS__)
+#define xhc_allreduce_fini(...) mca_coll_xhc_allreduce_fini(__VA_ARGS__)
 
 int mca_coll_xhc_allreduce_internal(const void *sbuf, void *rbuf, size_t count,
     ompi_datatype_t *datatype, ompi_op_t *op, ompi_communicator_t *ompi_comm,
     mca_coll_base_module_t *module, bool require_bcast);
 
+int mca_coll_xhc_allreduce_init(const void *sbuf, void *rbuf, size_t count,
+    ompi_datatype_t *datatype, ompi_op_t *op, ompi_communicator_t *ompi_comm,
+    xhc_module_t *module, xhc_allreduce_ctx_t *ctx_dst);
+
+int mca_coll_xhc_allreduce_progress(xhc_allreduce_ctx_t *ctx);
+int mca_coll_xhc_allreduce_ack_test(xhc_allreduce_ctx_t *ctx);
+void mca_coll_xhc_allreduce_fini(xhc_allreduce_ctx_t *ctx);
+
+// coll_xhc_request.c
+// ------------------
+
+#define xhc_request_new(...) mca_coll_xhc_request_new(__VA_ARGS__)
+#define xhc_request_post(...) mca_coll_xhc_request_post(__VA_ARGS__)
+#define xhc_request_drain(...) mca_coll_xhc_request_drain(__VA_ARGS__)
+#define xhc_progress(...) mca_coll_xhc_progress(__VA_ARGS__)
+
+xhc_request_t *mca_coll_xhc_request_new(xhc_module_t *module,
+    ompi_communicator_t *comm, bool persistent);
+int mca_coll_xhc_request_post(xhc_request_t *req);
+void mca_coll_xhc_request_drain(xhc_module_t *module);
+int mca_coll_xhc_progress(void);
+
+// coll_xhc_gather.c
+// -----------------
+
+#define xhc_gather_internal(...) mca_coll_xhc_gather_internal(__VA_ARGS__)
+
+int mca_coll_xhc_gather_internal(const void *sbuf, size_t scount,
+    ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+    ompi_datatype_t *rdtype, int root, ompi_communicator_t *ompi_comm,
+    mca_coll_base_module_t *ompi_module, XHC_COLLTYPE_T colltype);
+
 // ----------------------------------------
 
+/* Whether the primitive pipelines its data in chunks. The rest of them
+ * don't make use of the chunk size configuration. */
+static inline bool xhc_colltype_is_chunked(XHC_COLLTYPE_T colltype) {
+    return (XHC_BCAST == colltype || XHC_REDUCE == colltype
+        || XHC_ALLREDUCE == colltype);
+}
+
 /* Rollover-safe check that _flag_ has reached _thresh_,
  * without having exceeded it by more than _win_. */
 static inline bool CHECK_FLAG(volatile xf_sig_t *flag,
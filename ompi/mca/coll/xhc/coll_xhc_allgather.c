@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2021-2024 Computer Architecture and VLSI Systems (CARV)
+ *                         Laboratory, ICS Forth. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+
+#include "coll_xhc.h"
+
+/* Implemented as a gather to rank 0 (see coll_xhc_gather.c),
+ * followed by an xhc broadcast of the whole receive buffer. */
+int mca_coll_xhc_allgather(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+        ompi_datatype_t *rdtype, ompi_communicator_t *ompi_comm,
+        mca_coll_base_module_t *ompi_module) {
+
+    return xhc_gather_internal(sbuf, scount, sdtype, rbuf, rcount,
+        rdtype, 0, ompi_comm, ompi_module, XHC_ALLGATHER);
+}
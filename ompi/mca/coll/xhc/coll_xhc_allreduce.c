@@ -333,7 +333,7 @@ static int xhc_allreduce_init_member(xhc_comm_t *xc, xhc_peer_info_t *peer_info,
         xc->my_ctrl->rank = rank;
         xc->my_ctrl->is_leader = (xc->is_leader);
 
-        if(XHC_COPY_SMSC == method) {
+        if(XHC_COPY_SMSC == method || XHC_COPY_SMSC_NO_MAP == method) {
             xc->my_ctrl->sbuf_vaddr = (xc->is_bottom ? sbuf : rbuf);
             xc->my_ctrl->rbuf_vaddr = (xc->is_leader ? rbuf : NULL);
         }
@@ -371,6 +371,7 @@ static int xhc_allreduce_init_member(xhc_comm_t *xc, xhc_peer_info_t *peer_info,
             break;
 
         case XHC_COPY_SMSC:
+        case XHC_COPY_SMSC_NO_MAP:
             xc->my_info->sbuf = (xc->is_bottom ? sbuf : rbuf);
             xc->my_info->rbuf = rbuf;
 
@@ -458,6 +459,21 @@ static int xhc_allreduce_attach_member(xhc_comm_t *xc, int member,
             break;
         }
 
+        /* The member's buffers are not mapped; keep their addresses,
+         * and access them with copy_from/copy_to in do_reduce(). */
+        case XHC_COPY_SMSC_NO_MAP:
+            m_info->peer = &peer_info[m_ctrl->rank];
+
+            m_info->sbuf = m_ctrl->sbuf_vaddr;
+            m_info->sbuf_remote = true;
+
+            if(m_ctrl->is_leader && !m_info->rbuf) {
+                m_info->rbuf = m_ctrl->rbuf_vaddr;
+                m_info->rbuf_remote = true;
+            }
+
+            break;
+
         default:
             assert(0);
     }
@@ -580,9 +596,7 @@ static void xhc_allreduce_disconnect_peers(xhc_comm_t *comms) {
 
 // -----------------------------
 
-static void xhc_allreduce_ack(xhc_comm_t *comms,
-        xf_sig_t seq, xhc_bcast_ctx_t *bcast_ctx) {
-
+static void xhc_allreduce_ack_self(xhc_comm_t *comms, xf_sig_t seq) {
     // Set personal ack(s), in the (all)reduce hierarchy
     for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
         xc->my_ctrl->ack = seq;
@@ -594,6 +608,19 @@ static void xhc_allreduce_ack(xhc_comm_t *comms,
         xhc_prefetchw((void *) &xc->comm_ctrl->ack,
             sizeof(xc->comm_ctrl->ack), 1);
     }
+}
+
+static void xhc_allreduce_ack_comm(xhc_comm_t *comms, xf_sig_t seq) {
+    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+        if(!xc->is_leader) {break;}
+        xc->comm_ctrl->ack = seq;
+    }
+}
+
+static void xhc_allreduce_ack(xhc_comm_t *comms,
+        xf_sig_t seq, xhc_bcast_ctx_t *bcast_ctx) {
+
+    xhc_allreduce_ack_self(comms, seq);
 
     /* Do the ACK process for the broadcast operation. This is necessary
      * in order to appropriately set of the fields in the bcast hierarchy.
@@ -607,10 +634,7 @@ static void xhc_allreduce_ack(xhc_comm_t *comms,
      * finished the collective. No need to check their member ack fields.
      * Set ack appropriately. */
 
-    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
-        if(!xc->is_leader) {break;}
-        xc->comm_ctrl->ack = seq;
-    }
+    xhc_allreduce_ack_comm(comms, seq);
 
     /* Note that relying on bcast's ack procedure like above, means that
      * comm ack will be set only after the prodedure has finished on ALL
@@ -640,7 +664,8 @@ static void xhc_reduce_ack(xhc_comm_t *comms,
          * application is free to modify it). In CICO mode, we have increased
          * control over our internal buffer(s), and members are allowed to exit
          * even before all reductions have been completed. */
-        if(!xc->is_leader && XHC_COPY_SMSC == method) {
+        if(!xc->is_leader && (XHC_COPY_SMSC == method
+                || XHC_COPY_SMSC_NO_MAP == method)) {
             WAIT_FLAG(&xc->comm_ctrl->ack, seq, 0);
         }
 
@@ -765,9 +790,81 @@ static int xhc_allreduce_reduce_get_next(xhc_comm_t *xc, xhc_peer_info_t *peer_i
     return OMPI_SUCCESS;
 }
 
-static void xhc_allreduce_do_reduce(xhc_comm_t *xc, xhc_rq_item_t *member_item,
-        void *tmp_rbuf, size_t allreduce_count, ompi_datatype_t *dtype,
-        size_t dtype_size, ompi_op_t *op, xhc_copy_method_t method) {
+/* XHC_COPY_SMSC_NO_MAP counterpart of the reduction in do_reduce(). The
+ * member's data (and the leader's rbuf, on the last reduction) live in other
+ * address spaces; bring them in the staging buffer through copy_from(),
+ * reduce locally, and deliver the result with copy_to(). Since pointers in
+ * different address spaces can't be compared, aliasing is determined by
+ * the owner of each buffer, in addition to its address. */
+static int xhc_allreduce_reduce_no_map(xhc_module_t *module, xhc_comm_t *xc,
+        int member, char *src, char *src2, char *dst, bool dst_remote,
+        size_t elements, ompi_datatype_t *dtype, size_t dtype_size,
+        ompi_op_t *op) {
+
+    xhc_member_info_t *m_info = &xc->member_info[member];
+    xhc_member_info_t *l_info = &xc->member_info[xc->leader_id];
+
+    size_t bytes = elements * dtype_size;
+    int err;
+
+    if(module->stage_buf_size < 2 * bytes) {
+        void *new_buf = realloc(module->stage_buf, 2 * bytes);
+        if(!new_buf) {return OMPI_ERR_OUT_OF_RESOURCE;}
+
+        module->stage_buf = new_buf;
+        module->stage_buf_size = 2 * bytes;
+    }
+
+    char *stage_src = (char *) module->stage_buf;
+    char *stage_dst = (char *) module->stage_buf + bytes;
+
+    bool src_remote = m_info->sbuf_remote;
+
+    // Might happen under MPI_IN_PLACE or CICO
+    if(!dst_remote && src2 == dst) {
+        src2 = NULL;
+    } else if(src_remote == dst_remote && src == dst
+            && (!src_remote || member == xc->leader_id)) {
+        src = src2;
+        src2 = NULL;
+        src_remote = false;
+    }
+
+    xhc_atomic_rmb();
+
+    if(src_remote) {
+        err = xhc_copy_from(m_info->peer, stage_src, src, bytes, NULL);
+        if(0 != err) {return OMPI_ERROR;}
+
+        src = stage_src;
+    }
+
+    if(!dst_remote) {
+        if(src2) {ompi_3buff_op_reduce(op, src2, src, dst, elements, dtype);}
+        else {ompi_op_reduce(op, src, dst, elements, dtype);}
+
+        return OMPI_SUCCESS;
+    }
+
+    if(src2) {
+        ompi_3buff_op_reduce(op, src2, src, stage_dst, elements, dtype);
+    } else {
+        err = xhc_copy_from(l_info->peer, stage_dst, dst, bytes, NULL);
+        if(0 != err) {return OMPI_ERROR;}
+
+        ompi_op_reduce(op, src, stage_dst, elements, dtype);
+    }
+
+    err = xhc_copy_to(l_info->peer, stage_dst, dst, bytes, NULL);
+    if(0 != err) {return OMPI_ERROR;}
+
+    return OMPI_SUCCESS;
+}
+
+static int xhc_allreduce_do_reduce(xhc_module_t *module, xhc_comm_t *xc,
+        xhc_rq_item_t *member_item, void *tmp_rbuf, size_t allreduce_count,
+        ompi_datatype_t *dtype, size_t dtype_size, ompi_op_t *op,
+        xhc_copy_method_t method) {
 
     xhc_reduce_area_t *area = &xc->reduce_areas[member_item->area_id];
 
@@ -834,18 +931,27 @@ static void xhc_allreduce_do_reduce(xhc_comm_t *xc, xhc_rq_item_t *member_item,
         src2 = (char *) tmp_rbuf + offset;
     }
 
-    // Might happen under MPI_IN_PLACE or CICO
-    if(src2 == dst) {
-        src2 = NULL;
-    } else if(src == dst) {
-        src = src2;
-        src2 = NULL;
-    }
+    if(XHC_COPY_SMSC_NO_MAP == method) {
+        bool dst_remote = (last_reduction
+            && xc->member_info[xc->leader_id].rbuf_remote);
 
-    xhc_atomic_rmb();
+        int err = xhc_allreduce_reduce_no_map(module, xc, member_item->member,
+            src, src2, dst, dst_remote, elements, dtype, dtype_size, op);
+        if(OMPI_SUCCESS != err) {return err;}
+    } else {
+        // Might happen under MPI_IN_PLACE or CICO
+        if(src2 == dst) {
+            src2 = NULL;
+        } else if(src == dst) {
+            src = src2;
+            src2 = NULL;
+        }
 
-    if(src2) {ompi_3buff_op_reduce(op, src2, src, dst, elements, dtype);}
-    else {ompi_op_reduce(op, src, dst, elements, dtype);}
+        xhc_atomic_rmb();
+
+        if(src2) {ompi_3buff_op_reduce(op, src2, src, dst, elements, dtype);}
+        else {ompi_op_reduce(op, src, dst, elements, dtype);}
+    }
 
     // ---
 
@@ -899,78 +1005,27 @@ static void xhc_allreduce_do_reduce(xhc_comm_t *xc, xhc_rq_item_t *member_item,
         xhc_atomic_store_size_t(&xc->my_ctrl->reduce_done,
             (xc->reduce_done = rq_first->count));
     }
+
+    return OMPI_SUCCESS;
 }
 
 // -----------------------------
 
-int mca_coll_xhc_allreduce_internal(const void *sbuf, void *rbuf, size_t count,
-        ompi_datatype_t *datatype, ompi_op_t *op, ompi_communicator_t *ompi_comm,
-        mca_coll_base_module_t *ompi_module, bool require_bcast) {
-
-    XHC_COLLTYPE_T colltype = (require_bcast ? XHC_ALLREDUCE : XHC_REDUCE);
-    xhc_module_t *module = (xhc_module_t *) ompi_module;
-
-    int err;
-
-    // ---
-
-    if(!ompi_datatype_is_predefined(datatype)) {
-        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
-            "derived datatypes; utilizing fallback component");
-        goto _fallback;
-    }
-
-    if(!ompi_op_is_commute(op)) {
-        WARN_ONCE("coll:xhc: Warning: (all)reduce does not support "
-            "non-commutative operators; utilizing fallback component");
-        goto _fallback;
-    }
-
-    if(!module->zcopy_support) {
-        size_t dtype_size; ompi_datatype_type_size(datatype, &dtype_size);
-        size_t cico_size = module->op_config[colltype].cico_max;
-        if(count * dtype_size > cico_size) {
-            WARN_ONCE("coll:xhc: Warning: No smsc support; utilizing fallback "
-                "component for %s greater than %zu bytes", (require_bcast ?
-                "allreduce" : "reduce"), cico_size);
-            goto _fallback;
-        }
-    }
-
-    if(!module->op_data[colltype].init) {
-        err = xhc_init_op(module, ompi_comm, colltype);
-        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
-    }
-
-    if(require_bcast && !module->op_data[XHC_BCAST].init) {
-        err = xhc_init_op(module, ompi_comm, XHC_BCAST);
-        if(OMPI_SUCCESS != err) {goto _fallback_permanent_bcast;}
-    }
-
-    // ---
-
-    xhc_peer_info_t *peer_info = module->peer_info;
-    xhc_op_data_t *op_data = &module->op_data[colltype];
+/* Settings and initialization that are common in Allreduce and Reduce.
+ * Returns the sequence number of the new operation. */
+static xf_sig_t xhc_allreduce_prepare(xhc_module_t *module,
+        xhc_op_data_t *op_data, ompi_datatype_t *datatype, size_t count, size_t dtype_size,
+        XHC_COLLTYPE_T colltype, int rank, xhc_copy_method_t *method_dst,
+        bool *out_of_order_reduce_dst) {
 
     xhc_comm_t *comms = op_data->comms;
-
-    size_t dtype_size, bytes_total;
-    ompi_datatype_type_size(datatype, &dtype_size);
-    bytes_total = count * dtype_size;
+    size_t bytes_total = count * dtype_size;
 
     xhc_copy_method_t method;
 
     bool out_of_order_reduce = false;
     xhc_reduce_load_balance_enum_t lb_policy;
 
-    int rank = ompi_comm_rank(ompi_comm);
-
-    /* Currently hard-coded. Okay for Allreduce. For reduce, it's
-     * because we don't yet support non-zero root... (TODO) */
-    int root = comms->top->owner_rank;
-
-    // ---
-
     switch(mca_coll_xhc_component.dynamic_reduce) {
         case XHC_DYNAMIC_REDUCE_DISABLED:
             out_of_order_reduce = false;
@@ -991,7 +1046,8 @@ int mca_coll_xhc_allreduce_internal(const void *sbuf, void *rbuf, size_t count,
     } else if(bytes_total <= comms[0].cico_size) {
         method = XHC_COPY_CICO;
     } else {
-        method = XHC_COPY_SMSC;
+        method = (module->zcopy_map_support ?
+            XHC_COPY_SMSC : XHC_COPY_SMSC_NO_MAP);
     }
 
     /* In XHC_COPY_IMM, we force the leaders to perform the reductions,
@@ -1000,26 +1056,6 @@ int mca_coll_xhc_allreduce_internal(const void *sbuf, void *rbuf, size_t count,
     if(XHC_COPY_IMM == method) {lb_policy = XHC_REDUCE_LB_LEADER_ASSIST_ALL;}
     else {lb_policy = mca_coll_xhc_component.reduce_load_balance;}
 
-    /* We require a buffer to store intermediate data. In cases like MPI_Ruduce,
-     * non-root ranks don't normally have an rbuf, so allocate an internal one.
-     * TODO: Strictly speaking, the members that won't do reductions, shouldn't
-     * require an rbuf; consult this and don't allocate one for them?? */
-    if(NULL == rbuf) {
-        if(module->rbuf_size < bytes_total) {
-            void *new_rbuf = realloc(module->rbuf, bytes_total);
-            if(!new_rbuf) {return OPAL_ERR_OUT_OF_RESOURCE;}
-
-            module->rbuf = new_rbuf;
-            module->rbuf_size = bytes_total;
-        }
-
-        rbuf = module->rbuf;
-    }
-
-    if(MPI_IN_PLACE == sbuf) {
-        sbuf = rbuf;
-    }
-
     // ---
 
     xf_sig_t seq = ++op_data->seq;
@@ -1027,17 +1063,49 @@ int mca_coll_xhc_allreduce_internal(const void *sbuf, void *rbuf, size_t count,
     xhc_allreduce_init_local(comms, count, dtype_size, colltype, lb_policy, seq);
     xhc_allreduce_init_comm(comms, rank, seq);
 
-    // My conscience is clear!
-    if(require_bcast) {goto _allreduce;}
-    else {goto _reduce;}
+    *method_dst = method;
+    *out_of_order_reduce_dst = out_of_order_reduce;
 
-// =============================================================================
+    return seq;
+}
 
-_allreduce: {
+// -----------------------------
+
+int mca_coll_xhc_allreduce_init(const void *sbuf, void *rbuf, size_t count,
+        ompi_datatype_t *datatype, ompi_op_t *op, ompi_communicator_t *ompi_comm,
+        xhc_module_t *module, xhc_allreduce_ctx_t *ctx) {
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_op_data_t *op_data = &module->op_data[XHC_ALLREDUCE];
+
+    ctx->sbuf = (MPI_IN_PLACE == sbuf ? rbuf : sbuf);
+    ctx->rbuf = rbuf;
+    ctx->count = count;
+    ctx->datatype = datatype;
+    ctx->op = op;
+    ctx->ompi_comm = ompi_comm;
+    ctx->module = module;
 
-    xhc_bcast_ctx_t bcast_ctx;
-    bool bcast_started = false;
+    ctx->rank = ompi_comm_rank(ompi_comm);
+    ctx->comms = op_data->comms;
+
+    ompi_datatype_type_size(datatype, &ctx->dtype_size);
+    ctx->bytes_total = count * ctx->dtype_size;
+    ctx->bytes_done = 0;
+
+    ctx->self_acked = false;
+
+    /* Currently hard-coded. Okay for Allreduce. For reduce, it's
+     * because we don't yet support non-zero root... (TODO) */
+    int root = ctx->comms->top->owner_rank;
 
+    ctx->seq = xhc_allreduce_prepare(module, op_data, datatype, count,
+        ctx->dtype_size, XHC_ALLREDUCE, ctx->rank, &ctx->method,
+        &ctx->out_of_order_reduce);
+
+    // ---
+
+    xhc_comm_t *comms = ctx->comms;
     void *bcast_buf = rbuf;
 
     /* In CICO, the reduced data is placed on the root's cico reduce buffer,
@@ -1049,27 +1117,53 @@ _allreduce: {
      * if bcast is also CICO, the data will end up getting placed directly
      * on the root's bcast cico buffer (not a problem for setting bcast_buf,
      * just so you know there's a bit more to it!). */
-    if(XHC_COPY_CICO == method && rank == root && !comms->top->do_all_work) {
+    if(XHC_COPY_CICO == ctx->method && ctx->rank == root && !comms->top->do_all_work) {
         bcast_buf = CICO_BUFFER(comms->top, comms->top->my_id);
     }
 
-    xhc_bcast_init(bcast_buf, count, datatype, root,
-        ompi_comm, module, &bcast_ctx);
+    int err = xhc_bcast_init(bcast_buf, count, datatype, root,
+        ompi_comm, module, &ctx->bcast_ctx);
+    if(OMPI_SUCCESS != err) {return err;}
 
     /* Allreduce is not multi-sliced (no perf benefit from multi-slicing?),
      * so init the member struct on all comms here, in blocking manner. */
     for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
-        xhc_allreduce_init_member(xc, peer_info, (void *) sbuf, rbuf, count,
-            dtype_size, method, bcast_ctx.method, rank, seq, true);
+        xhc_allreduce_init_member(xc, peer_info, (void *) ctx->sbuf, rbuf,
+            count, ctx->dtype_size, ctx->method, ctx->bcast_ctx.method,
+            ctx->rank, ctx->seq, true);
         if(!xc->is_leader) {break;}
     }
 
-    for(size_t bytes_done = 0; bytes_done < bytes_total; ) {
+    return OMPI_SUCCESS;
+}
+
+/* Performs one round of reductions, propagation and broadcast, without
+ * blocking. Returns OMPI_ERR_WOULD_BLOCK until all of this rank's data
+ * movement is done; the ack phase follows (xhc_allreduce_ack_test()). */
+int mca_coll_xhc_allreduce_progress(xhc_allreduce_ctx_t *ctx) {
+    xhc_peer_info_t *peer_info = ctx->module->peer_info;
+    xhc_bcast_ctx_t *bcast_ctx = &ctx->bcast_ctx;
+    xhc_comm_t *comms = ctx->comms;
+
+    const void *sbuf = ctx->sbuf;
+    void *rbuf = ctx->rbuf;
+    size_t count = ctx->count;
+    size_t dtype_size = ctx->dtype_size;
+    size_t bytes_total = ctx->bytes_total;
+    size_t bytes_done = ctx->bytes_done;
+    xhc_copy_method_t method = ctx->method;
+    xf_sig_t seq = ctx->seq;
+
+    int err;
+
+    // ---
+
+    if(bytes_done < bytes_total) {
 
         // CICO mode, copy-in phase
         if(XHC_COPY_CICO == method && comms->bottom->reduce_ready < count) {
             xhc_allreduce_cico_publish(comms->bottom, (void *) sbuf,
-                peer_info, rank, count, dtype_size);
+                peer_info, ctx->rank, count, dtype_size);
         }
 
         for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
@@ -1078,13 +1172,14 @@ _allreduce: {
                 xhc_rq_item_t *member_item = NULL;
 
                 err = xhc_allreduce_reduce_get_next(xc, peer_info, count,
-                    dtype_size, method, bcast_ctx.method, out_of_order_reduce,
-                    seq, &member_item);
+                    dtype_size, method, bcast_ctx->method,
+                    ctx->out_of_order_reduce, seq, &member_item);
                 if(OMPI_SUCCESS != err) {return err;}
 
                 if(member_item) {
-                    xhc_allreduce_do_reduce(xc, member_item, rbuf,
-                        count, datatype, dtype_size, op, method);
+                    err = xhc_allreduce_do_reduce(ctx->module, xc, member_item,
+                        rbuf, count, ctx->datatype, dtype_size, ctx->op, method);
+                    if(OMPI_SUCCESS != err) {return err;}
                 }
             }
 
@@ -1149,8 +1244,8 @@ _allreduce: {
                 xhc_atomic_store_size_t(&xc->up->my_ctrl->reduce_ready,
                     (xc->up->reduce_ready = completed));
             } else if(xc->is_top && completed_bytes > bytes_done) {
-                for(xhc_comm_t *bxc = bcast_ctx.comms->top; bxc; bxc = bxc->down) {
-                    xhc_bcast_notify(&bcast_ctx, bxc, completed_bytes);
+                for(xhc_comm_t *bxc = bcast_ctx->comms->top; bxc; bxc = bxc->down) {
+                    xhc_bcast_notify(bcast_ctx, bxc, completed_bytes);
                 }
 
                 if(xc->my_info->rbuf != rbuf) {
@@ -1159,7 +1254,7 @@ _allreduce: {
                 }
 
                 bytes_done = completed_bytes;
-                bcast_ctx.bytes_done = completed_bytes;
+                bcast_ctx->bytes_done = completed_bytes;
             }
 
             /* As soon as reduction and propagation is fully finished on
@@ -1174,16 +1269,18 @@ _allreduce: {
             }
         }
 
+        ctx->bytes_done = bytes_done;
+
         // Broadcast
         // ---------
 
-        if(!bcast_started) {
-            err = xhc_bcast_start(&bcast_ctx);
-            if(OMPI_SUCCESS == err) {bcast_started = true;}
+        if(!bcast_ctx->started) {
+            err = xhc_bcast_start(bcast_ctx);
+            if(OMPI_SUCCESS == err) {bcast_ctx->started = true;}
             else if(OMPI_ERR_WOULD_BLOCK != err) {return err;}
         }
 
-        if(bcast_ctx.src_comm && bcast_ctx.bytes_done < bcast_ctx.bytes_total) {
+        if(bcast_ctx->src_comm && bcast_ctx->bytes_done < bcast_ctx->bytes_total) {
             /* Currently, in single-copy mode, even though we already have
              * some established xpmem attachments, these might need to be
              * re-established in bcast. Some form of small/quick caching
@@ -1191,46 +1288,171 @@ _allreduce: {
              * the allreduce implementation could hint to broadcast that
              * registrations are available. */
 
-            err = xhc_bcast_work(&bcast_ctx);
+            err = xhc_bcast_work(bcast_ctx);
 
             if(OMPI_SUCCESS != err && OMPI_ERR_WOULD_BLOCK != err) {
                 return err;
             }
 
-            bytes_done = bcast_ctx.bytes_done;
+            ctx->bytes_done = bcast_ctx->bytes_done;
         }
     }
 
-    // ---
-
     /* This is theoretically necessary, for the case that a leader has copied
      * all chunks and thus exited the loop, but hasn't yet notified some of
      * its children (e.g. because they were still active in a previous op). */
-    while(!bcast_started) {
-        err = xhc_bcast_start(&bcast_ctx);
-        if(OMPI_SUCCESS == err) {bcast_started = true;}
+    if(ctx->bytes_done >= bytes_total && !bcast_ctx->started) {
+        err = xhc_bcast_start(bcast_ctx);
+        if(OMPI_SUCCESS == err) {bcast_ctx->started = true;}
         else if(OMPI_ERR_WOULD_BLOCK != err) {return err;}
     }
 
-    xhc_allreduce_ack(comms, seq, &bcast_ctx);
+    return (ctx->bytes_done >= bytes_total && bcast_ctx->started ?
+        OMPI_SUCCESS : OMPI_ERR_WOULD_BLOCK);
+}
+
+/* Non-blocking counterpart of xhc_allreduce_ack(); returns
+ * OMPI_ERR_WOULD_BLOCK until the operation has completed for all. */
+int mca_coll_xhc_allreduce_ack_test(xhc_allreduce_ctx_t *ctx) {
+    if(!ctx->self_acked) {
+        xhc_allreduce_ack_self(ctx->comms, ctx->seq);
+        ctx->self_acked = true;
+    }
+
+    int err = xhc_bcast_ack_test(&ctx->bcast_ctx);
+    if(OMPI_SUCCESS != err) {return err;}
+
+    xhc_allreduce_ack_comm(ctx->comms, ctx->seq);
+
+    return OMPI_SUCCESS;
+}
 
-    xhc_bcast_fini(&bcast_ctx);
+void mca_coll_xhc_allreduce_fini(xhc_allreduce_ctx_t *ctx) {
+    xhc_bcast_fini(&ctx->bcast_ctx);
 
     /* See respective comment in xhc_bcast_fini(). Note that prefetchw is also
      * used in Reduce, but that happens inside xhc_allreduce_slice_gc(). */
-    if(XHC_COPY_CICO == method) {
-        for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
-            xhc_prefetchw(CICO_BUFFER(xc, xc->my_id), bytes_total, 2);
+    if(XHC_COPY_CICO == ctx->method) {
+        for(xhc_comm_t *xc = ctx->comms; xc; xc = xc->up) {
+            xhc_prefetchw(CICO_BUFFER(xc, xc->my_id), ctx->bytes_total, 2);
             if(!xc->is_leader) {break;}
         }
     }
 
-    goto _finish;
+    if(XHC_COPY_SMSC == ctx->method) {
+        xhc_allreduce_disconnect_peers(ctx->comms);
+    }
 }
 
-// =============================================================================
+// -----------------------------
+
+int mca_coll_xhc_allreduce_internal(const void *sbuf, void *rbuf, size_t count,
+        ompi_datatype_t *datatype, ompi_op_t *op, ompi_communicator_t *ompi_comm,
+        mca_coll_base_module_t *ompi_module, bool require_bcast) {
+
+    XHC_COLLTYPE_T colltype = (require_bcast ? XHC_ALLREDUCE : XHC_REDUCE);
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    int err;
+
+    // ---
+
+    if(!ompi_datatype_is_predefined(datatype)) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(!ompi_op_is_commute(op)) {
+        WARN_ONCE("coll:xhc: Warning: (all)reduce does not support "
+            "non-commutative operators; utilizing fallback component");
+        goto _fallback;
+    }
+
+    if(!module->zcopy_reduce_support) {
+        size_t dtype_size; ompi_datatype_type_size(datatype, &dtype_size);
+        size_t cico_size = module->op_config[colltype].cico_max;
+        if(count * dtype_size > cico_size) {
+            WARN_ONCE("coll:xhc: Warning: No suitable smsc support; utilizing fallback "
+                "component for %s greater than %zu bytes", (require_bcast ?
+                "allreduce" : "reduce"), cico_size);
+            goto _fallback;
+        }
+    }
+
+    if(!module->op_data[colltype].init) {
+        err = xhc_init_op(module, ompi_comm, colltype);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    if(require_bcast && !module->op_data[XHC_BCAST].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_BCAST);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent_bcast;}
+    }
 
-_reduce: {
+    xhc_request_drain(module);
+
+    // ---
+
+    if(require_bcast) {
+        xhc_allreduce_ctx_t ctx;
+
+        err = xhc_allreduce_init(sbuf, rbuf, count, datatype,
+            op, ompi_comm, module, &ctx);
+        if(OMPI_SUCCESS != err) {return err;}
+
+        do {
+            err = xhc_allreduce_progress(&ctx);
+        } while(OMPI_ERR_WOULD_BLOCK == err);
+
+        if(OMPI_SUCCESS != err) {return err;}
+
+        xhc_allreduce_ack(ctx.comms, ctx.seq, &ctx.bcast_ctx);
+        xhc_allreduce_fini(&ctx);
+
+        return OMPI_SUCCESS;
+    }
+
+    // ---
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_op_data_t *op_data = &module->op_data[colltype];
+
+    xhc_comm_t *comms = op_data->comms;
+
+    size_t dtype_size, bytes_total;
+    ompi_datatype_type_size(datatype, &dtype_size);
+    bytes_total = count * dtype_size;
+
+    xhc_copy_method_t method;
+    bool out_of_order_reduce;
+
+    int rank = ompi_comm_rank(ompi_comm);
+
+    /* We require a buffer to store intermediate data. In cases like MPI_Ruduce,
+     * non-root ranks don't normally have an rbuf, so allocate an internal one.
+     * TODO: Strictly speaking, the members that won't do reductions, shouldn't
+     * require an rbuf; consult this and don't allocate one for them?? */
+    if(NULL == rbuf) {
+        if(module->rbuf_size < bytes_total) {
+            void *new_rbuf = realloc(module->rbuf, bytes_total);
+            if(!new_rbuf) {return OPAL_ERR_OUT_OF_RESOURCE;}
+
+            module->rbuf = new_rbuf;
+            module->rbuf_size = bytes_total;
+        }
+
+        rbuf = module->rbuf;
+    }
+
+    if(MPI_IN_PLACE == sbuf) {
+        sbuf = rbuf;
+    }
+
+    xf_sig_t seq = xhc_allreduce_prepare(module, op_data, datatype, count,
+        dtype_size, colltype, rank, &method, &out_of_order_reduce);
+
+    // ---
 
     for(size_t bytes_done = 0; bytes_done < bytes_total; ) {
         for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
@@ -1275,8 +1497,9 @@ _reduce: {
                 if(OMPI_SUCCESS != err) {return err;}
 
                 if(member_item) {
-                    xhc_allreduce_do_reduce(xc, member_item, rbuf,
-                        count, datatype, dtype_size, op, method);
+                    err = xhc_allreduce_do_reduce(module, xc, member_item,
+                        rbuf, count, datatype, dtype_size, op, method);
+                    if(OMPI_SUCCESS != err) {return err;}
                 }
             }
 
@@ -1370,19 +1593,14 @@ _reduce: {
 
     xhc_reduce_ack(comms, method, seq);
 
-    goto _finish;
-}
-
-// =============================================================================
-
-_finish:
-
     if(XHC_COPY_SMSC == method) {
         xhc_allreduce_disconnect_peers(comms);
     }
 
     return OMPI_SUCCESS;
 
+    // ---
+
 _fallback_permanent_bcast:
 
     XHC_INSTALL_FALLBACK(module, ompi_comm, XHC_BCAST, bcast);
@@ -1415,3 +1633,149 @@ int mca_coll_xhc_allreduce(const void *sbuf, void *rbuf,
     return xhc_allreduce_internal(sbuf, rbuf, count,
         datatype, op, ompi_comm, ompi_module, true);
 }
+
+// -----------------------------
+
+static int xhc_iallreduce_begin(xhc_request_t *req) {
+    return xhc_allreduce_init(req->args.sbuf, req->args.buf, req->args.count,
+        req->args.datatype, req->args.op, req->super.req_mpi_object.comm,
+        req->module, &req->ctx.allreduce);
+}
+
+static int xhc_iallreduce_progress(xhc_request_t *req) {
+    xhc_allreduce_ctx_t *ctx = &req->ctx.allreduce;
+    int err;
+
+    if(ctx->bytes_done < ctx->bytes_total || !ctx->bcast_ctx.started) {
+        err = xhc_allreduce_progress(ctx);
+        if(OMPI_SUCCESS != err) {return err;}
+    }
+
+    err = xhc_allreduce_ack_test(ctx);
+    if(OMPI_SUCCESS != err) {return err;}
+
+    xhc_allreduce_fini(ctx);
+
+    return OMPI_SUCCESS;
+}
+
+static int xhc_iallreduce_create(const void *sbuf, void *rbuf, size_t count,
+        ompi_datatype_t *datatype, ompi_op_t *op, ompi_communicator_t *ompi_comm,
+        xhc_module_t *module, bool persistent, xhc_request_t **req_dst) {
+
+    int err;
+
+    if(!ompi_datatype_is_predefined(datatype)) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    if(!ompi_op_is_commute(op)) {
+        WARN_ONCE("coll:xhc: Warning: (all)reduce does not support "
+            "non-commutative operators; utilizing fallback component");
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    if(!module->zcopy_reduce_support) {
+        size_t dtype_size; ompi_datatype_type_size(datatype, &dtype_size);
+        size_t cico_size = module->op_config[XHC_ALLREDUCE].cico_max;
+        if(count * dtype_size > cico_size) {
+            WARN_ONCE("coll:xhc: Warning: No suitable smsc support; utilizing fallback "
+                "component for allreduce greater than %zu bytes", cico_size);
+            return OMPI_ERR_NOT_SUPPORTED;
+        }
+    }
+
+    if(!module->op_data[XHC_ALLREDUCE].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_ALLREDUCE);
+        if(OMPI_SUCCESS != err) {return OMPI_ERR_NOT_AVAILABLE;}
+    }
+
+    if(!module->op_data[XHC_BCAST].init) {
+        err = xhc_init_op(module, ompi_comm, XHC_BCAST);
+        if(OMPI_SUCCESS != err) {return OMPI_ERR_NOT_AVAILABLE;}
+    }
+
+    xhc_request_t *req = xhc_request_new(module, ompi_comm, persistent);
+    if(NULL == req) {return OMPI_ERR_OUT_OF_RESOURCE;}
+
+    req->args.sbuf = sbuf;
+    req->args.buf = rbuf;
+    req->args.count = count;
+    req->args.datatype = datatype;
+    req->args.op = op;
+
+    // Released in the request's destructor
+    OBJ_RETAIN(op);
+
+    req->begin = xhc_iallreduce_begin;
+    req->progress = xhc_iallreduce_progress;
+
+    *req_dst = req;
+
+    return OMPI_SUCCESS;
+}
+
+int mca_coll_xhc_iallreduce(const void *sbuf, void *rbuf, size_t count,
+        ompi_datatype_t *datatype, ompi_op_t *op, ompi_communicator_t *ompi_comm,
+        ompi_request_t **request, mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+    xhc_request_t *req;
+
+    int err = xhc_iallreduce_create(sbuf, rbuf, count, datatype,
+        op, ompi_comm, module, false, &req);
+
+    if(OMPI_ERR_NOT_AVAILABLE == err) {goto _fallback_permanent;}
+    if(OMPI_ERR_NOT_SUPPORTED == err) {goto _fallback;}
+    if(OMPI_SUCCESS != err) {return err;}
+
+    *request = &req->super;
+
+    return xhc_request_post(req);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_NB_FALLBACK(module,
+        ompi_comm, XHC_IALLREDUCE, iallreduce);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_nb_colls, XHC_IALLREDUCE,
+        iallreduce, sbuf, rbuf, count, datatype, op, ompi_comm, request);
+}
+
+int mca_coll_xhc_allreduce_persistent_init(const void *sbuf, void *rbuf,
+        size_t count, ompi_datatype_t *datatype, ompi_op_t *op,
+        ompi_communicator_t *ompi_comm, ompi_info_t *info,
+        ompi_request_t **request, mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+    xhc_request_t *req;
+
+    int err = xhc_iallreduce_create(sbuf, rbuf, count, datatype,
+        op, ompi_comm, module, true, &req);
+
+    if(OMPI_ERR_NOT_AVAILABLE == err) {goto _fallback_permanent;}
+    if(OMPI_ERR_NOT_SUPPORTED == err) {goto _fallback;}
+    if(OMPI_SUCCESS != err) {return err;}
+
+    *request = &req->super;
+
+    return OMPI_SUCCESS;
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_NB_FALLBACK(module,
+        ompi_comm, XHC_ALLREDUCE_INIT, allreduce_init);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_nb_colls, XHC_ALLREDUCE_INIT,
+        allreduce_init, sbuf, rbuf, count, datatype, op, ompi_comm, info, request);
+}
@@ -74,6 +74,8 @@ int mca_coll_xhc_barrier(ompi_communicator_t *ompi_comm,
         if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
     }
 
+    xhc_request_drain(module);
+
     xhc_peer_info_t *peer_info = module->peer_info;
     xhc_op_data_t *data = &module->op_data[XHC_BARRIER];
 
@@ -144,6 +144,9 @@ int mca_coll_xhc_bcast_init(void *buf, size_t count, ompi_datatype_t *datatype,
     ctx->bytes_done = 0;
     ctx->bytes_avail = 0;
 
+    ctx->started = false;
+    ctx->self_acked = false;
+
     // --
 
     size_t dtype_size;
@@ -182,6 +185,8 @@ int mca_coll_xhc_bcast_init(void *buf, size_t count, ompi_datatype_t *datatype,
         }
     }
 
+    ctx->ack_comm = ctx->comms;
+
     return OMPI_SUCCESS;
 }
 
@@ -333,9 +338,7 @@ int mca_coll_xhc_bcast_work(xhc_bcast_ctx_t *ctx) {
     return OMPI_SUCCESS;
 }
 
-void mca_coll_xhc_bcast_ack(xhc_bcast_ctx_t *ctx) {
-
-    // Set personal ack(s)
+static void xhc_bcast_ack_self(xhc_bcast_ctx_t *ctx) {
     for(xhc_comm_t *xc = ctx->comms; xc; xc = xc->up) {
         xc->my_ctrl->ack = ctx->seq;
 
@@ -343,6 +346,12 @@ void mca_coll_xhc_bcast_ack(xhc_bcast_ctx_t *ctx) {
             break;
         }
     }
+}
+
+void mca_coll_xhc_bcast_ack(xhc_bcast_ctx_t *ctx) {
+
+    // Set personal ack(s)
+    xhc_bcast_ack_self(ctx);
 
     // Gather members' acks and set comm ack
     for(xhc_comm_t *xc = ctx->comms; xc; xc = xc->up) {
@@ -367,6 +376,39 @@ void mca_coll_xhc_bcast_ack(xhc_bcast_ctx_t *ctx) {
     }
 }
 
+/* Non-blocking version of xhc_bcast_ack(). Resumes from the comm
+ * where it left off the last time, and returns OMPI_ERR_WOULD_BLOCK
+ * while any member's ack is still pending. */
+int mca_coll_xhc_bcast_ack_test(xhc_bcast_ctx_t *ctx) {
+    if(!ctx->self_acked) {
+        xhc_bcast_ack_self(ctx);
+        ctx->self_acked = true;
+    }
+
+    for(xhc_comm_t *xc = ctx->ack_comm; xc; xc = xc->up) {
+        if(!xc->is_leader) {
+            break;
+        }
+
+        for(int m = 0; m < xc->size; m++) {
+            if(m == xc->my_id) {
+                continue;
+            }
+
+            if(!CHECK_FLAG(&xc->member_ctrl[m].ack, ctx->seq, 0)) {
+                ctx->ack_comm = xc;
+                return OMPI_ERR_WOULD_BLOCK;
+            }
+        }
+
+        xc->comm_ctrl->ack = ctx->seq;
+    }
+
+    ctx->ack_comm = NULL;
+
+    return OMPI_SUCCESS;
+}
+
 void mca_coll_xhc_bcast_fini(xhc_bcast_ctx_t *ctx) {
     if(ctx->reg) {
         xhc_return_registration(ctx->reg);
@@ -388,6 +430,24 @@ void mca_coll_xhc_bcast_fini(xhc_bcast_ctx_t *ctx) {
 
 // ------------------------------------------------
 
+static void xhc_bcast_root_prepare(xhc_bcast_ctx_t *ctx) {
+    if(ctx->rank != ctx->root) {
+        return;
+    }
+
+    /* Safe to alter the CICO buffer without checking any flags,
+     * because this is this rank's personal buffer. In any past
+     * ops where others copied from it, the rank has gathered
+     * acks that these copies have completed. */
+    if(XHC_COPY_CICO == ctx->method) {
+        xhc_memcpy(ctx->self_cico, ctx->buf, ctx->bytes_total);
+    }
+
+    ctx->bytes_done = ctx->bytes_total;
+}
+
+// ------------------------------------------------
+
 int mca_coll_xhc_bcast(void *buf, size_t count, ompi_datatype_t *datatype, int root,
         ompi_communicator_t *ompi_comm, mca_coll_base_module_t *ompi_module) {
 
@@ -421,21 +481,13 @@ int mca_coll_xhc_bcast(void *buf, size_t count, ompi_datatype_t *datatype, int r
         if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
     }
 
+    xhc_request_drain(module);
+
     err = xhc_bcast_init(buf, count, datatype,
         root, ompi_comm, module, &ctx);
     if(OMPI_SUCCESS != err) {return err;}
 
-    /* Safe to alter the CICO buffer without checking any flags,
-     * because this is this rank's personal buffer. In any past
-     * ops where others copied from it, the rank has gathered
-     * acks that these copies have completed. */
-    if(ctx.rank == root && XHC_COPY_CICO == ctx.method) {
-        xhc_memcpy(ctx.self_cico, ctx.buf, ctx.bytes_total);
-    }
-
-    if(ctx.rank == root) {
-        ctx.bytes_done = ctx.bytes_total;
-    }
+    xhc_bcast_root_prepare(&ctx);
 
     while((err = xhc_bcast_start(&ctx)) != OMPI_SUCCESS) {
         if(OMPI_ERR_WOULD_BLOCK != err) {return err;}
@@ -466,3 +518,146 @@ _fallback:
     return XHC_CALL_FALLBACK(module->prev_colls, XHC_BCAST,
         bcast, buf, count, datatype, root, ompi_comm);
 }
+
+// ------------------------------------------------
+
+static int xhc_ibcast_begin(xhc_request_t *req) {
+    xhc_bcast_ctx_t *ctx = &req->ctx.bcast;
+
+    int err = xhc_bcast_init(req->args.buf, req->args.count,
+        req->args.datatype, req->args.root, req->super.req_mpi_object.comm,
+        req->module, ctx);
+    if(OMPI_SUCCESS != err) {return err;}
+
+    xhc_bcast_root_prepare(ctx);
+
+    return OMPI_SUCCESS;
+}
+
+static int xhc_ibcast_progress(xhc_request_t *req) {
+    xhc_bcast_ctx_t *ctx = &req->ctx.bcast;
+    int err;
+
+    if(!ctx->started) {
+        err = xhc_bcast_start(ctx);
+        if(OMPI_SUCCESS != err) {return err;}
+
+        ctx->started = true;
+    }
+
+    while(ctx->bytes_done < ctx->bytes_total) {
+        err = xhc_bcast_work(ctx);
+        if(OMPI_SUCCESS != err) {return err;}
+    }
+
+    err = xhc_bcast_ack_test(ctx);
+    if(OMPI_SUCCESS != err) {return err;}
+
+    xhc_bcast_fini(ctx);
+
+    return OMPI_SUCCESS;
+}
+
+static int xhc_ibcast_create(void *buf, size_t count,
+        ompi_datatype_t *datatype, int root, ompi_communicator_t *ompi_comm,
+        xhc_module_t *module, bool persistent, xhc_request_t **req_dst) {
+
+    if(!ompi_datatype_is_predefined(datatype)) {
+        WARN_ONCE("coll:xhc: Warning: XHC does not currently support "
+            "derived datatypes; utilizing fallback component");
+        return OMPI_ERR_NOT_SUPPORTED;
+    }
+
+    if(!module->zcopy_support) {
+        size_t dtype_size; ompi_datatype_type_size(datatype, &dtype_size);
+        size_t cico_size = module->op_config[XHC_BCAST].cico_max;
+        if(count * dtype_size > cico_size) {
+            WARN_ONCE("coll:xhc: Warning: No smsc support; utilizing fallback "
+                "component for bcast greater than %zu bytes", cico_size);
+            return OMPI_ERR_NOT_SUPPORTED;
+        }
+    }
+
+    if(!module->op_data[XHC_BCAST].init) {
+        int err = xhc_init_op(module, ompi_comm, XHC_BCAST);
+        if(OMPI_SUCCESS != err) {return OMPI_ERR_NOT_AVAILABLE;}
+    }
+
+    xhc_request_t *req = xhc_request_new(module, ompi_comm, persistent);
+    if(NULL == req) {return OMPI_ERR_OUT_OF_RESOURCE;}
+
+    req->args.buf = buf;
+    req->args.count = count;
+    req->args.datatype = datatype;
+    req->args.root = root;
+
+    req->begin = xhc_ibcast_begin;
+    req->progress = xhc_ibcast_progress;
+
+    *req_dst = req;
+
+    return OMPI_SUCCESS;
+}
+
+int mca_coll_xhc_ibcast(void *buf, size_t count, ompi_datatype_t *datatype,
+        int root, ompi_communicator_t *ompi_comm, ompi_request_t **request,
+        mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+    xhc_request_t *req;
+
+    int err = xhc_ibcast_create(buf, count, datatype,
+        root, ompi_comm, module, false, &req);
+
+    if(OMPI_ERR_NOT_AVAILABLE == err) {goto _fallback_permanent;}
+    if(OMPI_ERR_NOT_SUPPORTED == err) {goto _fallback;}
+    if(OMPI_SUCCESS != err) {return err;}
+
+    *request = &req->super;
+
+    return xhc_request_post(req);
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_NB_FALLBACK(module,
+        ompi_comm, XHC_IBCAST, ibcast);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_nb_colls, XHC_IBCAST,
+        ibcast, buf, count, datatype, root, ompi_comm, request);
+}
+
+int mca_coll_xhc_bcast_persistent_init(void *buf, size_t count,
+        ompi_datatype_t *datatype, int root, ompi_communicator_t *ompi_comm,
+        ompi_info_t *info, ompi_request_t **request,
+        mca_coll_base_module_t *ompi_module) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+    xhc_request_t *req;
+
+    int err = xhc_ibcast_create(buf, count, datatype,
+        root, ompi_comm, module, true, &req);
+
+    if(OMPI_ERR_NOT_AVAILABLE == err) {goto _fallback_permanent;}
+    if(OMPI_ERR_NOT_SUPPORTED == err) {goto _fallback;}
+    if(OMPI_SUCCESS != err) {return err;}
+
+    *request = &req->super;
+
+    return OMPI_SUCCESS;
+
+    // ---
+
+_fallback_permanent:
+
+    XHC_INSTALL_NB_FALLBACK(module,
+        ompi_comm, XHC_BCAST_INIT, bcast_init);
+
+_fallback:
+
+    return XHC_CALL_FALLBACK(module->prev_nb_colls, XHC_BCAST_INIT,
+        bcast_init, buf, count, datatype, root, ompi_comm, info, request);
+}
@@ -28,6 +28,8 @@ typedef int (*csv_parse_conv_fn_t)(char *str, void *dst);
 typedef void (*csv_parse_destruct_fn_t)(void *data);
 
 static int xhc_register(void);
+static int xhc_open(void);
+static int xhc_close(void);
 static int xhc_var_check_exclusive(const char *param_a, const char *param_b);
 
 // -----------------------------
@@ -58,7 +60,10 @@ static const COLLTYPE_T xhc_colltype_to_universal_map[XHC_COLLCOUNT] = {
     [XHC_BCAST] = BCAST,
     [XHC_BARRIER] = BARRIER,
     [XHC_REDUCE] = REDUCE,
-    [XHC_ALLREDUCE] = ALLREDUCE
+    [XHC_ALLREDUCE] = ALLREDUCE,
+    [XHC_ALLGATHER] = ALLGATHER,
+    [XHC_GATHER] = GATHER,
+    [XHC_SCATTER] = SCATTER
 };
 
 static const char *xhc_config_source_to_str_map[XHC_CONFIG_SOURCE_COUNT] = {
@@ -80,6 +85,8 @@ mca_coll_xhc_component_t mca_coll_xhc_component = {
             MCA_BASE_MAKE_VERSION(component, OMPI_MAJOR_VERSION,
                 OMPI_MINOR_VERSION, OMPI_RELEASE_VERSION),
 
+            .mca_open_component = xhc_open,
+            .mca_close_component = xhc_close,
             .mca_register_component_params = xhc_register,
         },
 
@@ -111,7 +118,10 @@ mca_coll_xhc_component_t mca_coll_xhc_component = {
     .uniform_chunks_min = 4096,
 
     .op_mca = {{0}},
-    .op_mca_global = {0}
+    .op_mca_global = {0},
+
+    .in_progress = false,
+    .active_comms = 0
 };
 MCA_BASE_COMPONENT_INIT(ompi, coll, xhc)
 
@@ -145,12 +155,44 @@ static xhc_op_mca_t op_mca_default[XHC_COLLCOUNT] = {
         .hierarchy = "l3,numa,socket",
         .chunk_size = "16K",
         .cico_max = 4096
+    },
+
+    [XHC_ALLGATHER] = {
+        .hierarchy = "numa,socket",
+        .chunk_size = "1",
+        .cico_max = 1024
+    },
+
+    [XHC_GATHER] = {
+        .hierarchy = "numa,socket",
+        .chunk_size = "1",
+        .cico_max = 256
+    },
+
+    [XHC_SCATTER] = {
+        .hierarchy = "numa,socket",
+        .chunk_size = "1",
+        .cico_max = 1024
     }
 };
 static xhc_op_mca_t op_mca_global_default = {0};
 
 // -----------------------------
 
+static int xhc_open(void) {
+    OBJ_CONSTRUCT(&mca_coll_xhc_component.active_requests, opal_list_t);
+    OBJ_CONSTRUCT(&mca_coll_xhc_component.lock, opal_mutex_t);
+
+    return OMPI_SUCCESS;
+}
+
+static int xhc_close(void) {
+    OBJ_DESTRUCT(&mca_coll_xhc_component.active_requests);
+    OBJ_DESTRUCT(&mca_coll_xhc_component.lock);
+
+    return OMPI_SUCCESS;
+}
+
 /* Initial query function that is invoked during MPI_INIT, allowing
  * this component to disqualify itself if it doesn't support the
  * required level of thread support. */
@@ -432,7 +474,7 @@ static int xhc_register(void) {
     mca_base_var_get(vari, &var);
 
     for(int t = 0; t < XHC_COLLCOUNT; t++) {
-        if(XHC_BARRIER == t) {
+        if(!xhc_colltype_is_chunked(t)) {
             continue;
         }
 
@@ -0,0 +1,499 @@
+/*
+ * Copyright (c) 2021-2024 Computer Architecture and VLSI Systems (CARV)
+ *                         Laboratory, ICS Forth. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/communicator/communicator.h"
+#include "opal/mca/smsc/smsc.h"
+
+#include "coll_xhc.h"
+
+/* Hierarchical Gather/Scatter with single-copy transfers
+ * -----------------------------------------------------------------
+ * Gather, Allgather and Scatter share the same engine. The root leads
+ * all the xhc comms it's a member of. The other comms are led by their
+ * owner, as in bcast without dynamic leadership.
+ *
+ * 1. The root exposes its buffer (rbuf in gather, sbuf in scatter),
+ *    and advertises its address on the comms it leads. Leaders pick
+ *    it up from the comm they're a member of, and propagate it down
+ *    to the comms they lead, so it reaches all ranks.
+ *
+ * 2. Each rank copies its own block straight to/from the root's
+ *    buffer; to it in gather, from it in scatter. All ranks copy in
+ *    parallel, and each byte is only copied once.
+ *
+ * 3. Ranks signal completion through their member seq field. Leaders
+ *    wait for all their members before signaling on the level above,
+ *    so when the root has seen all of its members, all ranks are done.
+ *
+ * For small messages, CICO is used instead. In gather, ranks place
+ * their block in their own CICO buffer, and the root reads them all
+ * out once everybody has joined; no need to advertise anything first.
+ * In scatter, the root fills its CICO buffer with all blocks, and
+ * members copy theirs out of it.
+ *
+ * In Allgather, the gather phase places the data on the root's rbuf,
+ * and a (pipelined, per-level chunked) XHC broadcast distributes it.
+ *
+ * The engine works on contiguous blocks of bytes. Only the signatures
+ * of the datatypes match across ranks, not their layouts, so a rank
+ * can't decide on its own to take the fallback because of its local
+ * datatypes; the others would still enter the protocol. Instead, a
+ * rank whose buffer isn't a contiguous run of a predefined type packs
+ * it into a temporary buffer, and runs the protocol on that.
+ * ----------------------------------------------------------------- */
+
+static bool xhc_gather_dtype_direct(ompi_datatype_t *dtype) {
+    return (ompi_datatype_is_predefined(dtype)
+        && ompi_datatype_is_contiguous_memory_layout(dtype, 2));
+}
+
+/* Allocate a packed copy of a buffer, filled with its data if pack is set */
+static void *xhc_gather_stage(const void *buf, size_t count,
+        ompi_datatype_t *dtype, size_t bytes, bool pack) {
+
+    void *staged = malloc(bytes);
+    if(NULL == staged || !pack) {
+        return staged;
+    }
+
+    opal_convertor_t convertor;
+    struct iovec iov = {.iov_base = staged, .iov_len = bytes};
+    uint32_t iov_count = 1;
+    size_t max_data = bytes;
+
+    OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+    opal_convertor_copy_and_prepare_for_send(ompi_mpi_local_convertor,
+        &dtype->super, count, buf, 0, &convertor);
+    opal_convertor_pack(&convertor, &iov, &iov_count, &max_data);
+    OBJ_DESTRUCT(&convertor);
+
+    return staged;
+}
+
+static void xhc_gather_unstage(void *buf, size_t count,
+        ompi_datatype_t *dtype, void *staged, size_t bytes) {
+
+    opal_convertor_t convertor;
+    struct iovec iov = {.iov_base = staged, .iov_len = bytes};
+    uint32_t iov_count = 1;
+    size_t max_data = bytes;
+
+    OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+    opal_convertor_copy_and_prepare_for_recv(ompi_mpi_local_convertor,
+        &dtype->super, count, buf, 0, &convertor);
+    opal_convertor_unpack(&convertor, &iov, &iov_count, &max_data);
+    OBJ_DESTRUCT(&convertor);
+}
+
+static void xhc_gather_init_local(xhc_comm_t *comms,
+        xhc_peer_info_t *peer_info, int rank, int root) {
+
+    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+        // Non-leader by default
+        xc->is_leader = false;
+    }
+
+    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+        // I'm the root and therefore always a leader
+        if(rank == root) {
+            xc->is_leader = true;
+            continue;
+        }
+
+        // The root takes leadership precedence when local
+        if(PEER_IS_LOCAL(peer_info, root, xc->locality)) {
+            break;
+        }
+
+        // Otherwise the owner is the leader
+        if(0 != xc->my_id) {
+            break;
+        }
+
+        xc->is_leader = true;
+    }
+}
+
+/* Advertise the root's buffer on the comms that I lead, from the top-most
+ * one downwards. Members only read the comm ctrl fields between seeing the
+ * comm seq and setting their member seq, and the leader waits for the latter
+ * before finishing the op; so no need to check comm ack before writing. */
+static void xhc_gather_notify(xhc_comm_t *comms, int root,
+        void *vaddr, void *token, xf_sig_t seq) {
+
+    xhc_comm_t *top = NULL;
+
+    for(xhc_comm_t *xc = comms; xc && xc->is_leader; xc = xc->up) {
+        top = xc;
+    }
+
+    for(xhc_comm_t *xc = top; xc; xc = xc->down) {
+        xc->comm_ctrl->leader_rank = root;
+        xc->comm_ctrl->data_vaddr = vaddr;
+
+        if(NULL != token) {
+            xhc_copy_region_post((void *) xc->comm_ctrl->access_token, token);
+        }
+
+        /* Make sure the above stores complete
+         * before the one to the control flag */
+        xhc_atomic_wmb();
+
+        xc->comm_ctrl->seq = seq;
+    }
+}
+
+static void xhc_gather_join(xhc_comm_t *comms, xf_sig_t seq) {
+    for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+        if(!xc->is_leader) {
+            /* Make sure our copies have completed
+             * before announcing that we're done */
+            xhc_atomic_wmb();
+
+            xc->my_ctrl->seq = seq;
+            break;
+        }
+
+        for(int m = 0; m < xc->size; m++) {
+            if(m == xc->my_id) {
+                continue;
+            }
+
+            WAIT_FLAG(&xc->member_ctrl[m].seq, seq, 0);
+        }
+
+        xhc_atomic_rmb();
+    }
+}
+
+static void xhc_gather_ack(xhc_comm_t *comms, xf_sig_t seq, bool wait) {
+    /* In CICO gather, the root reads the data out of each member's CICO
+     * buffer after they've joined. The members must not return (and
+     * possibly reuse the CICO buffer in another op), until it's done. */
+    if(wait) {
+        for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+            if(!xc->is_leader) {
+                WAIT_FLAG(&xc->comm_ctrl->ack, seq, 0);
+                break;
+            }
+        }
+    }
+
+    for(xhc_comm_t *xc = comms; xc && xc->is_leader; xc = xc->up) {
+        xc->comm_ctrl->ack = seq;
+    }
+}
+
+// ------------------------------------------------
+
+int mca_coll_xhc_gather_internal(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+        ompi_datatype_t *rdtype, int root, ompi_communicator_t *ompi_comm,
+        mca_coll_base_module_t *ompi_module, XHC_COLLTYPE_T colltype) {
+
+    xhc_module_t *module = (xhc_module_t *) ompi_module;
+
+    int rank = ompi_comm_rank(ompi_comm);
+    int comm_size = ompi_comm_size(ompi_comm);
+
+    bool is_scatter = (XHC_SCATTER == colltype);
+
+    xhc_copy_method_t method;
+    size_t block, dtype_size;
+
+    int err = OMPI_SUCCESS;
+
+    // ---
+
+    /* Determine the size of each rank's block, according to which
+     * arguments are significant on this rank. It only depends on the
+     * type signatures, so it's the same on all ranks. */
+    if(is_scatter && rank == root) {
+        ompi_datatype_type_size(sdtype, &dtype_size);
+        block = scount * dtype_size;
+    } else if(is_scatter) {
+        ompi_datatype_type_size(rdtype, &dtype_size);
+        block = rcount * dtype_size;
+    } else if(XHC_ALLGATHER == colltype || rank == root) {
+        ompi_datatype_type_size(rdtype, &dtype_size);
+        block = rcount * dtype_size;
+    } else {
+        ompi_datatype_type_size(sdtype, &dtype_size);
+        block = scount * dtype_size;
+    }
+
+    if(0 == block) {
+        return OMPI_SUCCESS;
+    }
+
+    size_t cico_size = module->op_config[colltype].cico_max;
+
+    if((is_scatter ? comm_size * block : block) <= cico_size) {
+        method = XHC_COPY_CICO;
+    } else if(module->zcopy_support) {
+        method = (module->zcopy_map_support ?
+            XHC_COPY_SMSC_MAP : XHC_COPY_SMSC_NO_MAP);
+    } else {
+        WARN_ONCE("coll:xhc: Warning: No smsc support; utilizing fallback "
+            "component for %s greater than %zu bytes",
+            xhc_colltype_to_str(colltype), cico_size);
+        goto _fallback;
+    }
+
+    if(!module->op_data[colltype].init) {
+        err = xhc_init_op(module, ompi_comm, colltype);
+        if(OMPI_SUCCESS != err) {goto _fallback_permanent;}
+    }
+
+    xhc_request_drain(module);
+
+    // ---
+
+    xhc_peer_info_t *peer_info = module->peer_info;
+    xhc_op_data_t *data = &module->op_data[colltype];
+    xhc_comm_t *comms = data->comms;
+
+    bool has_token = mca_smsc_base_has_feature(
+        MCA_SMSC_FEATURE_REQUIRE_REGISTRATION);
+
+    /* Pack the significant buffers of this rank that xhc can't address
+     * directly; the protocol below only sees the packed copies. */
+    void *user_rbuf = rbuf;
+    void *staged_sbuf = NULL, *staged_rbuf = NULL;
+    size_t staged_rbuf_count = 0, staged_rbuf_bytes = 0;
+
+    if(MPI_IN_PLACE != sbuf && (!is_scatter || rank == root)
+            && !xhc_gather_dtype_direct(sdtype)) {
+        size_t sbuf_count = (is_scatter ? comm_size * scount : scount);
+
+        staged_sbuf = xhc_gather_stage(sbuf, sbuf_count, sdtype,
+            (is_scatter ? comm_size * block : block), true);
+        if(NULL == staged_sbuf) {return OMPI_ERR_OUT_OF_RESOURCE;}
+        sbuf = staged_sbuf;
+    }
+
+    if(MPI_IN_PLACE != rbuf && (is_scatter || XHC_ALLGATHER == colltype
+            || rank == root) && !xhc_gather_dtype_direct(rdtype)) {
+        staged_rbuf_count = (is_scatter ? rcount : comm_size * rcount);
+        staged_rbuf_bytes = (is_scatter ? block : comm_size * block);
+
+        /* With in-place gather/allgather, this rank's own block is
+         * already inside rbuf */
+        staged_rbuf = xhc_gather_stage(rbuf, staged_rbuf_count, rdtype,
+            staged_rbuf_bytes, (!is_scatter && MPI_IN_PLACE == sbuf));
+        if(NULL == staged_rbuf) {
+            free(staged_sbuf);
+            return OMPI_ERR_OUT_OF_RESOURCE;
+        }
+        rbuf = staged_rbuf;
+    }
+
+    /* The data this rank contributes, in gather and allgather. In in-place
+     * allgather, it's already in its place inside rbuf. */
+    const void *send = sbuf;
+    if(XHC_ALLGATHER == colltype && MPI_IN_PLACE == sbuf) {
+        send = (char *) rbuf + rank * block;
+    }
+
+    xf_sig_t seq = ++data->seq;
+
+    xhc_gather_init_local(comms, peer_info, rank, root);
+
+    if(rank == root) {
+        char *root_buf = (is_scatter ? (char *) sbuf : (char *) rbuf);
+        xhc_copy_data_t *region_data = NULL;
+
+        if(is_scatter && MPI_IN_PLACE != rbuf) {
+            xhc_memcpy(rbuf, root_buf + rank * block, block);
+        } else if(!is_scatter && MPI_IN_PLACE != sbuf) {
+            xhc_memcpy(root_buf + rank * block, send, block);
+        }
+
+        /* Safe to write to the CICO buffer; in any past op where others
+         * read from it, this rank gathered their completion before exiting */
+        if(XHC_COPY_CICO == method && is_scatter) {
+            void *self_cico = xhc_get_cico(peer_info, rank);
+            if(NULL == self_cico) {err = OMPI_ERR_OUT_OF_RESOURCE; goto _end;}
+
+            xhc_memcpy(self_cico, root_buf, comm_size * block);
+        } else if(XHC_COPY_CICO != method) {
+            err = xhc_copy_expose_region(root_buf,
+                comm_size * block, &region_data);
+            if(0 != err) {err = OMPI_ERROR; goto _end;}
+        }
+
+        if(XHC_COPY_CICO != method || is_scatter) {
+            xhc_gather_notify(comms, rank, root_buf, region_data, seq);
+        }
+
+        xhc_gather_join(comms, seq);
+
+        if(XHC_COPY_CICO == method && !is_scatter) {
+            for(int r = 0; r < comm_size; r++) {
+                if(r == rank) {
+                    continue;
+                }
+
+                void *cico = xhc_get_cico(peer_info, r);
+                if(NULL == cico) {err = OMPI_ERR_OUT_OF_RESOURCE; goto _end;}
+
+                xhc_memcpy(root_buf + r * block, cico, block);
+            }
+        }
+
+        xhc_gather_ack(comms, seq, false);
+
+        if(NULL != region_data) {
+            xhc_copy_close_region(region_data);
+        }
+    } else if(XHC_COPY_CICO == method && !is_scatter) {
+        void *self_cico = xhc_get_cico(peer_info, rank);
+        if(NULL == self_cico) {err = OMPI_ERR_OUT_OF_RESOURCE; goto _end;}
+
+        xhc_memcpy(self_cico, send, block);
+
+        xhc_gather_join(comms, seq);
+
+        /* In allgather, the broadcast that follows only starts after the
+         * root has read all CICO buffers, and it's enough to keep them safe. */
+        xhc_gather_ack(comms, seq, (XHC_GATHER == colltype));
+    } else {
+        xhc_comm_t *src_comm = NULL;
+
+        for(xhc_comm_t *xc = comms; xc; xc = xc->up) {
+            if(!xc->is_leader) {
+                src_comm = xc;
+                break;
+            }
+        }
+
+        xhc_comm_ctrl_t *src_ctrl = src_comm->comm_ctrl;
+
+        WAIT_FLAG(&src_ctrl->seq, seq, 0);
+        xhc_atomic_rmb();
+
+        int src_rank = src_ctrl->leader_rank;
+        char *src_vaddr = (char *) src_ctrl->data_vaddr + rank * block;
+        void *token = (void *) src_ctrl->access_token;
+
+        // Pass it on to the ranks under me, before doing my own copy
+        xhc_gather_notify(comms, src_rank, src_ctrl->data_vaddr,
+            (has_token ? token : NULL), seq);
+
+        switch(method) {
+            case XHC_COPY_CICO: {
+                char *cico = xhc_get_cico(peer_info, src_rank);
+                if(NULL == cico) {err = OMPI_ERR_OUT_OF_RESOURCE; goto _end;}
+
+                xhc_memcpy(rbuf, cico + rank * block, block);
+                break;
+            }
+
+            case XHC_COPY_SMSC_MAP: {
+                xhc_reg_t *reg;
+
+                void *mapped = xhc_get_registration(&peer_info[src_rank],
+                    src_vaddr, block, &reg);
+                if(NULL == mapped) {err = OMPI_ERROR; goto _end;}
+
+                if(is_scatter) {
+                    xhc_memcpy(rbuf, mapped, block);
+                } else {
+                    xhc_memcpy(mapped, send, block);
+                }
+
+                xhc_return_registration(reg);
+                break;
+            }
+
+            case XHC_COPY_SMSC_NO_MAP:
+                if(is_scatter) {
+                    err = xhc_copy_from(&peer_info[src_rank],
+                        rbuf, src_vaddr, block, token);
+                } else {
+                    err = xhc_copy_to(&peer_info[src_rank],
+                        (void *) send, src_vaddr, block, token);
+                }
+
+                if(0 != err) {err = OMPI_ERROR; goto _end;}
+                break;
+
+            default:
+                assert(0);
+        }
+
+        xhc_gather_join(comms, seq);
+        xhc_gather_ack(comms, seq, false);
+    }
+
+    /* Broadcast bytes, so that ranks with packed and direct buffers
+     * take the same path in bcast too */
+    if(XHC_ALLGATHER == colltype) {
+        err = mca_coll_xhc_bcast(rbuf, comm_size * block,
+            MPI_BYTE, root, ompi_comm, ompi_module);
+    }
+
+_end:
+
+    if(NULL != staged_rbuf) {
+        if(OMPI_SUCCESS == err) {
+            xhc_gather_unstage(user_rbuf, staged_rbuf_count, rdtype,
+                staged_rbuf, staged_rbuf_bytes);
+        }
+
+        free(staged_rbuf);
+    }
+
+    free(staged_sbuf);
+
+    return err;
+
+    // ---
+
+_fallback_permanent:
+
+    if(XHC_SCATTER == colltype) {
+        XHC_INSTALL_FALLBACK(module,
+            ompi_comm, XHC_SCATTER, scatter);
+    } else if(XHC_ALLGATHER == colltype) {
+        XHC_INSTALL_FALLBACK(module,
+            ompi_comm, XHC_ALLGATHER, allgather);
+    } else {
+        XHC_INSTALL_FALLBACK(module,
+            ompi_comm, XHC_GATHER, gather);
+    }
+
+_fallback:
+
+    if(XHC_SCATTER == colltype) {
+        return XHC_CALL_FALLBACK(module->prev_colls, XHC_SCATTER, scatter,
+            sbuf, scount, sdtype, rbuf, rcount, rdtype, root, ompi_comm);
+    } else if(XHC_ALLGATHER == colltype) {
+        return XHC_CALL_FALLBACK(module->prev_colls, XHC_ALLGATHER, allgather,
+            sbuf, scount, sdtype, rbuf, rcount, rdtype, ompi_comm);
+    } else {
+        return XHC_CALL_FALLBACK(module->prev_colls, XHC_GATHER, gather,
+            sbuf, scount, sdtype, rbuf, rcount, rdtype, root, ompi_comm);
+    }
+}
+
+int mca_coll_xhc_gather(const void *sbuf, size_t scount,
+        ompi_datatype_t *sdtype, void *rbuf, size_t rcount,
+        ompi_datatype_t *rdtype, int root, ompi_communicator_t *ompi_comm,
+        mca_coll_base_module_t *ompi_module) {
+
+    return xhc_gather_internal(sbuf, scount, sdtype, rbuf, rcount,
+        rdtype, root, ompi_comm, ompi_module, XHC_GATHER);
+}
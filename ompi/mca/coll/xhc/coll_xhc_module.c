@@ -19,6 +19,7 @@
 #include "ompi/mca/coll/coll.h"
 #include "ompi/mca/coll/base/base.h"
 #include "opal/mca/smsc/smsc.h"
+#include "opal/runtime/opal_progress.h"
 
 #include "opal/util/arch.h"
 #include "opal/util/show_help.h"
@@ -40,21 +41,44 @@ static size_t xhc_colltype_to_c_coll_fn_offset_map[XHC_COLLCOUNT] = {
     [XHC_BCAST] = offsetof(mca_coll_base_comm_coll_t, coll_bcast),
     [XHC_BARRIER] = offsetof(mca_coll_base_comm_coll_t, coll_barrier),
     [XHC_REDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_reduce),
-    [XHC_ALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce)
+    [XHC_ALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce),
+    [XHC_ALLGATHER] = offsetof(mca_coll_base_comm_coll_t, coll_allgather),
+    [XHC_GATHER] = offsetof(mca_coll_base_comm_coll_t, coll_gather),
+    [XHC_SCATTER] = offsetof(mca_coll_base_comm_coll_t, coll_scatter)
 };
 
 static size_t xhc_colltype_to_c_coll_module_offset_map[XHC_COLLCOUNT] = {
     [XHC_BCAST] = offsetof(mca_coll_base_comm_coll_t, coll_bcast_module),
     [XHC_BARRIER] = offsetof(mca_coll_base_comm_coll_t, coll_barrier_module),
     [XHC_REDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_reduce_module),
-    [XHC_ALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce_module)
+    [XHC_ALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce_module),
+    [XHC_ALLGATHER] = offsetof(mca_coll_base_comm_coll_t, coll_allgather_module),
+    [XHC_GATHER] = offsetof(mca_coll_base_comm_coll_t, coll_gather_module),
+    [XHC_SCATTER] = offsetof(mca_coll_base_comm_coll_t, coll_scatter_module)
 };
 
 static size_t xhc_colltype_to_base_module_fn_offset_map[XHC_COLLCOUNT] = {
     [XHC_BCAST] = offsetof(mca_coll_base_module_t, coll_bcast),
     [XHC_BARRIER] = offsetof(mca_coll_base_module_t, coll_barrier),
     [XHC_REDUCE] = offsetof(mca_coll_base_module_t, coll_reduce),
-    [XHC_ALLREDUCE] = offsetof(mca_coll_base_module_t, coll_allreduce)
+    [XHC_ALLREDUCE] = offsetof(mca_coll_base_module_t, coll_allreduce),
+    [XHC_ALLGATHER] = offsetof(mca_coll_base_module_t, coll_allgather),
+    [XHC_GATHER] = offsetof(mca_coll_base_module_t, coll_gather),
+    [XHC_SCATTER] = offsetof(mca_coll_base_module_t, coll_scatter)
+};
+
+static size_t xhc_nb_colltype_to_c_coll_fn_offset_map[XHC_NB_COLLCOUNT] = {
+    [XHC_IBCAST] = offsetof(mca_coll_base_comm_coll_t, coll_ibcast),
+    [XHC_IALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_iallreduce),
+    [XHC_BCAST_INIT] = offsetof(mca_coll_base_comm_coll_t, coll_bcast_init),
+    [XHC_ALLREDUCE_INIT] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce_init)
+};
+
+static size_t xhc_nb_colltype_to_c_coll_module_offset_map[XHC_NB_COLLCOUNT] = {
+    [XHC_IBCAST] = offsetof(mca_coll_base_comm_coll_t, coll_ibcast_module),
+    [XHC_IALLREDUCE] = offsetof(mca_coll_base_comm_coll_t, coll_iallreduce_module),
+    [XHC_BCAST_INIT] = offsetof(mca_coll_base_comm_coll_t, coll_bcast_init_module),
+    [XHC_ALLREDUCE_INIT] = offsetof(mca_coll_base_comm_coll_t, coll_allreduce_init_module)
 };
 
 static inline void (*MODULE_COLL_FN(xhc_module_t *module,
@@ -83,6 +107,17 @@ static inline void GET_COLL_API(ompi_communicator_t *comm, XHC_COLLTYPE_T collty
         + xhc_colltype_to_c_coll_module_offset_map[colltype]);
 }
 
+static inline void GET_NB_COLL_API(ompi_communicator_t *comm,
+        XHC_NB_COLLTYPE_T nb_colltype, void (**coll_fn_dst)(void),
+        void **coll_module_dst) {
+
+    *coll_fn_dst = * (void (**)(void)) ((uintptr_t) comm->c_coll
+        + xhc_nb_colltype_to_c_coll_fn_offset_map[nb_colltype]);
+
+    *coll_module_dst = * (void **) ((uintptr_t) comm->c_coll
+        + xhc_nb_colltype_to_c_coll_module_offset_map[nb_colltype]);
+}
+
 // -----------------------------
 
 static void xhc_module_clear(xhc_module_t *module) {
@@ -91,16 +126,25 @@ static void xhc_module_clear(xhc_module_t *module) {
 
     module->zcopy_support = false;
     module->zcopy_map_support = false;
+    module->zcopy_reduce_support = false;
 
     module->rbuf = NULL;
     module->rbuf_size = 0;
 
+    module->stage_buf = NULL;
+    module->stage_buf_size = 0;
+
     module->peer_info = NULL;
 
     memset(&module->prev_colls, 0, sizeof(module->prev_colls));
+    memset(&module->prev_nb_colls, 0, sizeof(module->prev_nb_colls));
     memset(&module->op_config, 0, sizeof(module->op_config));
     memset(&module->op_data, 0, sizeof(module->op_data));
 
+    module->nb_current = NULL;
+    module->nb_pending = 0;
+    module->nb_registered = false;
+
     module->init = false;
     module->error = false;
 }
@@ -118,6 +162,12 @@ static void mca_coll_xhc_module_destruct(mca_coll_xhc_module_t *module) {
         xhc_fini(module);
     }
 
+    if(module->nb_registered) {
+        if(0 == OPAL_THREAD_ADD_FETCH32(&mca_coll_xhc_component.active_comms, -1)) {
+            opal_progress_unregister(mca_coll_xhc_progress);
+        }
+    }
+
     for(int t = 0; t < XHC_COLLCOUNT; t++) {
         free(module->op_config[t].hierarchy_string);
         free(module->op_config[t].chunk_string);
@@ -172,6 +222,13 @@ mca_coll_base_module_t *mca_coll_xhc_module_comm_query(ompi_communicator_t *comm
     module->zcopy_support = (NULL != mca_smsc);
     module->zcopy_map_support = mca_smsc_base_has_feature(MCA_SMSC_FEATURE_CAN_MAP);
 
+    /* Without CAN_MAP, reductions access the peers' buffers through
+     * copy_from/copy_to. Addresses are exchanged via the member ctrl,
+     * which has no room for registration tokens (e.g. KNEM). */
+    module->zcopy_reduce_support = module->zcopy_map_support
+        || (module->zcopy_support && !mca_smsc_base_has_feature(
+        MCA_SMSC_FEATURE_REQUIRE_REGISTRATION));
+
     if(!module->zcopy_support) {
         opal_output_verbose(MCA_BASE_VERBOSE_COMPONENT,
             ompi_coll_base_framework.framework_output,
@@ -191,6 +248,14 @@ mca_coll_base_module_t *mca_coll_xhc_module_comm_query(ompi_communicator_t *comm
     module->super.coll_barrier = mca_coll_xhc_barrier;
     module->super.coll_allreduce = mca_coll_xhc_allreduce;
     module->super.coll_reduce = mca_coll_xhc_reduce;
+    module->super.coll_allgather = mca_coll_xhc_allgather;
+    module->super.coll_gather = mca_coll_xhc_gather;
+    module->super.coll_scatter = mca_coll_xhc_scatter;
+
+    module->super.coll_ibcast = mca_coll_xhc_ibcast;
+    module->super.coll_iallreduce = mca_coll_xhc_iallreduce;
+    module->super.coll_bcast_init = mca_coll_xhc_bcast_persistent_init;
+    module->super.coll_allreduce_init = mca_coll_xhc_allreduce_persistent_init;
 
     return &module->super;
 }
@@ -237,6 +302,29 @@ int mca_coll_xhc_module_enable(mca_coll_base_module_t *ompi_module,
         module->prev_colls.coll_module[t] = fallback_module;
     }
 
+    /* The nonblocking and persistent ops are only provided if there's
+     * also a fallback for all of them (e.g. libnbc was not excluded) */
+    bool nb_support = true;
+
+    for(int t = 0; t < XHC_NB_COLLCOUNT; t++) {
+        void (*fallback_fn)(void), *fallback_module;
+        GET_NB_COLL_API(comm, t, &fallback_fn, &fallback_module);
+
+        if(NULL == fallback_fn || NULL == fallback_module) {
+            opal_output_verbose(MCA_BASE_VERBOSE_COMPONENT,
+                ompi_coll_base_framework.framework_output,
+                "coll:xhc:module_enable (%s/%s): No previous fallback component "
+                "found for nonblocking ops; not providing them",
+                ompi_comm_print_cid(comm), comm->c_name);
+
+            nb_support = false;
+            break;
+        }
+
+        module->prev_nb_colls.coll_fn[t] = fallback_fn;
+        module->prev_nb_colls.coll_module[t] = fallback_module;
+    }
+
     /* We perform the pointer installation last, after we've
      * successfully captured all the fallback pointers we need,
      * and we know xhc_module_enable can no longer fail. */
@@ -245,6 +333,17 @@ int mca_coll_xhc_module_enable(mca_coll_base_module_t *ompi_module,
         if(fn) {INSTALL_COLL_API(comm, t, fn, module);}
     }
 
+    if(nb_support) {
+        comm->c_coll->coll_ibcast = module->super.coll_ibcast;
+        comm->c_coll->coll_ibcast_module = &module->super;
+        comm->c_coll->coll_iallreduce = module->super.coll_iallreduce;
+        comm->c_coll->coll_iallreduce_module = &module->super;
+        comm->c_coll->coll_bcast_init = module->super.coll_bcast_init;
+        comm->c_coll->coll_bcast_init_module = &module->super;
+        comm->c_coll->coll_allreduce_init = module->super.coll_allreduce_init;
+        comm->c_coll->coll_allreduce_init_module = &module->super;
+    }
+
     // ---
 
     return OMPI_SUCCESS;
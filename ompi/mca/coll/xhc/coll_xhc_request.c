@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2021-2024 Computer Architecture and VLSI Systems (CARV)
+ *                         Laboratory, ICS Forth. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+#include "mpi.h"
+
+#include "ompi/constants.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/request/request.h"
+
+#include "opal/class/opal_list.h"
+#include "opal/runtime/opal_progress.h"
+
+#include "coll_xhc.h"
+
+/* Nonblocking & persistent ops
+ * ----------------------------
+ * The primitives are already structured as state machines that can be
+ * advanced without blocking (e.g. xhc_bcast_start/work/ack_test). A request
+ * captures the arguments of the op, and its state machine is driven from
+ * opal_progress, through xhc_progress().
+ *
+ * All ops on a communicator use the same shared control structures and
+ * sequence numbers (e.g. an Ibcast uses those of Bcast), so they may not
+ * overlap with each other. The requests of each module are executed one at
+ * a time, in the order that they were started (which MPI guarantees is the
+ * same on all ranks). The blocking primitives first wait for any pending
+ * requests of the module to complete (xhc_request_drain()). */
+
+// ------------------------------------------------
+
+static int xhc_request_start(size_t count, ompi_request_t **requests);
+static int xhc_request_free(ompi_request_t **ompi_req);
+static int xhc_request_cancel(ompi_request_t *ompi_req, int complete);
+
+static void xhc_request_construct(xhc_request_t *req) {
+    req->super.req_type = OMPI_REQUEST_COLL;
+    req->super.req_status._cancelled = 0;
+    req->super.req_start = xhc_request_start;
+    req->super.req_free = xhc_request_free;
+    req->super.req_cancel = xhc_request_cancel;
+
+    req->module = NULL;
+    req->begin = NULL;
+    req->progress = NULL;
+
+    req->args.op = NULL;
+
+    req->begun = false;
+}
+
+static void xhc_request_destruct(xhc_request_t *req) {
+    OBJ_RELEASE_IF_NOT_NULL(req->args.op);
+}
+
+OBJ_CLASS_INSTANCE(xhc_request_t, ompi_request_t,
+    xhc_request_construct, xhc_request_destruct);
+
+// ------------------------------------------------
+
+xhc_request_t *mca_coll_xhc_request_new(xhc_module_t *module,
+        ompi_communicator_t *comm, bool persistent) {
+
+    xhc_request_t *req = OBJ_NEW(xhc_request_t);
+    if(NULL == req) {return NULL;}
+
+    OMPI_REQUEST_INIT(&req->super, persistent);
+    req->super.req_mpi_object.comm = comm;
+
+    req->module = module;
+
+    return req;
+}
+
+int mca_coll_xhc_request_post(xhc_request_t *req) {
+    xhc_module_t *module = req->module;
+
+    req->super.req_state = OMPI_REQUEST_ACTIVE;
+    req->super.req_complete = REQUEST_PENDING;
+    req->super.req_status.MPI_ERROR = OMPI_SUCCESS;
+    req->super.req_status._cancelled = 0;
+
+    req->begun = false;
+
+    if(!module->nb_registered) {
+        module->nb_registered = true;
+
+        if(1 == OPAL_THREAD_ADD_FETCH32(&mca_coll_xhc_component.active_comms, 1)) {
+            opal_progress_register(mca_coll_xhc_progress);
+        }
+    }
+
+    OPAL_THREAD_LOCK(&mca_coll_xhc_component.lock);
+    module->nb_pending++;
+    opal_list_append(&mca_coll_xhc_component.active_requests,
+        &req->super.super.super);
+    OPAL_THREAD_UNLOCK(&mca_coll_xhc_component.lock);
+
+    /* Get things going right away; if no other request of the module
+     * is ahead of this one, the root may e.g. already publish its data. */
+    xhc_progress();
+
+    return OMPI_SUCCESS;
+}
+
+void mca_coll_xhc_request_drain(xhc_module_t *module) {
+    while(module->nb_pending > 0) {
+        opal_progress();
+    }
+}
+
+// ------------------------------------------------
+
+int mca_coll_xhc_progress(void) {
+    xhc_request_t *req, *next;
+    int completed = 0;
+
+    if(0 == opal_list_get_size(&mca_coll_xhc_component.active_requests)) {
+        return 0;
+    }
+
+    OPAL_THREAD_LOCK(&mca_coll_xhc_component.lock);
+
+    // Return if invoked recursively, or from another thread
+    if(mca_coll_xhc_component.in_progress) {
+        OPAL_THREAD_UNLOCK(&mca_coll_xhc_component.lock);
+        return 0;
+    }
+
+    mca_coll_xhc_component.in_progress = true;
+
+    OPAL_LIST_FOREACH_SAFE(req, next,
+            &mca_coll_xhc_component.active_requests, xhc_request_t) {
+
+        xhc_module_t *module = req->module;
+
+        /* The list is in start order, so the first request of
+         * each module that we come across is its current one. */
+        if(NULL == module->nb_current) {
+            module->nb_current = req;
+        }
+
+        if(module->nb_current != req) {
+            continue;
+        }
+
+        OPAL_THREAD_UNLOCK(&mca_coll_xhc_component.lock);
+
+        int err = OMPI_SUCCESS;
+
+        if(!req->begun) {
+            err = req->begin(req);
+            req->begun = true;
+        }
+
+        if(OMPI_SUCCESS == err) {
+            err = req->progress(req);
+        }
+
+        OPAL_THREAD_LOCK(&mca_coll_xhc_component.lock);
+
+        if(OMPI_ERR_WOULD_BLOCK == err) {
+            continue;
+        }
+
+        opal_list_remove_item(&mca_coll_xhc_component.active_requests,
+            &req->super.super.super);
+
+        module->nb_current = NULL;
+        module->nb_pending--;
+
+        OPAL_THREAD_UNLOCK(&mca_coll_xhc_component.lock);
+
+        req->super.req_status.MPI_ERROR = err;
+        ompi_request_complete(&req->super, true);
+        completed++;
+
+        OPAL_THREAD_LOCK(&mca_coll_xhc_component.lock);
+    }
+
+    mca_coll_xhc_component.in_progress = false;
+
+    OPAL_THREAD_UNLOCK(&mca_coll_xhc_component.lock);
+
+    return completed;
+}
+
+// ------------------------------------------------
+
+static int xhc_request_start(size_t count, ompi_request_t **requests) {
+    for(size_t i = 0; i < count; i++) {
+        xhc_request_t *req = (xhc_request_t *) requests[i];
+
+        if(NULL == req || OMPI_REQUEST_COLL != req->super.req_type) {
+            continue;
+        }
+
+        assert(req->super.req_persistent);
+        assert(REQUEST_COMPLETE(&req->super));
+
+        int err = xhc_request_post(req);
+        if(OMPI_SUCCESS != err) {return err;}
+    }
+
+    return OMPI_SUCCESS;
+}
+
+static int xhc_request_free(ompi_request_t **ompi_req) {
+    xhc_request_t *req = (xhc_request_t *) *ompi_req;
+
+    if(!REQUEST_COMPLETE(&req->super)) {
+        return MPI_ERR_REQUEST;
+    }
+
+    OMPI_REQUEST_FINI(&req->super);
+    OBJ_RELEASE(req);
+
+    *ompi_req = MPI_REQUEST_NULL;
+
+    return OMPI_SUCCESS;
+}
+
+static int xhc_request_cancel(ompi_request_t *ompi_req, int complete) {
+    return MPI_ERR_REQUEST;
+}
@@ -22,9 +22,9 @@ AC_DEFUN([MCA_ompi_pml_ob1_POST_CONFIG], [
 # ------------------------------------------------
 # We can always build, unless we were explicitly disabled.
 AC_DEFUN([MCA_ompi_pml_ob1_CONFIG],[
-    OPAL_VAR_SCOPE_PUSH([pml_ob1_matching_engine])
+    OPAL_VAR_SCOPE_PUSH([pml_ob1_matching_engine pml_ob1_matching_avx512 pml_ob1_cflags_save])
     AC_ARG_WITH([pml-ob1-matching], [AS_HELP_STRING([--with-pml-ob1-matching=type],
-                                                    [Configure pml/ob1 to use an alternate matching engine. Only valid on x86_64 systems.
+                                                    [Default matching engine of pml/ob1, which can also be selected at runtime with the pml_ob1_matching_engine MCA parameter. The fuzzy and vector engines are only available on x86_64 systems with AVX-512.
                                                      Valid values are: none, default, arrays, fuzzy-byte, fuzzy-short, fuzzy-word, vector (default: none)])])
 
     pml_ob1_matching_engine=MCA_PML_OB1_CUSTOM_MATCHING_NONE
@@ -58,8 +58,43 @@ AC_DEFUN([MCA_ompi_pml_ob1_CONFIG],[
         esac
     fi
 
-    AC_DEFINE_UNQUOTED([MCA_PML_OB1_CUSTOM_MATCHING], [$pml_ob1_matching_engine], [Custom matching engine to use in pml/ob1])
+    # The vectorized engines are built with the AVX-512 flags in their own
+    # library, and only selected at runtime if the processor supports them.
+    pml_ob1_matching_avx512=0
+    MCA_BUILD_PML_OB1_AVX512_FLAGS=""
+    case "${host}" in
+        x86_64*|amd64*)
+            AC_MSG_CHECKING([for AVX512 support of the pml/ob1 matching engines (with -mavx512f -mavx512bw)])
+            pml_ob1_cflags_save="$CFLAGS"
+            CFLAGS="-mavx512f -mavx512bw $CFLAGS"
+            AC_LINK_IFELSE(
+                [AC_LANG_PROGRAM([[#include <immintrin.h>]],
+                                 [[
+    __m512i vA = _mm512_set1_epi8(1), vB = _mm512_set1_epi16(1);
+    __mmask64 m = _mm512_cmpeq_epi8_mask(vA, vB);
+    if (__builtin_cpu_supports("avx512bw")) return (int) m;
+                                 ]])],
+                [pml_ob1_matching_avx512=1
+                 MCA_BUILD_PML_OB1_AVX512_FLAGS="-mavx512f -mavx512bw"
+                 AC_MSG_RESULT([yes])],
+                [AC_MSG_RESULT([no])])
+            CFLAGS="$pml_ob1_cflags_save"
+            ;;
+    esac
+
+    AS_IF([test $pml_ob1_matching_avx512 -eq 0],
+          [AS_CASE([$with_pml_ob1_matching],
+                   [fuzzy-*|vector],
+                   [AC_MSG_WARN([the $with_pml_ob1_matching matching engine of pml/ob1 requires AVX-512, ob1 will use its default matching])])])
+
+    AC_DEFINE_UNQUOTED([MCA_PML_OB1_CUSTOM_MATCHING], [$pml_ob1_matching_engine], [Default custom matching engine of pml/ob1])
+    AC_DEFINE_UNQUOTED([MCA_PML_OB1_CUSTOM_MATCHING_AVX512], [$pml_ob1_matching_avx512],
+                       [Whether the AVX-512 matching engines of pml/ob1 are built])
+    AM_CONDITIONAL([MCA_BUILD_ompi_pml_ob1_matching_avx512],
+                   [test "$pml_ob1_matching_avx512" = "1"])
+    AC_SUBST(MCA_BUILD_PML_OB1_AVX512_FLAGS)
 
     AC_CONFIG_FILES([ompi/mca/pml/ob1/Makefile])
+    OPAL_VAR_SCOPE_POP
     [$1]
 ])dnl
@@ -0,0 +1,65 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "pml_ob1_custom_match.h"
+
+const mca_base_var_enum_value_t mca_pml_ob1_custom_match_types[] = {
+    {MCA_PML_OB1_CUSTOM_MATCHING_NONE, "none"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_LINKEDLIST, "linkedlist"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_ARRAYS, "arrays"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_BYTE, "fuzzy_byte"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT, "fuzzy_short"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD, "fuzzy_word"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_VECTOR, "vector"},
+    {MCA_PML_OB1_CUSTOM_MATCHING_HASH, "hash"},
+    {0, NULL}
+};
+
+#if MCA_PML_OB1_CUSTOM_MATCHING_AVX512
+/* The vectorized engines are compiled for AVX-512 (F and BW for the byte
+ * engine), so they can only be used if the processor supports it. */
+static int custom_match_have_avx512(void)
+{
+    static int have_avx512 = -1;
+
+    if (-1 == have_avx512) {
+        __builtin_cpu_init();
+        have_avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+    return have_avx512;
+}
+#endif
+
+const mca_pml_ob1_custom_match_engine_t *mca_pml_ob1_custom_match_engine(int type)
+{
+    switch (type) {
+    case MCA_PML_OB1_CUSTOM_MATCHING_LINKEDLIST:
+        return &mca_pml_ob1_custom_match_linkedlist;
+    case MCA_PML_OB1_CUSTOM_MATCHING_ARRAYS:
+        return &mca_pml_ob1_custom_match_arrays;
+    case MCA_PML_OB1_CUSTOM_MATCHING_HASH:
+        return &mca_pml_ob1_custom_match_hash;
+#if MCA_PML_OB1_CUSTOM_MATCHING_AVX512
+    case MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_BYTE:
+        return custom_match_have_avx512() ? &mca_pml_ob1_custom_match_fuzzy_byte : NULL;
+    case MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT:
+        return custom_match_have_avx512() ? &mca_pml_ob1_custom_match_fuzzy_short : NULL;
+    case MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD:
+        return custom_match_have_avx512() ? &mca_pml_ob1_custom_match_fuzzy_word : NULL;
+    case MCA_PML_OB1_CUSTOM_MATCHING_VECTOR:
+        return custom_match_have_avx512() ? &mca_pml_ob1_custom_match_vector : NULL;
+#endif
+    default:
+        return NULL;
+    }
+}
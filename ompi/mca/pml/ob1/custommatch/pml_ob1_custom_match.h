@@ -3,6 +3,7 @@
  * Copyright (c) 2018      Los Alamos National Security, LLC. All rights
  *                         reserved.
  * Copyright (c) 2018      Sandia National Laboratories.  All rights reserved.
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
  *
  * $COPYRIGHT$
  *
@@ -15,10 +16,10 @@
 #define PML_OB1_CUSTOM_MATCH_H
 
 #include "ompi_config.h"
-#include "ompi/mca/pml/ob1/pml_ob1.h"
+#include "opal/mca/base/mca_base_var_enum.h"
 
-#define CUSTOM_MATCH_DEBUG         1
-#define CUSTOM_MATCH_DEBUG_VERBOSE 1
+#define CUSTOM_MATCH_DEBUG         0
+#define CUSTOM_MATCH_DEBUG_VERBOSE 0
 
 /**
  * Custom match types
@@ -30,29 +31,56 @@
 #define MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT 4
 #define MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD  5
 #define MCA_PML_OB1_CUSTOM_MATCHING_VECTOR      6
+#define MCA_PML_OB1_CUSTOM_MATCHING_HASH        7
+#define MCA_PML_OB1_CUSTOM_MATCHING_MAX         8
 
-#if MCA_PML_OB1_CUSTOM_MATCHING != MCA_PML_OB1_CUSTOM_MATCHING_NONE
-
-#define MCA_PML_OB1_CUSTOM_MATCH 1
-
-#if MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_LINKEDLIST
-#include "pml_ob1_custom_match_linkedlist.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_ARRAYS
-#include "pml_ob1_custom_match_arrays.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_BYTE
-#include "pml_ob1_custom_match_fuzzy512-byte.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_SHORT
-#include "pml_ob1_custom_match_fuzzy512-short.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_FUZZY_WORD
-#include "pml_ob1_custom_match_fuzzy512-word.h"
-#elif MCA_PML_OB1_CUSTOM_MATCHING == MCA_PML_OB1_CUSTOM_MATCHING_VECTOR
-#include "pml_ob1_custom_match_vectors.h"
-#endif
+/**
+ * A matching engine: the posted receive queue (prq) and the unexpected
+ * message queue (umq) of a communicator, replacing the per-peer lists of
+ * ob1. All the engines are built in the component (the vectorized ones
+ * only if the compiler supports AVX-512), and each communicator selects
+ * its engine when it is added to the PML. The hold arguments of
+ * umq_find_verify_hold are opaque cursors given back to umq_remove_hold.
+ */
+typedef struct mca_pml_ob1_custom_match_engine_t {
+    const char *name;
+    void *(*prq_init)(void);
+    void (*prq_destroy)(void *prq);
+    int (*prq_size)(void *prq);
+    void (*prq_append)(void *prq, void *payload, int tag, int source);
+    int (*prq_cancel)(void *prq, void *req);
+    void *(*prq_find_dequeue_verify)(void *prq, int tag, int peer);
+    void (*prq_dump)(void *prq);
+    void *(*umq_init)(void);
+    void (*umq_destroy)(void *umq);
+    int (*umq_size)(void *umq);
+    void (*umq_append)(void *umq, int tag, int source, void *payload);
+    void *(*umq_find_verify_hold)(void *umq, int tag, int peer, void **hold_prev,
+                                  void **hold_elem, int *hold_index);
+    void (*umq_remove_hold)(void *umq, void *prev, void *elem, int index);
+    void (*umq_dump)(void *umq);
+} mca_pml_ob1_custom_match_engine_t;
 
-#else
+extern const mca_pml_ob1_custom_match_engine_t mca_pml_ob1_custom_match_linkedlist;
+extern const mca_pml_ob1_custom_match_engine_t mca_pml_ob1_custom_match_arrays;
+extern const mca_pml_ob1_custom_match_engine_t mca_pml_ob1_custom_match_hash;
+#if MCA_PML_OB1_CUSTOM_MATCHING_AVX512
+extern const mca_pml_ob1_custom_match_engine_t mca_pml_ob1_custom_match_fuzzy_byte;
+extern const mca_pml_ob1_custom_match_engine_t mca_pml_ob1_custom_match_fuzzy_short;
+extern const mca_pml_ob1_custom_match_engine_t mca_pml_ob1_custom_match_fuzzy_word;
+extern const mca_pml_ob1_custom_match_engine_t mca_pml_ob1_custom_match_vector;
+#endif
 
-#define MCA_PML_OB1_CUSTOM_MATCH 0
+/**
+ * Names of the custom match types, terminated by a NULL string
+ */
+extern const mca_base_var_enum_value_t mca_pml_ob1_custom_match_types[];
 
-#endif
+/**
+ * Return the engine of a custom match type, or NULL for
+ * MCA_PML_OB1_CUSTOM_MATCHING_NONE and for the engines that cannot run
+ * here (not built, or not supported by the processor).
+ */
+const mca_pml_ob1_custom_match_engine_t *mca_pml_ob1_custom_match_engine(int type);
 
 #endif
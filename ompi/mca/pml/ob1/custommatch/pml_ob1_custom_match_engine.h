@@ -0,0 +1,113 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Build the engine table of a matching engine. This file is included once
+ * per engine, by a source file which first includes the header of the
+ * engine and defines MCA_PML_OB1_CUSTOM_MATCH_ENGINE (the name of the
+ * table) and MCA_PML_OB1_CUSTOM_MATCH_ENGINE_NAME (its name, as a string).
+ * The engines all use the same names for their types and functions, so
+ * each one lives in its own translation unit.
+ */
+
+#include "pml_ob1_custom_match.h"
+
+static void *engine_prq_init(void)
+{
+    return custom_match_prq_init();
+}
+
+static void engine_prq_destroy(void *prq)
+{
+    custom_match_prq_destroy((custom_match_prq *) prq);
+}
+
+static int engine_prq_size(void *prq)
+{
+    return custom_match_prq_size((custom_match_prq *) prq);
+}
+
+static void engine_prq_append(void *prq, void *payload, int tag, int source)
+{
+    custom_match_prq_append((custom_match_prq *) prq, payload, tag, source);
+}
+
+static int engine_prq_cancel(void *prq, void *req)
+{
+    return custom_match_prq_cancel((custom_match_prq *) prq, req);
+}
+
+static void *engine_prq_find_dequeue_verify(void *prq, int tag, int peer)
+{
+    return custom_match_prq_find_dequeue_verify((custom_match_prq *) prq, tag, peer);
+}
+
+static void engine_prq_dump(void *prq)
+{
+    custom_match_prq_dump((custom_match_prq *) prq);
+}
+
+static void *engine_umq_init(void)
+{
+    return custom_match_umq_init();
+}
+
+static void engine_umq_destroy(void *umq)
+{
+    custom_match_umq_destroy((custom_match_umq *) umq);
+}
+
+static int engine_umq_size(void *umq)
+{
+    return custom_match_umq_size((custom_match_umq *) umq);
+}
+
+static void engine_umq_append(void *umq, int tag, int source, void *payload)
+{
+    custom_match_umq_append((custom_match_umq *) umq, tag, source, payload);
+}
+
+static void *engine_umq_find_verify_hold(void *umq, int tag, int peer, void **hold_prev,
+                                         void **hold_elem, int *hold_index)
+{
+    return custom_match_umq_find_verify_hold((custom_match_umq *) umq, tag, peer,
+                                             (custom_match_umq_node **) hold_prev,
+                                             (custom_match_umq_node **) hold_elem, hold_index);
+}
+
+static void engine_umq_remove_hold(void *umq, void *prev, void *elem, int index)
+{
+    custom_match_umq_remove_hold((custom_match_umq *) umq, (custom_match_umq_node *) prev,
+                                 (custom_match_umq_node *) elem, index);
+}
+
+static void engine_umq_dump(void *umq)
+{
+    custom_match_umq_dump((custom_match_umq *) umq);
+}
+
+const mca_pml_ob1_custom_match_engine_t MCA_PML_OB1_CUSTOM_MATCH_ENGINE = {
+    .name = MCA_PML_OB1_CUSTOM_MATCH_ENGINE_NAME,
+    .prq_init = engine_prq_init,
+    .prq_destroy = engine_prq_destroy,
+    .prq_size = engine_prq_size,
+    .prq_append = engine_prq_append,
+    .prq_cancel = engine_prq_cancel,
+    .prq_find_dequeue_verify = engine_prq_find_dequeue_verify,
+    .prq_dump = engine_prq_dump,
+    .umq_init = engine_umq_init,
+    .umq_destroy = engine_umq_destroy,
+    .umq_size = engine_umq_size,
+    .umq_append = engine_umq_append,
+    .umq_find_verify_hold = engine_umq_find_verify_hold,
+    .umq_remove_hold = engine_umq_remove_hold,
+    .umq_dump = engine_umq_dump,
+};
@@ -11,13 +11,13 @@
  * $HEADER$
  */
 
-#ifndef PML_OB1_CUSTOM_MATCH_FUZZY512_SHORT_H
-#define PML_OB1_CUSTOM_MATCH_FUZZY512_SHORT_H
+#ifndef PML_OB1_CUSTOM_MATCH_FUZZY512_WORD_H
+#define PML_OB1_CUSTOM_MATCH_FUZZY512_WORD_H
 
 #include <immintrin.h>
 
-#include "ompi/mca/pml/ob1/pml_ob1_recvfrag.h"
-#include "ompi/mca/pml/ob1/pml_ob1_recvreq.h"
+#include "../pml_ob1_recvfrag.h"
+#include "../pml_ob1_recvreq.h"
 
 typedef struct custom_match_prq_node
 {
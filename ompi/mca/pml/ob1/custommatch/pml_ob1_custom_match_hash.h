@@ -0,0 +1,487 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#ifndef PML_OB1_CUSTOM_MATCH_HASH_H
+#define PML_OB1_CUSTOM_MATCH_HASH_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "../pml_ob1_recvreq.h"
+#include "../pml_ob1_recvfrag.h"
+
+/*
+ * Hash indexed queues, for the communicators which assert that they use
+ * neither MPI_ANY_SOURCE nor MPI_ANY_TAG. The posted receives and the
+ * unexpected fragments are hashed on (source, tag), and each bucket keeps
+ * its elements in order, so that a message is matched with the first
+ * element of its bucket with the same source and tag, without scanning the
+ * messages of the other sources and tags.
+ *
+ * Receives with a wildcard are still matched correctly, but slowly: they
+ * are kept in order in a separate list of the posted receive queue, and
+ * they scan the list of all the unexpected fragments in order of arrival.
+ */
+
+/* Initial number of buckets, a power of 2. The table doubles when it
+ * holds more than 2 elements per bucket on average. */
+#define CUSTOM_MATCH_HASH_INIT_SIZE 256
+
+typedef struct custom_match_hash_node
+{
+    /* bucket of the node, or pool */
+    struct custom_match_hash_node* next;
+    struct custom_match_hash_node* prev;
+    /* unexpected fragments in order of arrival, or receives with a wildcard */
+    struct custom_match_hash_node* order_next;
+    struct custom_match_hash_node* order_prev;
+    int tag;
+    int src;
+    uint64_t seq;
+    void* value;
+} custom_match_hash_node;
+
+typedef struct custom_match_hash_bucket
+{
+    custom_match_hash_node* head;
+    custom_match_hash_node* tail;
+} custom_match_hash_bucket;
+
+typedef struct custom_match_hash_table
+{
+    custom_match_hash_bucket* buckets;
+    uint32_t mask;
+    int count;
+} custom_match_hash_table;
+
+static inline uint32_t custom_match_hash_index(const custom_match_hash_table* table, int tag, int src)
+{
+    uint32_t h = ((uint32_t) src * 0x9e3779b1u) ^ ((uint32_t) tag * 0x85ebca6bu);
+
+    h ^= h >> 16;
+    return h & table->mask;
+}
+
+static inline int custom_match_hash_table_init(custom_match_hash_table* table)
+{
+    table->buckets = calloc(CUSTOM_MATCH_HASH_INIT_SIZE, sizeof(custom_match_hash_bucket));
+    table->mask = CUSTOM_MATCH_HASH_INIT_SIZE - 1;
+    table->count = 0;
+    return (NULL == table->buckets) ? -1 : 0;
+}
+
+static inline void custom_match_hash_bucket_append(custom_match_hash_bucket* bucket, custom_match_hash_node* node)
+{
+    node->next = NULL;
+    node->prev = bucket->tail;
+    if (bucket->tail) {
+        bucket->tail->next = node;
+    } else {
+        bucket->head = node;
+    }
+    bucket->tail = node;
+}
+
+/* Double the number of buckets. The nodes of a (source, tag) are all in the
+ * same bucket, and they stay in order in their new bucket. */
+static inline void custom_match_hash_table_grow(custom_match_hash_table* table)
+{
+    custom_match_hash_bucket* old_buckets = table->buckets;
+    uint32_t old_size = table->mask + 1;
+    custom_match_hash_bucket* buckets = calloc(2 * old_size, sizeof(custom_match_hash_bucket));
+
+    if (NULL == buckets) {
+        /* keep the longer buckets */
+        return;
+    }
+    table->buckets = buckets;
+    table->mask = 2 * old_size - 1;
+    for (uint32_t i = 0; i < old_size; ++i) {
+        custom_match_hash_node* node = old_buckets[i].head;
+        while (node) {
+            custom_match_hash_node* next = node->next;
+            custom_match_hash_bucket_append(&buckets[custom_match_hash_index(table, node->tag, node->src)], node);
+            node = next;
+        }
+    }
+    free(old_buckets);
+}
+
+static inline void custom_match_hash_table_append(custom_match_hash_table* table, custom_match_hash_node* node)
+{
+    if (table->count >= (int) (2 * (table->mask + 1))) {
+        custom_match_hash_table_grow(table);
+    }
+    custom_match_hash_bucket_append(&table->buckets[custom_match_hash_index(table, node->tag, node->src)], node);
+    table->count++;
+}
+
+static inline void custom_match_hash_table_remove(custom_match_hash_table* table, custom_match_hash_node* node)
+{
+    custom_match_hash_bucket* bucket = &table->buckets[custom_match_hash_index(table, node->tag, node->src)];
+
+    if (node->prev) {
+        node->prev->next = node->next;
+    } else {
+        bucket->head = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    } else {
+        bucket->tail = node->prev;
+    }
+    table->count--;
+}
+
+/* First node of a (source, tag) */
+static inline custom_match_hash_node* custom_match_hash_table_find(custom_match_hash_table* table, int tag, int src)
+{
+    custom_match_hash_node* node = table->buckets[custom_match_hash_index(table, tag, src)].head;
+
+    while (node && (node->tag != tag || node->src != src)) {
+        node = node->next;
+    }
+    return node;
+}
+
+static inline void custom_match_hash_table_destroy(custom_match_hash_table* table)
+{
+    for (uint32_t i = 0; i <= table->mask; ++i) {
+        custom_match_hash_node* node = table->buckets[i].head;
+        while (node) {
+            custom_match_hash_node* next = node->next;
+            free(node);
+            node = next;
+        }
+    }
+    free(table->buckets);
+}
+
+static inline custom_match_hash_node* custom_match_hash_node_alloc(custom_match_hash_node** pool)
+{
+    custom_match_hash_node* node = *pool;
+
+    if (node) {
+        *pool = node->next;
+        return node;
+    }
+    return malloc(sizeof(custom_match_hash_node));
+}
+
+static inline void custom_match_hash_node_release(custom_match_hash_node** pool, custom_match_hash_node* node)
+{
+    node->value = NULL;
+    node->next = *pool;
+    *pool = node;
+}
+
+static inline void custom_match_hash_pool_destroy(custom_match_hash_node* pool)
+{
+    while (pool) {
+        custom_match_hash_node* next = pool->next;
+        free(pool);
+        pool = next;
+    }
+}
+
+/* Whether a message of (source, tag) matches a receive, which can have wildcards */
+static inline int custom_match_hash_matches(int recv_tag, int recv_src, int tag, int src)
+{
+    return (OMPI_ANY_SOURCE == recv_src || recv_src == src) &&
+        ((OMPI_ANY_TAG == recv_tag && tag >= 0) || recv_tag == tag);
+}
+
+static inline int custom_match_hash_is_wild(int tag, int src)
+{
+    return OMPI_ANY_SOURCE == src || OMPI_ANY_TAG == tag;
+}
+
+/* Remove a node from an ordered list */
+static inline void custom_match_hash_order_remove(custom_match_hash_node** head, custom_match_hash_node** tail,
+                                                  custom_match_hash_node* node)
+{
+    if (node->order_prev) {
+        node->order_prev->order_next = node->order_next;
+    } else {
+        *head = node->order_next;
+    }
+    if (node->order_next) {
+        node->order_next->order_prev = node->order_prev;
+    } else {
+        *tail = node->order_prev;
+    }
+}
+
+static inline void custom_match_hash_order_append(custom_match_hash_node** head, custom_match_hash_node** tail,
+                                                  custom_match_hash_node* node)
+{
+    node->order_next = NULL;
+    node->order_prev = *tail;
+    if (*tail) {
+        (*tail)->order_next = node;
+    } else {
+        *head = node;
+    }
+    *tail = node;
+}
+
+// PRQ below.
+
+typedef struct custom_match_prq
+{
+    /* specific receives */
+    custom_match_hash_table table;
+    /* receives with a wildcard, in order */
+    custom_match_hash_node* wild_head;
+    custom_match_hash_node* wild_tail;
+    custom_match_hash_node* pool;
+    /* order of the receives, between the specific and the wildcard ones */
+    uint64_t seq;
+    int size;
+} custom_match_prq;
+
+static inline void custom_match_prq_remove(custom_match_prq* list, custom_match_hash_node* node)
+{
+    if (custom_match_hash_is_wild(node->tag, node->src)) {
+        custom_match_hash_order_remove(&list->wild_head, &list->wild_tail, node);
+    } else {
+        custom_match_hash_table_remove(&list->table, node);
+    }
+    custom_match_hash_node_release(&list->pool, node);
+    list->size--;
+}
+
+static inline int custom_match_prq_cancel(custom_match_prq* list, void* req)
+{
+    mca_pml_base_request_t *base = &((mca_pml_ob1_recv_request_t *) req)->req_recv.req_base;
+    custom_match_hash_node* node;
+
+    if (custom_match_hash_is_wild(base->req_tag, base->req_peer)) {
+        node = list->wild_head;
+        while (node && node->value != req) {
+            node = node->order_next;
+        }
+    } else {
+        node = custom_match_hash_table_find(&list->table, base->req_tag, base->req_peer);
+        while (node && node->value != req) {
+            node = node->next;
+        }
+    }
+    if (NULL == node) {
+        return 0;
+    }
+    custom_match_prq_remove(list, node);
+    return 1;
+}
+
+static inline void* custom_match_prq_find_dequeue_verify(custom_match_prq* list, int tag, int peer)
+{
+    custom_match_hash_node* node = custom_match_hash_table_find(&list->table, tag, peer);
+    custom_match_hash_node* wild;
+    void* payload;
+
+    /* a receive with a wildcard posted before the specific one matches first */
+    for (wild = list->wild_head; NULL != wild; wild = wild->order_next) {
+        if (NULL != node && wild->seq > node->seq) {
+            break;
+        }
+        if (custom_match_hash_matches(wild->tag, wild->src, tag, peer)) {
+            node = wild;
+            break;
+        }
+    }
+    if (NULL == node) {
+        return NULL;
+    }
+    payload = node->value;
+    custom_match_prq_remove(list, node);
+    return payload;
+}
+
+static inline void custom_match_prq_append(custom_match_prq* list, void* payload, int tag, int source)
+{
+    custom_match_hash_node* node = custom_match_hash_node_alloc(&list->pool);
+
+    node->tag = tag;
+    node->src = source;
+    node->seq = list->seq++;
+    node->value = payload;
+    if (custom_match_hash_is_wild(tag, source)) {
+        custom_match_hash_order_append(&list->wild_head, &list->wild_tail, node);
+    } else {
+        custom_match_hash_table_append(&list->table, node);
+    }
+    list->size++;
+}
+
+static inline int custom_match_prq_size(custom_match_prq* list)
+{
+    return list->size;
+}
+
+static inline custom_match_prq* custom_match_prq_init()
+{
+    custom_match_prq* list = malloc(sizeof(custom_match_prq));
+
+    if (NULL == list) {
+        return NULL;
+    }
+    if (0 != custom_match_hash_table_init(&list->table)) {
+        free(list);
+        return NULL;
+    }
+    list->wild_head = NULL;
+    list->wild_tail = NULL;
+    list->pool = NULL;
+    list->seq = 0;
+    list->size = 0;
+    return list;
+}
+
+static inline void custom_match_prq_destroy(custom_match_prq* list)
+{
+    custom_match_hash_node* node = list->wild_head;
+
+    while (node) {
+        custom_match_hash_node* next = node->order_next;
+        free(node);
+        node = next;
+    }
+    custom_match_hash_table_destroy(&list->table);
+    custom_match_hash_pool_destroy(list->pool);
+    free(list);
+}
+
+static inline void custom_match_prq_dump_node(custom_match_hash_node* node)
+{
+    mca_pml_base_request_t *req = (mca_pml_base_request_t *) node->value;
+
+    opal_output(0, "req %p peer %d tag %d addr %p count %lu req_seq %" PRIu64 " seq %" PRIu64,
+                (void*) req, req->req_peer, req->req_tag, (void*) req->req_addr,
+                (unsigned long) req->req_count, req->req_sequence, node->seq);
+}
+
+static inline void custom_match_prq_dump(custom_match_prq* list)
+{
+    custom_match_hash_node* node;
+
+    opal_output(0, "%d posted receives, %d specific in %u buckets\n", list->size,
+                list->table.count, list->table.mask + 1);
+    for (uint32_t i = 0; i <= list->table.mask; ++i) {
+        for (node = list->table.buckets[i].head; node; node = node->next) {
+            custom_match_prq_dump_node(node);
+        }
+    }
+    for (node = list->wild_head; node; node = node->order_next) {
+        custom_match_prq_dump_node(node);
+    }
+}
+
+// UMQ below.
+
+typedef custom_match_hash_node custom_match_umq_node;
+
+typedef struct custom_match_umq
+{
+    custom_match_hash_table table;
+    /* all the fragments, in order of arrival */
+    custom_match_hash_node* order_head;
+    custom_match_hash_node* order_tail;
+    custom_match_hash_node* pool;
+    int size;
+} custom_match_umq;
+
+static inline void* custom_match_umq_find_verify_hold(custom_match_umq* list, int tag, int peer, custom_match_umq_node** hold_prev, custom_match_umq_node** hold_elem, int* hold_index)
+{
+    custom_match_hash_node* node;
+
+    if (!custom_match_hash_is_wild(tag, peer)) {
+        node = custom_match_hash_table_find(&list->table, tag, peer);
+    } else {
+        for (node = list->order_head; NULL != node; node = node->order_next) {
+            if (custom_match_hash_matches(tag, peer, node->tag, node->src)) {
+                break;
+            }
+        }
+    }
+    if (NULL == node) {
+        return NULL;
+    }
+    *hold_prev = NULL;
+    *hold_elem = node;
+    *hold_index = 0;
+    return node->value;
+}
+
+static inline void custom_match_umq_remove_hold(custom_match_umq* list, custom_match_umq_node* prev, custom_match_umq_node* elem, int i)
+{
+    custom_match_hash_table_remove(&list->table, elem);
+    custom_match_hash_order_remove(&list->order_head, &list->order_tail, elem);
+    custom_match_hash_node_release(&list->pool, elem);
+    list->size--;
+}
+
+static inline void custom_match_umq_append(custom_match_umq* list, int tag, int source, void* payload)
+{
+    custom_match_hash_node* node = custom_match_hash_node_alloc(&list->pool);
+
+    node->tag = tag;
+    node->src = source;
+    node->seq = 0;
+    node->value = payload;
+    custom_match_hash_table_append(&list->table, node);
+    custom_match_hash_order_append(&list->order_head, &list->order_tail, node);
+    list->size++;
+}
+
+static inline custom_match_umq* custom_match_umq_init()
+{
+    custom_match_umq* list = malloc(sizeof(custom_match_umq));
+
+    if (NULL == list) {
+        return NULL;
+    }
+    if (0 != custom_match_hash_table_init(&list->table)) {
+        free(list);
+        return NULL;
+    }
+    list->order_head = NULL;
+    list->order_tail = NULL;
+    list->pool = NULL;
+    list->size = 0;
+    return list;
+}
+
+static inline void custom_match_umq_destroy(custom_match_umq* list)
+{
+    custom_match_hash_table_destroy(&list->table);
+    custom_match_hash_pool_destroy(list->pool);
+    free(list);
+}
+
+static inline int custom_match_umq_size(custom_match_umq* list)
+{
+    return list->size;
+}
+
+static inline void custom_match_umq_dump(custom_match_umq* list)
+{
+    custom_match_hash_node* node;
+
+    opal_output(0, "%d unexpected fragments in %u buckets\n", list->size, list->table.mask + 1);
+    for (node = list->order_head; node; node = node->order_next) {
+        mca_pml_ob1_recv_frag_t *frag = (mca_pml_ob1_recv_frag_t *) node->value;
+        opal_output(0, "frag %p peer %d tag %d seq %d", (void*) frag, frag->hdr.hdr_match.hdr_src,
+                    frag->hdr.hdr_match.hdr_tag, (int) frag->hdr.hdr_match.hdr_seq);
+    }
+}
+
+#endif
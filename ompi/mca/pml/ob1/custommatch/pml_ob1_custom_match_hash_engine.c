@@ -0,0 +1,19 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "ompi_config.h"
+
+#include "pml_ob1_custom_match.h"
+#include "pml_ob1_custom_match_hash.h"
+
+#define MCA_PML_OB1_CUSTOM_MATCH_ENGINE      mca_pml_ob1_custom_match_hash
+#define MCA_PML_OB1_CUSTOM_MATCH_ENGINE_NAME "hash"
+#include "pml_ob1_custom_match_engine.h"
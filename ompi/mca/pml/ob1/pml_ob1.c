@@ -171,6 +171,10 @@ int mca_pml_ob1_enable(bool enable)
     /* missing communicator pending list */
     OBJ_CONSTRUCT(&mca_pml_ob1.non_existing_communicator_pending, opal_list_t);
 
+    /* short messages waiting to be sent */
+    OBJ_CONSTRUCT(&mca_pml_ob1.batch_pending, opal_list_t);
+    mca_pml_ob1.batch_progress = false;
+
     /**
      * If we get here this is the PML who get selected for the run. We
      * should get ownership for the send and receive requests list, and
@@ -242,6 +246,48 @@ mca_pml_ob1_set_allow_overtake(opal_infosubscriber_t* obj,
     return "false";
 }
 
+/**
+ * Matching engine of a new communicator: the one named by its
+ * "ompi_pml_ob1_matching_engine" info key, or the hash engine if it
+ * asserts that it uses no wildcard, or the default one.
+ */
+static const mca_pml_ob1_custom_match_engine_t *
+mca_pml_ob1_comm_match_engine(ompi_communicator_t* comm)
+{
+    const mca_pml_ob1_custom_match_engine_t *engine;
+    int type = mca_pml_ob1.matching_engine;
+
+    /* The receives are matched on their exact source and tag */
+    if (mca_pml_ob1.hash_matching && OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE(comm) &&
+        OMPI_COMM_CHECK_ASSERT_NO_ANY_TAG(comm)) {
+        type = MCA_PML_OB1_CUSTOM_MATCHING_HASH;
+    }
+
+    if (NULL != comm->super.s_info) {
+        opal_cstring_t *info_str;
+        int flag;
+
+        opal_info_get(comm->super.s_info, "ompi_pml_ob1_matching_engine", &info_str, &flag);
+        if (flag) {
+            for (int i = 0 ; NULL != mca_pml_ob1_custom_match_types[i].string ; ++i) {
+                if (0 == strcmp(info_str->string, mca_pml_ob1_custom_match_types[i].string)) {
+                    type = mca_pml_ob1_custom_match_types[i].value;
+                    break;
+                }
+            }
+            OBJ_RELEASE(info_str);
+        }
+    }
+
+    engine = mca_pml_ob1_custom_match_engine(type);
+    if (NULL == engine && MCA_PML_OB1_CUSTOM_MATCHING_NONE != type) {
+        opal_output_verbose(10, mca_pml_ob1_output,
+                            "matching engine %d not available, using the default matching on %s",
+                            type, ompi_comm_print_cid(comm));
+    }
+    return engine;
+}
+
 int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
 {
     /* allocate pml specific comm data */
@@ -261,8 +307,15 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
     }
 
     ompi_comm_assert_subscribe (comm, OMPI_COMM_ASSERT_NO_ANY_SOURCE);
+    ompi_comm_assert_subscribe (comm, OMPI_COMM_ASSERT_NO_ANY_TAG);
 
     mca_pml_ob1_comm_init_size(pml_comm, comm->c_remote_group->grp_proc_count);
+
+    /* the queues must be set up before the pending fragments are added below */
+    if (OMPI_SUCCESS != mca_pml_ob1_comm_set_match_engine(pml_comm, mca_pml_ob1_comm_match_engine(comm))) {
+        OBJ_RELEASE(pml_comm);
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
     comm->c_pml_comm = pml_comm;
 
     /* Register the subscriber alert for the mpi_assert_allow_overtaking info. */
@@ -317,11 +370,11 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
         pml_proc = mca_pml_ob1_peer_lookup(comm, hdr->hdr_src);
 
         if (OMPI_COMM_CHECK_ASSERT_ALLOW_OVERTAKE(comm)) {
-#if !MCA_PML_OB1_CUSTOM_MATCH
-            opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
-#else
-            custom_match_umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
-#endif
+            if (NULL != pml_comm->match_engine) {
+                pml_comm->match_engine->umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
+            } else {
+                opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
+            }
             PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm,
                                    hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
             continue;
@@ -332,11 +385,11 @@ int mca_pml_ob1_add_comm(ompi_communicator_t* comm)
         add_fragment_to_unexpected:
             /* We're now expecting the next sequence number. */
             pml_proc->expected_sequence++;
-#if !MCA_PML_OB1_CUSTOM_MATCH
-            opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
-#else
-            custom_match_umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
-#endif
+            if (NULL != pml_comm->match_engine) {
+                pml_comm->match_engine->umq_append(pml_comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
+            } else {
+                opal_list_append( &pml_proc->unexpected_frags, (opal_list_item_t*)frag );
+            }
             PERUSE_TRACE_MSG_EVENT(PERUSE_COMM_MSG_INSERT_IN_UNEX_Q, comm,
                                    hdr->hdr_src, hdr->hdr_tag, PERUSE_RECV);
             /* And now the ugly part. As some fragments can be inserted in the cant_match list,
@@ -530,6 +583,13 @@ int mca_pml_ob1_add_procs(ompi_proc_t** procs, size_t nprocs)
         return rc;
     }
 
+    rc = mca_bml.bml_register (MCA_PML_OB1_HDR_TYPE_MULTI,
+                               mca_pml_ob1_recv_frag_callback_multi,
+                               NULL);
+    if (OMPI_SUCCESS != rc) {
+        return rc;
+    }
+
     /* register error handlers */
     return  mca_bml.bml_register_error(mca_pml_ob1_error_handler);
 }
@@ -541,6 +601,8 @@ int mca_pml_ob1_add_procs(ompi_proc_t** procs, size_t nprocs)
 
 int mca_pml_ob1_del_procs(ompi_proc_t** procs, size_t nprocs)
 {
+    /* don't leave short messages behind */
+    (void) mca_pml_ob1_batch_flush_all ();
     return mca_bml.bml_del_procs(nprocs, procs);
 }
 
@@ -599,6 +661,10 @@ static void mca_pml_ob1_dump_hdr(mca_pml_ob1_hdr_t* hdr)
         type = "FIN";
         header[0] = '\0';
         break;
+    case MCA_PML_OB1_HDR_TYPE_MULTI:
+        type = "MULTI";
+        snprintf( header, 128, "count %d", hdr->hdr_multi.hdr_count);
+        break;
     default:
         type = "UNKWN";
         header[0] = '\0';
@@ -609,7 +675,6 @@ static void mca_pml_ob1_dump_hdr(mca_pml_ob1_hdr_t* hdr)
                 header);
 }
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
 static void mca_pml_ob1_dump_frag_list(opal_list_t* queue, bool is_req)
 {
     opal_list_item_t* item;
@@ -642,7 +707,6 @@ static void mca_pml_ob1_dump_frag_list(opal_list_t* queue, bool is_req)
         }
     }
 }
-#endif
 
 void mca_pml_ob1_dump_cant_match(mca_pml_ob1_recv_frag_t* queue)
 {
@@ -672,19 +736,18 @@ int mca_pml_ob1_dump(struct ompi_communicator_t* comm, int verbose)
                 comm->c_name, (void*) comm, ompi_comm_print_cid (comm), comm->c_my_rank,
                 pml_comm->recv_sequence, pml_comm->num_procs, pml_comm->last_probed);
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
     if( opal_list_get_size(&pml_comm->wild_receives) ) {
         opal_output(0, "expected MPI_ANY_SOURCE fragments\n");
         mca_pml_ob1_dump_frag_list(&pml_comm->wild_receives, true);
     }
-#endif
 
-#if MCA_PML_OB1_CUSTOM_MATCH
-     opal_output(0, "expected receives\n");
-     custom_match_prq_dump(pml_comm->prq);
-     opal_output(0, "unexpected frag\n");
-     custom_match_umq_dump(pml_comm->umq);
-#endif
+    if( NULL != pml_comm->match_engine ) {
+        opal_output(0, "matching engine %s\n", pml_comm->match_engine->name);
+        opal_output(0, "expected receives\n");
+        pml_comm->match_engine->prq_dump(pml_comm->prq);
+        opal_output(0, "unexpected frag\n");
+        pml_comm->match_engine->umq_dump(pml_comm->umq);
+    }
 
     /* iterate through all procs on communicator */
     for( i = 0; i < (int)pml_comm->num_procs; i++ ) {
@@ -702,22 +765,18 @@ int mca_pml_ob1_dump(struct ompi_communicator_t* comm, int verbose)
                     proc->send_sequence);
 
         /* dump all receive queues */
-#if !MCA_PML_OB1_CUSTOM_MATCH
-       if( opal_list_get_size(&proc->specific_receives) ) {
+        if( opal_list_get_size(&proc->specific_receives) ) {
             opal_output(0, "expected specific receives\n");
             mca_pml_ob1_dump_frag_list(&proc->specific_receives, true);
         }
-#endif
         if( NULL != proc->frags_cant_match ) {
             opal_output(0, "out of sequence\n");
             mca_pml_ob1_dump_cant_match(proc->frags_cant_match);
         }
-#if !MCA_PML_OB1_CUSTOM_MATCH
         if( opal_list_get_size(&proc->unexpected_frags) ) {
             opal_output(0, "unexpected frag\n");
             mca_pml_ob1_dump_frag_list(&proc->unexpected_frags, false);
         }
-#endif
         /* dump all btls used for eager messages */
         for( n = 0; n < ep->btl_eager.arr_size; n++ ) {
             mca_bml_base_btl_t* bml_btl = &ep->btl_eager.bml_btls[n];
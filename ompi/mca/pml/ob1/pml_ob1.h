@@ -86,6 +86,18 @@ struct mca_pml_ob1_t {
     char* allocator_name;
     mca_allocator_base_module_t* allocator;
     unsigned int unexpected_limit;
+    /* Default matching engine of the communicators (MCA_PML_OB1_CUSTOM_MATCHING_*) */
+    int matching_engine;
+    /* Use the hash engine on the communicators without wildcards */
+    bool hash_matching;
+    /* Maximum number of short messages packed in one fragment (0: no batching) */
+    unsigned int batch_limit;
+    /* Largest message packed with others in a fragment */
+    size_t batch_max_size;
+    /* Batches with messages waiting to be sent */
+    opal_list_t batch_pending;
+    /* The progress function flushes the pending batches */
+    bool batch_progress;
     /* Accelerator support initialized */
     bool accelerator_enabled;
 };
@@ -417,6 +429,19 @@ mca_pml_ob1_calc_weighted_length( mca_pml_ob1_com_btl_t *btls, int num_btls, siz
  */
 int mca_pml_ob1_enable_progress(int32_t count);
 
+struct mca_pml_ob1_batch_t;
+
+/**
+ * Send the short messages packed in a batch, if any. On failure the
+ * messages stay in the batch, and the progress function retries.
+ */
+int mca_pml_ob1_batch_flush (struct mca_pml_ob1_batch_t *batch);
+
+/**
+ * Send all the pending batches. Returns the number of batches sent.
+ */
+int mca_pml_ob1_batch_flush_all (void);
+
 int mca_pml_ob1_send_control_any (ompi_proc_t *proc, int order, mca_pml_ob1_hdr_t *hdr, size_t hdr_size,
                                   bool add_to_pending);
 int mca_pml_ob1_send_control_btl (mca_bml_base_btl_t *bml_btl, int order, mca_pml_ob1_hdr_t *hdr, size_t hdr_size,
@@ -39,20 +39,25 @@ static void mca_pml_ob1_comm_proc_construct(mca_pml_ob1_comm_proc_t* proc)
     proc->frags_cant_match = NULL;
     /* don't know the index of this communicator yet */
     proc->comm_index = -1;
-#if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_CONSTRUCT(&proc->specific_receives, opal_list_t);
     OBJ_CONSTRUCT(&proc->unexpected_frags, opal_list_t);
-#endif
+    OBJ_CONSTRUCT(&proc->batch, opal_list_item_t);
+    proc->batch.proc = proc;
+    proc->batch.bml_btl = NULL;
+    proc->batch.des = NULL;
+    proc->batch.size = 0;
+    proc->batch.max_size = 0;
+    proc->batch.count = 0;
 }
 
 
 static void mca_pml_ob1_comm_proc_destruct(mca_pml_ob1_comm_proc_t* proc)
 {
     assert(NULL == proc->frags_cant_match);
-#if !MCA_PML_OB1_CUSTOM_MATCH
+    assert(NULL == proc->batch.des);
     OBJ_DESTRUCT(&proc->specific_receives);
+    OBJ_DESTRUCT(&proc->batch);
     OBJ_DESTRUCT(&proc->unexpected_frags);
-#endif
     if (proc->ompi_proc) {
         OBJ_RELEASE(proc->ompi_proc);
     }
@@ -66,12 +71,10 @@ OBJ_CLASS_INSTANCE(mca_pml_ob1_comm_proc_t, opal_object_t,
 
 static void mca_pml_ob1_comm_construct(mca_pml_ob1_comm_t* comm)
 {
-#if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_CONSTRUCT(&comm->wild_receives, opal_list_t);
-#else
-    comm->prq = custom_match_prq_init();
-    comm->umq = custom_match_umq_init();
-#endif
+    comm->match_engine = NULL;
+    comm->prq = NULL;
+    comm->umq = NULL;
     OBJ_CONSTRUCT(&comm->matching_lock, opal_mutex_t);
     OBJ_CONSTRUCT(&comm->proc_lock, opal_mutex_t);
     comm->recv_sequence = 0;
@@ -93,12 +96,11 @@ static void mca_pml_ob1_comm_destruct(mca_pml_ob1_comm_t* comm)
         free ((void *) comm->procs);
     }
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
     OBJ_DESTRUCT(&comm->wild_receives);
-#else
-    custom_match_prq_destroy(comm->prq);
-    custom_match_umq_destroy(comm->umq);
-#endif
+    if (NULL != comm->match_engine) {
+        comm->match_engine->prq_destroy(comm->prq);
+        comm->match_engine->umq_destroy(comm->umq);
+    }
     OBJ_DESTRUCT(&comm->matching_lock);
     OBJ_DESTRUCT(&comm->proc_lock);
 }
@@ -122,6 +124,29 @@ int mca_pml_ob1_comm_init_size (mca_pml_ob1_comm_t* comm, size_t size)
     return OMPI_SUCCESS;
 }
 
+int mca_pml_ob1_comm_set_match_engine (mca_pml_ob1_comm_t* comm, const mca_pml_ob1_custom_match_engine_t *engine)
+{
+    assert(NULL == comm->match_engine);
+    if (NULL == engine) {
+        return OMPI_SUCCESS;
+    }
+
+    comm->prq = engine->prq_init();
+    comm->umq = engine->umq_init();
+    if (NULL == comm->prq || NULL == comm->umq) {
+        if (NULL != comm->prq) {
+            engine->prq_destroy(comm->prq);
+        }
+        if (NULL != comm->umq) {
+            engine->umq_destroy(comm->umq);
+        }
+        comm->prq = comm->umq = NULL;
+        return OMPI_ERR_OUT_OF_RESOURCE;
+    }
+    comm->match_engine = engine;
+    return OMPI_SUCCESS;
+}
+
 mca_pml_ob1_comm_proc_t *mca_pml_ob1_peer_create (ompi_communicator_t *comm, mca_pml_ob1_comm_t *pml_comm, int rank)
 {
     mca_pml_ob1_comm_proc_t *proc = OBJ_NEW(mca_pml_ob1_comm_proc_t);
@@ -39,6 +39,20 @@ typedef struct mca_pml_ob1_comm_proc_t mca_pml_ob1_comm_proc_t;
 
 BEGIN_C_DECLS
 
+/**
+ * Short messages to a peer packed in a fragment which is not sent yet. The
+ * batch is on the mca_pml_ob1.batch_pending list while des is set.
+ */
+struct mca_pml_ob1_batch_t {
+    opal_list_item_t super;
+    mca_pml_ob1_comm_proc_t *proc;         /**< peer of the messages */
+    struct mca_bml_base_btl_t *bml_btl;    /**< btl the fragment was allocated on */
+    struct mca_btl_base_descriptor_t *des; /**< fragment, NULL if the batch is empty */
+    size_t size;                           /**< bytes used in the fragment */
+    size_t max_size;                       /**< size of the fragment */
+    uint16_t count;                        /**< number of messages in the fragment */
+};
+typedef struct mca_pml_ob1_batch_t mca_pml_ob1_batch_t;
 
 struct mca_pml_ob1_comm_proc_t {
     opal_object_t super;
@@ -47,10 +61,9 @@ struct mca_pml_ob1_comm_proc_t {
     int16_t comm_index;           /**< index of this communicator on the receiver size (-1 - not set) */
     opal_atomic_int32_t send_sequence; /**< send side sequence number */
     struct mca_pml_ob1_recv_frag_t* frags_cant_match;  /**< out-of-order fragment queues */
-#if !MCA_PML_OB1_CUSTOM_MATCH
     opal_list_t specific_receives; /**< queues of unmatched specific receives */
     opal_list_t unexpected_frags;  /**< unexpected fragment queues */
-#endif
+    mca_pml_ob1_batch_t batch;     /**< short messages waiting to be sent */
 };
 
 OBJ_CLASS_DECLARATION(mca_pml_ob1_comm_proc_t);
@@ -65,17 +78,15 @@ struct mca_pml_comm_t {
     opal_object_t super;
     volatile uint32_t recv_sequence;  /**< recv request sequence number - receiver side */
     opal_mutex_t matching_lock;   /**< matching lock */
-#if !MCA_PML_OB1_CUSTOM_MATCH
     opal_list_t wild_receives;    /**< queue of unmatched wild (source process not specified) receives */
-#endif
     opal_mutex_t proc_lock;
     mca_pml_ob1_comm_proc_t * volatile * procs;
     size_t num_procs;
     size_t last_probed;
-#if MCA_PML_OB1_CUSTOM_MATCH
-    custom_match_prq* prq;
-    custom_match_umq* umq;
-#endif
+    /** matching engine of the communicator, NULL when the lists above are used */
+    const mca_pml_ob1_custom_match_engine_t *match_engine;
+    void *prq;                    /**< posted receive queue of the matching engine */
+    void *umq;                    /**< unexpected message queue of the matching engine */
 };
 typedef struct mca_pml_comm_t mca_pml_ob1_comm_t;
 
@@ -117,6 +128,18 @@ static inline mca_pml_ob1_comm_proc_t *mca_pml_ob1_peer_lookup (struct ompi_comm
 
 extern int mca_pml_ob1_comm_init_size(mca_pml_ob1_comm_t* comm, size_t size);
 
+/**
+ * Use a matching engine for the queues of the communicator, instead of the
+ * default lists. Must be called before any message is matched on it.
+ *
+ * @param  comm   Instance of mca_pml_ob1_comm_t
+ * @param  engine Matching engine, NULL to keep the default lists
+ * @return        OMPI_SUCCESS or error status on failure.
+ */
+
+extern int mca_pml_ob1_comm_set_match_engine(mca_pml_ob1_comm_t* comm,
+                                             const mca_pml_ob1_custom_match_engine_t *engine);
+
 END_C_DECLS
 #endif
 
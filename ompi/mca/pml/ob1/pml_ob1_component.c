@@ -156,12 +156,12 @@ static int mca_pml_ob1_get_unex_msgq_size (const struct mca_base_pvar_t *pvar, v
     for (i = 0 ; i < comm_size ; ++i) {
         pml_proc = pml_comm->procs[i];
         if (pml_proc) {
-#if MCA_PML_OB1_CUSTOM_MATCH
-            values[i] = custom_match_umq_size(pml_comm->umq); // TODO: given the structure of custom match this does not make sense,
-                                                     //       as we only have one set of queues.
-#else
-            values[i] = opal_list_get_size (&pml_proc->unexpected_frags);
-#endif
+            if (NULL != pml_comm->match_engine) {
+                values[i] = pml_comm->match_engine->umq_size(pml_comm->umq); // TODO: given the structure of custom match this does not make sense,
+                                                                             //       as we only have one set of queues.
+            } else {
+                values[i] = opal_list_get_size (&pml_proc->unexpected_frags);
+            }
         } else {
             values[i] = 0;
         }
@@ -183,12 +183,12 @@ static int mca_pml_ob1_get_posted_recvq_size (const struct mca_base_pvar_t *pvar
         pml_proc = pml_comm->procs[i];
 
         if (pml_proc) {
-#if MCA_PML_OB1_CUSTOM_MATCH
-            values[i] = custom_match_prq_size(pml_comm->prq); // TODO: given the structure of custom match this does not make sense,
-                                                     //       as we only have one set of queues.
-#else
-            values[i] = opal_list_get_size (&pml_proc->specific_receives);
-#endif
+            if (NULL != pml_comm->match_engine) {
+                values[i] = pml_comm->match_engine->prq_size(pml_comm->prq); // TODO: given the structure of custom match this does not make sense,
+                                                                             //       as we only have one set of queues.
+            } else {
+                values[i] = opal_list_get_size (&pml_proc->specific_receives);
+            }
         } else {
             values[i] = 0;
         }
@@ -199,6 +199,8 @@ static int mca_pml_ob1_get_posted_recvq_size (const struct mca_base_pvar_t *pvar
 
 static int mca_pml_ob1_component_register(void)
 {
+    mca_base_var_enum_t *new_enum;
+
     mca_pml_ob1_param_register_int("verbose", 0, &mca_pml_ob1_verbose);
 
     mca_pml_ob1_param_register_int("free_list_num", 4, &mca_pml_ob1.free_list_num);
@@ -225,6 +227,47 @@ static int mca_pml_ob1_component_register(void)
                                            "(default: false)", MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
                                            OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_GROUP, &mca_pml_ob1.use_all_rdma);
 
+    mca_pml_ob1.matching_engine = MCA_PML_OB1_CUSTOM_MATCHING;
+    (void) mca_base_var_enum_create("pml_ob1_matching_engines", mca_pml_ob1_custom_match_types, &new_enum);
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "matching_engine",
+                                           "Matching engine of the communicators (none: per-peer lists, "
+                                           "linkedlist, arrays, hash, and with AVX-512 fuzzy_byte, fuzzy_short, "
+                                           "fuzzy_word, vector). A communicator can select another engine "
+                                           "with the \"ompi_pml_ob1_matching_engine\" info key at its "
+                                           "creation. Engines not supported by the processor fall back to none",
+                                           MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.matching_engine);
+    OBJ_RELEASE(new_enum);
+
+    mca_pml_ob1.hash_matching = true;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "hash_matching",
+                                           "Match with the hash engine, which indexes the queues by source "
+                                           "and tag, on the communicators created with both the "
+                                           "mpi_assert_no_any_source and mpi_assert_no_any_tag info keys "
+                                           "(default: true)", MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.hash_matching);
+
+    mca_pml_ob1.batch_limit = 0;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "batch_limit",
+                                           "Maximum number of short messages to the same peer packed "
+                                           "in a single fragment. The messages are sent when the fragment "
+                                           "is full, before a message which cannot be packed, or from the "
+                                           "progress engine. Not used when several threads can call "
+                                           "into MPI, including a collective progress thread. At most "
+                                           "65535 (default: 0, no batching)", MCA_BASE_VAR_TYPE_UNSIGNED_INT, NULL,
+                                           0, 0, OPAL_INFO_LVL_5, MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_pml_ob1.batch_limit);
+    /* the number of messages of a fragment is a uint16_t */
+    if (mca_pml_ob1.batch_limit > UINT16_MAX) {
+        mca_pml_ob1.batch_limit = UINT16_MAX;
+    }
+    mca_pml_ob1.batch_max_size = 256;
+    (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "batch_max_size",
+                                           "Largest message, in bytes, packed with other short messages "
+                                           "when pml_ob1_batch_limit is set (default: 256)",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_READONLY, &mca_pml_ob1.batch_max_size);
+
     mca_pml_ob1.allocator_name = "bucket";
     (void) mca_base_component_var_register(&mca_pml_ob1_component.pmlm_version, "allocator",
                                            "Name of allocator component for unexpected messages",
@@ -366,6 +409,7 @@ int mca_pml_ob1_component_fini(void)
     OBJ_DESTRUCT(&mca_pml_ob1.recv_pending);
     OBJ_DESTRUCT(&mca_pml_ob1.send_pending);
     OBJ_DESTRUCT(&mca_pml_ob1.non_existing_communicator_pending);
+    OBJ_DESTRUCT(&mca_pml_ob1.batch_pending);
     OBJ_DESTRUCT(&mca_pml_ob1.buffers);
     OBJ_DESTRUCT(&mca_pml_ob1.pending_pckts);
     OBJ_DESTRUCT(&mca_pml_ob1.recv_frags);
@@ -35,6 +35,7 @@
 #include <netinet/in.h>
 #endif
 
+#include "opal/align.h"
 #include "opal/types.h"
 #include "opal/util/arch.h"
 #include "opal/mca/btl/btl.h"
@@ -50,6 +51,7 @@
 #define MCA_PML_OB1_HDR_TYPE_PUT       (MCA_BTL_TAG_PML + 8)
 #define MCA_PML_OB1_HDR_TYPE_FIN       (MCA_BTL_TAG_PML + 9)
 #define MCA_PML_OB1_HDR_TYPE_CID       (MCA_BTL_TAG_PML + 10)
+#define MCA_PML_OB1_HDR_TYPE_MULTI     (MCA_BTL_TAG_PML + 11)
 
 #define MCA_PML_OB1_HDR_FLAGS_ACK     0x01  /* is an ack required */
 #define MCA_PML_OB1_HDR_FLAGS_NBO     0x02  /* is the hdr in network byte order */
@@ -479,6 +481,57 @@ static inline void mca_pml_ob1_fin_hdr_prepare (mca_pml_ob1_fin_hdr_t *hdr, uint
         (h).hdr_size = hton64((h).hdr_size);         \
     } while (0)
 
+/**
+ * Header definition of a fragment carrying several short messages to the
+ * same peer. It is followed by hdr_count messages, each one made of its
+ * length (a uint32_t covering the match header and the data), its match
+ * header and its data, padded to MCA_PML_OB1_MULTI_ALIGN bytes. The
+ * lengths use the byte order of this header.
+ */
+struct mca_pml_ob1_multi_hdr_t {
+    mca_pml_ob1_common_hdr_t hdr_common;   /**< common attributes */
+    uint16_t hdr_count;                    /**< number of messages in the fragment */
+};
+typedef struct mca_pml_ob1_multi_hdr_t mca_pml_ob1_multi_hdr_t;
+
+#define MCA_PML_OB1_MULTI_ALIGN 4
+#define MCA_PML_OB1_MULTI_HDR_LEN \
+    OPAL_ALIGN(sizeof (mca_pml_ob1_multi_hdr_t), MCA_PML_OB1_MULTI_ALIGN, size_t)
+/* space used in the fragment by a message of the given length */
+#define MCA_PML_OB1_MULTI_ENTRY_LEN(length) \
+    OPAL_ALIGN(sizeof (uint32_t) + (length), MCA_PML_OB1_MULTI_ALIGN, size_t)
+
+static inline void mca_pml_ob1_multi_hdr_prepare (mca_pml_ob1_multi_hdr_t *hdr, uint8_t hdr_flags,
+                                                  uint16_t hdr_count)
+{
+    mca_pml_ob1_common_hdr_prepare (&hdr->hdr_common, MCA_PML_OB1_HDR_TYPE_MULTI, hdr_flags);
+    hdr->hdr_count = hdr_count;
+}
+
+#define MCA_PML_OB1_MULTI_HDR_NTOH(h)                \
+    do {                                             \
+        MCA_PML_OB1_COMMON_HDR_NTOH((h).hdr_common); \
+        (h).hdr_count = ntohs((h).hdr_count);        \
+    } while (0)
+
+#define MCA_PML_OB1_MULTI_HDR_HTON(h)                \
+    do {                                             \
+        MCA_PML_OB1_COMMON_HDR_HTON((h).hdr_common); \
+        (h).hdr_count = htons((h).hdr_count);        \
+    } while (0)
+
+/* the message lengths of a multi fragment follow the decisions of
+ * ob1_hdr_hton and ob1_hdr_ntoh on its header */
+#if OPAL_ENABLE_HETEROGENEOUS_SUPPORT && !defined(WORDS_BIGENDIAN)
+#define ob1_multi_length_hton(l, p) \
+    (((p)->super.proc_arch & OPAL_ARCH_ISBIGENDIAN) ? htonl(l) : (l))
+#define ob1_multi_length_ntoh(l, h) \
+    (((h)->hdr_common.hdr_flags & MCA_PML_OB1_HDR_FLAGS_NBO) ? ntohl(l) : (l))
+#else
+#define ob1_multi_length_hton(l, p) (l)
+#define ob1_multi_length_ntoh(l, h) (l)
+#endif
+
 /**
  * Union of defined hdr types.
  */
@@ -491,6 +544,7 @@ union mca_pml_ob1_hdr_t {
     mca_pml_ob1_ack_hdr_t hdr_ack;
     mca_pml_ob1_rdma_hdr_t hdr_rdma;
     mca_pml_ob1_fin_hdr_t hdr_fin;
+    mca_pml_ob1_multi_hdr_t hdr_multi;
     /* extended CID support */
     mca_pml_ob1_cid_hdr_t hdr_cid;
     mca_pml_ob1_ext_match_hdr_t hdr_ext_match;
@@ -528,6 +582,9 @@ ob1_hdr_ntoh(mca_pml_ob1_hdr_t *hdr, const uint8_t hdr_type)
         case MCA_PML_OB1_HDR_TYPE_FIN:
             MCA_PML_OB1_FIN_HDR_NTOH(hdr->hdr_fin);
             break;
+        case MCA_PML_OB1_HDR_TYPE_MULTI:
+            MCA_PML_OB1_MULTI_HDR_NTOH(hdr->hdr_multi);
+            break;
         case MCA_PML_OB1_HDR_TYPE_CID:
 	{
 	    mca_pml_ob1_hdr_t *next_hdr = (mca_pml_ob1_hdr_t *) ((uintptr_t) hdr + sizeof (hdr->hdr_cid));
@@ -583,6 +640,9 @@ ob1_hdr_hton_intr(mca_pml_ob1_hdr_t *hdr, const uint8_t hdr_type,
         case MCA_PML_OB1_HDR_TYPE_FIN:
             MCA_PML_OB1_FIN_HDR_HTON(hdr->hdr_fin);
             break;
+        case MCA_PML_OB1_HDR_TYPE_MULTI:
+            MCA_PML_OB1_MULTI_HDR_HTON(hdr->hdr_multi);
+            break;
         case MCA_PML_OB1_HDR_TYPE_CID:
 	{
 	    mca_pml_ob1_hdr_t *next_hdr = (mca_pml_ob1_hdr_t *) ((uintptr_t) hdr + sizeof (hdr->hdr_cid));
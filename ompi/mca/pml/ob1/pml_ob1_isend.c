@@ -149,6 +149,202 @@ static inline int mca_pml_ob1_send_inline (const void *buf, size_t count,
     return (int) size;
 }
 
+static void mca_pml_ob1_batch_completion (mca_btl_base_module_t* btl, struct mca_btl_base_endpoint_t *endpoint,
+                                          mca_btl_base_descriptor_t *des, int status)
+{
+    mca_bml_base_btl_t* bml_btl = (mca_bml_base_btl_t*) des->des_context;
+
+    /* check for pending requests */
+    MCA_PML_OB1_PROGRESS_PENDING(bml_btl);
+}
+
+int mca_pml_ob1_batch_flush (mca_pml_ob1_batch_t *batch)
+{
+    mca_btl_base_descriptor_t *des = batch->des;
+    mca_bml_base_btl_t *bml_btl = batch->bml_btl;
+    mca_pml_ob1_comm_proc_t *proc = batch->proc;
+    mca_pml_ob1_multi_hdr_t *hdr;
+    int rc;
+
+    if (NULL == des) {
+        return OMPI_SUCCESS;
+    }
+
+    hdr = (mca_pml_ob1_multi_hdr_t *) des->des_segments->seg_addr.pval;
+    mca_pml_ob1_multi_hdr_prepare (hdr, 0, batch->count);
+    ob1_hdr_hton (hdr, MCA_PML_OB1_HDR_TYPE_MULTI, proc->ompi_proc);
+
+    des->des_segments->seg_len = batch->size;
+    des->des_cbfunc = mca_pml_ob1_batch_completion;
+
+    rc = mca_bml_base_send (bml_btl, des, MCA_PML_OB1_HDR_TYPE_MULTI);
+    if (OPAL_UNLIKELY(rc < 0)) {
+        return rc;
+    }
+
+    batch->des = NULL;
+    batch->count = 0;
+    batch->size = 0;
+    opal_list_remove_item (&mca_pml_ob1.batch_pending, &batch->super);
+    /* the batch may go away with the peer */
+    OBJ_RELEASE(proc);
+
+    if (1 == rc) {
+        MCA_PML_OB1_PROGRESS_PENDING(bml_btl);
+    }
+
+    return OMPI_SUCCESS;
+}
+
+int mca_pml_ob1_batch_flush_all (void)
+{
+    mca_pml_ob1_batch_t *batch, *next;
+    int count = 0;
+
+    OPAL_LIST_FOREACH_SAFE(batch, next, &mca_pml_ob1.batch_pending, mca_pml_ob1_batch_t) {
+        if (OMPI_SUCCESS == mca_pml_ob1_batch_flush (batch)) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/* pack a short message in the batch of the peer, to be sent with the next
+ * ones in a single fragment. A message which cannot be packed pushes out
+ * the batch so that it does not overtake the messages in it. */
+static inline int mca_pml_ob1_send_batch (const void *buf, size_t count,
+                                          ompi_datatype_t * datatype,
+                                          int tag, int16_t seqn,
+                                          ompi_proc_t *dst_proc, mca_pml_ob1_comm_proc_t *ob1_proc,
+                                          mca_bml_base_endpoint_t* endpoint,
+                                          ompi_communicator_t * comm)
+{
+    mca_pml_ob1_batch_t *batch = &ob1_proc->batch;
+    mca_pml_ob1_match_hdr_t *match;
+    opal_convertor_t convertor;
+    unsigned char *entry;
+    size_t size, entry_len;
+
+    /* the batches are not protected against concurrent access, which
+     * includes the progress thread of a collective component */
+    if (0 == mca_pml_ob1.batch_limit || opal_using_threads()) {
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    ompi_datatype_type_size (datatype, &size);
+
+    if ((size * count) > mca_pml_ob1.batch_max_size || -1 == ob1_proc->comm_index) {
+        (void) mca_pml_ob1_batch_flush (batch);
+        return OMPI_ERR_NOT_AVAILABLE;
+    }
+
+    if (count > 0) {
+        /* initialize just enough of the convertor to avoid a SEGV in opal_convertor_cleanup */
+        OBJ_CONSTRUCT(&convertor, opal_convertor_t);
+
+        /* We will create a convertor specialized for the        */
+        /* remote architecture and prepared with the datatype.   */
+        opal_convertor_copy_and_prepare_for_send (dst_proc->super.proc_convertor,
+                                                  (const struct opal_datatype_t *) datatype,
+                                                  count, buf, 0, &convertor);
+        opal_convertor_get_packed_size (&convertor, &size);
+    } else {
+        size = 0;
+    }
+
+    entry_len = MCA_PML_OB1_MULTI_ENTRY_LEN(OMPI_PML_OB1_MATCH_HDR_LEN + size);
+
+    if (NULL != batch->des && batch->size + entry_len > batch->max_size) {
+        (void) mca_pml_ob1_batch_flush (batch);
+    }
+
+    if (NULL == batch->des) {
+        mca_bml_base_btl_t *bml_btl = mca_bml_base_btl_array_get_next (&endpoint->btl_eager);
+        size_t max_size;
+
+        if (OPAL_UNLIKELY(NULL == bml_btl)) {
+            goto not_available;
+        }
+
+        /* enough space for batch_limit messages, within the eager limit of the btl */
+        max_size = MCA_PML_OB1_MULTI_HDR_LEN + mca_pml_ob1.batch_limit *
+            MCA_PML_OB1_MULTI_ENTRY_LEN(OMPI_PML_OB1_MATCH_HDR_LEN + mca_pml_ob1.batch_max_size);
+        if (max_size > bml_btl->btl->btl_eager_limit) {
+            max_size = bml_btl->btl->btl_eager_limit;
+        }
+        if (MCA_PML_OB1_MULTI_HDR_LEN + entry_len > max_size) {
+            goto not_available;
+        }
+
+        mca_bml_base_alloc (bml_btl, &batch->des, MCA_BTL_NO_ORDER, max_size,
+                            MCA_BTL_DES_FLAGS_PRIORITY | MCA_BTL_DES_FLAGS_BTL_OWNERSHIP);
+        if (OPAL_UNLIKELY(NULL == batch->des)) {
+            goto not_available;
+        }
+
+        batch->bml_btl = bml_btl;
+        batch->size = MCA_PML_OB1_MULTI_HDR_LEN;
+        batch->max_size = max_size;
+        batch->count = 0;
+        OBJ_RETAIN(ob1_proc);
+        opal_list_append (&mca_pml_ob1.batch_pending, &batch->super);
+
+        if (!mca_pml_ob1.batch_progress) {
+            mca_pml_ob1.batch_progress = true;
+            mca_pml_ob1_enable_progress (1);
+        }
+    } else if (OPAL_UNLIKELY(batch->size + entry_len > batch->max_size)) {
+        /* the batch could not be sent */
+        goto not_available;
+    }
+
+    entry = (unsigned char *) batch->des->des_segments->seg_addr.pval + batch->size;
+    *(uint32_t *) entry = ob1_multi_length_hton ((uint32_t) (OMPI_PML_OB1_MATCH_HDR_LEN + size), dst_proc);
+
+    match = (mca_pml_ob1_match_hdr_t *) (entry + sizeof (uint32_t));
+    mca_pml_ob1_match_hdr_prepare (match, MCA_PML_OB1_HDR_TYPE_MATCH, 0,
+                                   ob1_proc->comm_index, comm->c_my_rank,
+                                   tag, seqn);
+
+    ob1_hdr_hton(match, MCA_PML_OB1_HDR_TYPE_MATCH, dst_proc);
+
+    if (size > 0) {
+        struct iovec iov;
+        uint32_t iov_count = 1;
+        size_t max_data = size;
+
+        iov.iov_base = (IOVBASE_TYPE *) ((unsigned char *) match + OMPI_PML_OB1_MATCH_HDR_LEN);
+        iov.iov_len = size;
+        (void) opal_convertor_pack (&convertor, &iov, &iov_count, &max_data);
+    }
+
+    batch->size += entry_len;
+    ++batch->count;
+
+#if SPC_ENABLE == 1
+    SPC_USER_OR_MPI(tag, (ompi_spc_value_t)size, OMPI_SPC_BYTES_SENT_USER, OMPI_SPC_BYTES_SENT_MPI);
+#endif
+
+    if (count > 0) {
+        opal_convertor_cleanup (&convertor);
+    }
+
+    if (batch->count >= mca_pml_ob1.batch_limit) {
+        (void) mca_pml_ob1_batch_flush (batch);
+    }
+
+    return (int) size;
+
+not_available:
+    if (count > 0) {
+        opal_convertor_cleanup (&convertor);
+    }
+
+    (void) mca_pml_ob1_batch_flush (batch);
+    return OMPI_ERR_NOT_AVAILABLE;
+}
+
 int mca_pml_ob1_isend(const void *buf,
                       size_t count,
                       ompi_datatype_t * datatype,
@@ -179,8 +375,12 @@ int mca_pml_ob1_isend(const void *buf,
     }
 
     if (MCA_PML_BASE_SEND_SYNCHRONOUS != sendmode) {
-        rc = mca_pml_ob1_send_inline (buf, count, datatype, dst, tag, seqn, dst_proc, ob1_proc,
-                                      endpoint, comm);
+        rc = mca_pml_ob1_send_batch (buf, count, datatype, tag, seqn, dst_proc, ob1_proc,
+                                     endpoint, comm);
+        if (0 > rc) {
+            rc = mca_pml_ob1_send_inline (buf, count, datatype, dst, tag, seqn, dst_proc, ob1_proc,
+                                          endpoint, comm);
+        }
         if (OPAL_LIKELY(0 <= rc)) {
             /* NTH: it is legal to return ompi_request_empty since the only valid
              * field in a send completion status is whether or not the send was
@@ -194,6 +394,8 @@ int mca_pml_ob1_isend(const void *buf,
             *request = &ompi_request_empty;
             return OMPI_SUCCESS;
         }
+    } else if (NULL != ob1_proc->batch.des) {
+        (void) mca_pml_ob1_batch_flush (&ob1_proc->batch);
     }
 
     MCA_PML_OB1_SEND_REQUEST_ALLOC(comm, dst, sendreq);
@@ -294,11 +496,17 @@ int mca_pml_ob1_send(const void *buf,
      * the parallel application.
      */
     if (MCA_PML_BASE_SEND_SYNCHRONOUS != sendmode) {
-        rc = mca_pml_ob1_send_inline (buf, count, datatype, dst, tag, seqn, dst_proc,
-                                      ob1_proc, endpoint, comm);
+        rc = mca_pml_ob1_send_batch (buf, count, datatype, tag, seqn, dst_proc,
+                                     ob1_proc, endpoint, comm);
+        if (0 > rc) {
+            rc = mca_pml_ob1_send_inline (buf, count, datatype, dst, tag, seqn, dst_proc,
+                                          ob1_proc, endpoint, comm);
+        }
         if (OPAL_LIKELY(0 <= rc)) {
             return OMPI_SUCCESS;
         }
+    } else if (NULL != ob1_proc->batch.des) {
+        (void) mca_pml_ob1_batch_flush (&ob1_proc->batch);
     }
 
     if (OPAL_LIKELY(!ompi_mpi_thread_multiple)) {
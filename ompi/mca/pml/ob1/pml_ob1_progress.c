@@ -71,6 +71,14 @@ int mca_pml_ob1_progress(void)
 
     completed_requests += mca_pml_ob1_process_pending_accelerator_async_copies();
 
+    if (mca_pml_ob1.batch_progress) {
+        (void) mca_pml_ob1_batch_flush_all ();
+        if (opal_list_is_empty (&mca_pml_ob1.batch_pending)) {
+            mca_pml_ob1.batch_progress = false;
+            completed_requests++;
+        }
+    }
+
     for( i = 0; i < queue_length; i++ ) {
         mca_pml_ob1_send_pending_t pending_type = MCA_PML_OB1_SEND_PENDING_NONE;
         mca_pml_ob1_send_request_t* sendreq;
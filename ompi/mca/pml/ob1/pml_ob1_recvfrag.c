@@ -88,10 +88,8 @@ append_frag_to_list(opal_list_t *queue, mca_btl_base_module_t *btl,
     opal_list_append(queue, (opal_list_item_t*)frag);
 }
 
-#if MCA_PML_OB1_CUSTOM_MATCH
-
 static void
-append_frag_to_umq(custom_match_umq *queue, mca_btl_base_module_t *btl,
+append_frag_to_umq(mca_pml_ob1_comm_t *comm, mca_btl_base_module_t *btl,
                    const mca_pml_ob1_match_hdr_t *hdr, const mca_btl_base_segment_t *segments,
                    size_t num_segments, mca_pml_ob1_recv_frag_t* frag)
 {
@@ -99,11 +97,9 @@ append_frag_to_umq(custom_match_umq *queue, mca_btl_base_module_t *btl,
     MCA_PML_OB1_RECV_FRAG_ALLOC(frag);
     MCA_PML_OB1_RECV_FRAG_INIT(frag, hdr, segments, num_segments, btl);
   }
-  custom_match_umq_append(queue, hdr->hdr_tag, hdr->hdr_src, frag);
+  comm->match_engine->umq_append(comm->umq, hdr->hdr_tag, hdr->hdr_src, frag);
 }
 
-#endif
-
 
 /**
  * Append an unexpected descriptor to an ordered queue.
@@ -864,7 +860,6 @@ static mca_pml_ob1_recv_request_t *match_incomming(const mca_pml_ob1_match_hdr_t
                                                    mca_pml_ob1_comm_t *comm,
                                                    mca_pml_ob1_comm_proc_t *proc)
 {
-#if !MCA_PML_OB1_CUSTOM_MATCH
     mca_pml_ob1_recv_request_t *specific_recv, *wild_recv;
     mca_pml_sequence_t wild_recv_seq, specific_recv_seq;
     int tag = hdr->hdr_tag;
@@ -907,12 +902,8 @@ static mca_pml_ob1_recv_request_t *match_incomming(const mca_pml_ob1_match_hdr_t
     }
 
     return NULL;
-#else
-    return custom_match_prq_find_dequeue_verify(comm->prq, hdr->hdr_tag, hdr->hdr_src);
-#endif
 }
 
-#if !MCA_PML_OB1_CUSTOM_MATCH
 static mca_pml_ob1_recv_request_t *match_incomming_no_any_source (const mca_pml_ob1_match_hdr_t *hdr,
                                                                   mca_pml_ob1_comm_t *comm,
                                                                   mca_pml_ob1_comm_proc_t *proc)
@@ -933,7 +924,6 @@ static mca_pml_ob1_recv_request_t *match_incomming_no_any_source (const mca_pml_
 
     return NULL;
 }
-#endif
 
 static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
                                               const mca_pml_ob1_match_hdr_t *hdr,
@@ -951,15 +941,13 @@ static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
     mca_pml_ob1_comm_t *comm = (mca_pml_ob1_comm_t *)comm_ptr->c_pml_comm;
 
     do {
-#if MCA_PML_OB1_CUSTOM_MATCH
-        match = match_incomming(hdr, comm, proc);
-#else
-        if (!OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE (comm_ptr)) {
+        if (NULL != comm->match_engine) {
+            match = comm->match_engine->prq_find_dequeue_verify(comm->prq, hdr->hdr_tag, hdr->hdr_src);
+        } else if (!OMPI_COMM_CHECK_ASSERT_NO_ANY_SOURCE (comm_ptr)) {
             match = match_incomming(hdr, comm, proc);
         } else {
             match = match_incomming_no_any_source (hdr, comm, proc);
         }
-#endif
 
         /* if match found, process data */
         if(OPAL_LIKELY(NULL != match)) {
@@ -999,13 +987,13 @@ static mca_pml_ob1_recv_request_t *match_one (mca_btl_base_module_t *btl,
         }
 
         /* if no match found, place on unexpected queue */
-#if MCA_PML_OB1_CUSTOM_MATCH
-        append_frag_to_umq(comm->umq, btl, hdr, segments,
-                            num_segments, frag);
-#else
-        append_frag_to_list(&proc->unexpected_frags, btl, hdr, segments,
-                            num_segments, frag);
-#endif
+        if (NULL != comm->match_engine) {
+            append_frag_to_umq(comm, btl, hdr, segments,
+                               num_segments, frag);
+        } else {
+            append_frag_to_list(&proc->unexpected_frags, btl, hdr, segments,
+                                num_segments, frag);
+        }
         SPC_RECORD(OMPI_SPC_UNEXPECTED, 1);
         SPC_RECORD(OMPI_SPC_UNEXPECTED_IN_QUEUE, 1);
         SPC_UPDATE_WATERMARK(OMPI_SPC_MAX_UNEXPECTED_IN_QUEUE, OMPI_SPC_UNEXPECTED_IN_QUEUE);
@@ -1301,3 +1289,49 @@ void mca_pml_ob1_recv_frag_callback_cid (mca_btl_base_module_t* btl,
     mca_pml_ob1_recv_frag_match (btl, hdr_match, segments, des->des_segment_count,
                                  hdr_match->hdr_common.hdr_type);
 }
+
+void mca_pml_ob1_recv_frag_callback_multi (mca_btl_base_module_t *btl,
+                                           const mca_btl_base_receive_descriptor_t *descriptor)
+{
+    const mca_btl_base_segment_t *segments = descriptor->des_segments;
+    mca_pml_ob1_hdr_t *hdr = (mca_pml_ob1_hdr_t *) segments->seg_addr.pval;
+    unsigned char *entry, *end;
+    mca_btl_base_segment_t segment;
+    mca_btl_base_receive_descriptor_t match_descriptor = {
+        .endpoint = descriptor->endpoint,
+        .des_segments = &segment,
+        .des_segment_count = 1,
+        .tag = MCA_PML_OB1_HDR_TYPE_MATCH,
+        .cbdata = descriptor->cbdata,
+    };
+
+    /* the sender allocates the fragment, so it comes in a single segment */
+    assert (1 == descriptor->des_segment_count);
+    if (OPAL_UNLIKELY(segments->seg_len < MCA_PML_OB1_MULTI_HDR_LEN)) {
+        return;
+    }
+    ob1_hdr_ntoh (hdr, MCA_PML_OB1_HDR_TYPE_MULTI);
+
+    entry = (unsigned char *) hdr + MCA_PML_OB1_MULTI_HDR_LEN;
+    end = (unsigned char *) hdr + segments->seg_len;
+
+    /* match the messages in the order they were packed, each one as if it
+     * had been received in its own fragment */
+    for (uint16_t i = 0 ; i < hdr->hdr_multi.hdr_count ; ++i) {
+        uint32_t length;
+
+        if (OPAL_UNLIKELY(entry + sizeof (uint32_t) > end)) {
+            break;
+        }
+        length = ob1_multi_length_ntoh (*(uint32_t *) entry, hdr);
+        if (OPAL_UNLIKELY((size_t) (end - entry) < sizeof (uint32_t) + length)) {
+            break;
+        }
+
+        segment.seg_addr.pval = entry + sizeof (uint32_t);
+        segment.seg_len = length;
+        mca_pml_ob1_recv_frag_callback_match (btl, &match_descriptor);
+
+        entry += MCA_PML_OB1_MULTI_ENTRY_LEN(length);
+    }
+}
@@ -166,6 +166,12 @@ extern void mca_pml_ob1_recv_frag_callback_fin (mca_btl_base_module_t *btl,
 extern void mca_pml_ob1_recv_frag_callback_cid( mca_btl_base_module_t *btl,
                                                 const mca_btl_base_receive_descriptor_t* descriptor);
 
+/**
+ * Callback from BTL on receipt of several short messages packed together
+ */
+extern void mca_pml_ob1_recv_frag_callback_multi (mca_btl_base_module_t *btl,
+                                                  const mca_btl_base_receive_descriptor_t *descriptor);
+
 /**
  * Extract the next fragment from the cant_match ordered list. This fragment
  * will be the next in sequence.
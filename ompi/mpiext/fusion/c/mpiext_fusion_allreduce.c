@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+#include "ompi_config.h"
+
+#include <stdlib.h>
+
+#include "ompi/mpi/c/bindings.h"
+#include "ompi/runtime/params.h"
+#include "ompi/communicator/communicator.h"
+#include "ompi/datatype/ompi_datatype.h"
+#include "ompi/op/op.h"
+
+#include "ompi/mpiext/fusion/c/mpiext_fusion_c.h"
+
+#if OMPI_BUILD_MPI_PROFILING
+#if OPAL_HAVE_WEAK_SYMBOLS
+#pragma weak MPIX_Allreduce_multi = PMPIX_Allreduce_multi
+#endif
+#define MPIX_Allreduce_multi PMPIX_Allreduce_multi
+#endif
+
+static const char FUNC_NAME[] = "MPIX_Allreduce_multi";
+
+
+int MPIX_Allreduce_multi(int count, const void *sendbufs[], void *recvbufs[],
+                         const int counts[], const MPI_Datatype datatypes[],
+                         const MPI_Op ops[], MPI_Comm comm)
+{
+    int rc = MPI_SUCCESS;
+    size_t *scounts;
+
+    /* Argument checking */
+    if (MPI_PARAM_CHECK) {
+        OMPI_ERR_INIT_FINALIZE(FUNC_NAME);
+        if (ompi_comm_invalid(comm) || OMPI_COMM_IS_INTER(comm)) {
+            return OMPI_ERRHANDLER_INVOKE(MPI_COMM_WORLD, MPI_ERR_COMM, FUNC_NAME);
+        }
+        if (count < 0 || (count > 0 && (NULL == sendbufs || NULL == recvbufs
+                                        || NULL == counts || NULL == datatypes
+                                        || NULL == ops))) {
+            rc = MPI_ERR_ARG;
+        }
+        for (int i = 0; MPI_SUCCESS == rc && i < count; ++i) {
+            char *msg;
+            if (counts[i] < 0) {
+                rc = MPI_ERR_COUNT;
+            } else if (MPI_OP_NULL == ops[i]) {
+                rc = MPI_ERR_OP;
+            } else if (!ompi_op_is_valid(ops[i], datatypes[i], &msg, FUNC_NAME)) {
+                int ret = OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_OP, msg);
+                free(msg);
+                return ret;
+            } else if (MPI_IN_PLACE == recvbufs[i]) {
+                rc = MPI_ERR_BUFFER;
+            } else {
+                OMPI_CHECK_DATATYPE_FOR_SEND(rc, datatypes[i], counts[i]);
+            }
+        }
+        OMPI_ERRHANDLER_CHECK(rc, comm, rc, FUNC_NAME);
+    }
+
+    if (0 == count) {
+        return MPI_SUCCESS;
+    }
+
+    /* No component provides the fused path: issue the allreduces one by
+     * one, which is what the caller would have done without us. */
+    if (NULL == comm->c_coll->coll_allreduce_multi) {
+        for (int i = 0; MPI_SUCCESS == rc && i < count; ++i) {
+            rc = comm->c_coll->coll_allreduce(sendbufs[i], recvbufs[i], counts[i],
+                                              datatypes[i], ops[i], comm,
+                                              comm->c_coll->coll_allreduce_module);
+        }
+        OMPI_ERRHANDLER_RETURN(rc, comm, rc, FUNC_NAME);
+    }
+
+    scounts = (size_t *) malloc(count * sizeof(size_t));
+    if (NULL == scounts) {
+        return OMPI_ERRHANDLER_INVOKE(comm, MPI_ERR_NO_MEM, FUNC_NAME);
+    }
+    for (int i = 0; i < count; ++i) {
+        scounts[i] = (size_t) counts[i];
+    }
+
+    rc = comm->c_coll->coll_allreduce_multi(count, sendbufs, recvbufs, scounts,
+                                            (struct ompi_datatype_t * const *) datatypes,
+                                            (struct ompi_op_t * const *) ops, comm,
+                                            comm->c_coll->coll_allreduce_multi_module);
+    free(scounts);
+    OMPI_ERRHANDLER_RETURN(rc, comm, rc, FUNC_NAME);
+}
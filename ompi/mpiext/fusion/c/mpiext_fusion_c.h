@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ *
+ */
+
+/*
+ * Perform count independent allreduce operations on comm as a single
+ * fused collective. Operation i reduces counts[i] elements of
+ * datatypes[i] from sendbufs[i] (or MPI_IN_PLACE) into recvbufs[i] with
+ * ops[i]. The result is the same as calling MPI_Allreduce for each i in
+ * order, all processes must pass the same sequence of operations.
+ */
+OMPI_DECLSPEC int MPIX_Allreduce_multi(int count, const void *sendbufs[], void *recvbufs[],
+                                       const int counts[], const MPI_Datatype datatypes[],
+                                       const MPI_Op ops[], MPI_Comm comm);
+OMPI_DECLSPEC int PMPIX_Allreduce_multi(int count, const void *sendbufs[], void *recvbufs[],
+                                        const int counts[], const MPI_Datatype datatypes[],
+                                        const MPI_Op ops[], MPI_Comm comm);
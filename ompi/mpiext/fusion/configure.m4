@@ -0,0 +1,26 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2004-2009 The Trustees of Indiana University.
+#                         All rights reserved.
+# Copyright (c) 2012-2015 Cisco Systems, Inc.  All rights reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+# OMPI_MPIEXT_fusion_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([OMPI_MPIEXT_fusion_CONFIG], [
+    AC_CONFIG_FILES([ompi/mpiext/fusion/Makefile])
+    AC_CONFIG_FILES([ompi/mpiext/fusion/c/Makefile])
+    AC_CONFIG_FILES([ompi/mpiext/fusion/c/profile/Makefile])
+
+    # The fused calls fall back to regular collectives when no coll
+    # component provides them, so this can always build.
+    AS_IF([test "$ENABLE_fusion" = "1" || \
+           test "$ENABLE_EXT_ALL" = "1"],
+          [$1],
+          [$2])
+])
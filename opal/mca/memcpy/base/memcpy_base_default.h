@@ -14,6 +14,9 @@
 
 #define opal_memcpy(dst, src, length) memcpy((dst), (src), (length));
 
+/* Without a streaming implementation, write-once copies are plain copies */
+#define opal_memcpy_nt(dst, src, length) memcpy((dst), (src), (length))
+
 #define opal_memcpy_tov(dst_iov, src, count)                              \
     do {                                                                  \
         int _i;                                                           \
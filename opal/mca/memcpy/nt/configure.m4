@@ -0,0 +1,69 @@
+# -*- shell-script -*-
+#
+# Copyright (c) 2026      Advanced Micro Devices, Inc. All rights reserved.
+# $COPYRIGHT$
+#
+# Additional copyrights may follow
+#
+# $HEADER$
+#
+
+AC_DEFUN([MCA_opal_memcpy_nt_PRIORITY], [30])
+
+AC_DEFUN([MCA_opal_memcpy_nt_COMPILE_MODE], [
+    AC_MSG_CHECKING([for MCA component $2:$3 compile mode])
+    $4="static"
+    AC_MSG_RESULT([$$4])
+])
+
+AC_DEFUN([MCA_opal_memcpy_nt_POST_CONFIG],[
+    AS_IF([test "$1" = "1"], [memcpy_base_include="nt/memcpy_nt.h"])
+])dnl
+
+# MCA_memcpy_nt_CONFIG(action-if-can-compile,
+#                      [action-if-cant-compile])
+# ------------------------------------------------
+# The non-temporal kernels are compiled with function-level target
+# attributes and selected at runtime, so no global -m flags are needed.
+AC_DEFUN([MCA_opal_memcpy_nt_CONFIG],[
+    AC_CONFIG_FILES([opal/mca/memcpy/nt/Makefile])
+    OPAL_VAR_SCOPE_PUSH([memcpy_nt_happy memcpy_nt_avx512])
+
+    memcpy_nt_happy="no"
+    memcpy_nt_avx512=0
+    case "${host}" in
+        x86_64*|amd64*)
+            AC_MSG_CHECKING([for non-temporal AVX2 store support])
+            AC_LINK_IFELSE(
+                [AC_LANG_PROGRAM([[#include <immintrin.h>
+__attribute__((target("avx2"))) static void nt_copy(void *d, const void *s) {
+    _mm256_stream_si256((__m256i *) d, _mm256_loadu_si256((const __m256i *) s));
+    _mm_sfence();
+}]],
+                                 [[char d[64] __attribute__((aligned(32))), s[64];
+    if (__builtin_cpu_supports("avx2")) nt_copy(d, s);]])],
+                [memcpy_nt_happy="yes"],
+                [memcpy_nt_happy="no"])
+            AC_MSG_RESULT([$memcpy_nt_happy])
+
+            AS_IF([test "$memcpy_nt_happy" = "yes"],
+                  [AC_MSG_CHECKING([for non-temporal AVX512 store support])
+                   AC_LINK_IFELSE(
+                       [AC_LANG_PROGRAM([[#include <immintrin.h>
+__attribute__((target("avx512f"))) static void nt_copy(void *d, const void *s) {
+    _mm512_stream_si512((void *) d, _mm512_loadu_si512((const void *) s));
+}]],
+                                        [[char d[64] __attribute__((aligned(64))), s[64];
+    if (__builtin_cpu_supports("avx512f")) nt_copy(d, s);]])],
+                       [memcpy_nt_avx512=1
+                        AC_MSG_RESULT([yes])],
+                       [AC_MSG_RESULT([no])])])
+            ;;
+    esac
+
+    AC_DEFINE_UNQUOTED([OPAL_MEMCPY_NT_HAVE_AVX512], [$memcpy_nt_avx512],
+                       [Whether the memcpy nt component can build AVX512 kernels])
+
+    AS_IF([test "$memcpy_nt_happy" = "yes"], [$1], [$2])
+    OPAL_VAR_SCOPE_POP
+])dnl
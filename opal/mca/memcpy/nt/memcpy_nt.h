@@ -0,0 +1,70 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      Advanced Micro Devices, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/**
+ * @file
+ *
+ * memcpy implementation with non-temporal (streaming) store kernels.
+ *
+ * opal_memcpy keeps the semantics of the default implementation.
+ * opal_memcpy_nt is meant for write-once destinations that the calling
+ * core will not read again (e.g. shared memory segments read by peers):
+ * above opal_memcpy_nt_threshold bytes it bypasses the cache hierarchy
+ * using the widest streaming store supported by the processor. The
+ * destination is globally visible when opal_memcpy_nt returns.
+ */
+
+#ifndef OPAL_MCA_MEMCPY_NT_MEMCPY_NT_H
+#define OPAL_MCA_MEMCPY_NT_MEMCPY_NT_H
+
+#include "opal_config.h"
+
+#include <string.h>
+
+BEGIN_C_DECLS
+
+OPAL_DECLSPEC extern size_t opal_memcpy_nt_threshold;
+OPAL_DECLSPEC extern void *(*opal_memcpy_nt_fn)(void *dst, const void *src, size_t length);
+
+static inline void *opal_memcpy_nt(void *dst, const void *src, size_t length)
+{
+    if (length < opal_memcpy_nt_threshold) {
+        return memcpy(dst, src, length);
+    }
+    return opal_memcpy_nt_fn(dst, src, length);
+}
+
+END_C_DECLS
+
+#define opal_memcpy(dst, src, length) memcpy((dst), (src), (length));
+
+#define opal_memcpy_tov(dst_iov, src, count)                              \
+    do {                                                                  \
+        int _i;                                                           \
+        char *_src = (char *) src;                                        \
+                                                                          \
+        for (_i = 0; _i < count; _i++) {                                  \
+            opal_memcpy(dst_iov[_i].iov_base, _src, dst_iov[_i].iov_len); \
+            _src += dst_iov[_i].iov_len;                                  \
+        }                                                                 \
+    } while (0)
+
+#define opal_memcpy_fromv(dst, src_iov, count)                            \
+    do {                                                                  \
+        int _i;                                                           \
+        char *_dst = (char *) dst;                                        \
+                                                                          \
+        for (_i = 0; _i < count; _i++) {                                  \
+            opal_memcpy(_dst, src_iov[_i].iov_base, src_iov[_i].iov_len); \
+            _dst += src_iov[_i].iov_len;                                  \
+        }                                                                 \
+    } while (0)
+
+#endif /* OPAL_MCA_MEMCPY_NT_MEMCPY_NT_H */
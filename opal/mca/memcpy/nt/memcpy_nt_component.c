@@ -0,0 +1,236 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2026      Advanced Micro Devices, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "opal_config.h"
+
+#include <immintrin.h>
+#include <string.h>
+
+#include "opal/align.h"
+#include "opal/constants.h"
+#include "opal/mca/base/base.h"
+#include "opal/mca/memcpy/base/base.h"
+#include "opal/mca/memcpy/memcpy.h"
+#include "opal/mca/memcpy/nt/memcpy_nt.h"
+#include "opal/util/output.h"
+
+/* How far ahead of the copy position the source is prefetched */
+#define MEMCPY_NT_PREFETCH_DISTANCE 1024
+
+enum {
+    MEMCPY_NT_KERNEL_AUTO = 0,
+    MEMCPY_NT_KERNEL_SSE2,
+    MEMCPY_NT_KERNEL_AVX2,
+    MEMCPY_NT_KERNEL_AVX512,
+};
+
+static mca_base_var_enum_value_t memcpy_nt_kernels[] = {
+    {MEMCPY_NT_KERNEL_AUTO, "auto"},
+    {MEMCPY_NT_KERNEL_SSE2, "sse2"},
+    {MEMCPY_NT_KERNEL_AVX2, "avx2"},
+    {MEMCPY_NT_KERNEL_AVX512, "avx512"},
+    {0, NULL},
+};
+
+static int memcpy_nt_kernel = MEMCPY_NT_KERNEL_AUTO;
+
+size_t opal_memcpy_nt_threshold = 256 * 1024;
+void *(*opal_memcpy_nt_fn)(void *dst, const void *src, size_t length) = memcpy;
+
+static int memcpy_nt_register(void);
+static int memcpy_nt_open(void);
+
+const opal_memcpy_base_component_2_0_0_t mca_memcpy_nt_component = {
+    /* First, the mca_component_t struct containing meta information
+       about the component itself */
+    .memcpyc_version =
+        {
+            OPAL_MEMCPY_BASE_VERSION_2_0_0,
+
+            /* Component name and version */
+            .mca_component_name = "nt",
+            MCA_BASE_MAKE_VERSION(component, OPAL_MAJOR_VERSION, OPAL_MINOR_VERSION,
+                                  OPAL_RELEASE_VERSION),
+
+            /* Component open and close functions */
+            .mca_open_component = memcpy_nt_open,
+            .mca_register_component_params = memcpy_nt_register,
+        },
+    .memcpyc_data =
+        {/* The component is checkpoint ready */
+         MCA_BASE_METADATA_PARAM_CHECKPOINT},
+};
+MCA_BASE_COMPONENT_INIT(opal, memcpy, nt)
+
+/*
+ * Copy the unaligned head with memcpy so that all vector stores are
+ * aligned, as required by the streaming store instructions. Returns the
+ * number of bytes copied.
+ */
+static inline size_t memcpy_nt_head(char *dst, const char *src, size_t length, size_t align)
+{
+    size_t head = OPAL_ALIGN_PAD_AMOUNT(dst, align);
+
+    if (head > length) {
+        head = length;
+    }
+    memcpy(dst, src, head);
+    return head;
+}
+
+static void *memcpy_nt_sse2(void *dst, const void *src, size_t length)
+{
+    char *d = (char *) dst;
+    const char *s = (const char *) src;
+    size_t done = memcpy_nt_head(d, s, length, 16);
+
+    d += done;
+    s += done;
+    length -= done;
+    for (; length >= 64; length -= 64, d += 64, s += 64) {
+        _mm_prefetch(s + MEMCPY_NT_PREFETCH_DISTANCE, _MM_HINT_NTA);
+        __m128i v0 = _mm_loadu_si128((const __m128i *) s);
+        __m128i v1 = _mm_loadu_si128((const __m128i *) (s + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i *) (s + 32));
+        __m128i v3 = _mm_loadu_si128((const __m128i *) (s + 48));
+        _mm_stream_si128((__m128i *) d, v0);
+        _mm_stream_si128((__m128i *) (d + 16), v1);
+        _mm_stream_si128((__m128i *) (d + 32), v2);
+        _mm_stream_si128((__m128i *) (d + 48), v3);
+    }
+    memcpy(d, s, length);
+    /* Streaming stores are weakly ordered, make them visible before any
+     * subsequent store (e.g. a flag signaling the data is ready) */
+    _mm_sfence();
+    return dst;
+}
+
+__attribute__((target("avx2")))
+static void *memcpy_nt_avx2(void *dst, const void *src, size_t length)
+{
+    char *d = (char *) dst;
+    const char *s = (const char *) src;
+    size_t done = memcpy_nt_head(d, s, length, 32);
+
+    d += done;
+    s += done;
+    length -= done;
+    for (; length >= 128; length -= 128, d += 128, s += 128) {
+        _mm_prefetch(s + MEMCPY_NT_PREFETCH_DISTANCE, _MM_HINT_NTA);
+        _mm_prefetch(s + MEMCPY_NT_PREFETCH_DISTANCE + 64, _MM_HINT_NTA);
+        __m256i v0 = _mm256_loadu_si256((const __m256i *) s);
+        __m256i v1 = _mm256_loadu_si256((const __m256i *) (s + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i *) (s + 64));
+        __m256i v3 = _mm256_loadu_si256((const __m256i *) (s + 96));
+        _mm256_stream_si256((__m256i *) d, v0);
+        _mm256_stream_si256((__m256i *) (d + 32), v1);
+        _mm256_stream_si256((__m256i *) (d + 64), v2);
+        _mm256_stream_si256((__m256i *) (d + 96), v3);
+    }
+    memcpy(d, s, length);
+    _mm_sfence();
+    return dst;
+}
+
+#if OPAL_MEMCPY_NT_HAVE_AVX512
+__attribute__((target("avx512f")))
+static void *memcpy_nt_avx512(void *dst, const void *src, size_t length)
+{
+    char *d = (char *) dst;
+    const char *s = (const char *) src;
+    size_t done = memcpy_nt_head(d, s, length, 64);
+
+    d += done;
+    s += done;
+    length -= done;
+    for (; length >= 256; length -= 256, d += 256, s += 256) {
+        for (int i = 0; i < 256; i += 64) {
+            _mm_prefetch(s + MEMCPY_NT_PREFETCH_DISTANCE + i, _MM_HINT_NTA);
+        }
+        __m512i v0 = _mm512_loadu_si512((const void *) s);
+        __m512i v1 = _mm512_loadu_si512((const void *) (s + 64));
+        __m512i v2 = _mm512_loadu_si512((const void *) (s + 128));
+        __m512i v3 = _mm512_loadu_si512((const void *) (s + 192));
+        _mm512_stream_si512((void *) d, v0);
+        _mm512_stream_si512((void *) (d + 64), v1);
+        _mm512_stream_si512((void *) (d + 128), v2);
+        _mm512_stream_si512((void *) (d + 192), v3);
+    }
+    memcpy(d, s, length);
+    _mm_sfence();
+    return dst;
+}
+#endif /* OPAL_MEMCPY_NT_HAVE_AVX512 */
+
+static int memcpy_nt_register(void)
+{
+    mca_base_var_enum_t *new_enum;
+    int rc;
+
+    (void) mca_base_component_var_register(&mca_memcpy_nt_component.memcpyc_version, "threshold",
+                                           "Minimum size in bytes for which opal_memcpy_nt uses "
+                                           "non-temporal stores; smaller copies use memcpy",
+                                           MCA_BASE_VAR_TYPE_SIZE_T, NULL, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL, &opal_memcpy_nt_threshold);
+
+    rc = mca_base_var_enum_create("memcpy nt kernels", memcpy_nt_kernels, &new_enum);
+    if (OPAL_SUCCESS != rc) {
+        return rc;
+    }
+    (void) mca_base_component_var_register(&mca_memcpy_nt_component.memcpyc_version, "kernel",
+                                           "Non-temporal copy kernel to use. \"auto\" selects "
+                                           "the widest one supported by the processor; a kernel "
+                                           "not supported by the processor falls back to auto",
+                                           MCA_BASE_VAR_TYPE_INT, new_enum, 0, 0, OPAL_INFO_LVL_5,
+                                           MCA_BASE_VAR_SCOPE_LOCAL, &memcpy_nt_kernel);
+    OBJ_RELEASE(new_enum);
+
+    return OPAL_SUCCESS;
+}
+
+static int memcpy_nt_open(void)
+{
+    int best = MEMCPY_NT_KERNEL_SSE2;
+    int kernel = memcpy_nt_kernel;
+
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        best = MEMCPY_NT_KERNEL_AVX2;
+    }
+#if OPAL_MEMCPY_NT_HAVE_AVX512
+    if (__builtin_cpu_supports("avx512f")) {
+        best = MEMCPY_NT_KERNEL_AVX512;
+    }
+#endif
+
+    if (MEMCPY_NT_KERNEL_AUTO == kernel || kernel > best) {
+        kernel = best;
+    }
+
+    switch (kernel) {
+#if OPAL_MEMCPY_NT_HAVE_AVX512
+    case MEMCPY_NT_KERNEL_AVX512:
+        opal_memcpy_nt_fn = memcpy_nt_avx512;
+        break;
+#endif
+    case MEMCPY_NT_KERNEL_AVX2:
+        opal_memcpy_nt_fn = memcpy_nt_avx2;
+        break;
+    default:
+        opal_memcpy_nt_fn = memcpy_nt_sse2;
+        break;
+    }
+
+    opal_output_verbose(MCA_BASE_VERBOSE_COMPONENT, opal_memcpy_base_framework.framework_output,
+                        "memcpy:nt: using %s kernel above %zu bytes",
+                        memcpy_nt_kernels[kernel].string, opal_memcpy_nt_threshold);
+
+    return OPAL_SUCCESS;
+}
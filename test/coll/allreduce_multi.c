@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Check MPIX_Allreduce_multi against one MPI_Allreduce per operand.
+ *
+ * The first batch qualifies for the fused path of coll/acoll (predefined
+ * datatypes, commutative operations, a few hundred bytes in total, with and
+ * without MPI_IN_PLACE). The second one does not (a derived datatype and a
+ * non-commutative user operation) and must give the same results through the
+ * fallback. Each batch is run through MPIX_Allreduce_multi and through its
+ * profiling entry point PMPIX_Allreduce_multi. To exercise the fused path:
+ *
+ *     mpirun -n 4 --mca coll acoll,tuned,libnbc,basic --mca coll_acoll_priority 40 \
+ *            --mca coll_acoll_comm_size_thresh 2 allreduce_multi
+ *
+ * Exits with 0 if all the results match, 1 otherwise.
+ */
+
+#include "mpi.h"
+#include "mpi-ext.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(OMPI_HAVE_MPI_EXT_FUSION) && OMPI_HAVE_MPI_EXT_FUSION
+
+#define NOPS  5
+#define COUNT 16
+
+typedef int (*multi_fn_t)(int, const void *[], void *[], const int[], const MPI_Datatype[],
+                          const MPI_Op[], MPI_Comm);
+
+/* Non-commutative: keep the operand of the lowest rank */
+static void first_op(void *in, void *inout, int *len, MPI_Datatype *dtype)
+{
+    int size;
+
+    MPI_Type_size(*dtype, &size);
+    memcpy(inout, in, (size_t) *len * size);
+}
+
+static int check_batch(const char *name, multi_fn_t fn, const MPI_Datatype dtypes[],
+                       const MPI_Op ops[], const int in_place[], int rank)
+{
+    int ints[NOPS][COUNT], expected[NOPS][COUNT], results[NOPS][COUNT];
+    double dbls[NOPS][COUNT], dexpected[NOPS][COUNT], dresults[NOPS][COUNT];
+    const void *sbufs[NOPS];
+    void *rbufs[NOPS], *ebufs[NOPS];
+    int counts[NOPS], errors = 0, all_errors;
+
+    for (int i = 0; i < NOPS; i++) {
+        for (int j = 0; j < COUNT; j++) {
+            ints[i][j] = (rank + 1) * (j + 1) + i;
+            dbls[i][j] = (double) ((rank + 1) * (j + 1) + i) / 4.0;
+        }
+        /* Operands of different lengths, so that they are packed at different offsets */
+        counts[i] = COUNT - 3 * i;
+        if (MPI_DOUBLE == dtypes[i]) {
+            memcpy(dresults[i], dbls[i], sizeof(dbls[i]));
+            sbufs[i] = in_place[i] ? MPI_IN_PLACE : (const void *) dbls[i];
+            rbufs[i] = dresults[i];
+            ebufs[i] = dexpected[i];
+            MPI_Allreduce(dbls[i], dexpected[i], counts[i], dtypes[i], ops[i], MPI_COMM_WORLD);
+        } else {
+            memcpy(results[i], ints[i], sizeof(ints[i]));
+            sbufs[i] = in_place[i] ? MPI_IN_PLACE : (const void *) ints[i];
+            rbufs[i] = results[i];
+            ebufs[i] = expected[i];
+            /* The derived datatype holds 2 ints */
+            if (MPI_INT != dtypes[i]) {
+                counts[i] /= 2;
+            }
+            MPI_Allreduce(ints[i], expected[i], counts[i], dtypes[i], ops[i], MPI_COMM_WORLD);
+        }
+    }
+
+    if (MPI_SUCCESS != fn(NOPS, sbufs, rbufs, counts, dtypes, ops, MPI_COMM_WORLD)) {
+        errors++;
+    }
+    for (int i = 0; i < NOPS; i++) {
+        int size;
+        MPI_Type_size(dtypes[i], &size);
+        if (0 != memcmp(rbufs[i], ebufs[i], (size_t) counts[i] * size)) {
+            fprintf(stderr, "[%d] %s: operand %d differs from MPI_Allreduce\n", rank, name, i);
+            errors++;
+        }
+    }
+
+    MPI_Allreduce(&errors, &all_errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (0 == rank) {
+        printf("%-32s %s\n", name, 0 == all_errors ? "ok" : "FAILED");
+    }
+    return all_errors;
+}
+
+int main(int argc, char *argv[])
+{
+    MPI_Datatype pair;
+    MPI_Op first;
+    int rank, errors = 0;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Type_contiguous(2, MPI_INT, &pair);
+    MPI_Type_commit(&pair);
+    MPI_Op_create(first_op, 0, &first);
+
+    {
+        const MPI_Datatype dtypes[NOPS] = {MPI_INT, MPI_DOUBLE, MPI_INT, MPI_DOUBLE, MPI_INT};
+        const MPI_Op ops[NOPS] = {MPI_SUM, MPI_MAX, MPI_MIN, MPI_SUM, MPI_BXOR};
+        const int in_place[NOPS] = {0, 1, 0, 0, 1};
+
+        errors += check_batch("fused batch", MPIX_Allreduce_multi, dtypes, ops, in_place, rank);
+        errors += check_batch("fused batch (PMPIX)", PMPIX_Allreduce_multi, dtypes, ops, in_place,
+                              rank);
+    }
+    {
+        const MPI_Datatype dtypes[NOPS] = {MPI_INT, pair, MPI_INT, MPI_DOUBLE, MPI_INT};
+        const MPI_Op ops[NOPS] = {MPI_SUM, first, first, MPI_MAX, MPI_PROD};
+        const int in_place[NOPS] = {1, 0, 0, 1, 0};
+
+        errors += check_batch("fallback batch", MPIX_Allreduce_multi, dtypes, ops, in_place, rank);
+        errors += check_batch("fallback batch (PMPIX)", PMPIX_Allreduce_multi, dtypes, ops,
+                              in_place, rank);
+    }
+
+    MPI_Op_free(&first);
+    MPI_Type_free(&pair);
+    MPI_Finalize();
+    return 0 == errors ? 0 : 1;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void) argc;
+    (void) argv;
+    fprintf(stderr, "allreduce_multi: the fusion MPI extension is not built, skipped\n");
+    return 77;
+}
+
+#endif
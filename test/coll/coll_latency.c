@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Measure the latency of small blocking collectives.
+ *
+ * For each message size (per process, in bytes), print the average time of
+ * the collective, max over the ranks, and the minimum over the repetitions
+ * of the measurement. For small messages the fixed costs of the algorithm,
+ * such as the allocation of its temporary buffers, are a large part of the
+ * latency; compare for instance the scratch arena of coll/base with the
+ * allocation at each call:
+ *
+ *     mpirun -n 16 coll_latency -c allgather
+ *     mpirun -n 16 --mca coll_base_scratch_max 0 coll_latency -c allgather
+ *
+ * A given algorithm of coll/tuned can be forced with
+ * --mca coll_tuned_use_dynamic_rules 1 --mca coll_tuned_<coll>_algorithm <n>.
+ *
+ * Usage: coll_latency [-c allreduce|allgather|alltoall|reduce|bcast] [-m max_bytes]
+ *                     [-i iterations] [-r repetitions]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MIN_SIZE 8
+
+enum { COLL_ALLREDUCE, COLL_ALLGATHER, COLL_ALLTOALL, COLL_REDUCE, COLL_BCAST };
+
+static int coll = COLL_ALLREDUCE;
+static const char *coll_name = "allreduce";
+
+static void run_coll(void *sbuf, void *rbuf, int count)
+{
+    switch (coll) {
+    case COLL_ALLREDUCE:
+        MPI_Allreduce(sbuf, rbuf, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        break;
+    case COLL_ALLGATHER:
+        MPI_Allgather(sbuf, count, MPI_INT, rbuf, count, MPI_INT, MPI_COMM_WORLD);
+        break;
+    case COLL_ALLTOALL:
+        MPI_Alltoall(sbuf, count, MPI_INT, rbuf, count, MPI_INT, MPI_COMM_WORLD);
+        break;
+    case COLL_REDUCE:
+        MPI_Reduce(sbuf, rbuf, count, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+        break;
+    case COLL_BCAST:
+        MPI_Bcast(rbuf, count, MPI_INT, 0, MPI_COMM_WORLD);
+        break;
+    }
+}
+
+/* Average time of the collective, max over the ranks */
+static double time_coll(void *sbuf, void *rbuf, int count, int iters)
+{
+    double t, tmax;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    for (int i = 0; i < iters; i++) {
+        run_coll(sbuf, rbuf, count);
+    }
+    t = (MPI_Wtime() - t) / iters;
+    MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return tmax;
+}
+
+int main(int argc, char **argv)
+{
+    int rank, size, opt, iters = 1000, reps = 5;
+    size_t max_size = 4096;
+    void *sbuf, *rbuf;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    while (-1 != (opt = getopt(argc, argv, "c:m:i:r:"))) {
+        switch (opt) {
+        case 'c':
+            coll_name = optarg;
+            if (0 == strcmp(optarg, "allreduce")) {
+                coll = COLL_ALLREDUCE;
+            } else if (0 == strcmp(optarg, "allgather")) {
+                coll = COLL_ALLGATHER;
+            } else if (0 == strcmp(optarg, "alltoall")) {
+                coll = COLL_ALLTOALL;
+            } else if (0 == strcmp(optarg, "reduce")) {
+                coll = COLL_REDUCE;
+            } else if (0 == strcmp(optarg, "bcast")) {
+                coll = COLL_BCAST;
+            } else {
+                if (0 == rank) {
+                    fprintf(stderr, "Unknown collective %s\n", optarg);
+                }
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            break;
+        case 'm':
+            max_size = strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            iters = atoi(optarg);
+            break;
+        case 'r':
+            reps = atoi(optarg);
+            break;
+        default:
+            if (0 == rank) {
+                fprintf(stderr, "Usage: %s [-c allreduce|allgather|alltoall|reduce|bcast] "
+                        "[-m max_bytes] [-i iterations] [-r repetitions]\n", argv[0]);
+            }
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    /* allgather and alltoall move one message per peer */
+    sbuf = calloc(size, max_size);
+    rbuf = calloc(size, max_size);
+    if (NULL == sbuf || NULL == rbuf) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    if (0 == rank) {
+        printf("# %s on %d processes, %d iterations, best of %d\n", coll_name, size, iters, reps);
+        printf("# %12s %14s\n", "bytes", "latency(us)");
+    }
+
+    for (size_t bytes = MIN_SIZE; bytes <= max_size; bytes *= 2) {
+        int count = (int) (bytes / sizeof(int));
+        double t, t_best = 0.0;
+
+        /* warm up, e.g. to size the scratch arena and the request arrays */
+        (void) time_coll(sbuf, rbuf, count, iters / 10 + 1);
+        for (int r = 0; r < reps; r++) {
+            t = time_coll(sbuf, rbuf, count, iters);
+            if (0 == r || t < t_best) {
+                t_best = t;
+            }
+        }
+        if (0 == rank) {
+            printf("  %12zu %14.2f\n", bytes, t_best * 1e6);
+        }
+    }
+
+    free(sbuf);
+    free(rbuf);
+    MPI_Finalize();
+    return 0;
+}
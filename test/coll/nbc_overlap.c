@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026      The Open MPI Project.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Measure how much of a nonblocking collective overlaps with computation.
+ *
+ * For each message size, time the collective alone (t_coll), a computation
+ * of about the same length alone (t_comp), and the collective started before
+ * the computation and waited for after it (t_total). The overlap is the part
+ * of the shorter of the two that was hidden:
+ *
+ *     overlap = 100 * (t_coll + t_comp - t_total) / min(t_coll, t_comp)
+ *
+ * Without asynchronous progress the collective mostly advances in MPI_Wait
+ * and the overlap stays low; compare for instance
+ *
+ *     mpirun -n 8 nbc_overlap
+ *     mpirun -n 8 --mca coll_libnbc_progress_thread 1 nbc_overlap
+ *     mpirun -n 8 --mca coll_adapt_priority 100 --mca coll_adapt_progress_thread 1 nbc_overlap -c bcast
+ *
+ * Usage: nbc_overlap [-c allreduce|bcast|reduce|alltoall] [-m max_bytes] [-i iterations]
+ */
+
+#include "mpi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MIN_SIZE 1024
+
+enum { COLL_ALLREDUCE, COLL_BCAST, COLL_REDUCE, COLL_ALLTOALL };
+
+static int coll = COLL_ALLREDUCE;
+static const char *coll_name = "allreduce";
+
+static void start_coll(void *sbuf, void *rbuf, int count, int size, MPI_Request *req)
+{
+    switch (coll) {
+    case COLL_ALLREDUCE:
+        MPI_Iallreduce(sbuf, rbuf, count, MPI_INT, MPI_SUM, MPI_COMM_WORLD, req);
+        break;
+    case COLL_BCAST:
+        MPI_Ibcast(rbuf, count, MPI_INT, 0, MPI_COMM_WORLD, req);
+        break;
+    case COLL_REDUCE:
+        MPI_Ireduce(sbuf, rbuf, count, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD, req);
+        break;
+    case COLL_ALLTOALL:
+        MPI_Ialltoall(sbuf, count / size, MPI_INT, rbuf, count / size, MPI_INT,
+                      MPI_COMM_WORLD, req);
+        break;
+    }
+}
+
+/* Spin without calling MPI for about usec microseconds */
+static void compute(double usec)
+{
+    double end = MPI_Wtime() + usec * 1e-6;
+    while (MPI_Wtime() < end) {
+        /* busy */
+    }
+}
+
+/* Average time of a collective alone, max over the ranks */
+static double time_coll(void *sbuf, void *rbuf, int count, int size, int iters)
+{
+    MPI_Request req;
+    double t, tmax;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    for (int i = 0; i < iters; i++) {
+        start_coll(sbuf, rbuf, count, size, &req);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+    }
+    t = (MPI_Wtime() - t) / iters;
+    MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return tmax;
+}
+
+/* Average time of a collective overlapped with usec of computation */
+static double time_overlap(void *sbuf, void *rbuf, int count, int size, int iters, double usec)
+{
+    MPI_Request req;
+    double t, tmax;
+
+    MPI_Barrier(MPI_COMM_WORLD);
+    t = MPI_Wtime();
+    for (int i = 0; i < iters; i++) {
+        start_coll(sbuf, rbuf, count, size, &req);
+        compute(usec);
+        MPI_Wait(&req, MPI_STATUS_IGNORE);
+    }
+    t = (MPI_Wtime() - t) / iters;
+    MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return tmax;
+}
+
+int main(int argc, char **argv)
+{
+    int rank, size, opt, iters = 100;
+    size_t max_size = 4 * 1024 * 1024;
+    void *sbuf, *rbuf;
+
+    MPI_Init(&argc, &argv);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    while (-1 != (opt = getopt(argc, argv, "c:m:i:"))) {
+        switch (opt) {
+        case 'c':
+            coll_name = optarg;
+            if (0 == strcmp(optarg, "allreduce")) {
+                coll = COLL_ALLREDUCE;
+            } else if (0 == strcmp(optarg, "bcast")) {
+                coll = COLL_BCAST;
+            } else if (0 == strcmp(optarg, "reduce")) {
+                coll = COLL_REDUCE;
+            } else if (0 == strcmp(optarg, "alltoall")) {
+                coll = COLL_ALLTOALL;
+            } else {
+                if (0 == rank) {
+                    fprintf(stderr, "Unknown collective %s\n", optarg);
+                }
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            break;
+        case 'm':
+            max_size = strtoul(optarg, NULL, 0);
+            break;
+        case 'i':
+            iters = atoi(optarg);
+            break;
+        default:
+            if (0 == rank) {
+                fprintf(stderr, "Usage: %s [-c allreduce|bcast|reduce|alltoall] "
+                        "[-m max_bytes] [-i iterations]\n", argv[0]);
+            }
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+
+    sbuf = calloc(1, max_size);
+    rbuf = calloc(1, max_size);
+    if (NULL == sbuf || NULL == rbuf) {
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    if (0 == rank) {
+        printf("# %s on %d processes, %d iterations\n", coll_name, size, iters);
+        printf("# %12s %14s %14s %14s %10s\n", "bytes", "coll(us)", "comp(us)",
+               "total(us)", "overlap(%)");
+    }
+
+    for (size_t bytes = MIN_SIZE; bytes <= max_size; bytes *= 2) {
+        int count = (int) (bytes / sizeof(int));
+        double t_coll, t_comp, t_total, overlap;
+
+        /* warm up, e.g. to fill the schedule caches */
+        (void) time_coll(sbuf, rbuf, count, size, iters / 10 + 1);
+        t_coll = time_coll(sbuf, rbuf, count, size, iters);
+        t_comp = t_coll;
+        t_total = time_overlap(sbuf, rbuf, count, size, iters, t_comp * 1e6);
+
+        overlap = 100.0 * (t_coll + t_comp - t_total) / (t_coll < t_comp ? t_coll : t_comp);
+        if (overlap < 0.0) {
+            overlap = 0.0;
+        } else if (overlap > 100.0) {
+            overlap = 100.0;
+        }
+        if (0 == rank) {
+            printf("  %12zu %14.2f %14.2f %14.2f %10.1f\n", bytes, t_coll * 1e6, t_comp * 1e6,
+                   t_total * 1e6, overlap);
+        }
+    }
+
+    free(sbuf);
+    free(rbuf);
+    MPI_Finalize();
+    return 0;
+}